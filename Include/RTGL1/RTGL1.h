@@ -113,6 +113,15 @@ typedef struct RgWaylandSurfaceCreateInfo RgWaylandSurfaceCreateInfo;
 typedef struct RgXcbSurfaceCreateInfo     RgXcbSurfaceCreateInfo;
 typedef struct RgXlibSurfaceCreateInfo    RgXlibSurfaceCreateInfo;
 
+// No window: the final image is kept in an internal render target of the given size,
+// and it can be read with rgReadbackFinalImage. Swapchain acquire / present are skipped,
+// so it works with drivers that don't have any surface extensions.
+typedef struct RgHeadlessCreateInfo
+{
+    uint32_t            width;
+    uint32_t            height;
+} RgHeadlessCreateInfo;
+
 #ifdef RG_USE_SURFACE_WIN32
 typedef struct RgWin32SurfaceCreateInfo
 {
@@ -190,6 +199,7 @@ typedef struct RgInstanceCreateInfo
     RgWaylandSurfaceCreateInfo* pWaylandSurfaceCreateInfo;
     RgXcbSurfaceCreateInfo*     pXcbSurfaceCreateInfo;
     RgXlibSurfaceCreateInfo*    pXlibSurfaceCreateInfo;
+    RgHeadlessCreateInfo*       pHeadlessCreateInfo;
 
     // Path to the development configuration file. It's read line by line. Case-insensitive.
     // "VulkanValidation"   - validate each Vulkan API call and print using pfnPrint
@@ -381,6 +391,11 @@ typedef struct RgEditorInfo
     RgEditorAttachedLightInfo       attachedLight;
 } RgEditorInfo;
 
+// Texture name that was resolved once by rgGetMaterialHandle,
+// to avoid the lookups by a string for each primitive.
+typedef uint32_t RgMaterialHandle;
+#define RG_NO_MATERIAL_HANDLE 0
+
 // Primitive is an indexed or non-indexed geometry with a material.
 typedef struct RgMeshPrimitiveInfo
 {
@@ -395,6 +410,9 @@ typedef struct RgMeshPrimitiveInfo
 
     const char*                     pTextureName;
     uint32_t                        textureFrame;
+    // If not RG_NO_MATERIAL_HANDLE, it's used instead of pTextureName,
+    // and pTextureName can be null.
+    RgMaterialHandle                materialHandle;
 
     // If alpha < 1.0, then RG_MESH_PRIMITIVE_TRANSLUCENT is assumed.
     RgColor4DPacked32               color;
@@ -418,10 +436,50 @@ typedef struct RgMeshInfo
     float                           animationTime;
 } RgMeshInfo;
 
+// Can be called from multiple threads at once, between rgStartFrame and rgDrawFrame.
+// Other functions must not be called while any rgUploadMeshPrimitive is in progress.
+// Note: the order of the uploaded primitives is not defined in that case.
 RGAPI RgResult RGCONV rgUploadMeshPrimitive( RgInstance                 instance,
                                              const RgMeshInfo*          pMesh,
                                              const RgMeshPrimitiveInfo* pPrimitive );
 
+// Same as calling rgUploadMeshPrimitive for each primitive, but cheaper:
+// primitives are grouped by texture name, so the per-texture lookups are done once.
+// The primitives may be uploaded in a different order.
+RGAPI RgResult RGCONV rgUploadMeshPrimitives( RgInstance                 instance,
+                                              const RgMeshInfo*          pMesh,
+                                              const RgMeshPrimitiveInfo* pPrimitives,
+                                              uint32_t                   primitiveCount );
+
+typedef struct RgMeshPrimitivesUploadInfo
+{
+    const RgMeshInfo*          pMesh;
+    const RgMeshPrimitiveInfo* pPrimitives;
+    uint32_t                   primitiveCount;
+} RgMeshPrimitivesUploadInfo;
+
+// Same as rgUploadMeshPrimitives, but primitives of all meshes are grouped together.
+RGAPI RgResult RGCONV rgUploadMeshes( RgInstance                        instance,
+                                      const RgMeshPrimitivesUploadInfo* pMeshes,
+                                      uint32_t                          meshCount );
+
+typedef struct RgStaticSectorUploadInfo
+{
+    // Unique name of the sector. If a sector with such name exists, it's replaced.
+    const char*                       pSectorName;
+    const RgMeshPrimitivesUploadInfo* pMeshes;
+    uint32_t                          meshCount;
+} RgStaticSectorUploadInfo;
+
+// Static sector is a set of static world geometry that is kept until rgRemoveStaticSector,
+// independently of the static scene that is loaded by the map name. E.g. for streaming
+// parts of an open world. Each sector is built separately, without waiting for the device,
+// so it becomes visible after a frame. Rasterized and first-person primitives are ignored.
+// Requires non-zero "staticSectorShare" in the library config.
+// Must not be called while any rgUploadMeshPrimitive is in progress.
+RGAPI RgResult RGCONV rgUploadStaticSector( RgInstance instance, const RgStaticSectorUploadInfo* pInfo );
+RGAPI RgResult RGCONV rgRemoveStaticSector( RgInstance instance, const char* pSectorName );
+
 RGAPI RgResult RGCONV rgUploadNonWorldPrimitive( RgInstance                 instance,
                                                  const RgMeshPrimitiveInfo* pPrimitive,
                                                  const float*               pViewProjection,
@@ -572,6 +630,10 @@ typedef struct RgOriginalCubemapInfo
 RGAPI RgResult RGCONV rgProvideOriginalTexture( RgInstance instance, const RgOriginalTextureInfo* pInfo );
 RGAPI RgResult RGCONV rgProvideOriginalCubemapTexture( RgInstance instance, const RgOriginalCubemapInfo* pInfo );
 RGAPI RgResult RGCONV rgMarkOriginalTextureAsDeleted( RgInstance instance, const char* pTextureName );
+// Returned handle is valid until the instance is destroyed, even if the texture
+// is not provided yet, or was deleted / reloaded. Can't be called while
+// rgUploadMeshPrimitive is in progress on other threads.
+RGAPI RgResult RGCONV rgGetMaterialHandle( RgInstance instance, const char* pTextureName, RgMaterialHandle* pResult );
 
 
 
@@ -584,6 +646,49 @@ typedef struct RgStartFrameInfo
 RGAPI RgResult RGCONV rgStartFrame( RgInstance instance, const RgStartFrameInfo* pInfo );
 
 
+typedef struct RgFrameStatisticsScope
+{
+    const char* pName;
+    // Nesting level of the scope, 0 for the outermost
+    uint32_t    depth;
+    // Relative to the start of the frame
+    double      startMs;
+    double      durationMs;
+} RgFrameStatisticsScope;
+
+typedef struct RgFrameStatisticsEntryPoint
+{
+    // Name of the API function, e.g. "rgUploadMeshPrimitive"
+    const char* pName;
+    uint32_t    callCount;
+    // Sum of CPU time of all calls, including the calls from different threads
+    double      totalMs;
+} RgFrameStatisticsEntryPoint;
+
+typedef struct RgFrameStatistics
+{
+    uint32_t                           frameId;
+    // Time between the rgStartFrame of this frame and the next one
+    double                             cpuFrameTimeMs;
+    // Time of the frame's command buffer execution; 0, if timestamps are not supported
+    double                             gpuFrameTimeMs;
+    // Command buffer labels of the frame's passes
+    const RgFrameStatisticsScope*      pGpuScopes;
+    uint32_t                           gpuScopeCount;
+    const RgFrameStatisticsEntryPoint* pEntryPoints;
+    uint32_t                           entryPointCount;
+} RgFrameStatistics;
+
+// Statistics of the latest frame, which GPU results are already available, i.e.
+// it's a frame that was started a few rgStartFrame calls ago. If there's no such frame yet,
+// the result is zeroed. Pointers in the result are valid until the next rgStartFrame.
+// Requires "frameProfiler" in the library config.
+RGAPI RgResult RGCONV rgGetFrameStatistics( RgInstance instance, RgFrameStatistics* pResult );
+// Write the statistics of the last 64 frames to a file in Chrome trace event format,
+// which can be opened in chrome://tracing or Perfetto.
+RGAPI RgResult RGCONV rgDumpFrameStatistics( RgInstance instance, const char* pFilePath );
+
+
 
 typedef enum RgStructureType
 {
@@ -910,6 +1015,14 @@ typedef struct RgDrawFrameRenderResolutionParams
     const RgExtent2D*           pPixelizedRenderSize;
     // Drop history, e.g. if there's camera changed its position drastically.
     RgBool32                    resetUpscalerHistory;
+    // If not 0, render size is scaled each frame, so that GPU frame time approaches
+    // this value (in milliseconds). The size defined by resolutionMode / customRenderSize
+    // is the maximum one: framebuffers are allocated for it, and scaled frames use only
+    // a part of them, so changing the scale doesn't recreate any resources.
+    // Requires "frameProfiler" in the library config.
+    float                       dynamicResolutionTargetMs;
+    // Lower bound of the render size scale, in (0.0, 1.0]. If 0, 0.5 is used.
+    float                       dynamicResolutionMinScale;
 } RgDrawFrameRenderResolutionParams;
 
 typedef struct RgDrawFrameLightmapParams
@@ -961,6 +1074,34 @@ typedef struct RgDrawFrameInfo
 RGAPI RgResult RGCONV           rgDrawFrame( RgInstance instance, const RgDrawFrameInfo* pInfo );
 
 
+typedef struct RgReadbackFinalImageInfo
+{
+    // Destination for R8G8B8A8 pixels in sRGB, tightly packed, rows from the top.
+    // If null, only the extent is returned.
+    void*                       pDstPixels;
+    // Must be at least (width * height * 4) bytes.
+    uint64_t                    dstSize;
+    // If false and the GPU hasn't finished the frame yet, nothing is copied.
+    RgBool32                    wait;
+} RgReadbackFinalImageInfo;
+
+typedef struct RgReadbackFinalImageResult
+{
+    // True, if pDstPixels was filled.
+    RgBool32                    ready;
+    uint32_t                    width;
+    uint32_t                    height;
+    // ID of the frame that the image belongs to, 0 if no frame was drawn yet.
+    uint32_t                    frameId;
+} RgReadbackFinalImageResult;
+
+// Read the final image of the frame that was drawn by the latest rgDrawFrame.
+// The copy is recorded to the frame's command buffer, so the call doesn't stall
+// the GPU, and with wait=false it can be polled until the frame's fence is signaled.
+// Requires pHeadlessCreateInfo.
+RGAPI RgResult RGCONV           rgReadbackFinalImage( RgInstance instance, const RgReadbackFinalImageInfo* pInfo, RgReadbackFinalImageResult* pResult );
+
+
 
 typedef enum RgUtilImScratchTopology
 {
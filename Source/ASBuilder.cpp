@@ -37,7 +37,8 @@ VkAccelerationStructureBuildSizesInfoKHR ASBuilder::GetBuildSizes(
     uint32_t                                  geometryCount,
     const VkAccelerationStructureGeometryKHR* pGeometries,
     const uint32_t*                           pMaxPrimitiveCount,
-    bool                                      fastTrace ) const
+    bool                                      fastTrace,
+    bool                                      allowUpdate ) const
 {
     assert( geometryCount > 0 );
 
@@ -45,6 +46,12 @@ VkAccelerationStructureBuildSizesInfoKHR ASBuilder::GetBuildSizes(
         fastTrace ? VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR
                   : VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_BUILD_BIT_KHR;
 
+    // required to get a valid updateScratchSize
+    if( allowUpdate )
+    {
+        flags |= VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
+    }
+
     // mode, srcAccelerationStructure, dstAccelerationStructure
     // and all VkDeviceOrHostAddressKHR except transformData are ignored
     // in vkGetAccelerationStructureBuildSizesKHR(..)
@@ -74,13 +81,15 @@ VkAccelerationStructureBuildSizesInfoKHR ASBuilder::GetBottomBuildSizes(
     uint32_t                                  geometryCount,
     const VkAccelerationStructureGeometryKHR* pGeometries,
     const uint32_t*                           pMaxPrimitiveCount,
-    bool                                      fastTrace ) const
+    bool                                      fastTrace,
+    bool                                      allowUpdate ) const
 {
     return GetBuildSizes( VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR,
                           geometryCount,
                           pGeometries,
                           pMaxPrimitiveCount,
-                          fastTrace );
+                          fastTrace,
+                          allowUpdate );
 }
 
 VkAccelerationStructureBuildSizesInfoKHR ASBuilder::GetTopBuildSizes(
@@ -88,8 +97,12 @@ VkAccelerationStructureBuildSizesInfoKHR ASBuilder::GetTopBuildSizes(
     uint32_t                                  maxPrimitiveCount,
     bool                                      fastTrace ) const
 {
-    return GetBuildSizes(
-        VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR, 1, pGeometry, &maxPrimitiveCount, fastTrace );
+    return GetBuildSizes( VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR,
+                          1,
+                          pGeometry,
+                          &maxPrimitiveCount,
+                          fastTrace,
+                          false );
 }
 
 void ASBuilder::AddBLAS( VkAccelerationStructureKHR                      as,
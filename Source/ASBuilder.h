@@ -73,14 +73,16 @@ public:
         uint32_t                                  geometryCount,
         const VkAccelerationStructureGeometryKHR* pGeometries,
         const uint32_t*                           pMaxPrimitiveCount,
-        bool                                      fastTrace ) const;
+        bool                                      fastTrace,
+        bool                                      allowUpdate ) const;
 
     // GetBuildSizes(..) for BLAS
     VkAccelerationStructureBuildSizesInfoKHR GetBottomBuildSizes(
         uint32_t                                  geometryCount,
         const VkAccelerationStructureGeometryKHR* pGeometries,
         const uint32_t*                           pMaxPrimitiveCount,
-        bool                                      fastTrace ) const;
+        bool                                      fastTrace,
+        bool                                      allowUpdate ) const;
     // GetBuildSizes(..) for TLAS
     VkAccelerationStructureBuildSizesInfoKHR GetTopBuildSizes(
         const VkAccelerationStructureGeometryKHR* pGeometry,
@@ -27,12 +27,26 @@
 
 #include "Generated/ShaderCommonC.h"
 
+#include <algorithm>
 #include <array>
 #include <cstring>
+#include <string_view>
 
 namespace
 {
 constexpr uint32_t AdditionalTexCoordMaxCount = MAX_STATIC_VERTEX_COUNT;
+
+// Max instanced BLAS-es to build at once, to limit scratch memory usage
+constexpr uint32_t InstancedBlasBuildBatchSize = 256;
+
+// Max static sectors to build in one frame, to spread the building cost over frames
+constexpr uint32_t StaticSectorBuildsPerFrame = 4;
+
+template< class T >
+void HashCombine( uint64_t& seed, const T& v )
+{
+    seed ^= std::hash< T >{}( v ) + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+}
 }
 
 RTGL1::ASManager::ASManager( VkDevice                                _device,
@@ -42,12 +56,18 @@ RTGL1::ASManager::ASManager( VkDevice                                _device,
                              std::shared_ptr< GeomInfoManager >      _geomInfoManager,
                              bool                                    _enableTexCoordLayer1,
                              bool                                    _enableTexCoordLayer2,
-                             bool                                    _enableTexCoordLayer3 )
+                             bool                                    _enableTexCoordLayer3,
+                             bool                                    _enableStaticInstancing,
+                             uint32_t                                _dynamicBlasMaxRefitCount,
+                             float                                   _staticSectorShare,
+                             bool                                    _compactStaticVertices )
     : device( _device )
     , allocator( std::move( _allocator ) )
     , staticCopyFence( VK_NULL_HANDLE )
     , cmdManager( std::move( _cmdManager ) )
     , geomInfoMgr( std::move( _geomInfoManager ) )
+    , dynamicBlasMaxRefitCount( _dynamicBlasMaxRefitCount )
+    , enableStaticInstancing( _enableStaticInstancing )
     , descPool( VK_NULL_HANDLE )
     , buffersDescSetLayout( VK_NULL_HANDLE )
     , buffersDescSets{}
@@ -62,9 +82,11 @@ RTGL1::ASManager::ASManager( VkDevice                                _device,
     VertexCollectorFilterTypeFlags_IterateOverFlags( [ this ]( FL filter ) {
         if( filter & FT::CF_DYNAMIC )
         {
-            for( auto& b : allDynamicBlas )
+            for( uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++ )
             {
-                b.emplace_back( std::make_unique< BLASComponent >( device, filter ) );
+                allDynamicBlas[ i ].emplace_back(
+                    std::make_unique< BLASComponent >( device, filter ) );
+                dynamicBlasRefit[ i ].emplace_back();
             }
         }
         else
@@ -97,7 +119,36 @@ RTGL1::ASManager::ASManager( VkDevice                                _device,
         *allocator,
         maxVertsPerLayer,
         FT::CF_STATIC_NON_MOVABLE | FT::CF_STATIC_MOVABLE | FT::MASK_PASS_THROUGH_GROUP |
-            FT::MASK_PRIMARY_VISIBILITY_GROUP );
+            FT::MASK_PRIMARY_VISIBILITY_GROUP,
+        _compactStaticVertices );
+
+    // tail of the static buffers is kept for the static sectors
+    collectorStatic->ReservePersistentRegion( _staticSectorShare );
+
+    if( _staticSectorShare > 0.0f )
+    {
+        VertexCollectorFilterTypeFlags_IterateOverFlags( [ this, _staticSectorShare ]( FL filter ) {
+            // sectors contain only static world geometry
+            if( !( filter & FT::CF_STATIC_NON_MOVABLE ) || ( filter & FT::PV_FIRST_PERSON ) ||
+                ( filter & FT::PV_FIRST_PERSON_VIEWER ) )
+            {
+                return;
+            }
+
+            const uint32_t amount = VertexCollectorFilterTypeFlags_GetAmountInGlobalArray( filter );
+            const double   share  = std::min( double( _staticSectorShare ), 1.0 );
+
+            // geom infos of the non-instanced static geometry must stay untouched
+            const uint32_t begin = std::max( uint32_t( MAX_BOTTOM_LEVEL_GEOMETRIES_COUNT ),
+                                             uint32_t( double( amount ) * ( 1.0 - share ) ) );
+
+            if( begin < amount )
+            {
+                sectorGeomInfoBegin[ filter ]  = begin;
+                sectorGeomInfoRanges[ filter ] = RangeAllocator( begin, amount );
+            }
+        } );
+    }
 
 
     // dynamic vertices
@@ -139,7 +190,10 @@ RTGL1::ASManager::ASManager( VkDevice                                _device,
             VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR,
         "TLAS instance buffer" );
 
-    static_assert( std::size( TLASPrepareResult{}.instances ) == MAX_TOP_LEVEL_INSTANCE_COUNT );
+    tlasInstanceInfos = std::make_unique< AutoBuffer >( allocator );
+    tlasInstanceInfos->Create( MAX_TOP_LEVEL_INSTANCE_COUNT * sizeof( ShTlasInstance ),
+                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                               "TLAS instance infos" );
 
 
     CreateDescriptors();
@@ -282,6 +336,12 @@ void RTGL1::ASManager::CreateDescriptors()
                 .descriptorCount = 1,
                 .stageFlags      = VK_SHADER_STAGE_ALL,
             },
+            {
+                .binding         = BINDING_TLAS_INSTANCES,
+                .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .descriptorCount = 1,
+                .stageFlags      = VK_SHADER_STAGE_ALL,
+            },
         };
         static_assert( CheckBindings( bindings ) );
 
@@ -433,6 +493,11 @@ void RTGL1::ASManager::UpdateBufferDescriptors( uint32_t frameIndex )
             .offset = 0,
             .range  = VK_WHOLE_SIZE,
         },
+        {
+            .buffer = tlasInstanceInfos->GetDeviceLocal(),
+            .offset = 0,
+            .range  = VK_WHOLE_SIZE,
+        },
     };
 
     VkWriteDescriptorSet writes[] = {
@@ -562,6 +627,15 @@ void RTGL1::ASManager::UpdateBufferDescriptors( uint32_t frameIndex )
             .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
             .pBufferInfo     = &infos[ BINDING_DYNAMIC_TEXCOORD_LAYER_3 ],
         },
+        {
+            .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet          = buffersDescSets[ frameIndex ],
+            .dstBinding      = BINDING_TLAS_INSTANCES,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo     = &infos[ BINDING_TLAS_INSTANCES ],
+        },
     };
     assert( CheckBindings( writes ) );
 
@@ -601,8 +675,20 @@ RTGL1::ASManager::~ASManager()
         as->Destroy();
     }
 
+    DestroyInstancedBLAS();
+
+    for( auto& [ name, sector ] : staticSectors )
+    {
+        DestroyStaticSector( *sector );
+    }
+
     for( uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++ )
     {
+        for( auto& sector : sectorsToDestroy[ i ] )
+        {
+            DestroyStaticSector( *sector );
+        }
+
         for( auto& as : allDynamicBlas[ i ] )
         {
             as->Destroy();
@@ -632,12 +718,13 @@ bool RTGL1::ASManager::SetupBLAS( BLASComponent& blas, const VertexCollector& ve
     const auto& ranges     = vertCollector.GetASBuildRangeInfos( filter );
     const auto& primCounts = vertCollector.GetPrimitiveCounts( filter );
 
-    const bool fastTrace = !IsFastBuild( filter );
-    const bool update    = false;
+    const bool fastTrace   = !IsFastBuild( filter );
+    const bool update      = false;
+    const bool allowUpdate = IsUpdateable( filter );
 
     // get AS size and create buffer for AS
-    const auto buildSizes =
-        asBuilder->GetBottomBuildSizes( geoms.size(), geoms.data(), primCounts.data(), fastTrace );
+    const auto buildSizes = asBuilder->GetBottomBuildSizes(
+        geoms.size(), geoms.data(), primCounts.data(), fastTrace, allowUpdate );
 
     // if no buffer, or it was created, but its size is too small for current AS
     blas.RecreateIfNotValid( buildSizes, allocator );
@@ -652,7 +739,7 @@ bool RTGL1::ASManager::SetupBLAS( BLASComponent& blas, const VertexCollector& ve
                         buildSizes,
                         fastTrace,
                         update,
-                        blas.GetFilter() & VertexCollectorFilterTypeFlagBits::CF_STATIC_MOVABLE );
+                        allowUpdate );
 
     return true;
 }
@@ -676,8 +763,10 @@ void RTGL1::ASManager::UpdateBLAS( BLASComponent& blas, const VertexCollector& v
     // must be just updated
     const bool update = true;
 
-    const auto buildSizes =
-        asBuilder->GetBottomBuildSizes( geoms.size(), geoms.data(), primCounts.data(), fastTrace );
+    assert( IsUpdateable( filter ) );
+
+    const auto buildSizes = asBuilder->GetBottomBuildSizes(
+        geoms.size(), geoms.data(), primCounts.data(), fastTrace, true );
 
     assert( blas.IsValid( buildSizes ) );
     assert( blas.GetAS() != VK_NULL_HANDLE );
@@ -690,7 +779,7 @@ void RTGL1::ASManager::UpdateBLAS( BLASComponent& blas, const VertexCollector& v
                         buildSizes,
                         fastTrace,
                         update,
-                        blas.GetFilter() & VertexCollectorFilterTypeFlagBits::CF_STATIC_MOVABLE );
+                        true );
 }
 
 RTGL1::StaticGeometryToken RTGL1::ASManager::BeginStaticGeometry()
@@ -699,6 +788,15 @@ RTGL1::StaticGeometryToken RTGL1::ASManager::BeginStaticGeometry()
     collectorStatic->Reset();
     geomInfoMgr->ResetOnlyStatic();
 
+    instancedPrimitives.clear();
+    instancedMeshes.clear();
+
+    // sectors are not affected, but their geom infos were reset too
+    for( const auto& [ name, sector ] : staticSectors )
+    {
+        WriteStaticSectorGeomInfos( *sector );
+    }
+
     return StaticGeometryToken( InitAsExisting );
 }
 
@@ -727,14 +825,19 @@ void RTGL1::ASManager::SubmitStaticGeometry( StaticGeometryToken& token )
         }
     }
 
+    DestroyInstancedBLAS();
+
     assert( asBuilder->IsEmpty() );
 
     // skip if all static geometries are empty
-    if( collectorStatic->AreGeometriesEmpty( staticFlags ) )
+    if( collectorStatic->AreGeometriesEmpty( staticFlags ) && instancedMeshes.empty() )
     {
         return;
     }
 
+    // device is idle, so the whole scratch buffer can be used
+    scratchBuffer->Reset();
+
     VkCommandBuffer cmd = cmdManager->StartGraphicsCmd();
 
     // copy from staging with barrier
@@ -750,8 +853,14 @@ void RTGL1::ASManager::SubmitStaticGeometry( StaticGeometryToken& token )
         }
     }
 
+    // setup BLAS-es that are shared between mesh instances
+    SetupInstancedBLAS( cmd, *geomInfoMgr );
+
     // build AS
-    asBuilder->BuildBottomLevel( cmd );
+    if( !asBuilder->IsEmpty() )
+    {
+        asBuilder->BuildBottomLevel( cmd );
+    }
 
     // submit geom info, in case if rgStartNewScene and rgSubmitStaticGeometries
     // were out of rgStartFrame - rgDrawFrame, so static geominfo-s won't be
@@ -775,6 +884,13 @@ RTGL1::DynamicGeometryToken RTGL1::ASManager::BeginDynamicGeometry( VkCommandBuf
     // dynamic AS must be recreated
     collectorDynamic[ frameIndex ]->Reset();
 
+    // frame with this index was finished, so removed sectors are not in use anymore
+    for( auto& sector : sectorsToDestroy[ frameIndex ] )
+    {
+        DestroyStaticSector( *sector );
+    }
+    sectorsToDestroy[ frameIndex ].clear();
+
     return DynamicGeometryToken( InitAsExisting );
 }
 
@@ -784,17 +900,540 @@ bool RTGL1::ASManager::AddMeshPrimitive( uint32_t                   frameIndex,
                                          uint64_t                   uniqueID,
                                          bool                       isStatic,
                                          const TextureManager&      textureManager,
-                                         GeomInfoManager&           geomInfoManager )
+                                         GeomInfoManager&           geomInfoManager,
+                                         const MaterialTextures*    pBaseTextures )
 {
-    auto textures = textureManager.GetTexturesForLayers( primitive );
+    auto textures = pBaseTextures
+                        ? textureManager.GetTexturesForLayers( primitive, *pBaseTextures )
+                        : textureManager.GetTexturesForLayers( primitive );
     auto colors   = textureManager.GetColorForLayers( primitive );
 
+    if( isStatic && enableStaticInstancing && !Utils::IsCstrEmpty( mesh.pMeshName ) )
+    {
+        return AddInstancedMeshPrimitive( mesh, primitive, uniqueID, textures, colors );
+    }
+
     auto& collector = isStatic ? collectorStatic : collectorDynamic[ frameIndex ];
 
     return collector->AddPrimitive(
         frameIndex, isStatic, mesh, primitive, uniqueID, textures, colors, geomInfoManager );
 }
 
+bool RTGL1::ASManager::AddInstancedMeshPrimitive( const RgMeshInfo&                 mesh,
+                                                  const RgMeshPrimitiveInfo&        primitive,
+                                                  uint64_t                          uniqueID,
+                                                  std::span< MaterialTextures, 4 >  layerTextures,
+                                                  std::span< RgColor4DPacked32, 4 > layerColors )
+{
+    const auto filter = VertexCollectorFilterTypeFlags_GetForGeometry( mesh, primitive, true );
+
+    // primitives are identified by the mesh name, so the same name
+    // with the same primitive index must refer to the same vertex data
+    uint64_t primitiveKey = 0;
+    HashCombine( primitiveKey, std::string_view( mesh.pMeshName ) );
+    HashCombine( primitiveKey, primitive.primitiveIndexInMesh );
+    HashCombine( primitiveKey, primitive.vertexCount );
+    HashCombine( primitiveKey, primitive.indexCount );
+    HashCombine( primitiveKey, filter );
+    for( uint32_t layer = 1; layer <= 3; layer++ )
+    {
+        HashCombine( primitiveKey, GeomInfoManager::LayerExists( primitive, layer ) );
+    }
+
+    auto prim = instancedPrimitives.find( primitiveKey );
+
+    if( prim == instancedPrimitives.end() )
+    {
+        auto uploaded = collectorStatic->UploadPrimitive( true, primitive );
+        if( !uploaded )
+        {
+            return false;
+        }
+
+        prim = instancedPrimitives
+                   .emplace( primitiveKey,
+                             InstancedPrimitive{
+                                 .data = *uploaded,
+                                 .geom = collectorStatic->MakeASGeometry(
+                                     *uploaded, filter, std::nullopt ),
+                             } )
+                   .first;
+    }
+
+    uint64_t meshNameHash = 0;
+    HashCombine( meshNameHash, std::string_view( mesh.pMeshName ) );
+
+    uint64_t meshKey = meshNameHash;
+    HashCombine( meshKey, mesh.uniqueObjectID );
+    for( const auto& row : mesh.transform.matrix )
+    {
+        for( float v : row )
+        {
+            HashCombine( meshKey, v );
+        }
+    }
+
+    auto& dst = instancedMeshes[ meshKey ];
+    if( dst.parts.empty() )
+    {
+        dst.meshNameHash = meshNameHash;
+        dst.transform    = mesh.transform;
+    }
+
+    dst.parts.push_back( InstancedMeshPart{
+        .primitiveKey = primitiveKey,
+        .uniqueID     = uniqueID,
+        .filter       = filter,
+        .geomInfo     = VertexCollector::MakeGeomInfo(
+            mesh.transform, primitive, prim->second.data, layerTextures, layerColors ),
+    } );
+
+    return true;
+}
+
+void RTGL1::ASManager::SetupInstancedBLAS( VkCommandBuffer cmd, GeomInfoManager& geomInfoManager )
+{
+    assert( allInstancedBlas.empty() && staticInstances.empty() );
+
+    // BLAS key to the index in allInstancedBlas
+    rgl::unordered_map< uint64_t, uint32_t > blasIndices;
+
+    // next free local geom index in each filter group,
+    // as the non-instanced static geometry is already there
+    rgl::unordered_map< VertexCollectorFilterTypeFlags, uint32_t > nextLocalGeomIndex;
+
+    std::vector< const InstancedMeshPart* > partsOfFilter;
+
+    for( const auto& [ meshKey, mesh ] : instancedMeshes )
+    {
+        // one TLAS instance can have only one filter, so split a mesh by filters
+        std::vector< VertexCollectorFilterTypeFlags > filters;
+        for( const auto& part : mesh.parts )
+        {
+            if( std::ranges::find( filters, part.filter ) == filters.end() )
+            {
+                filters.push_back( part.filter );
+            }
+        }
+
+        for( const auto filter : filters )
+        {
+            partsOfFilter.clear();
+            for( const auto& part : mesh.parts )
+            {
+                if( part.filter == filter )
+                {
+                    partsOfFilter.push_back( &part );
+                }
+            }
+
+            // canonical order, so the same primitive sets produce the same BLAS
+            std::ranges::sort( partsOfFilter, []( const auto* a, const auto* b ) {
+                return a->primitiveKey < b->primitiveKey;
+            } );
+
+            const auto partCount = static_cast< uint32_t >( partsOfFilter.size() );
+
+            if( partCount > MAX_BOTTOM_LEVEL_GEOMETRIES_COUNT )
+            {
+                debug::Error( "Too many primitives in a static mesh. Limit: {}",
+                              MAX_BOTTOM_LEVEL_GEOMETRIES_COUNT );
+                continue;
+            }
+
+            auto [ nextIter, isNewFilter ] = nextLocalGeomIndex.emplace( filter, 0 );
+            if( isNewFilter )
+            {
+                nextIter->second =
+                    static_cast< uint32_t >( collectorStatic->GetASGeometries( filter ).size() );
+            }
+            uint32_t& localGeomIndex = nextIter->second;
+
+            if( localGeomIndex + partCount > GetStaticGeomInfoLimit( filter ) )
+            {
+                debug::Error( "Too many static mesh instances: geometry info limit of a filter "
+                              "group is {}, each instance takes {}",
+                              GetStaticGeomInfoLimit( filter ),
+                              partCount );
+                continue;
+            }
+
+            uint64_t blasKey = mesh.meshNameHash;
+            HashCombine( blasKey, filter );
+            for( const auto* part : partsOfFilter )
+            {
+                HashCombine( blasKey, part->primitiveKey );
+            }
+
+            auto [ blasIter, isNewBlas ] =
+                blasIndices.emplace( blasKey, static_cast< uint32_t >( allInstancedBlas.size() ) );
+
+            if( isNewBlas )
+            {
+                auto& dst = allInstancedBlas.emplace_back( InstancedBLAS{
+                    .blas = std::make_unique< BLASComponent >( device, filter ),
+                } );
+
+                for( const auto* part : partsOfFilter )
+                {
+                    const auto& prim = instancedPrimitives.at( part->primitiveKey );
+
+                    dst.geoms.push_back( prim.geom );
+                    dst.ranges.push_back( VkAccelerationStructureBuildRangeInfoKHR{
+                        .primitiveCount = prim.data.triangleCount,
+                    } );
+                    dst.primCounts.push_back( prim.data.triangleCount );
+                }
+                dst.blas->SetGeometryCount( partCount );
+            }
+
+            // each instance has its own geometry infos, as materials and transforms differ
+            const uint32_t geomInfoOffset =
+                VertexCollectorFilterTypeFlags_GetOffsetInGlobalArray( filter ) + localGeomIndex;
+
+            for( const auto* part : partsOfFilter )
+            {
+                auto geomInfo = part->geomInfo;
+                geomInfoManager.WriteGeomInfo(
+                    0, part->uniqueID, localGeomIndex, filter, geomInfo );
+
+                localGeomIndex++;
+            }
+
+            staticInstances.push_back( StaticInstance{
+                .instancedBlasIndex = blasIter->second,
+                .transform          = mesh.transform,
+                .geomInfoOffset     = geomInfoOffset,
+            } );
+        }
+    }
+
+    uint32_t toBuildCount = 0;
+
+    for( auto& b : allInstancedBlas )
+    {
+        // static mesh instances are never updated
+        const bool fastTrace = true;
+        const bool update    = false;
+
+        const auto buildSizes = asBuilder->GetBottomBuildSizes(
+            b.geoms.size(), b.geoms.data(), b.primCounts.data(), fastTrace, false );
+
+        b.blas->RecreateIfNotValid( buildSizes, allocator );
+        assert( b.blas->GetAS() != VK_NULL_HANDLE );
+
+        // all passed arrays are owned by allInstancedBlas
+        asBuilder->AddBLAS( b.blas->GetAS(),
+                            b.geoms.size(),
+                            b.geoms.data(),
+                            b.ranges.data(),
+                            buildSizes,
+                            fastTrace,
+                            update,
+                            false );
+        toBuildCount++;
+
+        // there can be thousands of unique meshes, build in batches to reuse scratch memory
+        if( toBuildCount >= InstancedBlasBuildBatchSize )
+        {
+            asBuilder->BuildBottomLevel( cmd );
+            Utils::ASBuildMemoryBarrier( cmd );
+
+            scratchBuffer->Reset();
+            toBuildCount = 0;
+        }
+    }
+}
+
+void RTGL1::ASManager::DestroyInstancedBLAS()
+{
+    for( auto& b : allInstancedBlas )
+    {
+        b.blas->Destroy();
+    }
+
+    allInstancedBlas.clear();
+    staticInstances.clear();
+}
+
+uint32_t RTGL1::ASManager::GetStaticGeomInfoLimit( VertexCollectorFilterTypeFlags filter ) const
+{
+    auto f = sectorGeomInfoBegin.find( filter );
+    return f != sectorGeomInfoBegin.end()
+               ? f->second
+               : VertexCollectorFilterTypeFlags_GetAmountInGlobalArray( filter );
+}
+
+bool RTGL1::ASManager::AreStaticVerticesCompact() const
+{
+    return collectorStatic->AreVerticesCompact();
+}
+
+bool RTGL1::ASManager::AreStaticSectorsEnabled() const
+{
+    return !sectorGeomInfoRanges.empty();
+}
+
+void RTGL1::ASManager::BeginStaticSector( std::string_view sectorName )
+{
+    // if previous one was interrupted by an error
+    if( sectorInProgress )
+    {
+        DestroyStaticSector( *sectorInProgress );
+    }
+
+    sectorInProgressName = sectorName;
+    sectorInProgress      = std::make_unique< StaticSector >();
+}
+
+bool RTGL1::ASManager::AddStaticSectorPrimitive( const RgMeshInfo&          mesh,
+                                                 const RgMeshPrimitiveInfo& primitive,
+                                                 uint64_t                   uniqueID,
+                                                 const TextureManager&      textureManager,
+                                                 const MaterialTextures*    pBaseTextures )
+{
+    assert( sectorInProgress );
+
+    const auto filter = VertexCollectorFilterTypeFlags_GetForGeometry( mesh, primitive, true );
+
+    if( !sectorGeomInfoRanges.contains( filter ) )
+    {
+        debug::Warning( "Static sector \"{}\": first-person geometry is ignored: {}",
+                        sectorInProgressName,
+                        Utils::SafeCstr( mesh.pMeshName ) );
+        return false;
+    }
+
+    auto uploaded = collectorStatic->UploadPersistentPrimitive( primitive );
+    if( !uploaded )
+    {
+        return false;
+    }
+
+    auto textures = pBaseTextures
+                        ? textureManager.GetTexturesForLayers( primitive, *pBaseTextures )
+                        : textureManager.GetTexturesForLayers( primitive );
+    auto colors   = textureManager.GetColorForLayers( primitive );
+
+    sectorInProgress->primitives.push_back( SectorPrimitive{
+        .data      = *uploaded,
+        .filter    = filter,
+        .uniqueID  = uniqueID,
+        .transform = mesh.transform,
+        .geomInfo  = VertexCollector::MakeGeomInfo(
+            mesh.transform, primitive, *uploaded, textures, colors ),
+    } );
+
+    return true;
+}
+
+void RTGL1::ASManager::SubmitStaticSector( uint32_t frameIndex )
+{
+    assert( sectorInProgress );
+
+    auto sector = std::move( sectorInProgress );
+    auto name   = std::move( sectorInProgressName );
+
+    if( !sector->primitives.empty() )
+    {
+        sector->transforms.Init(
+            *allocator,
+            sector->primitives.size() * sizeof( VkTransformMatrixKHR ),
+            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
+                VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            "Static sector transforms" );
+
+        auto* mapped = static_cast< VkTransformMatrixKHR* >( sector->transforms.Map() );
+        for( size_t i = 0; i < sector->primitives.size(); i++ )
+        {
+            static_assert( sizeof( RgTransform ) == sizeof( VkTransformMatrixKHR ) );
+            memcpy( &mapped[ i ], &sector->primitives[ i ].transform, sizeof( RgTransform ) );
+        }
+        sector->transforms.Unmap();
+    }
+
+    // one BLAS per filter, as one TLAS instance can have only one filter
+    rgl::unordered_map< VertexCollectorFilterTypeFlags, std::vector< uint32_t > > byFilter;
+    for( uint32_t i = 0; i < sector->primitives.size(); i++ )
+    {
+        byFilter[ sector->primitives[ i ].filter ].push_back( i );
+    }
+
+    for( auto& [ filter, primitiveIndices ] : byFilter )
+    {
+        const auto count = static_cast< uint32_t >( primitiveIndices.size() );
+
+        if( count > MAX_BOTTOM_LEVEL_GEOMETRIES_COUNT )
+        {
+            debug::Error( "Static sector \"{}\": too many primitives of one type. Limit: {}",
+                          name,
+                          MAX_BOTTOM_LEVEL_GEOMETRIES_COUNT );
+            continue;
+        }
+
+        auto localGeomIndex = sectorGeomInfoRanges.at( filter ).Allocate( count );
+        if( !localGeomIndex )
+        {
+            debug::Error( "Static sector \"{}\": not enough space for geometry infos. "
+                          "Recheck \"staticSectorShare\" in the library config",
+                          name );
+            continue;
+        }
+
+        auto& dst = sector->blases.emplace_back( SectorBLAS{
+            .blas           = std::make_unique< BLASComponent >( device, filter ),
+            .localGeomIndex = *localGeomIndex,
+        } );
+
+        for( uint32_t i : primitiveIndices )
+        {
+            const auto& prim = sector->primitives[ i ];
+
+            auto geom = collectorStatic->MakeASGeometry( prim.data, filter, std::nullopt );
+            geom.geometry.triangles.transformData = {
+                .deviceAddress =
+                    sector->transforms.GetAddress() + i * sizeof( VkTransformMatrixKHR ),
+            };
+
+            dst.geoms.push_back( geom );
+            dst.ranges.push_back( VkAccelerationStructureBuildRangeInfoKHR{
+                .primitiveCount = prim.data.triangleCount,
+            } );
+            dst.primCounts.push_back( prim.data.triangleCount );
+        }
+        dst.primitiveIndices = std::move( primitiveIndices );
+        dst.blas->SetGeometryCount( count );
+    }
+
+    WriteStaticSectorGeomInfos( *sector );
+
+    auto& slot = staticSectors[ name ];
+    if( slot )
+    {
+        // previous one might still be in use by the frames in flight
+        sectorsToDestroy[ frameIndex ].push_back( std::move( slot ) );
+    }
+    slot = std::move( sector );
+}
+
+bool RTGL1::ASManager::RemoveStaticSector( uint32_t frameIndex, std::string_view sectorName )
+{
+    auto found = staticSectors.find( std::string( sectorName ) );
+    if( found == staticSectors.end() )
+    {
+        return false;
+    }
+
+    sectorsToDestroy[ frameIndex ].push_back( std::move( found->second ) );
+    staticSectors.erase( found );
+
+    return true;
+}
+
+void RTGL1::ASManager::BuildStaticSectors( VkCommandBuffer cmd )
+{
+    std::vector< StaticSector* >                       toBuild;
+    std::vector< VertexCollector::UploadedPrimitive > toCopy;
+
+    for( auto& [ name, sector ] : staticSectors )
+    {
+        if( toBuild.size() >= StaticSectorBuildsPerFrame )
+        {
+            break;
+        }
+
+        if( !sector->isBuilt )
+        {
+            toBuild.push_back( sector.get() );
+
+            for( const auto& prim : sector->primitives )
+            {
+                toCopy.push_back( prim.data );
+            }
+        }
+    }
+
+    if( toBuild.empty() )
+    {
+        return;
+    }
+
+    CmdLabel label( cmd, "Building static sectors" );
+
+    collectorStatic->CopyPersistentFromStaging( cmd, toCopy );
+
+    assert( asBuilder->IsEmpty() );
+
+    for( StaticSector* sector : toBuild )
+    {
+        for( auto& b : sector->blases )
+        {
+            // sectors are never updated
+            const bool fastTrace = true;
+            const bool update    = false;
+
+            const auto buildSizes = asBuilder->GetBottomBuildSizes(
+                b.geoms.size(), b.geoms.data(), b.primCounts.data(), fastTrace, false );
+
+            b.blas->RecreateIfNotValid( buildSizes, allocator );
+            assert( b.blas->GetAS() != VK_NULL_HANDLE );
+
+            // all passed arrays are owned by the sector
+            asBuilder->AddBLAS( b.blas->GetAS(),
+                                b.geoms.size(),
+                                b.geoms.data(),
+                                b.ranges.data(),
+                                buildSizes,
+                                fastTrace,
+                                update,
+                                false );
+        }
+
+        sector->isBuilt = true;
+    }
+
+    if( !asBuilder->IsEmpty() )
+    {
+        asBuilder->BuildBottomLevel( cmd );
+        Utils::ASBuildMemoryBarrier( cmd );
+    }
+}
+
+void RTGL1::ASManager::WriteStaticSectorGeomInfos( const StaticSector& sector )
+{
+    for( const auto& b : sector.blases )
+    {
+        for( uint32_t g = 0; g < b.primitiveIndices.size(); g++ )
+        {
+            const auto& prim = sector.primitives[ b.primitiveIndices[ g ] ];
+
+            auto geomInfo = prim.geomInfo;
+            geomInfoMgr->WriteGeomInfo(
+                0, prim.uniqueID, b.localGeomIndex + g, prim.filter, geomInfo );
+        }
+    }
+}
+
+void RTGL1::ASManager::DestroyStaticSector( StaticSector& sector )
+{
+    for( auto& b : sector.blases )
+    {
+        sectorGeomInfoRanges.at( b.blas->GetFilter() )
+            .Free( b.localGeomIndex, static_cast< uint32_t >( b.geoms.size() ) );
+        b.blas->Destroy();
+    }
+
+    for( const auto& prim : sector.primitives )
+    {
+        collectorStatic->FreePersistentPrimitive( prim.data );
+    }
+
+    sector.blases.clear();
+    sector.primitives.clear();
+    sector.transforms.Destroy();
+}
+
 void RTGL1::ASManager::SubmitDynamicGeometry( DynamicGeometryToken& token,
                                               VkCommandBuffer       cmd,
                                               uint32_t              frameIndex )
@@ -807,19 +1446,51 @@ void RTGL1::ASManager::SubmitDynamicGeometry( DynamicGeometryToken& token,
 
     auto& colDyn = *collectorDynamic[ frameIndex ];
 
+    // geometry infos are copied to device-local after this function
+    colDyn.FlushPendingGeometries( frameIndex, *geomInfoMgr );
     colDyn.CopyFromStaging( cmd );
 
     assert( asBuilder->IsEmpty() );
 
     bool toBuild = false;
 
-    // recreate dynamic blas
-    for( auto& dynamicBlas : allDynamicBlas[ frameIndex ] )
+    for( size_t i = 0; i < allDynamicBlas[ frameIndex ].size(); i++ )
     {
+        auto& dynamicBlas = *allDynamicBlas[ frameIndex ][ i ];
+        auto& refit       = dynamicBlasRefit[ frameIndex ][ i ];
+
         // must be dynamic
-        assert( dynamicBlas->GetFilter() & FT::CF_DYNAMIC );
+        assert( dynamicBlas.GetFilter() & FT::CF_DYNAMIC );
+
+        const uint64_t topologyHash = colDyn.GetTopologyHash( dynamicBlas.GetFilter() );
+
+        // if the same geometries with the same vertex / index counts
+        // were in the last build of this BLAS, then only vertex positions
+        // and transforms have changed, so the BLAS can be refit;
+        // but BVH quality degrades with each refit, so rebuild periodically
+        const bool canRefit = refit.allowsUpdate && refit.topologyHash == topologyHash &&
+                              refit.refitCount < dynamicBlasMaxRefitCount;
+
+        if( canRefit )
+        {
+            UpdateBLAS( dynamicBlas, colDyn );
+            refit.refitCount++;
+
+            toBuild = true;
+        }
+        else
+        {
+            // recreate dynamic blas
+            bool isAdded = SetupBLAS( dynamicBlas, colDyn );
 
-        toBuild |= SetupBLAS( *dynamicBlas, colDyn );
+            refit = DynamicBLASRefit{
+                .allowsUpdate = isAdded && IsUpdateable( dynamicBlas.GetFilter() ),
+                .topologyHash = topologyHash,
+                .refitCount   = 0,
+            };
+
+            toBuild |= isAdded;
+        }
     }
 
     if( !toBuild )
@@ -962,37 +1633,34 @@ bool RTGL1::ASManager::SetupTLASInstanceFromBLAS( const BLASComponent& blas,
     return true;
 }
 
-static void WriteInstanceGeomInfo( int32_t*                    instanceGeomInfoOffset,
-                                   int32_t*                    instanceGeomCount,
-                                   uint32_t                    index,
-                                   const RTGL1::BLASComponent& blas )
+static RTGL1::ShTlasInstance MakeTlasInstanceInfo( uint32_t                    geomInfoOffset,
+                                                  const RTGL1::BLASComponent& blas )
 {
-    assert( index < MAX_TOP_LEVEL_INSTANCE_COUNT );
-
-    uint32_t arrayOffset =
-        RTGL1::VertexCollectorFilterTypeFlags_GetOffsetInGlobalArray( blas.GetFilter() );
     uint32_t geomCount = blas.GetGeomCount();
 
     // BLAS must not be empty, if it's added to TLAS
-    assert( geomCount < MAX_BOTTOM_LEVEL_GEOMETRIES_COUNT );
-
-    instanceGeomInfoOffset[ index ] = static_cast< int32_t >( arrayOffset );
-    instanceGeomCount[ index ]      = static_cast< int32_t >( geomCount );
+    assert( geomCount <= MAX_BOTTOM_LEVEL_GEOMETRIES_COUNT );
+
+    return RTGL1::ShTlasInstance{
+        .geomInfoOffset     = static_cast< int32_t >( geomInfoOffset ),
+        .geomInfoOffsetPrev = -1,
+        .geomCount          = static_cast< int32_t >( geomCount ),
+        .isDynamic = ( blas.GetFilter() & RTGL1::VertexCollectorFilterTypeFlagBits::CF_DYNAMIC )
+                         ? 1u
+                         : 0u,
+    };
 }
 
 std::pair< RTGL1::ASManager::TLASPrepareResult, RTGL1::ShVertPreprocessing > RTGL1::ASManager::
-    PrepareForBuildingTLAS( uint32_t         frameIndex,
-                            ShGlobalUniform& uniformData,
-                            uint32_t         uniformData_rayCullMaskWorld,
-                            bool             allowGeometryWithSkyFlag,
-                            bool             disableRTGeometry,
-                            bool             disableStaticGeometry ) const
+    PrepareForBuildingTLAS( VkCommandBuffer cmd,
+                            uint32_t        frameIndex,
+                            uint32_t        uniformData_rayCullMaskWorld,
+                            bool            allowGeometryWithSkyFlag,
+                            bool            disableRTGeometry,
+                            bool            disableStaticGeometry )
 {
     typedef VertexCollectorFilterTypeFlagBits FT;
 
-    static_assert( std::size( TLASPrepareResult{}.instances ) == MAX_TOP_LEVEL_INSTANCE_COUNT,
-                   "Change TLASPrepareResult sizes" );
-
 
     TLASPrepareResult   r    = {};
     ShVertPreprocessing push = {};
@@ -1000,63 +1668,135 @@ std::pair< RTGL1::ASManager::TLASPrepareResult, RTGL1::ShVertPreprocessing > RTG
 
     if( disableRTGeometry )
     {
+        prevInstanceGeomInfoOffset.clear();
         return std::make_pair( r, push );
     }
 
 
-    // write geometry offsets to uniform to access geomInfos
-    // with instance ID and local (in terms of BLAS) geometry index in shaders;
-    // Note: std140 requires elements to be aligned by sizeof(vec4)
-    int32_t* instanceGeomInfoOffset = uniformData.instanceGeomInfoOffset;
+    // geometry offsets and counts of each TLAS instance to access geomInfos
+    // with instance ID and local (in terms of BLAS) geometry index in shaders
+    auto* instanceInfos = tlasInstanceInfos->GetMappedAs< ShTlasInstance* >( frameIndex );
 
-    // write geometry counts of each BLAS for iterating in vertex preprocessing
-    int32_t* instanceGeomCount = uniformData.instanceGeomCount;
+    auto tryAddInstance = [ & ]( const BLASComponent& blas,
+                                 uint32_t             geomInfoOffset,
+                                 const RgTransform*   transform ) {
+        if( r.instances.size() >= MAX_TOP_LEVEL_INSTANCE_COUNT )
+        {
+            return false;
+        }
 
-    const std::vector< std::unique_ptr< BLASComponent > >* blasArrays[] = {
-        &allStaticBlas,
-        &allDynamicBlas[ frameIndex ],
+        VkAccelerationStructureInstanceKHR instance = {};
+
+        if( !SetupTLASInstanceFromBLAS(
+                blas, uniformData_rayCullMaskWorld, allowGeometryWithSkyFlag, instance ) )
+        {
+            return true;
+        }
+
+        if( transform )
+        {
+            static_assert( sizeof( instance.transform ) == sizeof( *transform ) );
+            memcpy( &instance.transform, transform, sizeof( *transform ) );
+        }
+
+        instanceInfos[ r.instances.size() ] = MakeTlasInstanceInfo( geomInfoOffset, blas );
+        r.instances.push_back( instance );
+
+        return true;
     };
 
-    for( const auto* blasArr : blasArrays )
+    bool overflow = false;
+
+    if( !disableStaticGeometry )
     {
-        for( const auto& blas : *blasArr )
+        for( const auto& blas : allStaticBlas )
         {
-            bool isDynamic = blas->GetFilter() & FT::CF_DYNAMIC;
+            overflow |= !tryAddInstance(
+                *blas, VertexCollectorFilterTypeFlags_GetOffsetInGlobalArray( blas->GetFilter() ),
+                nullptr );
+        }
 
-            if( disableStaticGeometry )
+        for( const auto& inst : staticInstances )
+        {
+            overflow |= !tryAddInstance( *allInstancedBlas[ inst.instancedBlasIndex ].blas,
+                                         inst.geomInfoOffset,
+                                         &inst.transform );
+        }
+
+        for( const auto& [ name, sector ] : staticSectors )
+        {
+            if( !sector->isBuilt )
             {
-                if( !isDynamic )
-                {
-                    continue;
-                }
+                continue;
             }
 
-            // add to TLAS instances array
-            bool isAdded = SetupTLASInstanceFromBLAS( *blas,
-                                                      uniformData_rayCullMaskWorld,
-                                                      allowGeometryWithSkyFlag,
-                                                      r.instances[ r.instanceCount ] );
-
-            if( isAdded )
+            for( const auto& b : sector->blases )
             {
-                // mark bit if dynamic
-                if( isDynamic )
-                {
-                    push.tlasInstanceIsDynamicBits[ r.instanceCount /
-                                                    MAX_TOP_LEVEL_INSTANCE_COUNT ] |=
-                        1 << ( r.instanceCount % MAX_TOP_LEVEL_INSTANCE_COUNT );
-                }
-
-                WriteInstanceGeomInfo(
-                    instanceGeomInfoOffset, instanceGeomCount, r.instanceCount, *blas );
-                r.instanceCount++;
+                overflow |= !tryAddInstance(
+                    *b.blas,
+                    VertexCollectorFilterTypeFlags_GetOffsetInGlobalArray( b.blas->GetFilter() ) +
+                        b.localGeomIndex,
+                    nullptr );
             }
         }
     }
 
-    push.tlasInstanceCount = r.instanceCount;
+    for( const auto& blas : allDynamicBlas[ frameIndex ] )
+    {
+        assert( blas->GetFilter() & FT::CF_DYNAMIC );
+
+        overflow |= !tryAddInstance(
+            *blas, VertexCollectorFilterTypeFlags_GetOffsetInGlobalArray( blas->GetFilter() ),
+            nullptr );
+    }
+
+    if( overflow )
+    {
+        debug::Error( "Too many TLAS instances. Limit: {}", MAX_TOP_LEVEL_INSTANCE_COUNT );
+    }
+
+
+    const auto instanceCount = static_cast< uint32_t >( r.instances.size() );
+
+    // instance IDs might be different in the previous frame; shaders access
+    // 'geomInfoOffsetPrev' with a previous instance ID, so if the instance count
+    // has shrunk, the entries past the current count must be valid too
+    const auto infoCount = std::max(
+        instanceCount, static_cast< uint32_t >( prevInstanceGeomInfoOffset.size() ) );
+    assert( infoCount <= MAX_TOP_LEVEL_INSTANCE_COUNT );
+
+    for( uint32_t i = instanceCount; i < infoCount; i++ )
+    {
+        instanceInfos[ i ] = ShTlasInstance{
+            .geomInfoOffset     = -1,
+            .geomInfoOffsetPrev = -1,
+            .geomCount          = 0,
+            .isDynamic          = 0,
+        };
+    }
 
-    return std::make_pair( r, push );
+    for( uint32_t i = 0; i < infoCount; i++ )
+    {
+        instanceInfos[ i ].geomInfoOffsetPrev = i < prevInstanceGeomInfoOffset.size()
+                                                    ? prevInstanceGeomInfoOffset[ i ]
+                                                    : -1;
+    }
+
+    prevInstanceGeomInfoOffset.resize( instanceCount );
+    for( uint32_t i = 0; i < instanceCount; i++ )
+    {
+        prevInstanceGeomInfoOffset[ i ] = instanceInfos[ i ].geomInfoOffset;
+    }
+
+    if( infoCount > 0 )
+    {
+        tlasInstanceInfos->CopyFromStaging(
+            cmd, frameIndex, infoCount * sizeof( ShTlasInstance ) );
+    }
+
+    push.tlasInstanceCount = instanceCount;
+
+    return std::make_pair( std::move( r ), push );
 }
 
 void RTGL1::ASManager::BuildTLAS( VkCommandBuffer          cmd,
@@ -1065,17 +1805,21 @@ void RTGL1::ASManager::BuildTLAS( VkCommandBuffer          cmd,
 {
     CmdLabel label( cmd, "Building TLAS" );
 
+    const auto instanceCount = static_cast< uint32_t >( r.instances.size() );
 
-    if( r.instanceCount > 0 )
+
+    if( instanceCount > 0 )
     {
         // fill buffer
-        auto* mapped = static_cast< VkAccelerationStructureInstanceKHR* >(
-            instanceBuffer->GetMapped( frameIndex ) );
+        auto* mapped =
+            instanceBuffer->GetMappedAs< VkAccelerationStructureInstanceKHR* >( frameIndex );
 
-        memcpy(
-            mapped, r.instances, r.instanceCount * sizeof( VkAccelerationStructureInstanceKHR ) );
+        memcpy( mapped,
+                r.instances.data(),
+                instanceCount * sizeof( VkAccelerationStructureInstanceKHR ) );
 
-        instanceBuffer->CopyFromStaging( cmd, frameIndex );
+        instanceBuffer->CopyFromStaging(
+            cmd, frameIndex, instanceCount * sizeof( VkAccelerationStructureInstanceKHR ) );
     }
 
 
@@ -1090,7 +1834,7 @@ void RTGL1::ASManager::BuildTLAS( VkCommandBuffer          cmd,
                 .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR,
                 .arrayOfPointers = VK_FALSE,
                 .data = {
-                    .deviceAddress = r.instanceCount > 0 ? instanceBuffer->GetDeviceAddress() : 0,
+                    .deviceAddress = instanceCount > 0 ? instanceBuffer->GetDeviceAddress() : 0,
                 },
             },
         },
@@ -1099,13 +1843,13 @@ void RTGL1::ASManager::BuildTLAS( VkCommandBuffer          cmd,
 
     // get AS size and create buffer for AS
     VkAccelerationStructureBuildSizesInfoKHR buildSizes =
-        asBuilder->GetTopBuildSizes( &instGeom, r.instanceCount, false );
+        asBuilder->GetTopBuildSizes( &instGeom, instanceCount, false );
 
     // if previous buffer's size is not enough
     pCurrentTLAS->RecreateIfNotValid( buildSizes, allocator );
 
     VkAccelerationStructureBuildRangeInfoKHR range = {};
-    range.primitiveCount                           = r.instanceCount;
+    range.primitiveCount                           = instanceCount;
 
 
     // build
@@ -1185,6 +1929,18 @@ void RTGL1::ASManager::OnVertexPreprocessingFinish( VkCommandBuffer cmd,
     collectorDynamic[ frameIndex ]->InsertVertexPreprocessFinishBarrier( cmd );
 }
 
+bool RTGL1::ASManager::IsUpdateable( VertexCollectorFilterTypeFlags filter ) const
+{
+    typedef VertexCollectorFilterTypeFlagBits FT;
+
+    if( filter & FT::CF_DYNAMIC )
+    {
+        return dynamicBlasMaxRefitCount > 0;
+    }
+
+    return filter & FT::CF_STATIC_MOVABLE;
+}
+
 bool RTGL1::ASManager::IsFastBuild( VertexCollectorFilterTypeFlags filter )
 {
     typedef VertexCollectorFilterTypeFlagBits FT;
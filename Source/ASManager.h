@@ -27,8 +27,12 @@
 #include "TextureManager.h"
 #include "VertexCollector.h"
 #include "ASComponent.h"
+#include "Containers.h"
+#include "RangeAllocator.h"
 #include "Token.h"
 
+#include "Generated/ShaderCommonC.h"
+
 namespace RTGL1
 {
 
@@ -39,8 +43,7 @@ class ASManager
 public:
     struct TLASPrepareResult
     {
-        VkAccelerationStructureInstanceKHR instances[ 45 ];
-        uint32_t                           instanceCount;
+        std::vector< VkAccelerationStructureInstanceKHR > instances;
     };
 
 public:
@@ -51,7 +54,11 @@ public:
                std::shared_ptr< GeomInfoManager >      geomInfoManager,
                bool                                    enableTexCoordLayer1,
                bool                                    enableTexCoordLayer2,
-               bool                                    enableTexCoordLayer3 );
+               bool                                    enableTexCoordLayer3,
+               bool                                    enableStaticInstancing,
+               uint32_t                                dynamicBlasMaxRefitCount,
+               float                                   staticSectorShare,
+               bool                                    compactStaticVertices );
     ~ASManager();
 
     ASManager( const ASManager& other )                = delete;
@@ -73,24 +80,43 @@ public:
                                                               uint32_t              frameIndex );
 
 
+    // Sectors are named sets of static geometry, that are kept until removed,
+    // and are not affected by BeginStaticGeometry. Each sector has its own BLAS-es
+    // and vertex data ranges. A submitted sector is built in the next frame's command buffer,
+    // so adding or removing a sector doesn't wait for the device.
+    bool AreStaticSectorsEnabled() const;
+    void BeginStaticSector( std::string_view sectorName );
+    bool AddStaticSectorPrimitive( const RgMeshInfo&          mesh,
+                                   const RgMeshPrimitiveInfo& primitive,
+                                   uint64_t                   uniqueID,
+                                   const TextureManager&      textureManager,
+                                   const MaterialTextures*    pBaseTextures );
+    // If there was a sector with the same name, it's replaced
+    void SubmitStaticSector( uint32_t frameIndex );
+    bool RemoveStaticSector( uint32_t frameIndex, std::string_view sectorName );
+    // Copy vertex data and build BLAS-es of the submitted sectors
+    void BuildStaticSectors( VkCommandBuffer cmd );
+
+
     bool AddMeshPrimitive( uint32_t                   frameIndex,
                            const RgMeshInfo&          mesh,
                            const RgMeshPrimitiveInfo& primitive,
                            uint64_t                   uniqueID,
                            bool                       isStatic,
                            const TextureManager&      textureManager,
-                           GeomInfoManager&           geomInfoManager );
+                           GeomInfoManager&           geomInfoManager,
+                           const MaterialTextures*    pBaseTextures );
 
 
     // Prepare data for building TLAS.
-    // Also fill uniform with current state.
+    // Also upload geometry info offsets of each TLAS instance.
     std::pair< TLASPrepareResult, ShVertPreprocessing > PrepareForBuildingTLAS(
-        uint32_t         frameIndex,
-        ShGlobalUniform& uniformData,
-        uint32_t         uniformData_rayCullMaskWorld,
-        bool             allowGeometryWithSkyFlag,
-        bool             disableRTGeometry,
-        bool             disableStaticGeometry ) const;
+        VkCommandBuffer cmd,
+        uint32_t        frameIndex,
+        uint32_t        uniformData_rayCullMaskWorld,
+        bool            allowGeometryWithSkyFlag,
+        bool            disableRTGeometry,
+        bool            disableStaticGeometry );
     void BuildTLAS( VkCommandBuffer cmd, uint32_t frameIndex, const TLASPrepareResult& info );
 
 
@@ -103,6 +129,9 @@ public:
     void OnVertexPreprocessingFinish( VkCommandBuffer cmd, uint32_t frameIndex, bool onlyDynamic );
 
 
+    // If true, shaders must read static vertices as ShVertexCompact
+    bool AreStaticVerticesCompact() const;
+
     VkDescriptorSet GetBuffersDescSet( uint32_t frameIndex ) const;
     VkDescriptorSet GetTLASDescSet( uint32_t frameIndex ) const;
 
@@ -116,6 +145,20 @@ private:
 
     bool SetupBLAS( BLASComponent& as, const VertexCollector& vertCollector );
 
+    bool AddInstancedMeshPrimitive( const RgMeshInfo&                 mesh,
+                                    const RgMeshPrimitiveInfo&        primitive,
+                                    uint64_t                          uniqueID,
+                                    std::span< MaterialTextures, 4 >  layerTextures,
+                                    std::span< RgColor4DPacked32, 4 > layerColors );
+    void SetupInstancedBLAS( VkCommandBuffer cmd, GeomInfoManager& geomInfoManager );
+    void DestroyInstancedBLAS();
+
+    struct StaticSector;
+    void WriteStaticSectorGeomInfos( const StaticSector& sector );
+    void DestroyStaticSector( StaticSector& sector );
+    // Max local geom index in a filter group for the static geometry that is not in sectors
+    uint32_t GetStaticGeomInfoLimit( VertexCollectorFilterTypeFlags filter ) const;
+
     void UpdateBLAS( BLASComponent& as, const VertexCollector& vertCollector );
 
     static bool SetupTLASInstanceFromBLAS( const BLASComponent& as,
@@ -124,6 +167,7 @@ private:
                                            VkAccelerationStructureInstanceKHR& instance );
 
     static bool IsFastBuild( VertexCollectorFilterTypeFlags filter );
+    bool        IsUpdateable( VertexCollectorFilterTypeFlags filter ) const;
 
 private:
     VkDevice                           device;
@@ -149,10 +193,112 @@ private:
     std::vector< std::unique_ptr< BLASComponent > > allStaticBlas;
     std::vector< std::unique_ptr< BLASComponent > > allDynamicBlas[ MAX_FRAMES_IN_FLIGHT ];
 
+    // Dynamic BLAS can be refit, if its topology wasn't changed since the last full build.
+    // If 0, dynamic BLAS-es are always fully rebuilt.
+    uint32_t dynamicBlasMaxRefitCount;
+
+    struct DynamicBLASRefit
+    {
+        // if BLAS was built with the update flag
+        bool     allowsUpdate{ false };
+        uint64_t topologyHash{ 0 };
+        // how many times BLAS was refit since the last full build
+        uint32_t refitCount{ 0 };
+    };
+    // same indexing as allDynamicBlas
+    std::vector< DynamicBLASRefit > dynamicBlasRefit[ MAX_FRAMES_IN_FLIGHT ];
+
+    // Static meshes with the same name and the same primitive set share vertex data
+    // and one BLAS. Each such mesh is placed into the scene by its own TLAS instance.
+    bool enableStaticInstancing;
+
+    struct InstancedPrimitive
+    {
+        VertexCollector::UploadedPrimitive data;
+        VkAccelerationStructureGeometryKHR geom;
+    };
+    // primitive key to the primitive data in collectorStatic
+    rgl::unordered_map< uint64_t, InstancedPrimitive > instancedPrimitives;
+
+    struct InstancedMeshPart
+    {
+        uint64_t                       primitiveKey;
+        uint64_t                       uniqueID;
+        VertexCollectorFilterTypeFlags filter;
+        ShGeometryInstance             geomInfo;
+    };
+    struct InstancedMesh
+    {
+        uint64_t                         meshNameHash;
+        RgTransform                      transform;
+        std::vector< InstancedMeshPart > parts;
+    };
+    // static mesh uploads, that are resolved to BLAS-es on SubmitStaticGeometry
+    rgl::unordered_map< uint64_t, InstancedMesh > instancedMeshes;
+
+    struct InstancedBLAS
+    {
+        std::unique_ptr< BLASComponent >                        blas;
+        std::vector< VkAccelerationStructureGeometryKHR >       geoms;
+        std::vector< VkAccelerationStructureBuildRangeInfoKHR > ranges;
+        std::vector< uint32_t >                                 primCounts;
+    };
+    std::vector< InstancedBLAS > allInstancedBlas;
+
+    struct StaticInstance
+    {
+        uint32_t    instancedBlasIndex;
+        RgTransform transform;
+        // in a global geom infos array
+        uint32_t    geomInfoOffset;
+    };
+    std::vector< StaticInstance > staticInstances;
+
+    struct SectorPrimitive
+    {
+        VertexCollector::UploadedPrimitive data;
+        VertexCollectorFilterTypeFlags     filter;
+        uint64_t                           uniqueID;
+        RgTransform                        transform;
+        ShGeometryInstance                 geomInfo;
+    };
+    struct SectorBLAS
+    {
+        std::unique_ptr< BLASComponent >                        blas;
+        std::vector< VkAccelerationStructureGeometryKHR >       geoms;
+        std::vector< VkAccelerationStructureBuildRangeInfoKHR > ranges;
+        std::vector< uint32_t >                                 primCounts;
+        // indices in StaticSector::primitives, in the order of geometries
+        std::vector< uint32_t >                                 primitiveIndices;
+        // first local geom index in the filter group
+        uint32_t                                                localGeomIndex;
+    };
+    struct StaticSector
+    {
+        std::vector< SectorPrimitive > primitives;
+        std::vector< SectorBLAS >      blases;
+        // transforms of BLAS geometries
+        Buffer                         transforms;
+        bool                           isBuilt{ false };
+    };
+    rgl::unordered_map< std::string, std::unique_ptr< StaticSector > > staticSectors;
+
+    std::string                                    sectorInProgressName;
+    std::unique_ptr< StaticSector >                sectorInProgress;
+    std::vector< std::unique_ptr< StaticSector > > sectorsToDestroy[ MAX_FRAMES_IN_FLIGHT ];
+
+    // sectors take the upper part of the static world filter groups in the global geom infos
+    rgl::unordered_map< VertexCollectorFilterTypeFlags, uint32_t >       sectorGeomInfoBegin;
+    rgl::unordered_map< VertexCollectorFilterTypeFlags, RangeAllocator > sectorGeomInfoRanges;
+
     // top level AS
     std::unique_ptr< AutoBuffer >    instanceBuffer;
     std::unique_ptr< TLASComponent > tlas[ MAX_FRAMES_IN_FLIGHT ];
 
+    // geometry info offsets for each TLAS instance
+    std::unique_ptr< AutoBuffer >    tlasInstanceInfos;
+    std::vector< int32_t >           prevInstanceGeomInfoOffset;
+
     // TLAS and buffer descriptors
     VkDescriptorPool descPool;
 
@@ -0,0 +1,131 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "AsyncCompute.h"
+
+RTGL1::AsyncCompute::AsyncCompute( VkDevice                                _device,
+                                   std::shared_ptr< Queues >               _queues,
+                                   std::shared_ptr< CommandBufferManager > _cmdManager )
+    : device( _device )
+    , queues( std::move( _queues ) )
+    , cmdManager( std::move( _cmdManager ) )
+    , timeline( VK_NULL_HANDLE )
+    , timelineValue( 0 )
+    , computeCmd( VK_NULL_HANDLE )
+{
+    VkSemaphoreTypeCreateInfo typeInfo = {
+        .sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue  = timelineValue,
+    };
+
+    VkSemaphoreCreateInfo semaphoreInfo = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &typeInfo,
+    };
+
+    VkResult r = vkCreateSemaphore( device, &semaphoreInfo, nullptr, &timeline );
+    VK_CHECKERROR( r );
+
+    SET_DEBUG_NAME( device, timeline, VK_OBJECT_TYPE_SEMAPHORE, "Async compute timeline" );
+}
+
+RTGL1::AsyncCompute::~AsyncCompute()
+{
+    assert( computeCmd == VK_NULL_HANDLE );
+    vkDestroySemaphore( device, timeline, nullptr );
+}
+
+VkCommandBuffer RTGL1::AsyncCompute::Fork( VkCommandBuffer graphicsCmd, VkSemaphore waitSemaphore )
+{
+    assert( computeCmd == VK_NULL_HANDLE );
+
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+
+    timelineValue++;
+    cmdManager->Submit( graphicsCmd,
+                        &waitSemaphore,
+                        nullptr,
+                        &waitStage,
+                        1,
+                        timeline,
+                        timelineValue,
+                        VK_NULL_HANDLE );
+
+    computeCmd = cmdManager->StartComputeCmd();
+
+    return cmdManager->StartGraphicsCmd();
+}
+
+VkCommandBuffer RTGL1::AsyncCompute::GetComputeCmd() const
+{
+    assert( computeCmd != VK_NULL_HANDLE );
+    return computeCmd;
+}
+
+VkCommandBuffer RTGL1::AsyncCompute::Join( VkCommandBuffer      graphicsCmd,
+                                           VkPipelineStageFlags dstStages )
+{
+    assert( computeCmd != VK_NULL_HANDLE );
+
+    {
+        // everything that was submitted before the fork is available to the compute cmd
+        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        uint64_t             waitValue = timelineValue;
+
+        timelineValue++;
+        cmdManager->Submit( computeCmd,
+                            &timeline,
+                            &waitValue,
+                            &waitStage,
+                            1,
+                            timeline,
+                            timelineValue,
+                            VK_NULL_HANDLE );
+
+        computeCmd = VK_NULL_HANDLE;
+    }
+
+    // the work between fork and join doesn't depend on the compute cmd
+    cmdManager->Submit( graphicsCmd );
+
+    {
+        // a wait in a batch without command buffers still blocks dstStages
+        // of all commands that are submitted later to the queue
+        VkTimelineSemaphoreSubmitInfo timelineInfo = {
+            .sType                   = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+            .waitSemaphoreValueCount = 1,
+            .pWaitSemaphoreValues    = &timelineValue,
+        };
+
+        VkSubmitInfo submitInfo = {
+            .sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .pNext              = &timelineInfo,
+            .waitSemaphoreCount = 1,
+            .pWaitSemaphores    = &timeline,
+            .pWaitDstStageMask  = &dstStages,
+        };
+
+        VkResult r = vkQueueSubmit( queues->GetGraphics(), 1, &submitInfo, VK_NULL_HANDLE );
+        VK_CHECKERROR( r );
+    }
+
+    return cmdManager->StartGraphicsCmd();
+}
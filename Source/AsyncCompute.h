@@ -0,0 +1,66 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CommandBufferManager.h"
+#include "Queues.h"
+
+namespace RTGL1
+{
+
+// Moves independent work of a frame to the compute queue, so it overlaps with
+// the graphics queue work. Both queues are synchronized with one timeline semaphore,
+// which value is incremented on each fork and join.
+class AsyncCompute
+{
+public:
+    AsyncCompute( VkDevice                                device,
+                  std::shared_ptr< Queues >               queues,
+                  std::shared_ptr< CommandBufferManager > cmdManager );
+    ~AsyncCompute();
+
+    AsyncCompute( const AsyncCompute& other )                = delete;
+    AsyncCompute( AsyncCompute&& other ) noexcept            = delete;
+    AsyncCompute& operator=( const AsyncCompute& other )     = delete;
+    AsyncCompute& operator=( AsyncCompute&& other ) noexcept = delete;
+
+    // Submit graphicsCmd, which waits waitSemaphore (can be null), and start
+    // a compute cmd that is executed after it. Returns a graphics cmd to continue the frame
+    VkCommandBuffer Fork( VkCommandBuffer graphicsCmd, VkSemaphore waitSemaphore );
+    // Valid between Fork and Join
+    VkCommandBuffer GetComputeCmd() const;
+    // Submit the compute cmd and graphicsCmd. The work on dstStages, that is submitted
+    // to the graphics queue later, waits for the compute cmd. Returns a graphics cmd
+    // to continue the frame
+    VkCommandBuffer Join( VkCommandBuffer graphicsCmd, VkPipelineStageFlags dstStages );
+
+private:
+    VkDevice                                device;
+    std::shared_ptr< Queues >               queues;
+    std::shared_ptr< CommandBufferManager > cmdManager;
+
+    VkSemaphore                             timeline;
+    uint64_t                                timelineValue;
+
+    VkCommandBuffer                         computeCmd;
+};
+
+}
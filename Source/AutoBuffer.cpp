@@ -33,7 +33,8 @@ RTGL1::AutoBuffer::~AutoBuffer()
 void RTGL1::AutoBuffer::Create( VkDeviceSize       size,
                                 VkBufferUsageFlags usage,
                                 const std::string& debugName,
-                                uint32_t           frameCount )
+                                uint32_t           frameCount,
+                                bool               sharedWithAsyncCompute )
 {
     assert( frameCount > 0 && frameCount <= MAX_FRAMES_IN_FLIGHT );
 
@@ -59,7 +60,8 @@ void RTGL1::AutoBuffer::Create( VkDeviceSize       size,
                       size,
                       usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                       VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                      debugName.c_str() );
+                      debugName.c_str(),
+                      sharedWithAsyncCompute );
 }
 
 void RTGL1::AutoBuffer::Destroy()
@@ -39,10 +39,13 @@ public:
     AutoBuffer&     operator=( const AutoBuffer& other ) = delete;
     AutoBuffer&     operator=( AutoBuffer&& other ) noexcept = delete;
 
+    // If sharedWithAsyncCompute, the device local buffer
+    // can be accessed from the async compute queue
     void            Create( VkDeviceSize       size,
                             VkBufferUsageFlags usage,
                             const std::string& debugName,
-                            uint32_t           frameCount = MAX_FRAMES_IN_FLIGHT );
+                            uint32_t           frameCount             = MAX_FRAMES_IN_FLIGHT,
+                            bool               sharedWithAsyncCompute = false );
     void            Destroy();
 
     void            CopyFromStaging( VkCommandBuffer cmd,
@@ -52,7 +52,6 @@ VkPipelineLayout CreatePipelineLayout( VkDevice                           device
 
 RTGL1::Bloom::Bloom( VkDevice                        _device,
                      std::shared_ptr< Framebuffers > _framebuffers,
-                     const ShaderManager&            _shaderManager,
                      const GlobalUniform&            _uniform,
                      const TextureManager&           _textureManager,
                      const Tonemapping&              _tonemapping )
@@ -79,7 +78,6 @@ RTGL1::Bloom::Bloom( VkDevice                        _device,
         };
         applyPipelineLayout = CreatePipelineLayout( device, setLayouts, "Bloom apply layout" );
     }
-    CreatePipelines( &_shaderManager );
 
     static_assert( StepCount == COMPUTE_BLOOM_STEP_COUNT, "Recheck COMPUTE_BLOOM_STEP_COUNT" );
 }
@@ -297,8 +295,12 @@ void RTGL1::Bloom::CreateStepPipelines( const ShaderManager* shaderManager )
             };
             info.stage.pSpecializationInfo = &specInfo;
 
-            VkResult r = vkCreateComputePipelines(
-                device, VK_NULL_HANDLE, 1, &info, nullptr, &downsamplePipelines[ i ] );
+            VkResult r = vkCreateComputePipelines( device,
+                                                   shaderManager->GetPipelineCache(),
+                                                   1,
+                                                   &info,
+                                                   nullptr,
+                                                   &downsamplePipelines[ i ] );
 
             VK_CHECKERROR( r );
             SET_DEBUG_NAME(
@@ -313,8 +315,12 @@ void RTGL1::Bloom::CreateStepPipelines( const ShaderManager* shaderManager )
             };
             info.stage.pSpecializationInfo = &specInfo;
 
-            VkResult r = vkCreateComputePipelines(
-                device, VK_NULL_HANDLE, 1, &info, nullptr, &upsamplePipelines[ i ] );
+            VkResult r = vkCreateComputePipelines( device,
+                                                   shaderManager->GetPipelineCache(),
+                                                   1,
+                                                   &info,
+                                                   nullptr,
+                                                   &upsamplePipelines[ i ] );
 
             VK_CHECKERROR( r );
             SET_DEBUG_NAME(
@@ -354,8 +360,12 @@ void RTGL1::Bloom::CreateApplyPipelines( const ShaderManager* shaderManager )
         };
         info.stage.pSpecializationInfo = &specInfo;
 
-        VkResult r = vkCreateComputePipelines(
-            device, VK_NULL_HANDLE, 1, &info, nullptr, &applyPipelines[ isSourcePing ] );
+        VkResult r = vkCreateComputePipelines( device,
+                                               shaderManager->GetPipelineCache(),
+                                               1,
+                                               &info,
+                                               nullptr,
+                                               &applyPipelines[ isSourcePing ] );
 
         VK_CHECKERROR( r );
         SET_DEBUG_NAME(
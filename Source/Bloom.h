@@ -39,7 +39,6 @@ class Bloom final : public IShaderDependency
 public:
     Bloom( VkDevice                        device,
            std::shared_ptr< Framebuffers > framebuffers,
-           const ShaderManager&            shaderManager,
            const GlobalUniform&            uniform,
            const TextureManager&           textureManager,
            const Tonemapping&              tonemapping );
@@ -118,6 +118,8 @@ RTGL1::BlueNoise::BlueNoise( VkDevice                           _device,
         .usage         = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
         .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
     };
+    // blue noise is used by async compute too
+    allocator->ApplySharingMode( info );
 
     blueNoiseImages = allocator->CreateDstTextureImage( &info, "Blue noise image VMA alloc" );
     SET_DEBUG_NAME( device, blueNoiseImages, VK_OBJECT_TYPE_IMAGE, "Blue noise Image" );
@@ -41,7 +41,8 @@ void Buffer::Init( MemoryAllocator&      allocator,
                    VkDeviceSize          bsize,
                    VkBufferUsageFlags    usage,
                    VkMemoryPropertyFlags properties,
-                   const char*           debugName )
+                   const char*           debugName,
+                   bool                  sharedWithAsyncCompute )
 {
     if( bsize == 0 )
     {
@@ -58,6 +59,10 @@ void Buffer::Init( MemoryAllocator&      allocator,
     bufferInfo.size               = bsize;
     bufferInfo.usage              = usage;
     bufferInfo.sharingMode        = VK_SHARING_MODE_EXCLUSIVE;
+    if( sharedWithAsyncCompute )
+    {
+        allocator.ApplySharingMode( bufferInfo );
+    }
 
     r = vkCreateBuffer( device, &bufferInfo, nullptr, &buffer );
     VK_CHECKERROR( r );
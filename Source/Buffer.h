@@ -32,12 +32,14 @@ public:
     Buffer();
     ~Buffer();
 
-    // Create VkBuffer, allocate memory and bind it
+    // Create VkBuffer, allocate memory and bind it.
+    // If sharedWithAsyncCompute, the buffer can be accessed from the async compute queue
     void Init( MemoryAllocator&      allocator,
                VkDeviceSize          size,
                VkBufferUsageFlags    usage,
                VkMemoryPropertyFlags properties,
-               const char*           debugName = nullptr );
+               const char*           debugName              = nullptr,
+               bool                  sharedWithAsyncCompute = false );
     void Destroy();
 
     void* Map();
@@ -163,18 +163,60 @@ void RTGL1::CommandBufferManager::Submit( VkCommandBuffer             cmd,
                                           uint32_t                    waitCount,
                                           VkSemaphore                 signalSemaphore,
                                           VkFence                     fence )
+{
+    Submit( cmd, waitSemaphores, nullptr, waitStages, waitCount, signalSemaphore, 0, fence );
+}
+
+void RTGL1::CommandBufferManager::Submit( VkCommandBuffer             cmd,
+                                          const VkSemaphore*          waitSemaphores,
+                                          const uint64_t*             waitValues,
+                                          const VkPipelineStageFlags* waitStages,
+                                          uint32_t                    waitCount,
+                                          VkSemaphore                 signalSemaphore,
+                                          uint64_t                    signalValue,
+                                          VkFence                     fence )
 {
     VkResult r = vkEndCommandBuffer( cmd );
     VK_CHECKERROR( r );
-    
+
+    constexpr uint32_t   MaxWaitCount = 4;
+    VkSemaphore          waits[ MaxWaitCount ];
+    uint64_t             values[ MaxWaitCount ];
+    VkPipelineStageFlags stages[ MaxWaitCount ];
+    uint32_t             count = 0;
+
+    // skip null semaphores
+    assert( waitCount <= MaxWaitCount );
+    for( uint32_t i = 0; i < waitCount && i < MaxWaitCount; i++ )
+    {
+        if( waitSemaphores[ i ] != VK_NULL_HANDLE )
+        {
+            waits[ count ]  = waitSemaphores[ i ];
+            values[ count ] = waitValues != nullptr ? waitValues[ i ] : 0;
+            stages[ count ] = waitStages[ i ];
+            count++;
+        }
+    }
+
+    uint32_t signalCount = signalSemaphore != VK_NULL_HANDLE ? 1 : 0;
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo = {
+        .sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .waitSemaphoreValueCount   = count,
+        .pWaitSemaphoreValues      = values,
+        .signalSemaphoreValueCount = signalCount,
+        .pSignalSemaphoreValues    = &signalValue,
+    };
+
     VkSubmitInfo submitInfo = {
         .sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .waitSemaphoreCount   = waitCount,
-        .pWaitSemaphores      = waitSemaphores,
-        .pWaitDstStageMask    = waitStages,
+        .pNext                = &timelineInfo,
+        .waitSemaphoreCount   = count,
+        .pWaitSemaphores      = waits,
+        .pWaitDstStageMask    = stages,
         .commandBufferCount   = 1,
         .pCommandBuffers      = &cmd,
-        .signalSemaphoreCount = 1,
+        .signalSemaphoreCount = signalCount,
         .pSignalSemaphores    = &signalSemaphore,
     };
 
@@ -51,6 +51,7 @@ public:
     VkCommandBuffer       StartTransferCmd();
 
     void                  Submit( VkCommandBuffer cmd, VkFence fence = VK_NULL_HANDLE );
+    // Null wait / signal semaphores are skipped
     void                  Submit( VkCommandBuffer      cmd,
                                   VkSemaphore          waitSemaphore,
                                   VkPipelineStageFlags waitStages,
@@ -62,6 +63,16 @@ public:
                                   uint32_t                    waitCount,
                                   VkSemaphore                 signalSemaphore,
                                   VkFence                     fence );
+    // Values are for timeline semaphores, they are ignored for binary ones.
+    // waitValues can be null, if all wait semaphores are binary
+    void                  Submit( VkCommandBuffer             cmd,
+                                  const VkSemaphore*          waitSemaphores,
+                                  const uint64_t*             waitValues,
+                                  const VkPipelineStageFlags* waitStages,
+                                  uint32_t                    waitCount,
+                                  VkSemaphore                 signalSemaphore,
+                                  uint64_t                    signalValue,
+                                  VkFence                     fence );
 
 
     void                  WaitGraphicsIdle();
@@ -20,6 +20,8 @@
 
 #include "Common.h"
 
+#include "Profiler.h"
+
 
 namespace RTGL1
 {
@@ -81,6 +83,8 @@ void RTGL1::AddDebugName( VkDevice device, uint64_t obj, VkObjectType type, cons
 
 void RTGL1::BeginCmdLabel( VkCommandBuffer cmd, const char* pName, const float pColor[ 4 ] )
 {
+    Profiler::OnBeginCmdLabel( cmd, pName );
+
     if( svkCmdBeginDebugUtilsLabelEXT == nullptr || pName == nullptr )
     {
         return;
@@ -101,6 +105,8 @@ void RTGL1::BeginCmdLabel( VkCommandBuffer cmd, const char* pName, const float p
 
 void RTGL1::EndCmdLabel( VkCommandBuffer cmd )
 {
+    Profiler::OnEndCmdLabel( cmd );
+
     if( svkCmdEndDebugUtilsLabelEXT == nullptr )
     {
         return;
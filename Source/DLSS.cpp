@@ -300,8 +300,8 @@ static NVSDK_NGX_PerfQuality_Value ToNGXPerfQuality( RgRenderResolutionMode mode
 
 bool RTGL1::DLSS::AreSameDlssFeatureValues( const RenderResolutionHelper& renderResolution ) const
 {
-    return prevDlssFeatureValues.renderWidth == renderResolution.Width() &&
-           prevDlssFeatureValues.renderHeight == renderResolution.Height() &&
+    return prevDlssFeatureValues.renderWidth == renderResolution.MaxWidth() &&
+           prevDlssFeatureValues.renderHeight == renderResolution.MaxHeight() &&
            prevDlssFeatureValues.upscaledWidth == renderResolution.UpscaledWidth() &&
            prevDlssFeatureValues.upscaledHeight == renderResolution.UpscaledHeight();
 }
@@ -309,8 +309,8 @@ bool RTGL1::DLSS::AreSameDlssFeatureValues( const RenderResolutionHelper& render
 void RTGL1::DLSS::SaveDlssFeatureValues( const RenderResolutionHelper& renderResolution )
 {
     prevDlssFeatureValues = {
-        .renderWidth    = renderResolution.Width(),
-        .renderHeight   = renderResolution.Height(),
+        .renderWidth    = renderResolution.MaxWidth(),
+        .renderHeight   = renderResolution.MaxHeight(),
         .upscaledWidth  = renderResolution.UpscaledWidth(),
         .upscaledHeight = renderResolution.UpscaledHeight(),
     };
@@ -339,8 +339,9 @@ bool RTGL1::DLSS::ValidateDlssFeature( VkCommandBuffer               cmd,
 
 
     NVSDK_NGX_DLSS_Create_Params dlssParams = {
-        .Feature = { .InWidth        = renderResolution.Width(),
-                     .InHeight       = renderResolution.Height(),
+        // max size, as a frame can use only a part of the framebuffers
+        .Feature = { .InWidth        = renderResolution.MaxWidth(),
+                     .InHeight       = renderResolution.MaxHeight(),
                      .InTargetWidth  = renderResolution.UpscaledWidth(),
                      .InTargetHeight = renderResolution.UpscaledHeight() },
     };
@@ -442,6 +443,10 @@ RTGL1::FramebufferImageIndex RTGL1::DLSS::Apply(
         renderResolution.Width(),
         renderResolution.Height(),
     };
+    NVSDK_NGX_Dimensions allocatedSize = {
+        renderResolution.MaxWidth(),
+        renderResolution.MaxHeight(),
+    };
     NVSDK_NGX_Dimensions targetSize = {
         renderResolution.UpscaledWidth(),
         renderResolution.UpscaledHeight(),
@@ -449,11 +454,11 @@ RTGL1::FramebufferImageIndex RTGL1::DLSS::Apply(
 
 
     // clang-format off
-    NVSDK_NGX_Resource_VK unresolvedColorResource = ToNGXResource( framebuffers, frameIndex, FI::FB_IMAGE_INDEX_FINAL, sourceSize );
+    NVSDK_NGX_Resource_VK unresolvedColorResource = ToNGXResource( framebuffers, frameIndex, FI::FB_IMAGE_INDEX_FINAL, allocatedSize );
     NVSDK_NGX_Resource_VK resolvedColorResource   = ToNGXResource( framebuffers, frameIndex, outputImage, targetSize, true );
-    NVSDK_NGX_Resource_VK motionVectorsResource   = ToNGXResource( framebuffers, frameIndex, FI::FB_IMAGE_INDEX_MOTION_DLSS, sourceSize );
-    NVSDK_NGX_Resource_VK depthResource           = ToNGXResource( framebuffers, frameIndex, FI::FB_IMAGE_INDEX_DEPTH_NDC, sourceSize );
-    NVSDK_NGX_Resource_VK rayLengthResource       = ToNGXResource( framebuffers, frameIndex, FI::FB_IMAGE_INDEX_DEPTH_WORLD, sourceSize );
+    NVSDK_NGX_Resource_VK motionVectorsResource   = ToNGXResource( framebuffers, frameIndex, FI::FB_IMAGE_INDEX_MOTION_DLSS, allocatedSize );
+    NVSDK_NGX_Resource_VK depthResource           = ToNGXResource( framebuffers, frameIndex, FI::FB_IMAGE_INDEX_DEPTH_NDC, allocatedSize );
+    NVSDK_NGX_Resource_VK rayLengthResource       = ToNGXResource( framebuffers, frameIndex, FI::FB_IMAGE_INDEX_DEPTH_WORLD, allocatedSize );
     // clang-format on
 
 
@@ -58,7 +58,6 @@ constexpr VkPrimitiveTopology CUBE_TOPOLOGY     = VK_PRIMITIVE_TOPOLOGY_TRIANGLE
 RTGL1::DecalManager::DecalManager( VkDevice                           _device,
                                    std::shared_ptr< MemoryAllocator > _allocator,
                                    std::shared_ptr< Framebuffers >    _storageFramebuffers,
-                                   const ShaderManager&               _shaderManager,
                                    const GlobalUniform&               _uniform,
                                    const TextureManager&              _textureManager )
     : device( _device ), storageFramebuffers( std::move( _storageFramebuffers ) )
@@ -88,7 +87,6 @@ RTGL1::DecalManager::DecalManager( VkDevice                           _device,
         copyingPipelineLayout = CreatePipelineLayout( device, setLayouts );
     }
 
-    CreatePipelines( &_shaderManager );
 }
 
 RTGL1::DecalManager::~DecalManager()
@@ -562,8 +560,12 @@ void RTGL1::DecalManager::CreatePipelines( const ShaderManager* shaderManager )
         {
             copyFromDecalToGbuffer = 0;
 
-            VkResult r = vkCreateComputePipelines(
-                device, VK_NULL_HANDLE, 1, &copyingInfo, nullptr, &copyNormalsToAttachment );
+            VkResult r = vkCreateComputePipelines( device,
+                                                   shaderManager->GetPipelineCache(),
+                                                   1,
+                                                   &copyingInfo,
+                                                   nullptr,
+                                                   &copyNormalsToAttachment );
 
             VK_CHECKERROR( r );
             SET_DEBUG_NAME( device,
@@ -574,8 +576,12 @@ void RTGL1::DecalManager::CreatePipelines( const ShaderManager* shaderManager )
         {
             copyFromDecalToGbuffer = 1;
 
-            VkResult r = vkCreateComputePipelines(
-                device, VK_NULL_HANDLE, 1, &copyingInfo, nullptr, &copyNormalsToGbuffer );
+            VkResult r = vkCreateComputePipelines( device,
+                                                   shaderManager->GetPipelineCache(),
+                                                   1,
+                                                   &copyingInfo,
+                                                   nullptr,
+                                                   &copyNormalsToGbuffer );
 
             VK_CHECKERROR( r );
             SET_DEBUG_NAME( device,
@@ -694,7 +700,8 @@ void RTGL1::DecalManager::CreatePipelines( const ShaderManager* shaderManager )
         .basePipelineHandle  = VK_NULL_HANDLE,
     };
 
-    VkResult r = vkCreateGraphicsPipelines( device, VK_NULL_HANDLE, 1, &info, nullptr, &pipeline );
+    VkResult r = vkCreateGraphicsPipelines(
+        device, shaderManager->GetPipelineCache(), 1, &info, nullptr, &pipeline );
     VK_CHECKERROR( r );
 }
 
@@ -37,7 +37,6 @@ public:
     DecalManager( VkDevice                           device,
                   std::shared_ptr< MemoryAllocator > allocator,
                   std::shared_ptr< Framebuffers >    storageFramebuffers,
-                  const ShaderManager&               shaderManager,
                   const GlobalUniform&               uniform,
                   const TextureManager&              textureManager );
     ~DecalManager() override;
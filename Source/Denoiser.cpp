@@ -27,7 +27,6 @@
 
 RTGL1::Denoiser::Denoiser( VkDevice                        _device,
                            std::shared_ptr< Framebuffers > _framebuffers,
-                           const ShaderManager&            _shaderManager,
                            const GlobalUniform&            _uniform )
     : device( _device )
     , framebuffers( std::move( _framebuffers ) )
@@ -51,7 +50,6 @@ RTGL1::Denoiser::Denoiser( VkDevice                        _device,
     };
 
     CreatePipelineLayout( setLayouts, std::size( setLayouts ) );
-    CreatePipelines( &_shaderManager );
 }
 
 RTGL1::Denoiser::~Denoiser()
@@ -335,8 +333,12 @@ void RTGL1::Denoiser::CreatePipelines( const ShaderManager* shaderManager )
         {
             gAtrousIteration = i;
 
-            VkResult r = vkCreateComputePipelines(
-                device, VK_NULL_HANDLE, 1, &plInfo, nullptr, &gradientAtrous[ i ] );
+            VkResult r = vkCreateComputePipelines( device,
+                                                   shaderManager->GetPipelineCache(),
+                                                   1,
+                                                   &plInfo,
+                                                   nullptr,
+                                                   &gradientAtrous[ i ] );
 
             VK_CHECKERROR( r );
             SET_DEBUG_NAME( device, gradientAtrous[ i ], VK_OBJECT_TYPE_PIPELINE, debugNames[ i ] );
@@ -351,7 +353,7 @@ void RTGL1::Denoiser::CreatePipelines( const ShaderManager* shaderManager )
         };
 
         VkResult r = vkCreateComputePipelines(
-            device, VK_NULL_HANDLE, 1, &plInfo, nullptr, &temporalAccumulation );
+            device, shaderManager->GetPipelineCache(), 1, &plInfo, nullptr, &temporalAccumulation );
 
         VK_CHECKERROR( r );
         SET_DEBUG_NAME( device,
@@ -368,7 +370,12 @@ void RTGL1::Denoiser::CreatePipelines( const ShaderManager* shaderManager )
         };
 
         VkResult r =
-            vkCreateComputePipelines( device, VK_NULL_HANDLE, 1, &plInfo, nullptr, &antifirefly );
+            vkCreateComputePipelines( device,
+                                      shaderManager->GetPipelineCache(),
+                                      1,
+                                      &plInfo,
+                                      nullptr,
+                                      &antifirefly );
         VK_CHECKERROR( r );
 
         SET_DEBUG_NAME( device, antifirefly, VK_OBJECT_TYPE_PIPELINE, "Antifirefly pipeline" );
@@ -382,7 +389,7 @@ void RTGL1::Denoiser::CreatePipelines( const ShaderManager* shaderManager )
         };
 
         VkResult r = vkCreateComputePipelines(
-            device, VK_NULL_HANDLE, 1, &plInfo, nullptr, &varianceEstimation );
+            device, shaderManager->GetPipelineCache(), 1, &plInfo, nullptr, &varianceEstimation );
 
         VK_CHECKERROR( r );
         SET_DEBUG_NAME( device,
@@ -408,7 +415,7 @@ void RTGL1::Denoiser::CreatePipelines( const ShaderManager* shaderManager )
             };
 
             VkResult r = vkCreateComputePipelines(
-                device, VK_NULL_HANDLE, 1, &plInfo, nullptr, &atrous[ 0 ] );
+                device, shaderManager->GetPipelineCache(), 1, &plInfo, nullptr, &atrous[ 0 ] );
 
             VK_CHECKERROR( r );
             SET_DEBUG_NAME( device, atrous[ 0 ], VK_OBJECT_TYPE_PIPELINE, debugNames[ 0 ] );
@@ -427,7 +434,7 @@ void RTGL1::Denoiser::CreatePipelines( const ShaderManager* shaderManager )
                 gAtrousIteration = i;
 
                 VkResult r = vkCreateComputePipelines(
-                    device, VK_NULL_HANDLE, 1, &plInfo, nullptr, &atrous[ i ] );
+                    device, shaderManager->GetPipelineCache(), 1, &plInfo, nullptr, &atrous[ i ] );
 
                 VK_CHECKERROR( r );
                 SET_DEBUG_NAME( device, atrous[ i ], VK_OBJECT_TYPE_PIPELINE, debugNames[ i ] );
@@ -33,7 +33,6 @@ class Denoiser final : public IShaderDependency
 public:
     Denoiser( VkDevice                                      device,
               std::shared_ptr< Framebuffers >               framebuffers,
-              const ShaderManager& shaderManager,
               const GlobalUniform& uniform );
     ~Denoiser() override;
 
@@ -27,10 +27,9 @@ constexpr const char* SHADER_FRAG = "FragDepthCopying";
 }
 
 
-RTGL1::DepthCopying::DepthCopying( VkDevice             _device,
-                                   VkFormat             _depthFormat,
-                                   const ShaderManager& _shaderManager,
-                                   const Framebuffers&  _storageFramebuffers )
+RTGL1::DepthCopying::DepthCopying( VkDevice            _device,
+                                   VkFormat            _depthFormat,
+                                   const Framebuffers& _storageFramebuffers )
     : device( _device )
     , renderPass( VK_NULL_HANDLE )
     , framebuffers{}
@@ -39,7 +38,6 @@ RTGL1::DepthCopying::DepthCopying( VkDevice             _device,
 {
     CreateRenderPass( _depthFormat );
     CreatePipelineLayout( _storageFramebuffers.GetDescSetLayout() );
-    CreatePipeline( &_shaderManager );
 }
 
 RTGL1::DepthCopying::~DepthCopying()
@@ -359,7 +357,8 @@ void RTGL1::DepthCopying::CreatePipeline( const ShaderManager* shaderManager )
         .basePipelineHandle  = VK_NULL_HANDLE,
     };
 
-    VkResult r = vkCreateGraphicsPipelines( device, nullptr, 1, &plInfo, nullptr, &pipeline );
+    VkResult r = vkCreateGraphicsPipelines(
+        device, shaderManager->GetPipelineCache(), 1, &plInfo, nullptr, &pipeline );
 
     VK_CHECKERROR( r );
     SET_DEBUG_NAME( device, pipeline, VK_OBJECT_TYPE_PIPELINE, "Rasterizer raster draw pipeline" );
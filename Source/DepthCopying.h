@@ -31,10 +31,9 @@ namespace RTGL1
 class DepthCopying
 {
 public:
-    DepthCopying( VkDevice             device,
-                  VkFormat             depthFormat,
-                  const ShaderManager& shaderManager,
-                  const Framebuffers&  storageFramebuffers );
+    DepthCopying( VkDevice            device,
+                  VkFormat            depthFormat,
+                  const Framebuffers& storageFramebuffers );
     ~DepthCopying();
 
     DepthCopying( const DepthCopying& other )     = delete;
@@ -36,14 +36,16 @@ namespace detail
         constexpr static RgStructureType sType = RG_STRUCTURE_TYPE_RENDER_RESOLUTION;
 
         constexpr static RgDrawFrameRenderResolutionParams value = {
-            .sType                = sType,
-            .pNext                = nullptr,
-            .upscaleTechnique     = RG_RENDER_UPSCALE_TECHNIQUE_AMD_FSR2,
-            .sharpenTechnique     = RG_RENDER_SHARPEN_TECHNIQUE_NONE,
-            .resolutionMode       = RG_RENDER_RESOLUTION_MODE_QUALITY,
-            .customRenderSize     = {},
-            .pPixelizedRenderSize = nullptr,
-            .resetUpscalerHistory = false,
+            .sType                     = sType,
+            .pNext                     = nullptr,
+            .upscaleTechnique          = RG_RENDER_UPSCALE_TECHNIQUE_AMD_FSR2,
+            .sharpenTechnique          = RG_RENDER_SHARPEN_TECHNIQUE_NONE,
+            .resolutionMode            = RG_RENDER_RESOLUTION_MODE_QUALITY,
+            .customRenderSize          = {},
+            .pPixelizedRenderSize      = nullptr,
+            .resetUpscalerHistory      = false,
+            .dynamicResolutionTargetMs = 0.0f,
+            .dynamicResolutionMinScale = 0.5f,
         };
     };
 
@@ -0,0 +1,128 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace RTGL1
+{
+
+// Adjusts the render size scale from measured GPU frame time toward a target budget.
+// GPU time is assumed to be roughly proportional to the pixel count, i.e. to the squared scale.
+// Measurements arrive a few frames late, so after each scale change the frames that were
+// already in flight are skipped, as they were rendered with the previous scale.
+class DynamicResolutionController
+{
+public:
+    DynamicResolutionController()  = default;
+    ~DynamicResolutionController() = default;
+
+    DynamicResolutionController( const DynamicResolutionController& other )     = delete;
+    DynamicResolutionController( DynamicResolutionController&& other ) noexcept = delete;
+    DynamicResolutionController& operator=( const DynamicResolutionController& other ) = delete;
+    DynamicResolutionController& operator=( DynamicResolutionController&& other ) noexcept =
+        delete;
+
+    // Returns the scale of the render size for the current frame
+    float Update( float    targetMs,
+                  float    minScale,
+                  uint32_t currentFrameId,
+                  bool     hasMeasurement,
+                  uint32_t measuredFrameId,
+                  double   measuredGpuMs )
+    {
+        if( targetMs <= 0.0f )
+        {
+            Reset();
+            return 1.0f;
+        }
+
+        minScale = std::clamp( minScale > 0.0f ? minScale : 0.5f, MinAllowedScale, 1.0f );
+        scale    = std::clamp( scale, minScale, 1.0f );
+
+        if( !hasMeasurement || measuredGpuMs <= 0.0 || measuredFrameId == lastMeasuredFrameId ||
+            measuredFrameId < firstValidFrameId )
+        {
+            return scale;
+        }
+        lastMeasuredFrameId = measuredFrameId;
+
+        smoothedGpuMs = smoothedGpuMs > 0.0
+                            ? smoothedGpuMs + ( measuredGpuMs - smoothedGpuMs ) * Smoothing
+                            : measuredGpuMs;
+
+        const double ratio = double( targetMs ) / smoothedGpuMs;
+
+        // don't resize, if close enough
+        if( std::abs( 1.0 - ratio ) < DeadZone )
+        {
+            return scale;
+        }
+
+        // react to an overload faster than to a headroom
+        const double gain    = ratio < 1.0 ? GainDown : GainUp;
+        const double desired = double( scale ) * std::sqrt( ratio );
+
+        float next = float( scale + ( desired - scale ) * gain );
+        next       = std::round( next / ScaleStep ) * ScaleStep;
+
+        if( next == scale )
+        {
+            next = ratio < 1.0 ? scale - ScaleStep : scale + ScaleStep;
+        }
+        next = std::clamp( next, minScale, 1.0f );
+
+        if( next != scale )
+        {
+            scale             = next;
+            firstValidFrameId = currentFrameId;
+            smoothedGpuMs     = 0.0;
+        }
+
+        return scale;
+    }
+
+    void Reset()
+    {
+        scale               = 1.0f;
+        smoothedGpuMs       = 0.0;
+        lastMeasuredFrameId = UINT32_MAX;
+        firstValidFrameId   = 0;
+    }
+
+private:
+    constexpr static float  MinAllowedScale = 0.1f;
+    constexpr static float  ScaleStep       = 1.0f / 64.0f;
+    constexpr static double Smoothing       = 0.3;
+    constexpr static double DeadZone        = 0.05;
+    constexpr static double GainDown        = 0.6;
+    constexpr static double GainUp          = 0.25;
+
+private:
+    float    scale               = 1.0f;
+    double   smoothedGpuMs       = 0.0;
+    uint32_t lastMeasuredFrameId = UINT32_MAX;
+    uint32_t firstValidFrameId   = 0;
+};
+
+}
@@ -59,7 +59,6 @@ protected:
     // Call this function in a child class constructor
     template <typename PUSH_CONST_T = std::nullptr_t, int DESC_SET_COUNT>
     void InitBase(
-        const std::shared_ptr<const ShaderManager> &shaderManager, 
         const VkDescriptorSetLayout(&setLayouts)[DESC_SET_COUNT],
         const PUSH_CONST_T&);
 
@@ -82,14 +81,12 @@ private:
 
 template<typename PUSH_CONST_T, int DESC_SET_COUNT>
 void EffectBase::InitBase(
-    const std::shared_ptr<const ShaderManager> &shaderManager,
     const VkDescriptorSetLayout(&setLayouts)[DESC_SET_COUNT],
     const PUSH_CONST_T&)
 {
     static_assert(sizeof(PUSH_CONST_T) <= 128, "Push constant must have size <= 128");
 
     CreatePipelineLayout<PUSH_CONST_T, DESC_SET_COUNT>(setLayouts);
-    CreatePipelines(shaderManager.get());
 }
 
 
@@ -31,8 +31,7 @@ struct EffectSimple : public EffectBase
     explicit EffectSimple(
         VkDevice device, const char *pShaderName,
         const std::shared_ptr<const Framebuffers> &framebuffers,
-        const std::shared_ptr<const GlobalUniform> &uniform,
-        const std::shared_ptr<const ShaderManager> &shaderManager)
+        const std::shared_ptr<const GlobalUniform> &uniform)
     :
         EffectBase(device),
         push{},
@@ -45,7 +44,7 @@ struct EffectSimple : public EffectBase
             uniform->GetDescSetLayout(),
         };
 
-        InitBase(shaderManager, setLayouts, push);
+        InitBase(setLayouts, push);
     }
 
 protected:
@@ -128,7 +127,7 @@ private:
 
 #define RTGL1_EFFECT_SIMPLE_INHERIT_CONSTRUCTOR(T, SHADER_NAME) \
     T(VkDevice device, const std::shared_ptr<const Framebuffers> &framebuffers, \
-    const std::shared_ptr<const GlobalUniform> &uniform, const std::shared_ptr<const ShaderManager> &shaderManager) : \
-    EffectSimple(device, SHADER_NAME, framebuffers, uniform, shaderManager) {}
+    const std::shared_ptr<const GlobalUniform> &uniform) : \
+    EffectSimple(device, SHADER_NAME, framebuffers, uniform) {}
 
 }
@@ -40,7 +40,6 @@ struct EffectWipe final : public EffectBase
                          const std::shared_ptr< const Framebuffers >&  _framebuffers,
                          const std::shared_ptr< const GlobalUniform >& _uniform,
                          const std::shared_ptr< const BlueNoise >&     _blueNoise,
-                         const std::shared_ptr< const ShaderManager >& _shaderManager,
                          bool                                          _effectWipeIsUsed )
         : EffectBase( device ), push{}, effectWipeIsUsed{ _effectWipeIsUsed }
     {
@@ -50,7 +49,7 @@ struct EffectWipe final : public EffectBase
             _blueNoise->GetDescSetLayout(),
         };
 
-        InitBase( _shaderManager, setLayouts, PushConst() );
+        InitBase( setLayouts, PushConst() );
     }
 
     bool Setup(const CommonnlyUsedEffectArguments &args, const RgPostEffectWipe *params, const std::shared_ptr<Swapchain> &swapchain, uint32_t currentFrameId)
@@ -107,7 +106,7 @@ struct EffectWipe final : public EffectBase
             Utils::BarrierImage(
                 args.cmd, src,
                 VK_ACCESS_NONE_KHR, VK_ACCESS_TRANSFER_READ_BIT,
-                VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+                swapchain->GetIdleLayout(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
 
             Utils::BarrierImage(
                 args.cmd, dst,
@@ -127,7 +126,7 @@ struct EffectWipe final : public EffectBase
             Utils::BarrierImage(
                 args.cmd, src,
                 VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_NONE_KHR,
-                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, swapchain->GetIdleLayout());
 
         }
 
@@ -193,13 +193,13 @@ RTGL1::FramebufferImageIndex RTGL1::FSR2::Apply(
     // clang-format off
     FfxFsr2DispatchDescription info = {
         .commandList                = ffxGetCommandListVK( cmd ),
-        .color                      = ToFSRResource( FI::FB_IMAGE_INDEX_FINAL, frameIndex, pCtx, *framebuffers, renderResolution.GetResolutionState() ),
-        .depth                      = ToFSRResource( FI::FB_IMAGE_INDEX_DEPTH_NDC, frameIndex, pCtx, *framebuffers, renderResolution.GetResolutionState() ),
-        .motionVectors              = ToFSRResource( FI::FB_IMAGE_INDEX_MOTION_DLSS, frameIndex, pCtx, *framebuffers, renderResolution.GetResolutionState() ),
+        .color                      = ToFSRResource( FI::FB_IMAGE_INDEX_FINAL, frameIndex, pCtx, *framebuffers, renderResolution.GetMaxResolutionState() ),
+        .depth                      = ToFSRResource( FI::FB_IMAGE_INDEX_DEPTH_NDC, frameIndex, pCtx, *framebuffers, renderResolution.GetMaxResolutionState() ),
+        .motionVectors              = ToFSRResource( FI::FB_IMAGE_INDEX_MOTION_DLSS, frameIndex, pCtx, *framebuffers, renderResolution.GetMaxResolutionState() ),
         .exposure                   = {},
-        .reactive                   = ToFSRResource( FI::FB_IMAGE_INDEX_REACTIVITY, frameIndex, pCtx, *framebuffers, renderResolution.GetResolutionState() ),
+        .reactive                   = ToFSRResource( FI::FB_IMAGE_INDEX_REACTIVITY, frameIndex, pCtx, *framebuffers, renderResolution.GetMaxResolutionState() ),
         .transparencyAndComposition = {},
-        .output                     = ToFSRResource( OUTPUT_IMAGE_INDEX, frameIndex, pCtx, *framebuffers, renderResolution.GetResolutionState() ),
+        .output                     = ToFSRResource( OUTPUT_IMAGE_INDEX, frameIndex, pCtx, *framebuffers, renderResolution.GetMaxResolutionState() ),
         .jitterOffset               = { -jitterOffset.data[ 0 ], -jitterOffset.data[ 1 ] },
         .motionVectorScale          = { float( renderResolution.GetResolutionState().renderWidth ), float( renderResolution.GetResolutionState().renderHeight ) },
         .renderSize                 = { renderResolution.GetResolutionState().renderWidth, renderResolution.GetResolutionState().renderHeight },
@@ -0,0 +1,211 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "FinalImageReadback.h"
+
+#include "RgException.h"
+
+#include <format>
+
+RTGL1::FinalImageReadback::FinalImageReadback( VkDevice                           _device,
+                                               std::shared_ptr< MemoryAllocator > _allocator )
+    : device( _device ), allocator( std::move( _allocator ) ), latestFrameIndex( UINT32_MAX )
+{
+}
+
+RTGL1::FinalImageReadback::~FinalImageReadback()
+{
+    for( Slot& s : slots )
+    {
+        s.buffer.Destroy();
+    }
+}
+
+void RTGL1::FinalImageReadback::Record( VkCommandBuffer cmd,
+                                        uint32_t        frameIndex,
+                                        uint32_t        frameId,
+                                        VkImage         srcImage,
+                                        VkImageLayout   srcImageLayout,
+                                        uint32_t        width,
+                                        uint32_t        height )
+{
+    assert( frameIndex < MAX_FRAMES_IN_FLIGHT );
+    assert( width > 0 && height > 0 );
+
+    Slot&              slot = slots[ frameIndex ];
+    const VkDeviceSize size = VkDeviceSize( width ) * height * 4;
+
+    // fence of the slot was already waited, so the buffer is not in use
+    if( slot.buffer.GetSize() != size )
+    {
+        slot.buffer.Destroy();
+        slot.buffer.Init( *allocator,
+                          size,
+                          VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                              VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                          "Final image readback" );
+    }
+
+    {
+        VkImageMemoryBarrier2KHR b = {
+            .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR,
+            .srcStageMask        = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR,
+            .srcAccessMask       = VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+            .dstStageMask        = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+            .dstAccessMask       = VK_ACCESS_2_TRANSFER_READ_BIT_KHR,
+            .oldLayout           = srcImageLayout,
+            .newLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image               = srcImage,
+            .subresourceRange    = { .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+                                     .baseMipLevel   = 0,
+                                     .levelCount     = 1,
+                                     .baseArrayLayer = 0,
+                                     .layerCount     = 1 },
+        };
+
+        VkDependencyInfoKHR dependencyInfo = {
+            .sType                   = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR,
+            .imageMemoryBarrierCount = 1,
+            .pImageMemoryBarriers    = &b,
+        };
+
+        svkCmdPipelineBarrier2KHR( cmd, &dependencyInfo );
+    }
+
+    VkBufferImageCopy region = {
+        .bufferOffset      = 0,
+        .bufferRowLength   = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource  = { .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+                               .mipLevel       = 0,
+                               .baseArrayLayer = 0,
+                               .layerCount     = 1 },
+        .imageOffset       = { 0, 0, 0 },
+        .imageExtent       = { width, height, 1 },
+    };
+
+    vkCmdCopyImageToBuffer( cmd,
+                            srcImage,
+                            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                            slot.buffer.GetBuffer(),
+                            1,
+                            &region );
+
+    {
+        VkImageMemoryBarrier2KHR ib = {
+            .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR,
+            .srcStageMask        = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+            .srcAccessMask       = VK_ACCESS_2_NONE_KHR,
+            .dstStageMask        = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR,
+            .dstAccessMask       = VK_ACCESS_2_NONE_KHR,
+            .oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .newLayout           = srcImageLayout,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image               = srcImage,
+            .subresourceRange    = { .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+                                     .baseMipLevel   = 0,
+                                     .levelCount     = 1,
+                                     .baseArrayLayer = 0,
+                                     .layerCount     = 1 },
+        };
+
+        // make the copy visible to the host after the fence
+        VkBufferMemoryBarrier2KHR bb = {
+            .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR,
+            .srcStageMask        = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+            .srcAccessMask       = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+            .dstStageMask        = VK_PIPELINE_STAGE_2_HOST_BIT_KHR,
+            .dstAccessMask       = VK_ACCESS_2_HOST_READ_BIT_KHR,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer              = slot.buffer.GetBuffer(),
+            .offset              = 0,
+            .size                = VK_WHOLE_SIZE,
+        };
+
+        VkDependencyInfoKHR dependencyInfo = {
+            .sType                    = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR,
+            .bufferMemoryBarrierCount = 1,
+            .pBufferMemoryBarriers    = &bb,
+            .imageMemoryBarrierCount  = 1,
+            .pImageMemoryBarriers     = &ib,
+        };
+
+        svkCmdPipelineBarrier2KHR( cmd, &dependencyInfo );
+    }
+
+    slot.width       = width;
+    slot.height      = height;
+    slot.frameId     = frameId;
+    latestFrameIndex = frameIndex;
+}
+
+void RTGL1::FinalImageReadback::Read( const RgReadbackFinalImageInfo& info,
+                                      const VkFence ( &frameFences )[ MAX_FRAMES_IN_FLIGHT ],
+                                      RgReadbackFinalImageResult* pResult )
+{
+    *pResult = {};
+
+    if( latestFrameIndex == UINT32_MAX )
+    {
+        return;
+    }
+
+    Slot& slot = slots[ latestFrameIndex ];
+
+    pResult->width   = slot.width;
+    pResult->height  = slot.height;
+    pResult->frameId = slot.frameId;
+
+    if( info.pDstPixels == nullptr )
+    {
+        return;
+    }
+
+    const VkDeviceSize size = slot.buffer.GetSize();
+
+    if( info.dstSize < size )
+    {
+        throw RgException( RG_RESULT_WRONG_FUNCTION_ARGUMENT,
+                           std::format( "dstSize must be at least {} bytes for {}x{} image",
+                                        size,
+                                        slot.width,
+                                        slot.height ) );
+    }
+
+    VkFence  fence = frameFences[ latestFrameIndex ];
+    VkResult r     = info.wait ? vkWaitForFences( device, 1, &fence, VK_TRUE, UINT64_MAX )
+                               : vkGetFenceStatus( device, fence );
+
+    if( r == VK_NOT_READY || r == VK_TIMEOUT )
+    {
+        return;
+    }
+    VK_CHECKERROR( r );
+
+    memcpy( info.pDstPixels, slot.buffer.Map(), size );
+    slot.buffer.Unmap();
+
+    pResult->ready = true;
+}
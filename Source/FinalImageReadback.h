@@ -0,0 +1,75 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Buffer.h"
+#include "Common.h"
+#include "MemoryAllocator.h"
+
+#include <array>
+
+namespace RTGL1
+{
+
+// Copies the final image of each frame to a host-visible buffer of the frame slot,
+// so it can be read after the frame's fence is signaled, without a separate submission.
+class FinalImageReadback
+{
+public:
+    FinalImageReadback( VkDevice device, std::shared_ptr< MemoryAllocator > allocator );
+    ~FinalImageReadback();
+
+    FinalImageReadback( const FinalImageReadback& other )                = delete;
+    FinalImageReadback( FinalImageReadback&& other ) noexcept            = delete;
+    FinalImageReadback& operator=( const FinalImageReadback& other )     = delete;
+    FinalImageReadback& operator=( FinalImageReadback&& other ) noexcept = delete;
+
+    // srcImage must have R8G8B8A8 format, and it's kept in srcImageLayout
+    void Record( VkCommandBuffer cmd,
+                 uint32_t        frameIndex,
+                 uint32_t        frameId,
+                 VkImage         srcImage,
+                 VkImageLayout   srcImageLayout,
+                 uint32_t        width,
+                 uint32_t        height );
+
+    // Copy the latest recorded image, frameFences are the fences of the frame slots
+    void Read( const RgReadbackFinalImageInfo& info,
+               const VkFence ( &frameFences )[ MAX_FRAMES_IN_FLIGHT ],
+               RgReadbackFinalImageResult* pResult );
+
+private:
+    struct Slot
+    {
+        Buffer   buffer;
+        uint32_t width   = 0;
+        uint32_t height  = 0;
+        uint32_t frameId = 0;
+    };
+
+    VkDevice                                 device;
+    std::shared_ptr< MemoryAllocator >       allocator;
+
+    std::array< Slot, MAX_FRAMES_IN_FLIGHT > slots;
+    uint32_t                                 latestFrameIndex;
+};
+
+}
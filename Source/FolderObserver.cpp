@@ -22,6 +22,15 @@
 
 #include "Const.h"
 
+#include <condition_variable>
+#include <mutex>
+
+#ifdef __linux__
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
 namespace fs = std::filesystem;
 
 namespace RTGL1
@@ -30,31 +39,24 @@ namespace
 {
     constexpr auto CHECK_FREQUENCY = std::chrono::milliseconds( 500 );
 
-    void InsertAllFolderFiles( std::deque< FolderObserver::DependentFile >& dst,
-                               const fs::path&                              folder )
+    using Clock = fs::file_time_type::clock;
+
+    template< typename Func >
+    void ForEachFolderFile( const fs::path& folder, Func&& onFile )
     {
-        if( !fs::exists( folder ) )
+        std::error_code ec;
+        if( !fs::is_directory( folder, ec ) )
         {
             return;
         }
 
-        for( const fs::directory_entry& entry : fs::directory_iterator( folder ) )
+        for( const fs::directory_entry& entry : fs::directory_iterator( folder, ec ) )
         {
-            if( entry.is_regular_file() )
+            if( entry.is_regular_file( ec ) )
             {
-                FileType type = MakeFileType( entry.path() );
-
-                if( type != FileType::Unknown )
-                {
-                    dst.push_back( FolderObserver::DependentFile{
-                        .type          = type,
-                        .path          = entry.path(),
-                        .pathHash      = std::hash< fs::path >{}( entry.path() ),
-                        .lastWriteTime = entry.last_write_time(),
-                    } );
-                }
+                onFile( entry );
             }
-            else if( entry.is_directory() )
+            else if( entry.is_directory( ec ) )
             {
                 // ignore
                 if( entry.path().filename() == TEXTURES_FOLDER_JUNCTION )
@@ -62,14 +64,26 @@ namespace
                     continue;
                 }
 
-                InsertAllFolderFiles( dst, entry.path() );
+                ForEachFolderFile( entry.path(), onFile );
             }
         }
     }
+
+    void PushAllFolderFiles( FolderObserver& self, const fs::path& folder )
+    {
+        ForEachFolderFile( folder, [ &self ]( const fs::directory_entry& entry ) {
+            FileType type = MakeFileType( entry.path() );
+
+            if( type != FileType::Unknown )
+            {
+                self.PushChange( type, entry.path() );
+            }
+        } );
+    }
 }
 }
 
-RTGL1::FolderObserver::FolderObserver( const fs::path &ovrdFolder )
+RTGL1::FolderObserver::FolderObserver( const fs::path& ovrdFolder )
 {
     foldersToCheck = {
         ovrdFolder / DATABASE_FOLDER,
@@ -78,50 +92,285 @@ RTGL1::FolderObserver::FolderObserver( const fs::path &ovrdFolder )
         ovrdFolder / TEXTURES_FOLDER,
         ovrdFolder / TEXTURES_FOLDER_DEV,
     };
+
+    watcher = std::jthread( [ this ]( std::stop_token stoken ) {
+#ifdef __linux__
+        if( WatchLoop_Inotify( stoken ) )
+        {
+            return;
+        }
+        // otherwise, fallback to polling
+#endif
+        WatchLoop_Polling( stoken );
+    } );
+}
+
+RTGL1::FolderObserver::~FolderObserver()
+{
+    watcher.request_stop();
+    if( watcher.joinable() )
+    {
+        watcher.join();
+    }
+
+    ChangedFile* c = changes.exchange( nullptr, std::memory_order_acquire );
+    while( c )
+    {
+        delete std::exchange( c, c->next );
+    }
 }
 
-void RTGL1::FolderObserver::RecheckFiles()
+void RTGL1::FolderObserver::PushChange( FileType type, const fs::path& path )
 {
-    if( Clock::now() - lastCheck < CHECK_FREQUENCY )
+    auto c = new ChangedFile{
+        .type = type,
+        .path = path,
+        .next = changes.load( std::memory_order_relaxed ),
+    };
+
+    while( !changes.compare_exchange_weak(
+        c->next, c, std::memory_order_release, std::memory_order_relaxed ) )
+    {
+    }
+}
+
+void RTGL1::FolderObserver::DispatchChanges()
+{
+    // fast path, if nothing was changed
+    if( changes.load( std::memory_order_relaxed ) == nullptr )
     {
         return;
     }
 
+    ChangedFile* c = changes.exchange( nullptr, std::memory_order_acquire );
 
-    std::deque< DependentFile > curAllFiles;
-    for( const fs::path &f : foldersToCheck )
+    // reverse, to dispatch in the order of pushing
+    ChangedFile* ordered = nullptr;
+    while( c )
     {
-        InsertAllFolderFiles( curAllFiles, f );
+        ChangedFile* next = c->next;
+        c->next           = ordered;
+        ordered           = c;
+        c                 = next;
+    }
+
+    // a file might be reported few times during one frame
+    rgl::unordered_set< fs::path > dispatched;
+
+    while( ordered )
+    {
+        if( !dispatched.contains( ordered->path ) )
+        {
+            CallSubsbribers( &IFileDependency::OnFileChanged, ordered->type, ordered->path );
+            dispatched.insert( ordered->path );
+        }
+
+        delete std::exchange( ordered, ordered->next );
     }
+}
+
+void RTGL1::FolderObserver::WatchLoop_Polling( std::stop_token stoken )
+{
+    using FileTimes = rgl::unordered_map< fs::path, fs::file_time_type >;
+
+    auto gatherAll = [ this ]() {
+        FileTimes all;
+        for( const fs::path& f : foldersToCheck )
+        {
+            ForEachFolderFile( f, [ &all ]( const fs::directory_entry& entry ) {
+                if( MakeFileType( entry.path() ) != FileType::Unknown )
+                {
+                    std::error_code ec;
+                    all[ entry.path() ] = entry.last_write_time( ec );
+                }
+            } );
+        }
+        return all;
+    };
 
+    FileTimes prevAllFiles = gatherAll();
 
-    for( const auto& cur : curAllFiles )
+    std::mutex                  mutex;
+    std::condition_variable_any cv;
+
+    while( !stoken.stop_requested() )
     {
-        bool foundInPrev = false;
+        {
+            auto lock = std::unique_lock( mutex );
+            cv.wait_for( lock, stoken, CHECK_FREQUENCY, []() { return false; } );
+        }
 
-        for( const auto& prev : prevAllFiles )
+        if( stoken.stop_requested() )
         {
-            // if file previously existed
-            if( cur.pathHash == prev.pathHash && cur.path == prev.path )
+            break;
+        }
+
+        FileTimes curAllFiles = gatherAll();
+
+        for( const auto& [ path, lastWriteTime ] : curAllFiles )
+        {
+            auto prev = prevAllFiles.find( path );
+
+            // if new file or was changed
+            if( prev == prevAllFiles.end() || prev->second != lastWriteTime )
             {
-                // if was changed
-                if( cur.lastWriteTime != prev.lastWriteTime )
+                PushChange( MakeFileType( path ), path );
+            }
+        }
+
+        prevAllFiles = std::move( curAllFiles );
+    }
+}
+
+#ifdef __linux__
+
+namespace RTGL1
+{
+namespace
+{
+    constexpr uint32_t INOTIFY_MASK = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR;
+
+    void AddWatchRecursive( int                                  inotifyFd,
+                            const fs::path&                      dir,
+                            rgl::unordered_map< int, fs::path >& watched )
+    {
+        if( dir.filename() == TEXTURES_FOLDER_JUNCTION )
+        {
+            return;
+        }
+
+        int wd = inotify_add_watch( inotifyFd, dir.c_str(), INOTIFY_MASK );
+        if( wd < 0 )
+        {
+            return;
+        }
+        watched[ wd ] = dir;
+
+        std::error_code ec;
+        for( const fs::directory_entry& entry : fs::directory_iterator( dir, ec ) )
+        {
+            if( entry.is_directory( ec ) )
+            {
+                AddWatchRecursive( inotifyFd, entry.path(), watched );
+            }
+        }
+    }
+}
+}
+
+bool RTGL1::FolderObserver::WatchLoop_Inotify( std::stop_token stoken )
+{
+    int inotifyFd = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+    if( inotifyFd < 0 )
+    {
+        return false;
+    }
+
+    rgl::unordered_map< int, fs::path > watched;
+
+    auto isWatched = [ &watched ]( const fs::path& dir ) {
+        return std::ranges::any_of( watched, [ &dir ]( const auto& w ) { return w.second == dir; } );
+    };
+
+    // folders might not exist at the start, so recheck them periodically
+    auto addMissingRoots = [ & ]( bool reportFiles ) {
+        for( const fs::path& f : foldersToCheck )
+        {
+            std::error_code ec;
+            if( fs::is_directory( f, ec ) && !isWatched( f ) )
+            {
+                AddWatchRecursive( inotifyFd, f, watched );
+
+                if( reportFiles )
                 {
-                    CallSubsbribers( &IFileDependency::OnFileChanged, cur.type, cur.path );
+                    PushAllFolderFiles( *this, f );
                 }
+            }
+        }
+    };
+
+    addMissingRoots( false );
+    auto lastRootsCheck = Clock::now();
+
+    while( !stoken.stop_requested() )
+    {
+        pollfd pfd = {
+            .fd      = inotifyFd,
+            .events  = POLLIN,
+            .revents = 0,
+        };
+
+        // timeout, to check the stop token
+        int r = poll( &pfd, 1, int( CHECK_FREQUENCY.count() ) );
+
+        if( r > 0 && ( pfd.revents & POLLIN ) )
+        {
+            alignas( inotify_event ) char buffer[ 16 * 1024 ];
+
+            ssize_t len;
+            while( ( len = read( inotifyFd, buffer, sizeof( buffer ) ) ) > 0 )
+            {
+                for( const char* ptr = buffer; ptr < buffer + len; )
+                {
+                    const auto* ev = reinterpret_cast< const inotify_event* >( ptr );
+                    ptr += sizeof( inotify_event ) + ev->len;
 
-                foundInPrev = true;
-                break;
+                    if( ev->mask & IN_Q_OVERFLOW )
+                    {
+                        // events were lost, report everything
+                        for( const fs::path& f : foldersToCheck )
+                        {
+                            PushAllFolderFiles( *this, f );
+                        }
+                        continue;
+                    }
+
+                    if( ev->mask & IN_IGNORED )
+                    {
+                        // watched folder was removed
+                        watched.erase( ev->wd );
+                        continue;
+                    }
+
+                    auto w = watched.find( ev->wd );
+                    if( w == watched.end() || ev->len == 0 )
+                    {
+                        continue;
+                    }
+
+                    fs::path path = w->second / ev->name;
+
+                    if( ev->mask & IN_ISDIR )
+                    {
+                        if( ev->mask & ( IN_CREATE | IN_MOVED_TO ) )
+                        {
+                            AddWatchRecursive( inotifyFd, path, watched );
+                            // files could be added before the watch
+                            PushAllFolderFiles( *this, path );
+                        }
+                    }
+                    else if( ev->mask & ( IN_CLOSE_WRITE | IN_MOVED_TO ) )
+                    {
+                        FileType type = MakeFileType( path );
+
+                        if( type != FileType::Unknown )
+                        {
+                            PushChange( type, path );
+                        }
+                    }
+                }
             }
         }
 
-        // if new file
-        if( !foundInPrev )
+        if( Clock::now() - lastRootsCheck >= CHECK_FREQUENCY )
         {
-            CallSubsbribers( &IFileDependency::OnFileChanged, cur.type, cur.path );
+            addMissingRoots( true );
+            lastRootsCheck = Clock::now();
         }
     }
 
-    prevAllFiles = std::move( curAllFiles );
-    lastCheck    = Clock::now();
+    close( inotifyFd );
+    return true;
 }
+
+#endif // __linux__
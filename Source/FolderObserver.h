@@ -23,24 +23,29 @@
 #include "Containers.h"
 #include "IFileDependency.h"
 
-#include <deque>
+#include <atomic>
 #include <filesystem>
+#include <thread>
 
 namespace RTGL1
 {
 
+// Watches the folders on a background thread: inotify on Linux,
+// periodic polling otherwise. Changes are dispatched on DispatchChanges.
 class FolderObserver
 {
 public:
     explicit FolderObserver( const std::filesystem::path& ovrdFolder );
-    ~FolderObserver() = default;
+    ~FolderObserver();
 
     FolderObserver( const FolderObserver& other )                = delete;
     FolderObserver( FolderObserver&& other ) noexcept            = delete;
     FolderObserver& operator=( const FolderObserver& other )     = delete;
     FolderObserver& operator=( FolderObserver&& other ) noexcept = delete;
 
-    void RecheckFiles();
+    // Call subscribers for files that were changed since the last call.
+    // Must be called from the thread that owns subscribers.
+    void DispatchChanges();
 
     void Subscribe( const std::shared_ptr< IFileDependency >& subscriber )
     {
@@ -48,28 +53,29 @@ public:
     }
 
 public:
-    using Clock = std::filesystem::file_time_type::clock;
-
-    struct DependentFile
+    struct ChangedFile
     {
         FileType              type;
         std::filesystem::path path;
-        uint64_t              pathHash;
-        Clock::time_point     lastWriteTime;
-
-        friend std::strong_ordering operator<=>( const DependentFile& a,
-                                                 const DependentFile& b ) noexcept
-        {
-            // only path
-            return a.path <=> b.path;
-        }
+        ChangedFile*          next;
     };
 
+    // Called by the watcher thread
+    void PushChange( FileType type, const std::filesystem::path& path );
+
+private:
+    void WatchLoop_Polling( std::stop_token stoken );
+#ifdef __linux__
+    bool WatchLoop_Inotify( std::stop_token stoken );
+#endif
+
 private:
     std::vector< std::filesystem::path > foldersToCheck;
 
-    Clock::time_point           lastCheck;
-    std::deque< DependentFile > prevAllFiles;
+    // Lock-free list: pushed by the watcher thread, taken all at once in DispatchChanges
+    std::atomic< ChangedFile* > changes{ nullptr };
+
+    std::jthread watcher;
 
     std::vector< std::weak_ptr< IFileDependency > > subscribers;
 
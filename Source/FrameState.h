@@ -77,6 +77,13 @@ public:
         frameCmd = cmd;
     }
 
+    // If the frame's work was split into several submissions
+    void OnCmdBufferChange( VkCommandBuffer cmd )
+    {
+        assert( frameCmd != VK_NULL_HANDLE && cmd != VK_NULL_HANDLE );
+        frameCmd = cmd;
+    }
+
     void OnEndFrame()
     {
         assert( frameCmd != VK_NULL_HANDLE );
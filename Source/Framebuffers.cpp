@@ -26,6 +26,7 @@ using namespace RTGL1;
 #include "Utils.h"
 #include "CmdLabel.h"
 
+#include <algorithm>
 #include <vector>
 
 static_assert( MAX_FRAMES_IN_FLIGHT == FRAMEBUFFERS_HISTORY_LENGTH,
@@ -52,14 +53,17 @@ FramebufferImageIndex Framebuffers::FrameIndexToFBIndex(
 Framebuffers::Framebuffers( VkDevice                                _device,
                             std::shared_ptr< MemoryAllocator >      _allocator,
                             std::shared_ptr< CommandBufferManager > _cmdManager,
-                            const RgInstanceCreateInfo&             info )
+                            const RgInstanceCreateInfo&             info,
+                            bool                                    aliasTransientImages )
     : device( _device )
     , effectWipeIsUsed( info.effectWipeIsUsed )
+    , aliasTransient( aliasTransientImages )
     , bilinearSampler( VK_NULL_HANDLE )
     , nearestSampler( VK_NULL_HANDLE )
     , allocator( std::move( _allocator ) )
     , cmdManager( std::move( _cmdManager ) )
     , currentResolution{}
+    , allocatedResolution{}
     , descSetLayout( VK_NULL_HANDLE )
     , descPool( VK_NULL_HANDLE )
     , descSets{}
@@ -213,9 +217,18 @@ void RTGL1::Framebuffers::CreateSamplers()
     }
 }
 
-bool RTGL1::Framebuffers::PrepareForSize( ResolutionState resolutionState )
+bool RTGL1::Framebuffers::PrepareForSize( ResolutionState resolutionState,
+                                          ResolutionState maxResolutionState )
 {
-    if( currentResolution == resolutionState )
+    assert( resolutionState.renderWidth <= maxResolutionState.renderWidth &&
+            resolutionState.renderHeight <= maxResolutionState.renderHeight );
+    assert( resolutionState.upscaledWidth == maxResolutionState.upscaledWidth &&
+            resolutionState.upscaledHeight == maxResolutionState.upscaledHeight );
+
+    // passes only use the render area, so a smaller size doesn't require new images
+    currentResolution = resolutionState;
+
+    if( allocatedResolution == maxResolutionState )
     {
         return false;
     }
@@ -223,12 +236,63 @@ bool RTGL1::Framebuffers::PrepareForSize( ResolutionState resolutionState )
     vkDeviceWaitIdle( device );
 
     DestroyImages();
-    CreateImages( resolutionState );
+    CreateImages( maxResolutionState );
 
-    assert( currentResolution == resolutionState );
+    assert( allocatedResolution == maxResolutionState );
     return true;
 }
 
+void RTGL1::Framebuffers::BeginPhase( VkCommandBuffer cmd, FramebufferPassPhase phase )
+{
+    if( aliasedImages.empty() )
+    {
+        return;
+    }
+
+    std::vector< VkImageMemoryBarrier2KHR > barriers;
+
+    for( FramebufferImageIndex i : aliasedImages )
+    {
+        if( ShFramebuffers_LifetimeFirstPhase[ i ] != phase )
+        {
+            continue;
+        }
+
+        // previous contents belong to another image, wait for all of its accesses,
+        // including the ones from the previous frame
+        barriers.push_back( VkImageMemoryBarrier2KHR{
+            .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR,
+            .srcStageMask        = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR,
+            .srcAccessMask       = VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+            .dstStageMask        = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR,
+            .dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+            .oldLayout     = VK_IMAGE_LAYOUT_UNDEFINED,
+            .newLayout     = VK_IMAGE_LAYOUT_GENERAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image               = images[ i ],
+            .subresourceRange    = { .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+                                     .baseMipLevel   = 0,
+                                     .levelCount     = 1,
+                                     .baseArrayLayer = 0,
+                                     .layerCount     = 1 },
+        } );
+    }
+
+    if( barriers.empty() )
+    {
+        return;
+    }
+
+    VkDependencyInfoKHR dependencyInfo = {
+        .sType                   = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR,
+        .imageMemoryBarrierCount = uint32_t( barriers.size() ),
+        .pImageMemoryBarriers    = barriers.data(),
+    };
+
+    svkCmdPipelineBarrier2KHR( cmd, &dependencyInfo );
+}
+
 void RTGL1::Framebuffers::BarrierOne( VkCommandBuffer       cmd,
                                       uint32_t              frameIndex,
                                       FramebufferImageIndex framebufImageIndex,
@@ -703,6 +767,8 @@ void Framebuffers::CreateImages( ResolutionState resolutionState )
 {
     VkCommandBuffer cmd = cmdManager->StartGraphicsCmd();
 
+    std::vector< uint32_t > transient;
+
     for( uint32_t i = 0; i < ShFramebuffers_Count; i++ )
     {
         VkFormat              format = ShFramebuffers_Formats[ i ];
@@ -745,6 +811,13 @@ void Framebuffers::CreateImages( ResolutionState resolutionState )
                 device, images[ i ], VK_OBJECT_TYPE_IMAGE, ShFramebuffers_DebugNames[ i ] );
         }
 
+        // transient images are bound after all of them are created
+        if( aliasTransient && ShFramebuffers_LifetimeFirstPhase[ i ] != FB_LIFETIME_PERSISTENT )
+        {
+            transient.push_back( i );
+            continue;
+        }
+
         // allocate dedicated memory
         {
             VkMemoryRequirements memReqs;
@@ -758,6 +831,13 @@ void Framebuffers::CreateImages( ResolutionState resolutionState )
             VkResult r = vkBindImageMemory( device, images[ i ], imageMemories[ i ], 0 );
             VK_CHECKERROR( r );
         }
+    }
+
+    AllocateTransientMemory( transient );
+
+    for( uint32_t i = 0; i < ShFramebuffers_Count; i++ )
+    {
+        VkFormat format = ShFramebuffers_Formats[ i ];
 
         // create image view
         {
@@ -795,7 +875,7 @@ void Framebuffers::CreateImages( ResolutionState resolutionState )
     cmdManager->Submit( cmd );
     cmdManager->WaitGraphicsIdle();
 
-    currentResolution = resolutionState;
+    allocatedResolution = resolutionState;
 
 
     UpdateDescriptors();
@@ -882,6 +962,93 @@ void Framebuffers::UpdateDescriptors()
     vkUpdateDescriptorSets( device, wrtCount, writes.data(), 0, nullptr );
 }
 
+void Framebuffers::AllocateTransientMemory( const std::vector< uint32_t >& transient )
+{
+    assert( aliasedMemories.empty() && aliasedImages.empty() );
+
+    struct Slot
+    {
+        VkMemoryRequirements    memReqs;
+        uint32_t                phaseMask;
+        std::vector< uint32_t > fbIndices;
+    };
+
+    auto toPhaseMask = []( uint32_t fbIndex ) {
+        uint32_t first = ShFramebuffers_LifetimeFirstPhase[ fbIndex ];
+        uint32_t last  = ShFramebuffers_LifetimeLastPhase[ fbIndex ];
+        assert( first <= last && last < FB_PASS_PHASE_COUNT );
+
+        return ( ( 1u << ( last + 1 ) ) - 1 ) & ~( ( 1u << first ) - 1 );
+    };
+
+    std::vector< VkMemoryRequirements > memReqs( transient.size() );
+    std::vector< uint32_t >             order( transient.size() );
+
+    for( uint32_t k = 0; k < transient.size(); k++ )
+    {
+        vkGetImageMemoryRequirements( device, images[ transient[ k ] ], &memReqs[ k ] );
+        order[ k ] = k;
+    }
+
+    // largest first, so smaller images fill already allocated slots
+    std::ranges::sort( order, [ &memReqs ]( uint32_t a, uint32_t b ) {
+        return memReqs[ a ].size > memReqs[ b ].size;
+    } );
+
+    std::vector< Slot > slots;
+
+    for( uint32_t k : order )
+    {
+        const VkMemoryRequirements& req  = memReqs[ k ];
+        const uint32_t              mask = toPhaseMask( transient[ k ] );
+
+        auto found = std::ranges::find_if( slots, [ & ]( const Slot& slot ) {
+            return ( slot.phaseMask & mask ) == 0 &&
+                   ( slot.memReqs.memoryTypeBits & req.memoryTypeBits ) != 0;
+        } );
+
+        if( found == slots.end() )
+        {
+            slots.push_back( Slot{
+                .memReqs   = req,
+                .phaseMask = mask,
+                .fbIndices = { transient[ k ] },
+            } );
+        }
+        else
+        {
+            found->memReqs.size = std::max( found->memReqs.size, req.size );
+            found->memReqs.alignment = std::max( found->memReqs.alignment, req.alignment );
+            found->memReqs.memoryTypeBits &= req.memoryTypeBits;
+            found->phaseMask |= mask;
+            found->fbIndices.push_back( transient[ k ] );
+        }
+    }
+
+    for( const Slot& slot : slots )
+    {
+        VkDeviceMemory memory = allocator->AllocDedicated(
+            slot.memReqs,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            MemoryAllocator::AllocType::DEFAULT,
+            slot.fbIndices.size() > 1 ? "Framebuf aliased memory"
+                                      : ShFramebuffers_DebugNames[ slot.fbIndices[ 0 ] ] );
+        aliasedMemories.push_back( memory );
+
+        for( uint32_t i : slot.fbIndices )
+        {
+            VkResult r = vkBindImageMemory( device, images[ i ], memory, 0 );
+            VK_CHECKERROR( r );
+
+            // an image that has its own memory keeps its contents
+            if( slot.fbIndices.size() > 1 )
+            {
+                aliasedImages.push_back( static_cast< FramebufferImageIndex >( i ) );
+            }
+        }
+    }
+}
+
 void Framebuffers::DestroyImages()
 {
     for( auto& i : images )
@@ -902,6 +1069,13 @@ void Framebuffers::DestroyImages()
         }
     }
 
+    for( VkDeviceMemory m : aliasedMemories )
+    {
+        vkFreeMemory( device, m, nullptr );
+    }
+    aliasedMemories.clear();
+    aliasedImages.clear();
+
     for( auto& v : imageViews )
     {
         if( v != VK_NULL_HANDLE )
@@ -44,7 +44,8 @@ public:
     explicit Framebuffers( VkDevice                                device,
                            std::shared_ptr< MemoryAllocator >      allocator,
                            std::shared_ptr< CommandBufferManager > cmdManager,
-                           const RgInstanceCreateInfo&             info );
+                           const RgInstanceCreateInfo&             info,
+                           bool                                    aliasTransientImages );
     ~Framebuffers();
 
     Framebuffers( const Framebuffers& other )     = delete;
@@ -52,7 +53,16 @@ public:
     Framebuffers& operator=( const Framebuffers& other ) = delete;
     Framebuffers& operator=( Framebuffers&& other ) noexcept = delete;
 
-    bool          PrepareForSize( ResolutionState resolutionState );
+    // Images are allocated for maxResolutionState, and resolutionState defines
+    // the part of them that is used. Images are recreated only if maxResolutionState
+    // is changed, returns true in that case.
+    bool          PrepareForSize( ResolutionState resolutionState,
+                                  ResolutionState maxResolutionState );
+
+    // Must be called at the start of each pass phase in a frame, in order.
+    // Transient images that share memory and whose lifetime starts at this phase
+    // are transitioned from the undefined layout, as their contents were overwritten.
+    void          BeginPhase( VkCommandBuffer cmd, FramebufferPassPhase phase );
 
     enum class BarrierType
     {
@@ -111,6 +121,7 @@ private:
     void                         CreateSamplers();
 
     void                         CreateImages( ResolutionState resolutionState );
+    void                         AllocateTransientMemory( const std::vector< uint32_t >& transient );
     void                         UpdateDescriptors();
 
     VkExtent2D                   GetFramebufSize( const ResolutionState& resolutionState,
@@ -123,6 +134,7 @@ private:
 private:
     VkDevice                                              device;
     bool                                                  effectWipeIsUsed;
+    bool                                                  aliasTransient;
 
     VkSampler                                             bilinearSampler;
     VkSampler                                             nearestSampler;
@@ -131,11 +143,16 @@ private:
     std::shared_ptr< CommandBufferManager >               cmdManager;
 
     ResolutionState                                       currentResolution;
+    ResolutionState                                       allocatedResolution;
 
     std::vector< VkImage >                                images;
     std::vector< VkDeviceMemory >                         imageMemories;
     std::vector< VkImageView >                            imageViews;
 
+    // memory shared by transient images with non-overlapping lifetimes
+    std::vector< VkDeviceMemory >                         aliasedMemories;
+    std::vector< FramebufferImageIndex >                  aliasedImages;
+
     VkDescriptorSetLayout                                 descSetLayout;
     VkDescriptorPool                                      descPool;
     VkDescriptorSet                                       descSets[ FRAMEBUFFERS_HISTORY_LENGTH ];
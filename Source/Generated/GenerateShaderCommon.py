@@ -236,7 +236,9 @@ CONST = {
     # used for first-person geometries
     "LOWER_BOTTOM_LEVEL_GEOMETRIES_COUNT"   : 1 << 8,
     
-    "MAX_TOP_LEVEL_INSTANCE_COUNT"          : 45,
+    "MAX_TOP_LEVEL_INSTANCE_COUNT"          : 1 << 16,
+    # geometry infos for static world geometry, includes instanced meshes
+    "MAX_STATIC_BOTTOM_LEVEL_GEOMETRIES_COUNT" : 1 << 14,
     
     "BINDING_VERTEX_BUFFER_STATIC"              : 0,
     "BINDING_VERTEX_BUFFER_DYNAMIC"             : 1,
@@ -252,6 +254,7 @@ CONST = {
     "BINDING_DYNAMIC_TEXCOORD_LAYER_1"          : 11,
     "BINDING_DYNAMIC_TEXCOORD_LAYER_2"          : 12,
     "BINDING_DYNAMIC_TEXCOORD_LAYER_3"          : 13,
+    "BINDING_TLAS_INSTANCES"                    : 14,
     "BINDING_GLOBAL_UNIFORM"                    : 0,
     "BINDING_ACCELERATION_STRUCTURE_MAIN"       : 0,
     "BINDING_TEXTURES"                          : 0,
@@ -265,9 +268,11 @@ CONST = {
     "BINDING_LIGHT_SOURCES_INDEX_CUR_TO_PREV"   : 3,
     "BINDING_INITIAL_LIGHTS_GRID"               : 4,
     "BINDING_INITIAL_LIGHTS_GRID_PREV"          : 5,
+    "BINDING_LIGHT_TREE_NODES"                  : 6,
     "BINDING_LENS_FLARES_CULLING_INPUT"         : 0,
     "BINDING_LENS_FLARES_DRAW_CMDS"             : 1,
     "BINDING_DRAW_LENS_FLARES_INSTANCES"        : 0,
+    "BINDING_RASTERIZED_DRAWS"                  : 0,
     "BINDING_DECAL_INSTANCES"                   : 0,
     "BINDING_PORTAL_INSTANCES"                  : 0,
     "BINDING_LPM_PARAMS"                        : 0,
@@ -433,9 +438,16 @@ CONST = {
     "LIGHT_GRID_CELL_SIZE"                  : 128,
     "COMPUTE_LIGHT_GRID_GROUP_SIZE_X"       : 256,
 
+    "LIGHT_TREE_NODE_LEAF_BIT"              : BIT( 31 ),
+    "LIGHT_TREE_MAX_DEPTH"                  : 32,
+
     "PORTAL_INDEX_NONE"                     : 63,
     "PORTAL_MAX_COUNT"                      : 63,
 
+    "RT_FEATURE_PORTALS"                    : BIT( 0 ),
+    "RT_FEATURE_ILLUMINATION_VOLUME"        : BIT( 1 ),
+    "RT_FEATURE_LIGHT_TREE"                 : BIT( 2 ),
+
     "PACKED_INDIRECT_SAMPLE_SIZE_IN_WORDS"    : 6,
     "PACKED_INDIRECT_RESERVOIR_SIZE_IN_WORDS" : 8,
 
@@ -498,6 +510,16 @@ VERTEX_STRUCT = [
     (TYPE_UINT32,       1,     "_padding",              1),
 ]
 
+# Optional layout for static geometry: octahedral normal in 2x snorm16, texCoord in 2x half;
+# position is kept in floats for the BLAS build. Tangents are not stored, as
+# they're calculated per triangle.
+VERTEX_COMPACT_STRUCT = [
+    (TYPE_FLOAT32,      1,     "position",              3),
+    (TYPE_UINT32,       1,     "normalPacked",          1),
+    (TYPE_UINT32,       1,     "texCoordPacked",        1),
+    (TYPE_UINT32,       1,     "color",                 1),
+]
+
 # Must be careful with std140 offsets! They are set manually.
 # Other structs are using std430 and padding is done automatically.
 GLOBAL_UNIFORM_STRUCT = [
@@ -590,7 +612,7 @@ GLOBAL_UNIFORM_STRUCT = [
 
     (TYPE_UINT32,       1,      "rayCullMaskWorld_Shadow",          1),
     (TYPE_UINT32,       1,      "volumeAllowTintUnderwater",        1),
-    (TYPE_UINT32,       1,      "_unused2",                         1),
+    (TYPE_UINT32,       1,      "lightTreeNodeCount",               1),
     (TYPE_UINT32,       1,      "twirlPortalNormal",                1),
 
     (TYPE_UINT32,       1,      "lightIndexIgnoreFPVShadows",       1),
@@ -613,15 +635,21 @@ GLOBAL_UNIFORM_STRUCT = [
     (TYPE_FLOAT32,      1,      "volumeFallbackSrcExists",          1),
     (TYPE_FLOAT32,      1,      "volumeLightMult",                  1),
 
+    (TYPE_UINT32,       1,      "staticVerticesCompact",            1),
+    (TYPE_FLOAT32,      1,      "prevRenderWidth",                  1),
+    (TYPE_FLOAT32,      1,      "prevRenderHeight",                 1),
+    (TYPE_FLOAT32,      1,      "maxRenderWidth",                   1),
+
+    (TYPE_FLOAT32,      1,      "maxRenderHeight",                  1),
+    (TYPE_UINT32,       1,      "_unused0",                         1),
+    (TYPE_UINT32,       1,      "_unused1",                         1),
+    (TYPE_UINT32,       1,      "_unused2",                         1),
+
     #(TYPE_FLOAT32,      1,      "_pad0",                            1),
     #(TYPE_FLOAT32,      1,      "_pad1",                            1),
     #(TYPE_FLOAT32,      1,      "_pad2",                            1),
     #(TYPE_FLOAT32,      1,      "_pad3",                            1),
 
-    # for std140
-    (TYPE_INT32,        4,      "instanceGeomInfoOffset",       align4(CONST["MAX_TOP_LEVEL_INSTANCE_COUNT"]) // 4),
-    (TYPE_INT32,        4,      "instanceGeomInfoOffsetPrev",   align4(CONST["MAX_TOP_LEVEL_INSTANCE_COUNT"]) // 4),
-    (TYPE_INT32,        4,      "instanceGeomCount",            align4(CONST["MAX_TOP_LEVEL_INSTANCE_COUNT"]) // 4),
     (TYPE_FLOAT32,     44,      "viewProjCubemap",              6),
     (TYPE_FLOAT32,     44,      "skyCubemapRotationTransform",  1),
 ]
@@ -687,14 +715,32 @@ LIGHT_IN_CELL = [
     (TYPE_FLOAT32,      1,      "weightSum",            1),
 ]
 
+# node of a light BVH; left child is next to its parent,
+# so only the right one is stored; leaf stores a light index with LIGHT_TREE_NODE_LEAF_BIT
+LIGHT_TREE_NODE_STRUCT = [
+    (TYPE_FLOAT32,      3,      "aabbMin",              1),
+    (TYPE_FLOAT32,      1,      "power",                1),
+    (TYPE_FLOAT32,      3,      "aabbMax",              1),
+    (TYPE_UINT32,       1,      "rightChildOrLight",    1),
+    (TYPE_FLOAT32,      3,      "coneAxis",             1),
+    (TYPE_FLOAT32,      1,      "coneCosAngle",         1),
+]
+
 TONEMAPPING_STRUCT = [
     (TYPE_UINT32,       1,      "histogram",            CONST["COMPUTE_LUM_HISTOGRAM_BIN_COUNT"]),
     (TYPE_FLOAT32,      1,      "avgLuminance",         1),
 ]
 
+# geometry infos of a TLAS instance: geometryInstances[geomInfoOffset + gl_GeometryIndexEXT]
+TLAS_INSTANCE_STRUCT = [
+    (TYPE_INT32,        1,      "geomInfoOffset",       1),
+    (TYPE_INT32,        1,      "geomInfoOffsetPrev",   1),
+    (TYPE_INT32,        1,      "geomCount",            1),
+    (TYPE_UINT32,       1,      "isDynamic",            1),
+]
+
 VERT_PREPROC_PUSH_STRUCT = [
     (TYPE_UINT32,       1,      "tlasInstanceCount",            1),
-    (TYPE_UINT32,       1,      "tlasInstanceIsDynamicBits",    align(CONST["MAX_TOP_LEVEL_INSTANCE_COUNT"], 32) // 32),
 ]
 
 INDIRECT_DRAW_CMD_STRUCT = [
@@ -715,6 +761,17 @@ LENS_FLARES_INSTANCE_STRUCT = [
     (TYPE_FLOAT32,      1,      "emissiveMult",         1),
 ]
 
+RASTERIZED_DRAW_STRUCT = [
+    (TYPE_FLOAT32,     44,      "model",                1),
+    (TYPE_FLOAT32,     44,      "viewProj",             1),
+    (TYPE_UINT32,       1,      "packedColor",          1),
+    (TYPE_UINT32,       1,      "textureIndex",         1),
+    (TYPE_UINT32,       1,      "emissiveTextureIndex", 1),
+    (TYPE_FLOAT32,      1,      "emissiveMult",         1),
+    # if 0, default view-projection from push constants is used
+    (TYPE_UINT32,       1,      "useViewProj",          1),
+]
+
 DECAL_INSTANCE_STRUCT = [
     (TYPE_FLOAT32,     44,      "transform",                            1),
     (TYPE_UINT32,       1,      "textureAlbedoAlpha",                   1),
@@ -744,15 +801,20 @@ STRUCT_BREAK_TYPE_ONLY_C    = 2
 #                      it'll be represented as an array of primitive types
 STRUCTS = {
     "ShVertex":                 (VERTEX_STRUCT,                 False,  STRUCT_ALIGNMENT_STD430,    0),
+    # no padding to 16 bytes, members are 4-byte aligned in std430, so the array stride is 24
+    "ShVertexCompact":          (VERTEX_COMPACT_STRUCT,         False,  0,                          0),
     "ShGlobalUniform":          (GLOBAL_UNIFORM_STRUCT,         False,  STRUCT_ALIGNMENT_STD140,    STRUCT_BREAK_TYPE_ONLY_C),
     "ShGeometryInstance":       (GEOM_INSTANCE_STRUCT,          False,  STRUCT_ALIGNMENT_STD430,    0),
+    "ShTlasInstance":           (TLAS_INSTANCE_STRUCT,          False,  STRUCT_ALIGNMENT_STD430,    0),
     "ShTonemapping":            (TONEMAPPING_STRUCT,            False,  0,                          0),
     "ShLightEncoded":           (LIGHT_ENCODED_STRUCT,          False,  STRUCT_ALIGNMENT_STD430,    0),
     "ShLightInCell":            (LIGHT_IN_CELL,                 False,  STRUCT_ALIGNMENT_STD430,    0),
+    "ShLightTreeNode":          (LIGHT_TREE_NODE_STRUCT,        False,  STRUCT_ALIGNMENT_STD430,    0),
     "ShVertPreprocessing":      (VERT_PREPROC_PUSH_STRUCT,      False,  0,                          0),
     "ShIndirectDrawCommand":    (INDIRECT_DRAW_CMD_STRUCT,      False,  STRUCT_ALIGNMENT_STD430,    0),
     # TODO: should be STRUCT_ALIGNMENT_STD430, but current generator is not great as it just adds pads at the end, so it's 0
     "ShLensFlareInstance":      (LENS_FLARES_INSTANCE_STRUCT,   False,  0,                          0),
+    "ShRasterizedDraw":         (RASTERIZED_DRAW_STRUCT,        False,  STRUCT_ALIGNMENT_STD430,    0),
     "ShDecalInstance":          (DECAL_INSTANCE_STRUCT,         False,  STRUCT_ALIGNMENT_STD430,    0),
     "ShPortalInstance":         (PORTAL_INSTANCE_STRUCT,        False,  STRUCT_ALIGNMENT_STD140,    0),
 }
@@ -887,6 +949,68 @@ if GRADIENT_ESTIMATION_ENABLED:
     })
 
 
+# Frame is split into coarse pass phases, in the order they are recorded.
+# A framebuf that is written and read only within [first phase, last phase]
+# of the same frame is transient: its memory can be aliased with other transient
+# framebufs whose lifetimes don't overlap. Framebufs that are not listed here
+# are persistent, i.e. they carry data between frames (STORE_PREV, histories)
+# or are accessed outside of the phased part of a frame (attachments, upscaled).
+FRAMEBUF_PASS_PHASES = [
+    "Primary",          # primary rays, decals, reflections / refractions
+    "Lighting",         # initial reservoirs, direct, indirect, volumetric
+    "Denoise",          # gradients, temporal accumulation, atrous
+    "Compose",          # scattering, exposure, checkerboard, rasterization, finalize
+    "Postprocess",      # bloom, upscaling, effects
+]
+
+FRAMEBUF_LIFETIME_PERSISTENT = "FB_LIFETIME_PERSISTENT"
+
+FRAMEBUF_LIFETIMES = {
+    # (image name)                      : (first phase,     last phase)
+    "PrimaryToReflRefr"                 : ("Primary",       "Primary"),
+    "NormalDecal"                       : ("Primary",       "Primary"),
+    "DepthGrad"                         : ("Primary",       "Denoise"),
+    "Throughput"                        : ("Primary",       "Compose"),
+    "ScreenEmisRT"                      : ("Primary",       "Compose"),
+    "AcidFogRT"                         : ("Primary",       "Compose"),
+
+    "ReservoirsInitial"                 : ("Lighting",      "Lighting"),
+    # read in Compose by debug views
+    "UnfilteredDirect"                  : ("Lighting",      "Compose"),
+    "UnfilteredSpecular"                : ("Lighting",      "Compose"),
+    "UnfilteredIndir"                   : ("Lighting",      "Compose"),
+
+    "DiffTemporary"                     : ("Denoise",       "Denoise"),
+    "DiffPingColorAndVariance"          : ("Denoise",       "Denoise"),
+    "DiffPongColorAndVariance"          : ("Denoise",       "Denoise"),
+    "SpecPingColor"                     : ("Denoise",       "Denoise"),
+    "SpecPongColor"                     : ("Denoise",       "Denoise"),
+    "IndirPing"                         : ("Denoise",       "Denoise"),
+    "IndirPong"                         : ("Denoise",       "Denoise"),
+    "AtrousFilteredVariance"            : ("Denoise",       "Denoise"),
+    "HistogramInput"                    : ("Denoise",       "Compose"),
+    "PreFinal"                          : ("Denoise",       "Compose"),
+
+    "BloomInput"                        : ("Compose",       "Postprocess"),
+    "Bloom_Mip1"                        : ("Postprocess",   "Postprocess"),
+    "Bloom_Mip2"                        : ("Postprocess",   "Postprocess"),
+    "Bloom_Mip3"                        : ("Postprocess",   "Postprocess"),
+    "Bloom_Mip4"                        : ("Postprocess",   "Postprocess"),
+    "Bloom_Mip5"                        : ("Postprocess",   "Postprocess"),
+    "Bloom_Mip6"                        : ("Postprocess",   "Postprocess"),
+    "Bloom_Mip7"                        : ("Postprocess",   "Postprocess"),
+    "Bloom_Mip8"                        : ("Postprocess",   "Postprocess"),
+    "Bloom_Result"                      : ("Postprocess",   "Postprocess"),
+}
+
+if GRADIENT_ESTIMATION_ENABLED:
+    FRAMEBUF_LIFETIMES.update({
+        # read in Compose by debug views
+        "DISPingGradient"               : ("Denoise",       "Compose"),
+        "DISPongGradient"               : ("Denoise",       "Denoise"),
+    })
+
+
 # ---
 # User defined structs END
 # ---
@@ -1159,7 +1283,29 @@ def getAllFramebufConstants():
         for (flName, flValue) in FRAMEBUF_FLAGS_ENUM.items()
     ) + "\n};\ntypedef uint32_t FramebufferImageFlags;\n\n"
 
-    return fbConst + fbEnum + fbFlags
+    fbPhases = "enum FramebufferPassPhase\n{\n" + "\n".join(
+        "    FB_PASS_PHASE_%s = %d," % (capitalizeForEnum(s), i)
+        for i, s in enumerate(FRAMEBUF_PASS_PHASES)
+    ) + "\n    FB_PASS_PHASE_COUNT = %d,\n};\n" % len(FRAMEBUF_PASS_PHASES)
+    fbPhases += "#define " + FRAMEBUF_LIFETIME_PERSISTENT + " 0xFFFFFFFF\n\n"
+
+    return fbConst + fbEnum + fbFlags + fbPhases
+
+
+# returns (first phase, last phase) as strings for C, or persistent for both
+def getFramebufLifetime(name, flags):
+    if name not in FRAMEBUF_LIFETIMES:
+        return (FRAMEBUF_LIFETIME_PERSISTENT, FRAMEBUF_LIFETIME_PERSISTENT)
+
+    if flags & FRAMEBUF_FLAGS_STORE_PREV:
+        raise Exception("Framebuf \"" + name + "\" has STORE_PREV flag, so it can't be transient")
+
+    first, last = FRAMEBUF_LIFETIMES[name]
+    if FRAMEBUF_PASS_PHASES.index(first) > FRAMEBUF_PASS_PHASES.index(last):
+        raise Exception("Framebuf \"" + name + "\" has inverted lifetime")
+
+    return ("RTGL1::FB_PASS_PHASE_" + capitalizeForEnum(first),
+            "RTGL1::FB_PASS_PHASE_" + capitalizeForEnum(last))
 
 
 def getPublicFlags(flags):
@@ -1182,7 +1328,9 @@ def getAllVulkanFramebufDeclarations():
             "extern const uint32_t ShFramebuffers_BindingsSwapped[];\n"
             "extern const uint32_t ShFramebuffers_Sampler_Bindings[];\n"
             "extern const uint32_t ShFramebuffers_Sampler_BindingsSwapped[];\n"
-            "extern const char *const ShFramebuffers_DebugNames[];\n\n")
+            "extern const char *const ShFramebuffers_DebugNames[];\n"
+            "extern const uint32_t ShFramebuffers_LifetimeFirstPhase[];\n"
+            "extern const uint32_t ShFramebuffers_LifetimeLastPhase[];\n\n")
 
 
 def getAllVulkanFramebufDefinitions():
@@ -1193,7 +1341,9 @@ def getAllVulkanFramebufDefinitions():
                 "const uint32_t RTGL1::ShFramebuffers_BindingsSwapped[] = \n{\n%s};\n\n"
                 "const uint32_t RTGL1::ShFramebuffers_Sampler_Bindings[] = \n{\n%s};\n\n"
                 "const uint32_t RTGL1::ShFramebuffers_Sampler_BindingsSwapped[] = \n{\n%s};\n\n"
-                "const char *const RTGL1::ShFramebuffers_DebugNames[] = \n{\n%s};\n\n")
+                "const char *const RTGL1::ShFramebuffers_DebugNames[] = \n{\n%s};\n\n"
+                "const uint32_t RTGL1::ShFramebuffers_LifetimeFirstPhase[] = \n{\n%s};\n\n"
+                "const uint32_t RTGL1::ShFramebuffers_LifetimeLastPhase[] = \n{\n%s};\n\n")
     TAB_STR = "    "
     formats = ""
     count = 0
@@ -1204,10 +1354,18 @@ def getAllVulkanFramebufDefinitions():
     samplerBindings = ""
     samplerBindingsSwapped = ""
     names = ""
+    lifetimeFirst = ""
+    lifetimeLast = ""
+    for name in FRAMEBUF_LIFETIMES:
+        if name not in FRAMEBUFFERS:
+            raise Exception("Lifetime is specified for unknown framebuf \"" + name + "\"")
     for name, (baseFormat, components, flags) in FRAMEBUFFERS.items():
         formats += TAB_STR + VULKAN_IMAGE_FORMATS[(baseFormat, components)] + ",\n"
         names += TAB_STR + "\"" + FRAMEBUF_DEBUG_NAME_PREFIX + name + "\",\n"
         publicFlags += TAB_STR + getPublicFlags(flags) + ",\n"
+        first, last = getFramebufLifetime(name, flags)
+        lifetimeFirst += TAB_STR + first + ",\n"
+        lifetimeLast += TAB_STR + last + ",\n"
 
         if not flags & FRAMEBUF_FLAGS_STORE_PREV:
             bindings                += TAB_STR + str(count)         + ",\n"
@@ -1221,6 +1379,8 @@ def getAllVulkanFramebufDefinitions():
             formats += TAB_STR + VULKAN_IMAGE_FORMATS[(baseFormat, components)] + ",\n"
             names += TAB_STR + "\"" + FRAMEBUF_DEBUG_NAME_PREFIX + name + FRAMEBUF_STORE_PREV_POSTFIX + "\",\n"
             publicFlags += TAB_STR + getPublicFlags(flags) + ",\n"
+            lifetimeFirst += TAB_STR + first + ",\n"
+            lifetimeLast += TAB_STR + last + ",\n"
             count += 1
 
         count += 1
@@ -1244,7 +1404,7 @@ def getAllVulkanFramebufDefinitions():
 
         samplerCount += 1
 
-    return template % (count, formats, publicFlags, bindings, bindingsSwapped, samplerBindings, samplerBindingsSwapped, names)
+    return template % (count, formats, publicFlags, bindings, bindingsSwapped, samplerBindings, samplerBindingsSwapped, names, lifetimeFirst, lifetimeLast)
 
 
 FILE_HEADER = "// This file was generated by GenerateShaderCommon.py\n\n"
@@ -15,7 +15,8 @@ namespace RTGL1
 #define MAX_GEOMETRY_PRIMITIVE_COUNT (1048576)
 #define MAX_GEOMETRY_PRIMITIVE_COUNT_POW (20)
 #define LOWER_BOTTOM_LEVEL_GEOMETRIES_COUNT (256)
-#define MAX_TOP_LEVEL_INSTANCE_COUNT (45)
+#define MAX_TOP_LEVEL_INSTANCE_COUNT (65536)
+#define MAX_STATIC_BOTTOM_LEVEL_GEOMETRIES_COUNT (16384)
 #define BINDING_VERTEX_BUFFER_STATIC (0)
 #define BINDING_VERTEX_BUFFER_DYNAMIC (1)
 #define BINDING_INDEX_BUFFER_STATIC (2)
@@ -30,6 +31,7 @@ namespace RTGL1
 #define BINDING_DYNAMIC_TEXCOORD_LAYER_1 (11)
 #define BINDING_DYNAMIC_TEXCOORD_LAYER_2 (12)
 #define BINDING_DYNAMIC_TEXCOORD_LAYER_3 (13)
+#define BINDING_TLAS_INSTANCES (14)
 #define BINDING_GLOBAL_UNIFORM (0)
 #define BINDING_ACCELERATION_STRUCTURE_MAIN (0)
 #define BINDING_TEXTURES (0)
@@ -43,9 +45,11 @@ namespace RTGL1
 #define BINDING_LIGHT_SOURCES_INDEX_CUR_TO_PREV (3)
 #define BINDING_INITIAL_LIGHTS_GRID (4)
 #define BINDING_INITIAL_LIGHTS_GRID_PREV (5)
+#define BINDING_LIGHT_TREE_NODES (6)
 #define BINDING_LENS_FLARES_CULLING_INPUT (0)
 #define BINDING_LENS_FLARES_DRAW_CMDS (1)
 #define BINDING_DRAW_LENS_FLARES_INSTANCES (0)
+#define BINDING_RASTERIZED_DRAWS (0)
 #define BINDING_DECAL_INSTANCES (0)
 #define BINDING_PORTAL_INSTANCES (0)
 #define BINDING_LPM_PARAMS (0)
@@ -182,8 +186,13 @@ namespace RTGL1
 #define LIGHT_GRID_SIZE_Z (16)
 #define LIGHT_GRID_CELL_SIZE (128)
 #define COMPUTE_LIGHT_GRID_GROUP_SIZE_X (256)
+#define LIGHT_TREE_NODE_LEAF_BIT (1 << 31)
+#define LIGHT_TREE_MAX_DEPTH (32)
 #define PORTAL_INDEX_NONE (63)
 #define PORTAL_MAX_COUNT (63)
+#define RT_FEATURE_PORTALS (1 << 0)
+#define RT_FEATURE_ILLUMINATION_VOLUME (1 << 1)
+#define RT_FEATURE_LIGHT_TREE (1 << 2)
 #define PACKED_INDIRECT_SAMPLE_SIZE_IN_WORDS (6)
 #define PACKED_INDIRECT_RESERVOIR_SIZE_IN_WORDS (8)
 #define VOLUMETRIC_SIZE_X (160)
@@ -206,6 +215,14 @@ struct ShVertex
     uint32_t _padding;
 };
 
+struct ShVertexCompact
+{
+    float position[3];
+    uint32_t normalPacked;
+    uint32_t texCoordPacked;
+    uint32_t color;
+};
+
 struct ShGlobalUniform
 {
     float view[16];
@@ -278,7 +295,7 @@ struct ShGlobalUniform
     float primaryRayMinDist;
     uint32_t rayCullMaskWorld_Shadow;
     uint32_t volumeAllowTintUnderwater;
-    uint32_t _unused2;
+    uint32_t lightTreeNodeCount;
     uint32_t twirlPortalNormal;
     uint32_t lightIndexIgnoreFPVShadows;
     float gradientMultDiffuse;
@@ -296,9 +313,14 @@ struct ShGlobalUniform
     uint32_t volumeLightSourceIndex;
     float volumeFallbackSrcExists;
     float volumeLightMult;
-    int32_t instanceGeomInfoOffset[48];
-    int32_t instanceGeomInfoOffsetPrev[48];
-    int32_t instanceGeomCount[48];
+    uint32_t staticVerticesCompact;
+    float prevRenderWidth;
+    float prevRenderHeight;
+    float maxRenderWidth;
+    float maxRenderHeight;
+    uint32_t _unused0;
+    uint32_t _unused1;
+    uint32_t _unused2;
     float viewProjCubemap[96];
     float skyCubemapRotationTransform[16];
 };
@@ -341,6 +363,14 @@ struct ShGeometryInstance
     uint32_t _unused10;
 };
 
+struct ShTlasInstance
+{
+    int32_t geomInfoOffset;
+    int32_t geomInfoOffsetPrev;
+    int32_t geomCount;
+    uint32_t isDynamic;
+};
+
 struct ShTonemapping
 {
     uint32_t histogram[256];
@@ -364,10 +394,19 @@ struct ShLightInCell
     uint32_t __pad0;
 };
 
+struct ShLightTreeNode
+{
+    float aabbMin[3];
+    float power;
+    float aabbMax[3];
+    uint32_t rightChildOrLight;
+    float coneAxis[3];
+    float coneCosAngle;
+};
+
 struct ShVertPreprocessing
 {
     uint32_t tlasInstanceCount;
-    uint32_t tlasInstanceIsDynamicBits[2];
 };
 
 struct ShIndirectDrawCommand
@@ -390,6 +429,20 @@ struct ShLensFlareInstance
     float emissiveMult;
 };
 
+struct ShRasterizedDraw
+{
+    float model[16];
+    float viewProj[16];
+    uint32_t packedColor;
+    uint32_t textureIndex;
+    uint32_t emissiveTextureIndex;
+    float emissiveMult;
+    uint32_t useViewProj;
+    uint32_t __pad0;
+    uint32_t __pad1;
+    uint32_t __pad2;
+};
+
 struct ShDecalInstance
 {
     float transform[16];
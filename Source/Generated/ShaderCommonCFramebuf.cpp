@@ -564,3 +564,163 @@ const char *const RTGL1::ShFramebuffers_DebugNames[] =
     "Framebuf GradientPrevPix",
 };
 
+const uint32_t RTGL1::ShFramebuffers_LifetimeFirstPhase[] = 
+{
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_PRIMARY,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_LIGHTING,
+    RTGL1::FB_PASS_PHASE_LIGHTING,
+    RTGL1::FB_PASS_PHASE_LIGHTING,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_PRIMARY,
+    RTGL1::FB_PASS_PHASE_PRIMARY,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    RTGL1::FB_PASS_PHASE_PRIMARY,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_PRIMARY,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_PRIMARY,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_COMPOSE,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_LIGHTING,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+};
+
+const uint32_t RTGL1::ShFramebuffers_LifetimeLastPhase[] = 
+{
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_COMPOSE,
+    RTGL1::FB_PASS_PHASE_COMPOSE,
+    RTGL1::FB_PASS_PHASE_COMPOSE,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_PRIMARY,
+    RTGL1::FB_PASS_PHASE_COMPOSE,
+    RTGL1::FB_PASS_PHASE_COMPOSE,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    RTGL1::FB_PASS_PHASE_COMPOSE,
+    RTGL1::FB_PASS_PHASE_PRIMARY,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_COMPOSE,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_COMPOSE,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    RTGL1::FB_PASS_PHASE_POSTPROCESS,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_LIGHTING,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+    RTGL1::FB_PASS_PHASE_COMPOSE,
+    RTGL1::FB_PASS_PHASE_DENOISE,
+    FB_LIFETIME_PERSISTENT,
+    FB_LIFETIME_PERSISTENT,
+};
+
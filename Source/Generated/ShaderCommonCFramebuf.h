@@ -101,6 +101,17 @@ enum FramebufferImageFlagBits
 };
 typedef uint32_t FramebufferImageFlags;
 
+enum FramebufferPassPhase
+{
+    FB_PASS_PHASE_PRIMARY = 0,
+    FB_PASS_PHASE_LIGHTING = 1,
+    FB_PASS_PHASE_DENOISE = 2,
+    FB_PASS_PHASE_COMPOSE = 3,
+    FB_PASS_PHASE_POSTPROCESS = 4,
+    FB_PASS_PHASE_COUNT = 5,
+};
+#define FB_LIFETIME_PERSISTENT 0xFFFFFFFF
+
 extern const uint32_t ShFramebuffers_Count;
 extern const VkFormat ShFramebuffers_Formats[];
 extern const FramebufferImageFlags ShFramebuffers_Flags[];
@@ -109,5 +120,7 @@ extern const uint32_t ShFramebuffers_BindingsSwapped[];
 extern const uint32_t ShFramebuffers_Sampler_Bindings[];
 extern const uint32_t ShFramebuffers_Sampler_BindingsSwapped[];
 extern const char *const ShFramebuffers_DebugNames[];
+extern const uint32_t ShFramebuffers_LifetimeFirstPhase[];
+extern const uint32_t ShFramebuffers_LifetimeLastPhase[];
 
 }
\ No newline at end of file
@@ -8,7 +8,8 @@
 #define MAX_GEOMETRY_PRIMITIVE_COUNT (1048576)
 #define MAX_GEOMETRY_PRIMITIVE_COUNT_POW (20)
 #define LOWER_BOTTOM_LEVEL_GEOMETRIES_COUNT (256)
-#define MAX_TOP_LEVEL_INSTANCE_COUNT (45)
+#define MAX_TOP_LEVEL_INSTANCE_COUNT (65536)
+#define MAX_STATIC_BOTTOM_LEVEL_GEOMETRIES_COUNT (16384)
 #define BINDING_VERTEX_BUFFER_STATIC (0)
 #define BINDING_VERTEX_BUFFER_DYNAMIC (1)
 #define BINDING_INDEX_BUFFER_STATIC (2)
@@ -23,6 +24,7 @@
 #define BINDING_DYNAMIC_TEXCOORD_LAYER_1 (11)
 #define BINDING_DYNAMIC_TEXCOORD_LAYER_2 (12)
 #define BINDING_DYNAMIC_TEXCOORD_LAYER_3 (13)
+#define BINDING_TLAS_INSTANCES (14)
 #define BINDING_GLOBAL_UNIFORM (0)
 #define BINDING_ACCELERATION_STRUCTURE_MAIN (0)
 #define BINDING_TEXTURES (0)
@@ -36,9 +38,11 @@
 #define BINDING_LIGHT_SOURCES_INDEX_CUR_TO_PREV (3)
 #define BINDING_INITIAL_LIGHTS_GRID (4)
 #define BINDING_INITIAL_LIGHTS_GRID_PREV (5)
+#define BINDING_LIGHT_TREE_NODES (6)
 #define BINDING_LENS_FLARES_CULLING_INPUT (0)
 #define BINDING_LENS_FLARES_DRAW_CMDS (1)
 #define BINDING_DRAW_LENS_FLARES_INSTANCES (0)
+#define BINDING_RASTERIZED_DRAWS (0)
 #define BINDING_DECAL_INSTANCES (0)
 #define BINDING_PORTAL_INSTANCES (0)
 #define BINDING_LPM_PARAMS (0)
@@ -175,8 +179,13 @@
 #define LIGHT_GRID_SIZE_Z (16)
 #define LIGHT_GRID_CELL_SIZE (128)
 #define COMPUTE_LIGHT_GRID_GROUP_SIZE_X (256)
+#define LIGHT_TREE_NODE_LEAF_BIT (1 << 31)
+#define LIGHT_TREE_MAX_DEPTH (32)
 #define PORTAL_INDEX_NONE (63)
 #define PORTAL_MAX_COUNT (63)
+#define RT_FEATURE_PORTALS (1 << 0)
+#define RT_FEATURE_ILLUMINATION_VOLUME (1 << 1)
+#define RT_FEATURE_LIGHT_TREE (1 << 2)
 #define PACKED_INDIRECT_SAMPLE_SIZE_IN_WORDS (6)
 #define PACKED_INDIRECT_RESERVOIR_SIZE_IN_WORDS (8)
 #define VOLUMETRIC_SIZE_X (160)
@@ -201,6 +210,14 @@ struct ShVertex
     uint _padding;
 };
 
+struct ShVertexCompact
+{
+    float position[3];
+    uint normalPacked;
+    uint texCoordPacked;
+    uint color;
+};
+
 struct ShGlobalUniform
 {
     mat4 view;
@@ -273,7 +290,7 @@ struct ShGlobalUniform
     float primaryRayMinDist;
     uint rayCullMaskWorld_Shadow;
     uint volumeAllowTintUnderwater;
-    uint _unused2;
+    uint lightTreeNodeCount;
     uint twirlPortalNormal;
     uint lightIndexIgnoreFPVShadows;
     float gradientMultDiffuse;
@@ -291,9 +308,14 @@ struct ShGlobalUniform
     uint volumeLightSourceIndex;
     float volumeFallbackSrcExists;
     float volumeLightMult;
-    ivec4 instanceGeomInfoOffset[12];
-    ivec4 instanceGeomInfoOffsetPrev[12];
-    ivec4 instanceGeomCount[12];
+    uint staticVerticesCompact;
+    float prevRenderWidth;
+    float prevRenderHeight;
+    float maxRenderWidth;
+    float maxRenderHeight;
+    uint _unused0;
+    uint _unused1;
+    uint _unused2;
     mat4 viewProjCubemap[6];
     mat4 skyCubemapRotationTransform;
 };
@@ -336,6 +358,14 @@ struct ShGeometryInstance
     uint _unused10;
 };
 
+struct ShTlasInstance
+{
+    int geomInfoOffset;
+    int geomInfoOffsetPrev;
+    int geomCount;
+    uint isDynamic;
+};
+
 struct ShTonemapping
 {
     uint histogram[256];
@@ -359,10 +389,19 @@ struct ShLightInCell
     uint __pad0;
 };
 
+struct ShLightTreeNode
+{
+    vec3 aabbMin;
+    float power;
+    vec3 aabbMax;
+    uint rightChildOrLight;
+    vec3 coneAxis;
+    float coneCosAngle;
+};
+
 struct ShVertPreprocessing
 {
     uint tlasInstanceCount;
-    uint tlasInstanceIsDynamicBits[2];
 };
 
 struct ShIndirectDrawCommand
@@ -385,6 +424,20 @@ struct ShLensFlareInstance
     float emissiveMult;
 };
 
+struct ShRasterizedDraw
+{
+    mat4 model;
+    mat4 viewProj;
+    uint packedColor;
+    uint textureIndex;
+    uint emissiveTextureIndex;
+    float emissiveMult;
+    uint useViewProj;
+    uint __pad0;
+    uint __pad1;
+    uint __pad2;
+};
+
 struct ShDecalInstance
 {
     mat4 transform;
@@ -231,8 +231,8 @@ bool RTGL1::GeomInfoManager::CopyFromStaging( VkCommandBuffer cmd,
     CmdLabel label( cmd, "Copying geom infos" );
 
     {
-        VkBufferCopy          copyInfos[ MAX_TOP_LEVEL_INSTANCE_COUNT ];
-        VkBufferMemoryBarrier barriers[ MAX_TOP_LEVEL_INSTANCE_COUNT ];
+        VkBufferCopy          copyInfos[ VERTEX_COLLECTOR_FILTER_GROUP_COUNT ];
+        VkBufferMemoryBarrier barriers[ VERTEX_COLLECTOR_FILTER_GROUP_COUNT ];
 
         uint32_t infoCount = 0;
 
@@ -310,8 +310,8 @@ bool RTGL1::GeomInfoManager::CopyFromStaging( VkCommandBuffer cmd,
 
 
     {
-        VkBufferCopy          copyInfos[ MAX_TOP_LEVEL_INSTANCE_COUNT ];
-        VkBufferMemoryBarrier barriers[ MAX_TOP_LEVEL_INSTANCE_COUNT ];
+        VkBufferCopy          copyInfos[ VERTEX_COLLECTOR_FILTER_GROUP_COUNT ];
+        VkBufferMemoryBarrier barriers[ VERTEX_COLLECTOR_FILTER_GROUP_COUNT ];
 
         uint32_t infoCount = 0;
 
@@ -469,13 +469,18 @@ void RTGL1::GeomInfoManager::WriteGeomInfo( uint32_t                       frame
 
         auto& geomInstSpan = AccessGeometryInstanceGroup( i, flags );
 
+        // each geometry has its own index, so only the bookkeeping must be synchronized
         memcpy( &geomInstSpan[ localGeomIndex ], &src, sizeof( ShGeometryInstance ) );
-        geomInstSpan.add_to_subspan( localGeomIndex );
+        {
+            auto lock = std::lock_guard( writeMutex );
+            geomInstSpan.add_to_subspan( localGeomIndex );
 
-        // optimization
-        mappedBufferRegionsCount[ i ]++;
+            // optimization
+            mappedBufferRegionsCount[ i ]++;
+        }
     }
 
+    auto lock = std::lock_guard( writeMutex );
     WriteInfoForNextUsage( flags, geomUniqueID, globalGeomIndex, src, frameIndex );
 }
 
@@ -642,6 +647,8 @@ uint32_t RTGL1::GeomInfoManager::RecalculateCount( uint32_t frameIndex ) const
 
 uint32_t RTGL1::GeomInfoManager::GetCount( uint32_t frameIndex ) const
 {
+    auto lock = std::lock_guard( writeMutex );
+
     assert( RecalculateCount( frameIndex ) == mappedBufferRegionsCount[ frameIndex ] );
     return mappedBufferRegionsCount[ frameIndex ];
 }
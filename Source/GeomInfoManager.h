@@ -31,6 +31,7 @@
 
 #include "Generated/ShaderCommonC.h"
 
+#include <mutex>
 #include <vector>
 
 namespace RTGL1
@@ -57,6 +58,7 @@ public:
     // Save instance for copying into buffer and fill previous frame's data.
     // For dynamic geometry it should be called every frame,
     // and for static geometry -- only when whole static scene was changed.
+    // Thread-safe for different localGeomIndex values.
     void WriteGeomInfo( uint32_t                       frameIndex,
                         uint64_t                       geomUniqueID,
                         uint32_t                       localGeomIndex,
@@ -141,6 +143,9 @@ private:
 
     uint32_t mappedBufferRegionsCount[ MAX_FRAMES_IN_FLIGHT ]{}; // optimization
 
+    // dynamic geometry can be written from multiple threads
+    mutable std::mutex writeMutex;
+
     rgl::subspan_incremental< ShGeometryInstance >& AccessGeometryInstanceGroup(
         uint32_t frameIndex, VertexCollectorFilterTypeFlags flagsForGroup );
 };
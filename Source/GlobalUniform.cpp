@@ -35,8 +35,12 @@ GlobalUniform::GlobalUniform( VkDevice _device, std::shared_ptr< MemoryAllocator
     uniformData = std::make_shared< ShGlobalUniform >();
 
     uniformBuffer = std::make_shared< AutoBuffer >( std::move( _allocator ) );
-    uniformBuffer->Create(
-        sizeof( ShGlobalUniform ), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, "Uniform buffer" );
+    // read by the light grid build, that can be on the async compute queue
+    uniformBuffer->Create( sizeof( ShGlobalUniform ),
+                           VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                           "Uniform buffer",
+                           MAX_FRAMES_IN_FLIGHT,
+                           true );
 
     CreateDescriptors();
 }
@@ -24,6 +24,7 @@
 #include "SpanCounted.h"
 #include "TextureExporter.h"
 #include "Utils.h"
+#include "VertexKernels.h"
 
 #include "Generated/ShaderCommonC.h"
 
@@ -1097,11 +1098,6 @@ void MakeLightsForPrimitive( const RgMeshInfo&                     mesh,
     assert( initial.empty() );
     assert( result.empty() );
 
-    constexpr auto toFloat3 = []( const float( &ptr )[ 3 ] ) {
-        return RgFloat3D{ RG_ACCESS_VEC3( ptr ) };
-    };
-    using RTGL1::Utils::ApplyTransform;
-
     assert( prim.indexCount % 3 == 0 );
     if( prim.indexCount / 3 > 1024 )
     {
@@ -1168,6 +1164,25 @@ void MakeLightsForPrimitive( const RgMeshInfo&                     mesh,
         }
         return false;
     };
+
+    const uint32_t triangleCount = prim.indexCount / 3;
+
+    // transform all vertices at once, then gather them per triangle
+    auto transformed = std::vector< RgFloat3D >( prim.vertexCount );
+    RTGL1::VertexKernels::TransformPositions(
+        transformed.data(), prim.pVertices, prim.vertexCount, mesh.transform );
+
+    auto triPositions = std::vector< RgFloat3D >( size_t( triangleCount ) * 3 );
+    for( uint32_t i = 0; i < triangleCount * 3; i++ )
+    {
+        triPositions[ i ] = transformed[ prim.pIndices[ i ] ];
+    }
+
+    auto triNormals = std::vector< RgFloat3D >( triangleCount );
+    auto triAreas   = std::vector< float >( triangleCount );
+    RTGL1::VertexKernels::TriangleNormals(
+        triNormals.data(), triAreas.data(), triPositions.data(), triangleCount );
+
     std::optional< Tri >            prev;
     std::optional< PositionNormal > accum;
 
@@ -1179,21 +1194,16 @@ void MakeLightsForPrimitive( const RgMeshInfo&                     mesh,
         }
     };
 
-    for( uint32_t tri = 0; tri < prim.indexCount / 3; tri++ )
+    for( uint32_t tri = 0; tri < triangleCount; tri++ )
     {
-        Tri local = {
-            toFloat3( prim.pVertices[ prim.pIndices[ tri * 3 + 0 ] ].position ),
-            toFloat3( prim.pVertices[ prim.pIndices[ tri * 3 + 1 ] ].position ),
-            toFloat3( prim.pVertices[ prim.pIndices[ tri * 3 + 2 ] ].position ),
-        };
-
         Tri global = {
-            ApplyTransform( mesh.transform, local.v[ 0 ] ),
-            ApplyTransform( mesh.transform, local.v[ 1 ] ),
-            ApplyTransform( mesh.transform, local.v[ 2 ] ),
+            triPositions[ tri * 3 + 0 ],
+            triPositions[ tri * 3 + 1 ],
+            triPositions[ tri * 3 + 2 ],
         };
 
-        if( auto n = TryGetNormal( global.v ) )
+        // same threshold as in Utils::GetNormalAndArea
+        if( triAreas[ tri ] > 0.01f )
         {
             if( prev )
             {
@@ -1207,7 +1217,7 @@ void MakeLightsForPrimitive( const RgMeshInfo&                     mesh,
             accum = merge( accum,
                            PositionNormal{
                                .position = GetCenter( global.v ),
-                               .normal   = *n,
+                               .normal   = triNormals[ tri ],
                            } );
         }
     }
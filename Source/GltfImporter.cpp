@@ -21,9 +21,11 @@
 #include "GltfImporter.h"
 
 #include "Const.h"
+#include "Containers.h"
 #include "Matrix.h"
 #include "Scene.h"
 #include "Utils.h"
+#include "VertexKernels.h"
 
 #include "Generated/ShaderCommonC.h"
 
@@ -332,16 +334,24 @@ namespace
                     break;
                 }
 
-                case cgltf_attribute_type_color:
+                case cgltf_attribute_type_color: {
                     defaultColor = std::nullopt;
+
+                    auto rgba   = std::vector< float >( primVertices.size() * 4, 1.0f );
+                    auto packed = std::vector< RgColor4DPacked32 >( primVertices.size() );
+                    for( size_t i = 0; i < primVertices.size(); i++ )
+                    {
+                        ok &= cgltf_accessor_read_float( attr.data, i, &rgba[ i * 4 ], 4 );
+                    }
+
+                    VertexKernels::PackColors(
+                        packed.data(), rgba.data(), uint32_t( primVertices.size() ) );
                     for( size_t i = 0; i < primVertices.size(); i++ )
                     {
-                        float c[ 4 ] = { 1, 1, 1, 1 };
-                        ok &= cgltf_accessor_read_float_h( attr.data, i, c );
-                        primVertices[ i ].color =
-                            Utils::PackColorFromFloat( c[ 0 ], c[ 1 ], c[ 2 ], c[ 3 ] );
+                        primVertices[ i ].color = packed[ i ];
                     }
                     break;
+                }
 
                 default: break;
             }
@@ -439,25 +449,39 @@ namespace
         return "";
     }
 
-    struct UploadTexturesResult
-    {
-        RgColor4DPacked32 color        = Utils::PackColor( 255, 255, 255, 255 );
-        float             emissiveMult = 0.0f;
-        std::string       pTextureName;
-        float             metallicFactor  = 0.0f;
-        float             roughnessFactor = 1.0f;
-    };
-
-    UploadTexturesResult UploadTextures( VkCommandBuffer              cmd,
-                                         uint32_t                     frameIndex,
-                                         const cgltf_material*        mat,
-                                         TextureManager&              textureManager,
+    scenecache::Material GatherMaterial( const cgltf_material*        mat,
+                                         scenecache::Builder&         builder,
                                          const std::filesystem::path& gltfFolder,
                                          std::string_view             gltfPath )
     {
+        scenecache::Material dst = {
+            .pbrSwizzling    = RG_TEXTURE_SWIZZLING_NULL_ROUGHNESS_METALLIC,
+            .color           = Utils::PackColor( 255, 255, 255, 255 ),
+            .emissiveMult    = 0.0f,
+            .metallicFactor  = 0.0f,
+            .roughnessFactor = 1.0f,
+        };
+        for( uint32_t i = 0; i < TEXTURES_PER_MATERIAL_COUNT; i++ )
+        {
+            dst.filter[ i ]       = RG_SAMPLER_FILTER_AUTO;
+            dst.addressModeU[ i ] = RG_SAMPLER_ADDRESS_MODE_REPEAT;
+            dst.addressModeV[ i ] = RG_SAMPLER_ADDRESS_MODE_REPEAT;
+        }
+
+        auto finalize = [ &builder, &dst ]( std::string_view                   materialName,
+                                            std::span< std::filesystem::path > fullPaths ) {
+            dst.nameStr = builder.AddString( materialName );
+            for( uint32_t i = 0; i < TEXTURES_PER_MATERIAL_COUNT; i++ )
+            {
+                dst.fullPathStr[ i ] =
+                    builder.AddString( i < fullPaths.size() ? fullPaths[ i ].string() : "" );
+            }
+            return dst;
+        };
+
         if( mat == nullptr )
         {
-            return {};
+            return finalize( "", {} );
         }
 
         if( !mat->has_pbr_metallic_roughness )
@@ -466,25 +490,16 @@ namespace
                             "Can't find PBR Metallic-Roughness",
                             gltfPath,
                             Utils::SafeCstr( mat->name ) );
-            return {};
+            return finalize( "", {} );
         }
 
-        // clang-format off
         std::filesystem::path fullPaths[] = {
             std::filesystem::path(),
             std::filesystem::path(),
             std::filesystem::path(),
             std::filesystem::path(),
         };
-        SamplerManager::Handle samplers[] = {
-            SamplerManager::Handle( RG_SAMPLER_FILTER_AUTO, RG_SAMPLER_ADDRESS_MODE_REPEAT, RG_SAMPLER_ADDRESS_MODE_REPEAT ),
-            SamplerManager::Handle( RG_SAMPLER_FILTER_AUTO, RG_SAMPLER_ADDRESS_MODE_REPEAT, RG_SAMPLER_ADDRESS_MODE_REPEAT ),
-            SamplerManager::Handle( RG_SAMPLER_FILTER_AUTO, RG_SAMPLER_ADDRESS_MODE_REPEAT, RG_SAMPLER_ADDRESS_MODE_REPEAT ),
-            SamplerManager::Handle( RG_SAMPLER_FILTER_AUTO, RG_SAMPLER_ADDRESS_MODE_REPEAT, RG_SAMPLER_ADDRESS_MODE_REPEAT ),
-        };
         static_assert( std::size( fullPaths ) == TEXTURES_PER_MATERIAL_COUNT );
-        static_assert( std::size( samplers ) == TEXTURES_PER_MATERIAL_COUNT );
-        // clang-format on
 
 
         const std::pair< int, const cgltf_texture_view& > txds[] = {
@@ -507,7 +522,6 @@ namespace
         };
         static_assert( std::size( txds ) == TEXTURES_PER_MATERIAL_COUNT );
 
-        RgTextureSwizzling pbrSwizzling = RG_TEXTURE_SWIZZLING_NULL_ROUGHNESS_METALLIC;
         {
             cgltf_texture* texRM = mat->pbr_metallic_roughness.metallic_roughness_texture.texture;
             cgltf_texture* texO  = mat->occlusion_texture.texture;
@@ -518,7 +532,7 @@ namespace
                 {
                     if( texRM->image == texO->image )
                     {
-                        pbrSwizzling = RG_TEXTURE_SWIZZLING_OCCLUSION_ROUGHNESS_METALLIC;
+                        dst.pbrSwizzling = RG_TEXTURE_SWIZZLING_OCCLUSION_ROUGHNESS_METALLIC;
                     }
                     else
                     {
@@ -590,23 +604,14 @@ namespace
 
             if( txview.texture->sampler )
             {
-                samplers[ index ] = SamplerManager::Handle(
-                    makeRgSamplerFilter( txview.texture->sampler->mag_filter ),
-                    makeRgSamplerAddrMode( txview.texture->sampler->wrap_s ),
-                    makeRgSamplerAddrMode( txview.texture->sampler->wrap_t ) );
+                dst.filter[ index ] = makeRgSamplerFilter( txview.texture->sampler->mag_filter );
+                dst.addressModeU[ index ] =
+                    makeRgSamplerAddrMode( txview.texture->sampler->wrap_s );
+                dst.addressModeV[ index ] =
+                    makeRgSamplerAddrMode( txview.texture->sampler->wrap_t );
             }
         }
 
-
-        std::string materialName = MakePTextureName( *mat, fullPaths );
-
-        // if fullPaths are empty
-        if( !materialName.empty() )
-        {
-            textureManager.TryCreateImportedMaterial(
-                cmd, frameIndex, materialName, fullPaths, samplers, pbrSwizzling );
-        }
-
         if( auto t = mat->pbr_metallic_roughness.metallic_roughness_texture.texture )
         {
             if( t->image )
@@ -625,13 +630,248 @@ namespace
             }
         }
 
-        return UploadTexturesResult{
-            .color = Utils::PackColorFromFloat( mat->pbr_metallic_roughness.base_color_factor ),
-            .emissiveMult    = Utils::Luminance( mat->emissive_factor ),
-            .pTextureName    = std::move( materialName ),
-            .metallicFactor  = mat->pbr_metallic_roughness.metallic_factor,
-            .roughnessFactor = mat->pbr_metallic_roughness.roughness_factor,
-        };
+        dst.color = Utils::PackColorFromFloat( mat->pbr_metallic_roughness.base_color_factor );
+        dst.emissiveMult    = Utils::Luminance( mat->emissive_factor );
+        dst.metallicFactor  = mat->pbr_metallic_roughness.metallic_factor;
+        dst.roughnessFactor = mat->pbr_metallic_roughness.roughness_factor;
+
+        // if fullPaths are empty, then the material name is empty
+        return finalize( MakePTextureName( *mat, fullPaths ), fullPaths );
+    }
+
+    void GatherMeshes( const cgltf_node&            mainNode,
+                       scenecache::Builder&         builder,
+                       const std::filesystem::path& gltfFolder,
+                       std::string_view             gltfPath )
+    {
+        rgl::unordered_map< const cgltf_material*, uint32_t > materialIndices;
+
+        for( cgltf_node* srcNode : std::span( mainNode.children, mainNode.children_count ) )
+        {
+            if( !srcNode || !srcNode->mesh )
+            {
+                continue;
+            }
+
+            if( Utils::IsCstrEmpty( srcNode->name ) )
+            {
+                debug::Warning( "{}: Found srcMesh with null name (a child node of {}). Ignoring",
+                                gltfPath,
+                                mainNode.name );
+                continue;
+            }
+
+            if( srcNode->children_count > 0 )
+            {
+                debug::Warning( "{}: Found a child nodes of {}->{}. Ignoring them",
+                                gltfPath,
+                                mainNode.name,
+                                srcNode->name );
+            }
+
+            auto primitiveExtra = json_parser::ReadStringAs< PrimitiveExtraInfo >(
+                Utils::SafeCstr( srcNode->extras.data ) );
+
+            RgMeshPrimitiveFlags extraFlags = 0;
+            {
+                if( primitiveExtra.isGlass )
+                {
+                    extraFlags |= RG_MESH_PRIMITIVE_GLASS;
+                }
+
+                if( primitiveExtra.isMirror )
+                {
+                    extraFlags |= RG_MESH_PRIMITIVE_MIRROR;
+                }
+
+                if( primitiveExtra.isWater )
+                {
+                    extraFlags |= RG_MESH_PRIMITIVE_WATER;
+                }
+
+                if( primitiveExtra.isSkyVisibility )
+                {
+                    extraFlags |= RG_MESH_PRIMITIVE_SKY_VISIBILITY;
+                }
+
+                if( primitiveExtra.isAcid )
+                {
+                    extraFlags |= RG_MESH_PRIMITIVE_ACID;
+                }
+
+                if( primitiveExtra.isThinMedia )
+                {
+                    extraFlags |= RG_MESH_PRIMITIVE_THIN_MEDIA;
+                }
+            }
+
+            // TODO: really bad way to reduce hash64 to 32 bits
+            uint32_t meshIndex = builder.AddMesh(
+                srcNode->name,
+                uint32_t( std::hash< std::string_view >{}( srcNode->name ) % UINT32_MAX ),
+                MakeRgTransformFromGltfNode( *srcNode ) );
+
+            for( uint32_t i = 0; i < srcNode->mesh->primitives_count; i++ )
+            {
+                const cgltf_primitive& srcPrim = srcNode->mesh->primitives[ i ];
+
+                auto vertices = GatherVertices( srcPrim, *srcNode, gltfPath );
+                if( vertices.empty() )
+                {
+                    continue;
+                }
+
+                auto indices = GatherIndices( srcPrim, *srcNode, gltfPath );
+                if( indices.empty() )
+                {
+                    continue;
+                }
+
+
+                RgMeshPrimitiveFlags dstFlags = 0;
+
+                if( srcPrim.material )
+                {
+                    if( srcPrim.material->alpha_mode == cgltf_alpha_mode_mask )
+                    {
+                        dstFlags |= RG_MESH_PRIMITIVE_ALPHA_TESTED;
+                    }
+                    else if( srcPrim.material->alpha_mode == cgltf_alpha_mode_blend )
+                    {
+                        debug::Warning(
+                            "{}: Ignoring primitive of ...->{}->{}: Found blend material, "
+                            "so it requires to be uploaded each frame, and not once on load",
+                            gltfPath,
+                            NodeName( srcNode->parent ),
+                            NodeName( srcNode ) );
+                        continue;
+                        dstFlags |= RG_MESH_PRIMITIVE_TRANSLUCENT;
+                    }
+                }
+
+
+                uint32_t materialIndex;
+                {
+                    auto found = materialIndices.find( srcPrim.material );
+                    if( found != materialIndices.end() )
+                    {
+                        materialIndex = found->second;
+                    }
+                    else
+                    {
+                        materialIndex = builder.AddMaterial(
+                            GatherMaterial( srcPrim.material, builder, gltfFolder, gltfPath ) );
+                        materialIndices[ srcPrim.material ] = materialIndex;
+                    }
+                }
+
+                builder.AddPrimitive(
+                    meshIndex, i, dstFlags, extraFlags, materialIndex, vertices, indices );
+            }
+        }
+    }
+
+    void GatherLights( const cgltf_node&    mainNode,
+                       scenecache::Builder& builder,
+                       std::string_view     gltfPath,
+                       float                oneGameUnitInMeters )
+    {
+        uint64_t counter = 0;
+
+        for( cgltf_node* srcNode : std::span( mainNode.children, mainNode.children_count ) )
+        {
+            if( !srcNode || !srcNode->light )
+            {
+                continue;
+            }
+
+            if( srcNode->children_count > 0 )
+            {
+                debug::Warning( "{}: Found a child nodes of {}->{}. Ignoring them",
+                                gltfPath,
+                                mainNode.name,
+                                srcNode->name );
+            }
+
+            constexpr auto candelaToLuminousFlux = []( float lumensPerSteradian ) {
+                // to lumens
+                return lumensPerSteradian * ( 4 * float( Utils::M_PI ) );
+            };
+
+            auto makeExtras = []( const char* extradata ) {
+                return json_parser::ReadStringAs< RgLightExtraInfo >(
+                    Utils::SafeCstr( extradata ) );
+            };
+
+            RgTransform tr = MakeRgTransformFromGltfNode( *srcNode );
+
+            RgFloat3D position = {
+                tr.matrix[ 0 ][ 3 ],
+                tr.matrix[ 1 ][ 3 ],
+                tr.matrix[ 2 ][ 3 ],
+            };
+
+            RgFloat3D direction = {
+                -tr.matrix[ 0 ][ 2 ],
+                -tr.matrix[ 1 ][ 2 ],
+                -tr.matrix[ 2 ][ 2 ],
+            };
+
+            RgColor4DPacked32 packedColor =
+                Utils::PackColorFromFloat( RG_ACCESS_VEC3( srcNode->light->color ), 1.0f );
+
+            // TODO: change id
+            uint64_t uniqueId = UINT64_MAX - counter;
+            counter++;
+
+            switch( srcNode->light->type )
+            {
+                case cgltf_light_type_directional: {
+                    builder.AddLight( RgDirectionalLightUploadInfo{
+                        .uniqueID               = uniqueId,
+                        .isExportable           = true,
+                        .extra                  = makeExtras( srcNode->light->extras.data ),
+                        .color                  = packedColor,
+                        .intensity              = srcNode->light->intensity, // already in lm/m^2
+                        .direction              = direction,
+                        .angularDiameterDegrees = 0.5f,
+                    } );
+                    break;
+                }
+                case cgltf_light_type_point: {
+                    builder.AddLight( RgSphericalLightUploadInfo{
+                        .uniqueID     = uniqueId,
+                        .isExportable = true,
+                        .extra        = makeExtras( srcNode->light->extras.data ),
+                        .color        = packedColor,
+                        .intensity =
+                            candelaToLuminousFlux( srcNode->light->intensity ), // from lm/sr to lm
+                        .position = position,
+                        .radius   = 0.05f / oneGameUnitInMeters,
+                    } );
+                    break;
+                }
+                case cgltf_light_type_spot: {
+                    builder.AddLight( RgSpotLightUploadInfo{
+                        .uniqueID     = uniqueId,
+                        .isExportable = true,
+                        .extra        = makeExtras( srcNode->light->extras.data ),
+                        .color        = packedColor,
+                        .intensity =
+                            candelaToLuminousFlux( srcNode->light->intensity ), // from lm/sr to lm
+                        .position   = position,
+                        .direction  = direction,
+                        .radius     = 0.05f / oneGameUnitInMeters,
+                        .angleOuter = srcNode->light->spot_outer_cone_angle,
+                        .angleInner = srcNode->light->spot_inner_cone_angle,
+                    } );
+                    break;
+                }
+                case cgltf_light_type_invalid:
+                case cgltf_light_type_max_enum:
+                default: break;
+            }
+        }
     }
 
 }
@@ -640,39 +880,72 @@ namespace
 RTGL1::GltfImporter::GltfImporter( const std::filesystem::path& _gltfPath,
                                    const RgTransform&           _worldTransform,
                                    float                        _oneGameUnitInMeters )
-    : data( nullptr )
-    , gltfPath( _gltfPath.string() )
+    : gltfPath( _gltfPath.string() )
     , gltfFolder( _gltfPath.parent_path() )
     , oneGameUnitInMeters( _oneGameUnitInMeters )
+{
+    uint64_t key       = scenecache::MakeKey( _gltfPath, _worldTransform, _oneGameUnitInMeters );
+    auto     cachePath = scenecache::MakeCachePath( _gltfPath );
+
+    if( TryLoadCache( cachePath, key ) )
+    {
+        debug::Verbose( "{}: Using scene cache {}", gltfPath, cachePath.string() );
+        return;
+    }
+
+    if( !ParseGltf( _worldTransform, key ) )
+    {
+        return;
+    }
+
+    if( !scenecache::WriteToFile( cachePath, builtCache ) )
+    {
+        debug::Warning( "{}: Failed to write scene cache to {}", gltfPath, cachePath.string() );
+    }
+}
+
+bool RTGL1::GltfImporter::TryLoadCache( const std::filesystem::path& cachePath, uint64_t key )
+{
+    auto file = std::make_unique< MappedFile >( cachePath );
+    if( !*file )
+    {
+        return false;
+    }
+
+    auto view = scenecache::View::Make( file->Data(), key );
+    if( !view || !view->AreDependenciesUpToDate() )
+    {
+        return false;
+    }
+
+    cacheFile = std::move( file );
+    cached    = view;
+    return true;
+}
+
+bool RTGL1::GltfImporter::ParseGltf( const RgTransform& worldTransform, uint64_t key )
 {
     cgltf_result  r{ cgltf_result_success };
     cgltf_options options{};
     cgltf_data*   parsedData{ nullptr };
 
-    struct FreeIfFail
+    struct FreeOnExit
     {
-        cgltf_data** data;
         cgltf_data** parsedData;
-        ~FreeIfFail()
-        {
-            if( *data == nullptr )
-            {
-                cgltf_free( *parsedData );
-            }
-        }
-    } tmp = { &data, &parsedData };
+        ~FreeOnExit() { cgltf_free( *parsedData ); }
+    } tmp = { &parsedData };
 
     r = cgltf_parse_file( &options, gltfPath.c_str(), &parsedData );
     if( r == cgltf_result_file_not_found )
     {
         debug::Warning( "{}: Can't find a file, no static scene will be present", gltfPath );
-        return;
+        return false;
     }
     else if( r != cgltf_result_success )
     {
         debug::Warning(
             "{}: cgltf_parse_file. Error code: {} {}", gltfPath, int( r ), CgltfErrorName( r ) );
-        return;
+        return false;
     }
 
     r = cgltf_load_buffers( &options, parsedData, gltfPath.c_str() );
@@ -683,7 +956,7 @@ RTGL1::GltfImporter::GltfImporter( const std::filesystem::path& _gltfPath,
             gltfPath,
             int( r ),
             CgltfErrorName( r ) );
-        return;
+        return false;
     }
 
     r = cgltf_validate( parsedData );
@@ -691,13 +964,13 @@ RTGL1::GltfImporter::GltfImporter( const std::filesystem::path& _gltfPath,
     {
         debug::Warning(
             "{}: cgltf_validate. Error code: {} {}", gltfPath, int( r ), CgltfErrorName( r ) );
-        return;
+        return false;
     }
 
     if( parsedData->scenes_count == 0 )
     {
         debug::Warning( "{}: {}", gltfPath, "No scenes found" );
-        return;
+        return false;
     }
 
     if( parsedData->scene == nullptr )
@@ -712,288 +985,150 @@ RTGL1::GltfImporter::GltfImporter( const std::filesystem::path& _gltfPath,
     {
         debug::Warning(
             "{}: {}", gltfPath, "No \"" RTGL1_MAIN_ROOT_NODE "\" node in the default scene" );
-        return;
+        return false;
     }
 
-    ApplyInverseWorldTransform( *mainNode, _worldTransform );
+    ApplyInverseWorldTransform( *mainNode, worldTransform );
 
-    data = parsedData;
-}
+    if( mainNode->mesh || mainNode->light )
+    {
+        debug::Warning( "{}: Main node ({}) should not have meshes / lights. Ignoring",
+                        gltfPath,
+                        mainNode->name );
+    }
 
-RTGL1::GltfImporter::~GltfImporter()
-{
-    cgltf_free( data );
+
+    scenecache::Builder builder;
+
+    // .bin files, the .gltf itself is a part of the key
+    for( const cgltf_buffer& b : std::span( parsedData->buffers, parsedData->buffers_count ) )
+    {
+        if( !Utils::IsCstrEmpty( b.uri ) && !std::string_view( b.uri ).starts_with( "data:" ) )
+        {
+            builder.AddDependency( gltfFolder / b.uri );
+        }
+    }
+
+    GatherMeshes( *mainNode, builder, gltfFolder, gltfPath );
+    GatherLights( *mainNode, builder, gltfPath, oneGameUnitInMeters );
+
+    builtCache = builder.Finish( key );
+    cached     = scenecache::View::Make( builtCache, key );
+
+    assert( cached );
+    return cached.has_value();
 }
 
+RTGL1::GltfImporter::~GltfImporter() = default;
+
 void RTGL1::GltfImporter::UploadToScene( VkCommandBuffer           cmd,
                                          uint32_t                  frameIndex,
                                          Scene&                    scene,
                                          TextureManager&           textureManager,
                                          const TextureMetaManager& textureMeta ) const
 {
-    cgltf_node* mainNode = FindMainRootNode( data );
-    if( !mainNode )
+    if( !cached )
     {
         return;
     }
 
-    if( mainNode->mesh || mainNode->light )
+    // materials
+    for( const scenecache::Material& m : cached->materials )
     {
-        debug::Warning( "{}: Main node ({}) should not have meshes / lights. Ignoring",
-                        gltfPath,
-                        mainNode->name );
-    }
+        std::string materialName = cached->String( m.nameStr );
 
-    // meshes
-    for( cgltf_node* srcNode : std::span( mainNode->children, mainNode->children_count ) )
-    {
-        if( !srcNode || !srcNode->mesh )
+        // if fullPaths are empty
+        if( materialName.empty() )
         {
             continue;
         }
 
-        if( Utils::IsCstrEmpty( srcNode->name ) )
-        {
-            debug::Warning( "{}: Found srcMesh with null name (a child node of {}). Ignoring",
-                            gltfPath,
-                            mainNode->name );
-            continue;
-        }
+        std::filesystem::path  fullPaths[ TEXTURES_PER_MATERIAL_COUNT ];
+        SamplerManager::Handle samplers[ TEXTURES_PER_MATERIAL_COUNT ];
 
-        if( srcNode->children_count > 0 )
+        for( uint32_t i = 0; i < TEXTURES_PER_MATERIAL_COUNT; i++ )
         {
-            debug::Warning( "{}: Found a child nodes of {}->{}. Ignoring them",
-                            gltfPath,
-                            mainNode->name,
-                            srcNode->name );
+            fullPaths[ i ] = cached->String( m.fullPathStr[ i ] );
+            samplers[ i ] =
+                SamplerManager::Handle( m.filter[ i ], m.addressModeU[ i ], m.addressModeV[ i ] );
         }
-        
-        auto primitiveExtra = json_parser::ReadStringAs< PrimitiveExtraInfo >(
-            Utils::SafeCstr( srcNode->extras.data ) );
-
-        // TODO: really bad way to reduce hash64 to 32 bits
-        RgMeshInfo dstMesh = {
-            .uniqueObjectID =
-                uint32_t( std::hash< std::string_view >{}( srcNode->name ) % UINT32_MAX ),
-            .pMeshName    = srcNode->name,
-            .transform    = MakeRgTransformFromGltfNode( *srcNode ),
-            .isExportable = true,
-        };
-
-        for( uint32_t i = 0; i < srcNode->mesh->primitives_count; i++ )
-        {
-            const cgltf_primitive& srcPrim = srcNode->mesh->primitives[ i ];
-
-            auto vertices = GatherVertices( srcPrim, *srcNode, gltfPath );
-            if( vertices.empty() )
-            {
-                continue;
-            }
-
-            auto indices = GatherIndices( srcPrim, *srcNode, gltfPath );
-            if( indices.empty() )
-            {
-                continue;
-            }
-
 
-            RgMeshPrimitiveFlags dstFlags = 0;
-
-            if( srcPrim.material )
-            {
-                if( srcPrim.material->alpha_mode == cgltf_alpha_mode_mask )
-                {
-                    dstFlags |= RG_MESH_PRIMITIVE_ALPHA_TESTED;
-                }
-                else if( srcPrim.material->alpha_mode == cgltf_alpha_mode_blend )
-                {
-                    debug::Warning(
-                        "{}: Ignoring primitive of ...->{}->{}: Found blend material, "
-                        "so it requires to be uploaded each frame, and not once on load",
-                        gltfPath,
-                        NodeName( srcNode->parent ),
-                        NodeName( srcNode ) );
-                    continue;
-                    dstFlags |= RG_MESH_PRIMITIVE_TRANSLUCENT;
-                }
-            }
-
-
-            auto matinfo = UploadTextures(
-                cmd, frameIndex, srcPrim.material, textureManager, gltfFolder, gltfPath );
-
-            auto primname = std::to_string( i );
-
-            RgEditorInfo editorInfo = {};
-
-            RgMeshPrimitiveInfo dstPrim = {
-                .pPrimitiveNameInMesh = primname.c_str(),
-                .primitiveIndexInMesh = uint32_t( i ),
-                .flags                = dstFlags,
-                .pVertices            = vertices.data(),
-                .vertexCount          = uint32_t( vertices.size() ),
-                .pIndices             = indices.empty() ? nullptr : indices.data(),
-                .indexCount           = uint32_t( indices.size() ),
-                .pTextureName         = matinfo.pTextureName.c_str(),
-                .textureFrame         = 0,
-                .color                = matinfo.color,
-                .emissive             = matinfo.emissiveMult,
-                .pEditorInfo          = &editorInfo,
-            };
-
-            textureMeta.Modify( dstPrim, editorInfo, true );
-            {
-                // pbr info from gltf has higher priority
-                editorInfo.pbrInfoExists = true;
-                editorInfo.pbrInfo       = { .metallicDefault  = matinfo.metallicFactor,
-                                             .roughnessDefault = matinfo.roughnessFactor };
-            }
-
-            if( primitiveExtra.isGlass )
-            {
-                dstPrim.flags |= RG_MESH_PRIMITIVE_GLASS;
-            }
-
-            if( primitiveExtra.isMirror )
-            {
-                dstPrim.flags |= RG_MESH_PRIMITIVE_MIRROR;
-            }
-
-            if( primitiveExtra.isWater )
-            {
-                dstPrim.flags |= RG_MESH_PRIMITIVE_WATER;
-            }
-
-            if( primitiveExtra.isSkyVisibility )
-            {
-                dstPrim.flags |= RG_MESH_PRIMITIVE_SKY_VISIBILITY;
-            }
-
-            if( primitiveExtra.isAcid )
-            {
-                dstPrim.flags |= RG_MESH_PRIMITIVE_ACID;
-            }
-
-            if( primitiveExtra.isThinMedia )
-            {
-                dstPrim.flags |= RG_MESH_PRIMITIVE_THIN_MEDIA;
-            }
-
-            auto r = scene.UploadPrimitive( frameIndex, dstMesh, dstPrim, textureManager, true );
-
-
-            if( !( r == UploadResult::Static || r == UploadResult::ExportableStatic ) )
-            {
-                assert( 0 );
-            }
-        }
+        textureManager.TryCreateImportedMaterial(
+            cmd, frameIndex, materialName, fullPaths, samplers, m.pbrSwizzling );
     }
 
-    bool     foundLight = false;
-    uint64_t counter    = 0;
-
-    // lights
-    for( cgltf_node* srcNode : std::span( mainNode->children, mainNode->children_count ) )
+    // meshes
+    for( const scenecache::Primitive& p : cached->primitives )
     {
-        if( !srcNode || !srcNode->light )
-        {
-            continue;
-        }
+        const scenecache::Mesh& mesh = cached->meshes[ p.meshIndex ];
 
-        if( srcNode->children_count > 0 )
-        {
-            debug::Warning( "{}: Found a child nodes of {}->{}. Ignoring them",
-                            gltfPath,
-                            mainNode->name,
-                            srcNode->name );
-        }
-
-        constexpr auto candelaToLuminousFlux = []( float lumensPerSteradian ) {
-            // to lumens
-            return lumensPerSteradian * ( 4 * float( Utils::M_PI ) );
+        RgMeshInfo dstMesh = {
+            .uniqueObjectID = mesh.uniqueObjectID,
+            .pMeshName      = cached->String( mesh.nameStr ),
+            .transform      = mesh.transform,
+            .isExportable   = true,
         };
 
-        auto makeExtras = []( const char* extradata ) {
-            return json_parser::ReadStringAs< RgLightExtraInfo >( Utils::SafeCstr( extradata ) );
+        const scenecache::Material* mat =
+            p.materialIndex != scenecache::NoMaterial ? &cached->materials[ p.materialIndex ]
+                                                      : nullptr;
+
+        auto primname = std::to_string( p.primitiveIndexInMesh );
+
+        RgEditorInfo editorInfo = {};
+
+        // vertices are pointing directly to the cache memory
+        RgMeshPrimitiveInfo dstPrim = {
+            .pPrimitiveNameInMesh = primname.c_str(),
+            .primitiveIndexInMesh = p.primitiveIndexInMesh,
+            .flags                = p.flags,
+            .pVertices            = &cached->vertices[ p.firstVertex ],
+            .vertexCount          = p.vertexCount,
+            .pIndices             = p.indexCount > 0 ? &cached->indices[ p.firstIndex ] : nullptr,
+            .indexCount           = p.indexCount,
+            .pTextureName         = mat ? cached->String( mat->nameStr ) : "",
+            .textureFrame         = 0,
+            .color                = mat ? mat->color : Utils::PackColor( 255, 255, 255, 255 ),
+            .emissive             = mat ? mat->emissiveMult : 0.0f,
+            .pEditorInfo          = &editorInfo,
         };
 
-        RgTransform tr = MakeRgTransformFromGltfNode( *srcNode );
+        textureMeta.Modify( dstPrim, editorInfo, true );
+        {
+            // pbr info from gltf has higher priority
+            editorInfo.pbrInfoExists = true;
+            editorInfo.pbrInfo       = {
+                .metallicDefault  = mat ? mat->metallicFactor : 0.0f,
+                .roughnessDefault = mat ? mat->roughnessFactor : 1.0f,
+            };
+        }
 
-        RgFloat3D position = {
-            tr.matrix[ 0 ][ 3 ],
-            tr.matrix[ 1 ][ 3 ],
-            tr.matrix[ 2 ][ 3 ],
-        };
+        dstPrim.flags |= p.extraFlags;
 
-        RgFloat3D direction = {
-            -tr.matrix[ 0 ][ 2 ],
-            -tr.matrix[ 1 ][ 2 ],
-            -tr.matrix[ 2 ][ 2 ],
-        };
+        auto r = scene.UploadPrimitive( frameIndex, dstMesh, dstPrim, textureManager, true );
 
-        RgColor4DPacked32 packedColor =
-            Utils::PackColorFromFloat( RG_ACCESS_VEC3( srcNode->light->color ), 1.0f );
 
-        // TODO: change id
-        uint64_t uniqueId = UINT64_MAX - counter;
-        counter++;
-
-        switch( srcNode->light->type )
+        if( !( r == UploadResult::Static || r == UploadResult::ExportableStatic ) )
         {
-            case cgltf_light_type_directional: {
-                RgDirectionalLightUploadInfo info = {
-                    .uniqueID               = uniqueId,
-                    .isExportable           = true,
-                    .extra                  = makeExtras( srcNode->light->extras.data ),
-                    .color                  = packedColor,
-                    .intensity              = srcNode->light->intensity, // already in lm/m^2
-                    .direction              = direction,
-                    .angularDiameterDegrees = 0.5f,
-                };
-                scene.UploadLight( frameIndex, &info, nullptr, true );
-                foundLight = true;
-                break;
-            }
-            case cgltf_light_type_point: {
-                RgSphericalLightUploadInfo info = {
-                    .uniqueID     = uniqueId,
-                    .isExportable = true,
-                    .extra        = makeExtras( srcNode->light->extras.data ),
-                    .color        = packedColor,
-                    .intensity =
-                        candelaToLuminousFlux( srcNode->light->intensity ), // from lm/sr to lm
-                    .position = position,
-                    .radius   = 0.05f / oneGameUnitInMeters,
-                };
-                scene.UploadLight( frameIndex, &info, nullptr, true );
-                foundLight = true;
-                break;
-            }
-            case cgltf_light_type_spot: {
-                RgSpotLightUploadInfo info = {
-                    .uniqueID     = uniqueId,
-                    .isExportable = true,
-                    .extra        = makeExtras( srcNode->light->extras.data ),
-                    .color        = packedColor,
-                    .intensity =
-                        candelaToLuminousFlux( srcNode->light->intensity ), // from lm/sr to lm
-                    .position   = position,
-                    .direction  = direction,
-                    .radius     = 0.05f / oneGameUnitInMeters,
-                    .angleOuter = srcNode->light->spot_outer_cone_angle,
-                    .angleInner = srcNode->light->spot_inner_cone_angle,
-                };
-                scene.UploadLight( frameIndex, &info, nullptr, true );
-                foundLight = true;
-                break;
-            }
-            case cgltf_light_type_invalid:
-            case cgltf_light_type_max_enum:
-            default: break;
+            assert( 0 );
         }
     }
 
-    if( !foundLight )
+    // lights
+    for( const RgDirectionalLightUploadInfo& info : cached->dirLights )
+    {
+        scene.UploadLight( frameIndex, &info, nullptr, true );
+    }
+    for( const RgSphericalLightUploadInfo& info : cached->sphereLights )
+    {
+        scene.UploadLight( frameIndex, &info, nullptr, true );
+    }
+    for( const RgSpotLightUploadInfo& info : cached->spotLights )
+    {
+        scene.UploadLight( frameIndex, &info, nullptr, true );
+    }
+
+    if( cached->dirLights.empty() && cached->sphereLights.empty() && cached->spotLights.empty() )
     {
         debug::Warning( "Haven't found any lights in {}: "
                         "Original exportable lights will be used",
@@ -1003,5 +1138,5 @@ void RTGL1::GltfImporter::UploadToScene( VkCommandBuffer           cmd,
 
 RTGL1::GltfImporter::operator bool() const
 {
-    return data != nullptr;
+    return cached.has_value();
 }
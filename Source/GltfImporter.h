@@ -21,13 +21,11 @@
 #pragma once
 
 #include "Common.h"
+#include "MappedFile.h"
+#include "SceneCache.h"
 
 #include <filesystem>
 
-struct cgltf_node;
-struct cgltf_data;
-struct cgltf_material;
-
 namespace RTGL1
 {
 
@@ -36,6 +34,8 @@ class TextureManager;
 class TextureMetaManager;
 class LightManager;
 
+// Imports a static scene from GLTF. To skip parsing on the next load,
+// the converted data is stored in a binary cache file next to the GLTF.
 class GltfImporter
 {
 public:
@@ -58,10 +58,19 @@ public:
     explicit operator bool() const;
 
 private:
-    cgltf_data*           data;
+    bool TryLoadCache( const std::filesystem::path& cachePath, uint64_t key );
+    bool ParseGltf( const RgTransform& worldTransform, uint64_t key );
+
+private:
     std::string           gltfPath;
     std::filesystem::path gltfFolder;
     float                 oneGameUnitInMeters;
+
+    // either a mapped cache file, or a freshly built one
+    std::unique_ptr< MappedFile > cacheFile;
+    std::vector< std::byte >      builtCache;
+
+    std::optional< scenecache::View > cached;
 };
 
 }
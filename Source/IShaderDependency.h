@@ -25,6 +25,8 @@ namespace RTGL1
 
 class ShaderManager;
 
+// OnShaderReload is called on a worker thread, concurrently with other dependencies.
+// So it must only (re)create pipelines, and not allocate memory or record commands.
 class IShaderDependency
 {
 public:
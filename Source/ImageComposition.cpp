@@ -33,7 +33,6 @@ constexpr auto LPM_BUFFER_SIZE = sizeof( uint32_t ) * 24 * 4;
 RTGL1::ImageComposition::ImageComposition( VkDevice                           _device,
                                            std::shared_ptr< MemoryAllocator > _allocator,
                                            std::shared_ptr< Framebuffers >    _framebuffers,
-                                           const ShaderManager&               _shaderManager,
                                            const GlobalUniform&               _uniform,
                                            const Tonemapping&                 _tonemapping )
     : device( _device )
@@ -71,8 +70,6 @@ RTGL1::ImageComposition::ImageComposition( VkDevice                           _d
         checkerboardPipelineLayout = CreatePipelineLayout(
             device, setLayouts, std::size( setLayouts ), "Checkerboard pipeline layout" );
     }
-
-    CreatePipelines( &_shaderManager );
 }
 
 RTGL1::ImageComposition::~ImageComposition()
@@ -305,7 +302,7 @@ void RTGL1::ImageComposition::CreatePipelines( const ShaderManager* shaderManage
         };
 
         VkResult r = vkCreateComputePipelines(
-            device, VK_NULL_HANDLE, 1, &plInfo, nullptr, &composePipeline );
+            device, shaderManager->GetPipelineCache(), 1, &plInfo, nullptr, &composePipeline );
 
         VK_CHECKERROR( r );
         SET_DEBUG_NAME( device, composePipeline, VK_OBJECT_TYPE_PIPELINE, "Composition pipeline" );
@@ -318,7 +315,7 @@ void RTGL1::ImageComposition::CreatePipelines( const ShaderManager* shaderManage
         };
 
         VkResult r = vkCreateComputePipelines(
-            device, VK_NULL_HANDLE, 1, &plInfo, nullptr, &checkerboardPipeline );
+            device, shaderManager->GetPipelineCache(), 1, &plInfo, nullptr, &checkerboardPipeline );
 
         VK_CHECKERROR( r );
         SET_DEBUG_NAME(
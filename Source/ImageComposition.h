@@ -37,7 +37,6 @@ public:
     ImageComposition( VkDevice                           device,
                       std::shared_ptr< MemoryAllocator > allocator,
                       std::shared_ptr< Framebuffers >    framebuffers,
-                      const ShaderManager&               shaderManager,
                       const GlobalUniform&               uniform,
                       const Tonemapping&                 tonemapping );
     ~ImageComposition() override;
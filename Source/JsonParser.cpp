@@ -210,6 +210,18 @@ JSON_TYPE( RTGL1::LibraryConfig )
     , "vulkanValidation", &T::vulkanValidation
     , "dlssValidation", &T::dlssValidation
     , "fpsMonitor", &T::fpsMonitor
+    , "asyncTextureLoading", &T::asyncTextureLoading
+    , "textureLoaderThreadCount", &T::textureLoaderThreadCount
+    , "staticMeshInstancing", &T::staticMeshInstancing
+    , "dynamicBlasMaxRefitCount", &T::dynamicBlasMaxRefitCount
+    , "staticSectorShare", &T::staticSectorShare
+    , "frameProfiler", &T::frameProfiler
+    , "rasterPipelineFallback", &T::rasterPipelineFallback
+    , "lightTree", &T::lightTree
+    , "compactStaticVertices", &T::compactStaticVertices
+    , "transientFramebufferAliasing", &T::transientFramebufferAliasing
+    , "asyncCompute", &T::asyncCompute
+    , "parallelCmdRecording", &T::parallelCmdRecording
 JSON_TYPE_END;
 // clang-format on
 
@@ -40,6 +40,56 @@ struct LibraryConfig
     bool vulkanValidation = false;
     bool dlssValidation   = false;
     bool fpsMonitor       = false;
+
+    // Read and decode texture override files on background threads
+    bool     asyncTextureLoading      = false;
+    // If 0, the count is chosen from the hardware concurrency
+    uint32_t textureLoaderThreadCount = 0;
+
+    // Static meshes with the same name share one BLAS, and are placed by TLAS instances.
+    // Each instance still has its own geometry infos, so the total amount of instanced
+    // primitives is limited by MAX_STATIC_BOTTOM_LEVEL_GEOMETRIES_COUNT (16384) per filter
+    // group, not by MAX_TOP_LEVEL_INSTANCE_COUNT.
+    bool staticMeshInstancing = false;
+
+    // Dynamic BLAS with unchanged geometry set and vertex / index counts is refit
+    // instead of rebuilding, but fully rebuilt after this amount of refits.
+    // If 0, dynamic BLAS-es are always rebuilt.
+    uint32_t dynamicBlasMaxRefitCount = 30;
+
+    // Fraction of static vertex buffers and geometry infos, that is reserved
+    // for static sectors (rgUploadStaticSector). If 0, sectors are disabled.
+    float staticSectorShare = 0.0f;
+
+    // Per-pass GPU timestamps and per-API-function CPU timers,
+    // see rgGetFrameStatistics
+    bool frameProfiler = false;
+
+    // If a rasterization pipeline permutation is not compiled yet, draw with the closest
+    // compiled one, while the required one is being compiled on a background thread
+    bool rasterPipelineFallback = false;
+
+    // Choose initial light candidates for ReSTIR with a light BVH built on the CPU,
+    // instead of a uniform distribution. Helps, if there are thousands of lights.
+    bool lightTree = false;
+
+    // Store static vertices in a 24-byte layout (octahedral normal, half texture coordinates)
+    // instead of 64 bytes. Vertex tangents are not kept, texture coordinates lose precision
+    // if they are large.
+    bool compactStaticVertices = false;
+
+    // Framebuffers that are used only within a part of a frame share memory with
+    // other such framebuffers, if their lifetimes don't overlap. Saves memory at high
+    // resolutions, but their contents can't be inspected after the frame.
+    bool transientFramebufferAliasing = false;
+
+    // Build the light grid on the async compute queue, while primary rays are traced.
+    // Ignored, if there's no separate compute queue family
+    bool asyncCompute = false;
+
+    // Record the draws of the rasterized passes (sky, world with lens flares, swapchain)
+    // into secondary command buffers on worker threads
+    bool parallelCmdRecording = false;
 };
 
 
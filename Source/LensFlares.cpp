@@ -143,7 +143,6 @@ RTGL1::LensFlares::LensFlares( VkDevice                            _device,
                                                  1 /* emission, for compatibility */,
                                                  _instanceInfo.rasterizedVertexColorGamma );
 
-    CreatePipelines( &_shaderManager );
 }
 
 RTGL1::LensFlares::~LensFlares()
@@ -554,7 +553,8 @@ void RTGL1::LensFlares::CreatePipelines( const ShaderManager* shaderManager )
     };
     info.stage.pSpecializationInfo = &spec;
 
-    VkResult r = vkCreateComputePipelines( device, nullptr, 1, &info, nullptr, &cullPipeline );
+    VkResult r = vkCreateComputePipelines(
+        device, shaderManager->GetPipelineCache(), 1, &info, nullptr, &cullPipeline );
     VK_CHECKERROR( r );
 }
 
@@ -26,7 +26,6 @@
 
 RTGL1::LightGrid::LightGrid(
     VkDevice _device,
-    const std::shared_ptr<ShaderManager> &_shaderManager,
     const std::shared_ptr<GlobalUniform> &_uniform,
     const std::shared_ptr<BlueNoise> &_blueNoise,
     const std::shared_ptr<LightManager> &_lightManager
@@ -53,7 +52,6 @@ RTGL1::LightGrid::LightGrid(
     SET_DEBUG_NAME(device, pipelineLayout, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "Light grid pipeline layout");
 
 
-    CreatePipelines(_shaderManager.get());
 }
 
 RTGL1::LightGrid::~LightGrid()
@@ -106,7 +104,7 @@ void RTGL1::LightGrid::CreatePipelines(const ShaderManager* shaderManager)
     plInfo.layout = pipelineLayout;
     plInfo.stage = shaderManager->GetStageInfo("CLightGridBuild");
 
-    VkResult r = vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &plInfo, nullptr, &gridBuildPipeline);
+    VkResult r = vkCreateComputePipelines(device, shaderManager->GetPipelineCache(), 1, &plInfo, nullptr, &gridBuildPipeline);
     VK_CHECKERROR(r);
 
     SET_DEBUG_NAME(device, gridBuildPipeline, VK_OBJECT_TYPE_PIPELINE, "Light grid build pipeline");
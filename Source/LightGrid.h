@@ -32,7 +32,6 @@ namespace RTGL1
     public:
         LightGrid(
             VkDevice device,
-            const std::shared_ptr<ShaderManager> &shaderManager,
             const std::shared_ptr<GlobalUniform> &uniform,
             const std::shared_ptr<BlueNoise> &blueNoise,
             const std::shared_ptr<LightManager> &lightManager);
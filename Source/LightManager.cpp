@@ -20,8 +20,10 @@
 
 #include "LightManager.h"
 
-#include <cmath>
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <ranges>
 
 #include "Generated/ShaderCommonC.h"
 #include "CmdLabel.h"
@@ -43,27 +45,39 @@ constexpr VkDeviceSize GRID_LIGHTS_COUNT =
 }
 
 RTGL1::LightManager::LightManager( VkDevice                            _device,
-                                   std::shared_ptr< MemoryAllocator >& _allocator )
+                                   std::shared_ptr< MemoryAllocator >& _allocator,
+                                   bool                                _useLightTree )
     : device( _device )
     , regLightCount( 0 )
     , regLightCount_Prev( 0 )
     , dirLightCount( 0 )
     , dirLightCount_Prev( 0 )
+    , staticLightCount( 0 )
+    , staticLightCount_Prev( 0 )
+    , staticVersion( 0 )
+    , staticVersion_Prev( 0 )
+    , staticUploadNeeded( false )
+    , staticMatchedVersion{}
     , descSetLayout( VK_NULL_HANDLE )
     , descPool( VK_NULL_HANDLE )
     , descSets{}
     , needDescSetUpdate{}
 {
     lightsBuffer = std::make_shared< AutoBuffer >( _allocator );
+    // the buffers of the descriptor set are accessed
+    // by the light grid build, that can be on the async compute queue
     lightsBuffer->Create( sizeof( ShLightEncoded ) * LIGHT_ARRAY_MAX_SIZE,
                           VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                          "Lights buffer" );
+                          "Lights buffer",
+                          MAX_FRAMES_IN_FLIGHT,
+                          true );
 
     lightsBuffer_Prev.Init( *_allocator,
                             sizeof( ShLightEncoded ) * LIGHT_ARRAY_MAX_SIZE,
                             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                            "Lights buffer - prev" );
+                            "Lights buffer - prev",
+                            true );
 
     for( auto& buf : initialLightsGrid )
     {
@@ -71,18 +85,39 @@ RTGL1::LightManager::LightManager( VkDevice                            _device,
                   sizeof( ShLightInCell ) * GRID_LIGHTS_COUNT,
                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
                   VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                  "Lights grid" );
+                  "Lights grid",
+                  true );
     }
 
     prevToCurIndex = std::make_shared< AutoBuffer >( _allocator );
     prevToCurIndex->Create( sizeof( uint32_t ) * LIGHT_ARRAY_MAX_SIZE,
                             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                            "Lights buffer - prev to cur" );
+                            "Lights buffer - prev to cur",
+                            MAX_FRAMES_IN_FLIGHT,
+                            true );
 
     curToPrevIndex = std::make_shared< AutoBuffer >( _allocator );
     curToPrevIndex->Create( sizeof( uint32_t ) * LIGHT_ARRAY_MAX_SIZE,
                             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                            "Lights buffer - cur to prev" );
+                            "Lights buffer - cur to prev",
+                            MAX_FRAMES_IN_FLIGHT,
+                            true );
+
+    if( _useLightTree )
+    {
+        lightTree = std::make_unique< LightTree >();
+    }
+
+    // a descriptor must point to a valid buffer, even if the tree is not used
+    const uint32_t maxTreeNodeCount =
+        lightTree ? LightTree::GetMaxNodeCount( LIGHT_ARRAY_MAX_SIZE ) : 1;
+
+    lightTreeNodes = std::make_shared< AutoBuffer >( _allocator );
+    lightTreeNodes->Create( sizeof( ShLightTreeNode ) * maxTreeNodeCount,
+                            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                            "Light tree nodes",
+                            MAX_FRAMES_IN_FLIGHT,
+                            true );
 
     CreateDescriptors();
 }
@@ -243,10 +278,13 @@ uint32_t GetLightArrayEnd( uint32_t regCount, uint32_t dirCount )
 
 void RTGL1::LightManager::PrepareForFrame( VkCommandBuffer cmd, uint32_t frameIndex )
 {
-    regLightCount_Prev = regLightCount;
-    dirLightCount_Prev = dirLightCount;
+    regLightCount_Prev    = regLightCount;
+    dirLightCount_Prev    = dirLightCount;
+    staticLightCount_Prev = staticLightCount;
+    staticVersion_Prev    = staticVersion;
 
-    regLightCount = 0;
+    // static block stays, dynamic lights are added after it
+    regLightCount = staticLightCount;
     dirLightCount = 0;
 
     // TODO: similar system to just swap desc sets, instead of actual copying
@@ -263,12 +301,22 @@ void RTGL1::LightManager::PrepareForFrame( VkCommandBuffer cmd, uint32_t frameIn
             cmd, lightsBuffer->GetDeviceLocal(), lightsBuffer_Prev.GetBuffer(), 1, &info );
     }
 
-    memset( prevToCurIndex->GetMapped( frameIndex ),
-            0xFF,
-            sizeof( uint32_t ) * GetLightArrayEnd( regLightCount_Prev, dirLightCount_Prev ) );
+    {
+        // static block is matched in FillMatchPrevStatic
+        const uint32_t staticEnd = GetLightArrayEnd( staticLightCount_Prev, 0 );
+        const uint32_t prevEnd   = GetLightArrayEnd( regLightCount_Prev, dirLightCount_Prev );
+
+        auto* prev2cur = prevToCurIndex->GetMappedAs< uint32_t* >( frameIndex );
+        memset( prev2cur, 0xFF, sizeof( uint32_t ) * LIGHT_ARRAY_REGULAR_LIGHTS_OFFSET );
+        memset( prev2cur + staticEnd, 0xFF, sizeof( uint32_t ) * ( prevEnd - staticEnd ) );
+    }
     // no need to clear curToPrevIndex, as it'll be filled in the cur frame
 
     uniqueIDToArrayIndex[ frameIndex ].clear();
+
+    // keep only the static block
+    treeLights.resize( staticEncoded.size() );
+    treeLightIDs.resize( staticIDs.size() );
 }
 
 void RTGL1::LightManager::Reset()
@@ -287,10 +335,21 @@ void RTGL1::LightManager::Reset()
                               GetLightArrayEnd( regLightCount_Prev, dirLightCount_Prev ) ) );
 
         uniqueIDToArrayIndex[ i ].clear();
+        staticMatchedVersion[ i ] = 0;
     }
 
+    treeLights.clear();
+    treeLightIDs.clear();
+
+    staticEncoded.clear();
+    staticIDs.clear();
+    staticIDToArrayIndex.clear();
+    staticVersion++;
+    staticUploadNeeded = false;
+
     regLightCount_Prev = regLightCount = 0;
     dirLightCount_Prev = dirLightCount = 0;
+    staticLightCount_Prev = staticLightCount = 0;
 }
 
 RTGL1::LightArrayIndex RTGL1::LightManager::GetIndex( const ShLightEncoded& encodedLight ) const
@@ -335,6 +394,15 @@ void RTGL1::LightManager::AddInternal( uint32_t              frameIndex,
     auto* dst = lightsBuffer->GetMappedAs< ShLightEncoded* >( frameIndex );
     memcpy( &dst[ index.GetArrayIndex() ], &encodedLight, sizeof( ShLightEncoded ) );
 
+    if( lightTree && encodedLight.lightType != LIGHT_TYPE_DIRECTIONAL )
+    {
+        // regular lights are added sequentially, so the array index is implied
+        assert( index.GetArrayIndex() == LIGHT_ARRAY_REGULAR_LIGHTS_OFFSET + treeLights.size() );
+
+        treeLights.push_back( encodedLight );
+        treeLightIDs.push_back( uniqueId );
+    }
+
 
     FillMatchPrev( frameIndex, index, uniqueId );
     // must be unique
@@ -382,49 +450,79 @@ float CalculateLightStyle( const T& l, std::span< const float > lightstyles )
     return 1.0f;
 }
 
-}
-
-void RTGL1::LightManager::Add( uint32_t frameIndex, const RgSphericalLightUploadInfo& info )
+std::optional< RTGL1::ShLightEncoded > TryEncode( const RgSphericalLightUploadInfo& info,
+                                                   float                             mult )
 {
     if( IsLightColorTooDim( info ) )
     {
-        return;
+        return std::nullopt;
     }
 
-    AddInternal( frameIndex,
-                 info.uniqueID,
-                 EncodeAsSphereLight( info, CalculateLightStyle( info, lightstyles ) ) );
+    return EncodeAsSphereLight( info, mult );
 }
 
-void RTGL1::LightManager::Add( uint32_t frameIndex, const RgPolygonalLightUploadInfo& info )
+std::optional< RTGL1::ShLightEncoded > TryEncode( const RgPolygonalLightUploadInfo& info,
+                                                   float                             mult )
 {
     if( IsLightColorTooDim( info ) )
     {
-        return;
+        return std::nullopt;
     }
 
-    RgFloat3D unnormalizedNormal = Utils::GetUnnormalizedNormal( info.positions );
-    if( Utils::Dot( unnormalizedNormal.data, unnormalizedNormal.data ) <= 0.0f )
+    RgFloat3D unnormalizedNormal = RTGL1::Utils::GetUnnormalizedNormal( info.positions );
+    if( RTGL1::Utils::Dot( unnormalizedNormal.data, unnormalizedNormal.data ) <= 0.0f )
     {
-        return;
+        return std::nullopt;
     }
 
-    AddInternal( frameIndex,
-                 info.uniqueID,
-                 EncodeAsTriangleLight(
-                     info, unnormalizedNormal, CalculateLightStyle( info, lightstyles ) ) );
+    return EncodeAsTriangleLight( info, unnormalizedNormal, mult );
 }
 
-void RTGL1::LightManager::Add( uint32_t frameIndex, const RgSpotLightUploadInfo& info )
+std::optional< RTGL1::ShLightEncoded > TryEncode( const RgSpotLightUploadInfo& info, float mult )
 {
     if( IsLightColorTooDim( info ) || info.radius < 0.0f || info.angleOuter <= 0.0f )
     {
-        return;
+        return std::nullopt;
+    }
+
+    return EncodeAsSpotLight( info, mult );
+}
+
+std::optional< RTGL1::ShLightEncoded > TryEncode( const RgDirectionalLightUploadInfo& info,
+                                                   float                               mult )
+{
+    if( IsLightColorTooDim( info ) || info.angularDiameterDegrees < 0.0f )
+    {
+        return std::nullopt;
+    }
+
+    return EncodeAsDirectionalLight( info, mult );
+}
+
+}
+
+void RTGL1::LightManager::Add( uint32_t frameIndex, const RgSphericalLightUploadInfo& info )
+{
+    if( auto encoded = TryEncode( info, CalculateLightStyle( info, lightstyles ) ) )
+    {
+        AddInternal( frameIndex, info.uniqueID, *encoded );
+    }
+}
+
+void RTGL1::LightManager::Add( uint32_t frameIndex, const RgPolygonalLightUploadInfo& info )
+{
+    if( auto encoded = TryEncode( info, CalculateLightStyle( info, lightstyles ) ) )
+    {
+        AddInternal( frameIndex, info.uniqueID, *encoded );
     }
+}
 
-    AddInternal( frameIndex,
-                 info.uniqueID,
-                 EncodeAsSpotLight( info, CalculateLightStyle( info, lightstyles ) ) );
+void RTGL1::LightManager::Add( uint32_t frameIndex, const RgSpotLightUploadInfo& info )
+{
+    if( auto encoded = TryEncode( info, CalculateLightStyle( info, lightstyles ) ) )
+    {
+        AddInternal( frameIndex, info.uniqueID, *encoded );
+    }
 }
 
 void RTGL1::LightManager::Add( uint32_t frameIndex, const RgDirectionalLightUploadInfo& info )
@@ -435,24 +533,115 @@ void RTGL1::LightManager::Add( uint32_t frameIndex, const RgDirectionalLightUplo
         return;
     }
 
-    if( IsLightColorTooDim( info ) || info.angularDiameterDegrees < 0.0f )
+    if( auto encoded = TryEncode( info, CalculateLightStyle( info, lightstyles ) ) )
     {
-        return;
+        AddInternal( frameIndex, info.uniqueID, *encoded );
+    }
+}
+
+bool RTGL1::LightManager::IsCacheableStatic( const GenericLight& light )
+{
+    return std::visit(
+        []< typename T >( const T& specific ) {
+            // directional light is not in the regular light block;
+            // lightstyle can change the intensity every frame
+            return !std::is_same_v< T, RgDirectionalLightUploadInfo > &&
+                   !( specific.extra.exists && specific.extra.lightstyle >= 0 );
+        },
+        light );
+}
+
+void RTGL1::LightManager::SetStaticLights( std::span< const GenericLight > lights )
+{
+    // static block is at the start of the regular lights, so no dynamic light must be added yet
+    assert( regLightCount == staticLightCount );
+
+    staticEncoded.clear();
+    staticIDs.clear();
+    staticIDToArrayIndex.clear();
+
+    for( const GenericLight& l : lights )
+    {
+        if( !IsCacheableStatic( l ) )
+        {
+            continue;
+        }
+
+        if( GetLightArrayEnd( uint32_t( staticEncoded.size() ), 0 ) >= LIGHT_ARRAY_MAX_SIZE )
+        {
+            assert( 0 );
+            break;
+        }
+
+        auto encoded =
+            std::visit( []( const auto& specific ) { return TryEncode( specific, 1.0f ); }, l );
+        if( !encoded )
+        {
+            continue;
+        }
+
+        UniqueLightID uniqueId =
+            std::visit( []( const auto& specific ) { return specific.uniqueID; }, l );
+
+        staticIDToArrayIndex[ uniqueId ] =
+            LightArrayIndex{ LIGHT_ARRAY_REGULAR_LIGHTS_OFFSET + uint32_t( staticEncoded.size() ) };
+        staticEncoded.push_back( *encoded );
+        staticIDs.push_back( uniqueId );
     }
 
-    AddInternal( frameIndex,
-                 info.uniqueID,
-                 EncodeAsDirectionalLight( info, CalculateLightStyle( info, lightstyles ) ) );
+    staticLightCount = uint32_t( staticEncoded.size() );
+    regLightCount    = staticLightCount;
+
+    staticVersion++;
+    staticUploadNeeded = true;
+
+    if( lightTree )
+    {
+        treeLights   = staticEncoded;
+        treeLightIDs = staticIDs;
+    }
 }
 
 void RTGL1::LightManager::SubmitForFrame( VkCommandBuffer cmd, uint32_t frameIndex )
 {
     CmdLabel label( cmd, "Copying lights" );
 
-    lightsBuffer->CopyFromStaging( cmd,
-                                   frameIndex,
-                                   sizeof( ShLightEncoded ) *
-                                       GetLightArrayEnd( regLightCount, dirLightCount ) );
+    if( staticUploadNeeded )
+    {
+        auto* dst = lightsBuffer->GetMappedAs< ShLightEncoded* >( frameIndex );
+        memcpy( &dst[ LIGHT_ARRAY_REGULAR_LIGHTS_OFFSET ],
+                staticEncoded.data(),
+                sizeof( ShLightEncoded ) * staticEncoded.size() );
+
+        lightsBuffer->CopyFromStaging( cmd,
+                                       frameIndex,
+                                       sizeof( ShLightEncoded ) *
+                                           GetLightArrayEnd( regLightCount, dirLightCount ) );
+        staticUploadNeeded = false;
+    }
+    else
+    {
+        // static block is already in the device local buffer
+        const VkDeviceSize staticEnd = GetLightArrayEnd( staticLightCount, 0 );
+        const VkDeviceSize end       = GetLightArrayEnd( regLightCount, dirLightCount );
+
+        const VkBufferCopy copies[] = {
+            {
+                .srcOffset = 0,
+                .dstOffset = 0,
+                .size      = sizeof( ShLightEncoded ) * LIGHT_ARRAY_REGULAR_LIGHTS_OFFSET,
+            },
+            {
+                .srcOffset = sizeof( ShLightEncoded ) * staticEnd,
+                .dstOffset = sizeof( ShLightEncoded ) * staticEnd,
+                .size      = sizeof( ShLightEncoded ) * ( end - staticEnd ),
+            },
+        };
+
+        lightsBuffer->CopyFromStaging( cmd, frameIndex, copies, end > staticEnd ? 2 : 1 );
+    }
+
+    FillMatchPrevStatic( frameIndex );
 
     prevToCurIndex->CopyFromStaging(
         cmd,
@@ -461,6 +650,21 @@ void RTGL1::LightManager::SubmitForFrame( VkCommandBuffer cmd, uint32_t frameInd
     curToPrevIndex->CopyFromStaging(
         cmd, frameIndex, sizeof( uint32_t ) * GetLightArrayEnd( regLightCount, dirLightCount ) );
 
+    if( lightTree )
+    {
+        uint32_t nodeCount = lightTree->Build( treeLights, treeLightIDs );
+        assert( nodeCount == GetLightTreeNodeCount() );
+
+        if( nodeCount > 0 )
+        {
+            memcpy( lightTreeNodes->GetMapped( frameIndex ),
+                    lightTree->GetNodes(),
+                    sizeof( ShLightTreeNode ) * nodeCount );
+            lightTreeNodes->CopyFromStaging(
+                cmd, frameIndex, sizeof( ShLightTreeNode ) * nodeCount );
+        }
+    }
+
     // should be used when buffers changed
     if( needDescSetUpdate[ frameIndex ] )
     {
@@ -505,6 +709,40 @@ VkDescriptorSet RTGL1::LightManager::GetDescSet( uint32_t frameIndex ) const
     return descSets[ frameIndex ];
 }
 
+void RTGL1::LightManager::FillMatchPrevStatic( uint32_t frameIndex )
+{
+    auto* prev2cur = prevToCurIndex->GetMappedAs< uint32_t* >( frameIndex );
+    auto* cur2prev = curToPrevIndex->GetMappedAs< uint32_t* >( frameIndex );
+
+    if( staticVersion != staticVersion_Prev )
+    {
+        // static block was replaced in this frame, nothing to match
+        memset( &prev2cur[ LIGHT_ARRAY_REGULAR_LIGHTS_OFFSET ],
+                0xFF,
+                sizeof( uint32_t ) * staticLightCount_Prev );
+        memset( &cur2prev[ LIGHT_ARRAY_REGULAR_LIGHTS_OFFSET ],
+                0xFF,
+                sizeof( uint32_t ) * staticLightCount );
+
+        staticMatchedVersion[ frameIndex ] = 0;
+        return;
+    }
+
+    // staging buffers of this frame already have the same block
+    if( staticMatchedVersion[ frameIndex ] == staticVersion )
+    {
+        return;
+    }
+
+    // static lights have the same indices in both frames
+    auto staticIndices = std::views::iota( uint32_t( LIGHT_ARRAY_REGULAR_LIGHTS_OFFSET ),
+                                           GetLightArrayEnd( staticLightCount, 0 ) );
+    std::ranges::copy( staticIndices, &prev2cur[ LIGHT_ARRAY_REGULAR_LIGHTS_OFFSET ] );
+    std::ranges::copy( staticIndices, &cur2prev[ LIGHT_ARRAY_REGULAR_LIGHTS_OFFSET ] );
+
+    staticMatchedVersion[ frameIndex ] = staticVersion;
+}
+
 void RTGL1::LightManager::FillMatchPrev( uint32_t        curFrameIndex,
                                          LightArrayIndex lightIndexInCurFrame,
                                          UniqueLightID   uniqueID )
@@ -535,6 +773,7 @@ constexpr uint32_t BINDINGS[] = {
     BINDING_LIGHT_SOURCES_INDEX_CUR_TO_PREV,
     BINDING_INITIAL_LIGHTS_GRID,
     BINDING_INITIAL_LIGHTS_GRID_PREV,
+    BINDING_LIGHT_TREE_NODES,
 };
 
 void RTGL1::LightManager::CreateDescriptors()
@@ -621,6 +860,7 @@ void RTGL1::LightManager::UpdateDescriptors( uint32_t frameIndex )
         initialLightsGrid[ frameIndex ].GetBuffer(),
         initialLightsGrid[ Utils::GetPreviousByModulo( frameIndex, MAX_FRAMES_IN_FLIGHT ) ]
             .GetBuffer(),
+        lightTreeNodes->GetDeviceLocal(),
     };
     static_assert( std::size( BINDINGS ) == std::size( buffers ) );
 
@@ -670,6 +910,11 @@ uint32_t RTGL1::LightManager::DoesDirectionalLightExist() const
     return dirLightCount > 0 ? 1 : 0;
 }
 
+uint32_t RTGL1::LightManager::GetLightTreeNodeCount() const
+{
+    return lightTree ? LightTree::GetMaxNodeCount( regLightCount ) : 0;
+}
+
 uint32_t RTGL1::LightManager::GetLightIndexForShaders( uint32_t  frameIndex,
                                                        uint64_t* pLightUniqueId ) const
 {
@@ -682,7 +927,13 @@ uint32_t RTGL1::LightManager::GetLightIndexForShaders( uint32_t  frameIndex,
     const auto f = uniqueIDToArrayIndex[ frameIndex ].find( uniqueId );
     if( f == uniqueIDToArrayIndex[ frameIndex ].end() )
     {
-        return LIGHT_INDEX_NONE;
+        const auto s = staticIDToArrayIndex.find( uniqueId );
+        if( s == staticIDToArrayIndex.end() )
+        {
+            return LIGHT_INDEX_NONE;
+        }
+
+        return s->second.GetArrayIndex();
     }
 
     return f->second.GetArrayIndex();
@@ -25,6 +25,7 @@
 #include "Containers.h"
 #include "AutoBuffer.h"
 #include "LightDefs.h"
+#include "LightTree.h"
 
 #include <optional>
 #include <span>
@@ -37,7 +38,9 @@ struct ShLightEncoded;
 class LightManager
 {
 public:
-    LightManager( VkDevice device, std::shared_ptr< MemoryAllocator >& allocator );
+    LightManager( VkDevice                            device,
+                  std::shared_ptr< MemoryAllocator >& allocator,
+                  bool                                useLightTree );
     ~LightManager();
 
     LightManager( const LightManager& other )                = delete;
@@ -51,6 +54,7 @@ public:
     uint32_t GetLightCount() const;
     uint32_t GetLightCountPrev() const;
     uint32_t DoesDirectionalLightExist() const;
+    uint32_t GetLightTreeNodeCount() const;
 
     uint32_t GetLightIndexForShaders( uint32_t frameIndex, uint64_t* pLightUniqueId ) const;
 
@@ -59,6 +63,12 @@ public:
     void Add( uint32_t frameIndex, const RgDirectionalLightUploadInfo& info );
     void Add( uint32_t frameIndex, const RgSpotLightUploadInfo& info );
 
+    // Static lights that can be cached are encoded only once into a block at the start
+    // of the regular lights, and only dynamic lights are added after it each frame.
+    // Must be called before any Add in the frame.
+    void        SetStaticLights( std::span< const GenericLight > lights );
+    static bool IsCacheableStatic( const GenericLight& light );
+
     void SubmitForFrame( VkCommandBuffer cmd, uint32_t frameIndex );
     void BarrierLightGrid( VkCommandBuffer cmd, uint32_t frameIndex );
 
@@ -83,6 +93,7 @@ private:
     void FillMatchPrev( uint32_t        curFrameIndex,
                         LightArrayIndex lightIndexInCurFrame,
                         UniqueLightID   uniqueID );
+    void FillMatchPrevStatic( uint32_t frameIndex );
 
     void CreateDescriptors();
     void UpdateDescriptors( uint32_t frameIndex );
@@ -93,6 +104,12 @@ private:
     std::shared_ptr< AutoBuffer > lightsBuffer;
     Buffer                        lightsBuffer_Prev;
     Buffer                        initialLightsGrid[ MAX_FRAMES_IN_FLIGHT ];
+    std::shared_ptr< AutoBuffer > lightTreeNodes;
+
+    // if null, initial light candidates are chosen uniformly
+    std::unique_ptr< LightTree >  lightTree;
+    std::vector< ShLightEncoded > treeLights;
+    std::vector< UniqueLightID >  treeLightIDs;
 
     // Match light indices between current and previous frames
     std::shared_ptr< AutoBuffer > prevToCurIndex;
@@ -101,6 +118,18 @@ private:
     rgl::unordered_map< UniqueLightID, LightArrayIndex >
         uniqueIDToArrayIndex[ MAX_FRAMES_IN_FLIGHT ];
 
+    // Static block keeps its place in the light array while static lights are the same
+    std::vector< ShLightEncoded >                        staticEncoded;
+    std::vector< UniqueLightID >                         staticIDs;
+    rgl::unordered_map< UniqueLightID, LightArrayIndex > staticIDToArrayIndex;
+    uint32_t                                             staticLightCount;
+    uint32_t                                             staticLightCount_Prev;
+    uint64_t                                             staticVersion;
+    uint64_t                                             staticVersion_Prev;
+    bool                                                 staticUploadNeeded;
+    // version, for which the staging index buffers have the static block matched
+    uint64_t staticMatchedVersion[ MAX_FRAMES_IN_FLIGHT ];
+
     uint32_t regLightCount;
     uint32_t regLightCount_Prev;
     uint32_t dirLightCount;
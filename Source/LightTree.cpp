@@ -0,0 +1,389 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "LightTree.h"
+
+#include "Utils.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+
+namespace RTGL1
+{
+namespace
+{
+    constexpr float PI = 3.14159265358979323846f;
+
+    // subtrees below this depth are built on worker threads
+    constexpr uint32_t PARALLEL_SPLIT_DEPTH = 3;
+    // smaller ranges are not worth a separate task
+    constexpr uint32_t MIN_PARALLEL_LIGHT_COUNT = 256;
+    // refit loosens the bounds, if lights are moving
+    constexpr uint32_t MAX_REFIT_COUNT = 30;
+
+    ShLightTreeNode MakeLeaf( const ShLightEncoded& l, uint32_t lightArrayIndex )
+    {
+        ShLightTreeNode n = {};
+
+        const float* p0 = l.data_0;
+        const float* p1 = l.data_1;
+        const float* p2 = l.data_2;
+
+        float area = 0.0f;
+
+        switch( l.lightType )
+        {
+            case LIGHT_TYPE_SPHERE:
+            case LIGHT_TYPE_SPOT: {
+                float radius = l.data_0[ 3 ];
+                for( int i = 0; i < 3; i++ )
+                {
+                    n.aabbMin[ i ] = p0[ i ] - radius;
+                    n.aabbMax[ i ] = p0[ i ] + radius;
+                }
+                area = PI * radius * radius;
+
+                if( l.lightType == LIGHT_TYPE_SPOT )
+                {
+                    n.coneAxis[ 0 ] = l.data_1[ 0 ];
+                    n.coneAxis[ 1 ] = l.data_1[ 1 ];
+                    n.coneAxis[ 2 ] = l.data_1[ 2 ];
+                    // outer angle
+                    n.coneCosAngle = l.data_2[ 1 ];
+                }
+                else
+                {
+                    n.coneAxis[ 2 ] = 1.0f;
+                    n.coneCosAngle  = -1.0f;
+                }
+                break;
+            }
+            case LIGHT_TYPE_TRIANGLE: {
+                for( int i = 0; i < 3; i++ )
+                {
+                    n.aabbMin[ i ] = std::min( { p0[ i ], p1[ i ], p2[ i ] } );
+                    n.aabbMax[ i ] = std::max( { p0[ i ], p1[ i ], p2[ i ] } );
+                }
+
+                float unnormalizedNormal[] = { l.data_0[ 3 ], l.data_1[ 3 ], l.data_2[ 3 ] };
+                area = Utils::Length( unnormalizedNormal ) * 0.5f;
+
+                Utils::Normalize( unnormalizedNormal );
+                n.coneAxis[ 0 ] = unnormalizedNormal[ 0 ];
+                n.coneAxis[ 1 ] = unnormalizedNormal[ 1 ];
+                n.coneAxis[ 2 ] = unnormalizedNormal[ 2 ];
+                // one-sided, so emits in a hemisphere
+                n.coneCosAngle = 0.0f;
+                break;
+            }
+            default: assert( 0 ); break;
+        }
+
+        // encoded color is divided by area
+        n.power             = Utils::Luminance( l.color ) * area;
+        n.rightChildOrLight = lightArrayIndex | LIGHT_TREE_NODE_LEAF_BIT;
+
+        return n;
+    }
+
+    // Bounding cone of two cones, angles include the emission spread
+    void MergeCones( const ShLightTreeNode& a, const ShLightTreeNode& b, ShLightTreeNode& dst )
+    {
+        auto setFullSphere = [ &dst ]() {
+            dst.coneAxis[ 0 ] = 0.0f;
+            dst.coneAxis[ 1 ] = 0.0f;
+            dst.coneAxis[ 2 ] = 1.0f;
+            dst.coneCosAngle  = -1.0f;
+        };
+
+        auto copyFrom = [ &dst ]( const ShLightTreeNode& src ) {
+            dst.coneAxis[ 0 ] = src.coneAxis[ 0 ];
+            dst.coneAxis[ 1 ] = src.coneAxis[ 1 ];
+            dst.coneAxis[ 2 ] = src.coneAxis[ 2 ];
+            dst.coneCosAngle  = src.coneCosAngle;
+        };
+
+        float angleA = std::acos( std::clamp( a.coneCosAngle, -1.0f, 1.0f ) );
+        float angleB = std::acos( std::clamp( b.coneCosAngle, -1.0f, 1.0f ) );
+        float angleD = std::acos( std::clamp( Utils::Dot( a.coneAxis, b.coneAxis ), -1.0f, 1.0f ) );
+
+        if( std::min( angleD + angleB, PI ) <= angleA )
+        {
+            copyFrom( a );
+            return;
+        }
+        if( std::min( angleD + angleA, PI ) <= angleB )
+        {
+            copyFrom( b );
+            return;
+        }
+
+        float angle = ( angleA + angleD + angleB ) * 0.5f;
+        if( angle >= PI )
+        {
+            setFullSphere();
+            return;
+        }
+
+        // rotate axis of 'a' towards 'b'
+        float dotAB   = Utils::Dot( a.coneAxis, b.coneAxis );
+        float ortho[] = {
+            b.coneAxis[ 0 ] - a.coneAxis[ 0 ] * dotAB,
+            b.coneAxis[ 1 ] - a.coneAxis[ 1 ] * dotAB,
+            b.coneAxis[ 2 ] - a.coneAxis[ 2 ] * dotAB,
+        };
+        if( !Utils::TryNormalize( ortho ) )
+        {
+            setFullSphere();
+            return;
+        }
+
+        float rotation = angle - angleA;
+        for( int i = 0; i < 3; i++ )
+        {
+            dst.coneAxis[ i ] =
+                a.coneAxis[ i ] * std::cos( rotation ) + ortho[ i ] * std::sin( rotation );
+        }
+        dst.coneCosAngle = std::cos( angle );
+    }
+
+    ShLightTreeNode MergeNodes( const ShLightTreeNode& a,
+                                const ShLightTreeNode& b,
+                                uint32_t               rightChild )
+    {
+        ShLightTreeNode n = {};
+
+        for( int i = 0; i < 3; i++ )
+        {
+            n.aabbMin[ i ] = std::min( a.aabbMin[ i ], b.aabbMin[ i ] );
+            n.aabbMax[ i ] = std::max( a.aabbMax[ i ], b.aabbMax[ i ] );
+        }
+        MergeCones( a, b, n );
+
+        n.power             = a.power + b.power;
+        n.rightChildOrLight = rightChild;
+
+        return n;
+    }
+
+    bool IsLeaf( const ShLightTreeNode& n )
+    {
+        return n.rightChildOrLight & LIGHT_TREE_NODE_LEAF_BIT;
+    }
+
+    // Nodes are in depth-first order: a subtree over N lights takes 2N-1 consecutive nodes,
+    // so the right child index is known without building the left subtree
+    uint32_t GetRightChild( uint32_t nodeIndex, uint32_t begin, uint32_t mid )
+    {
+        return nodeIndex + 2 * ( mid - begin );
+    }
+}
+}
+
+RTGL1::LightTree::LightTree()
+    : refitCount( 0 )
+    , workers( std::min( ThreadPool::GetDefaultThreadCount(), 1u << PARALLEL_SPLIT_DEPTH ) )
+{
+}
+
+uint32_t RTGL1::LightTree::Build( std::span< const ShLightEncoded > lights,
+                                  std::span< const UniqueLightID >  uniqueIDs )
+{
+    assert( lights.size() == uniqueIDs.size() );
+
+    if( lights.empty() )
+    {
+        nodes.clear();
+        prevUniqueIDs.clear();
+        return 0;
+    }
+
+    leaves.resize( lights.size() );
+    centroids.resize( lights.size() );
+
+    for( uint32_t i = 0; i < lights.size(); i++ )
+    {
+        const ShLightTreeNode& l = leaves[ i ] =
+            MakeLeaf( lights[ i ], LIGHT_ARRAY_REGULAR_LIGHTS_OFFSET + i );
+
+        centroids[ i ] = { {
+            ( l.aabbMin[ 0 ] + l.aabbMax[ 0 ] ) * 0.5f,
+            ( l.aabbMin[ 1 ] + l.aabbMax[ 1 ] ) * 0.5f,
+            ( l.aabbMin[ 2 ] + l.aabbMax[ 2 ] ) * 0.5f,
+        } };
+    }
+
+    if( refitCount < MAX_REFIT_COUNT && std::ranges::equal( uniqueIDs, prevUniqueIDs ) )
+    {
+        Refit();
+        refitCount++;
+    }
+    else
+    {
+        Rebuild();
+        refitCount = 0;
+        prevUniqueIDs.assign( uniqueIDs.begin(), uniqueIDs.end() );
+    }
+
+    assert( nodes.size() == GetMaxNodeCount( uint32_t( lights.size() ) ) );
+    return uint32_t( nodes.size() );
+}
+
+void RTGL1::LightTree::Refit()
+{
+    // children are always after their parent
+    for( size_t i = nodes.size(); i-- > 0; )
+    {
+        ShLightTreeNode& n = nodes[ i ];
+
+        if( IsLeaf( n ) )
+        {
+            uint32_t lightIndex = n.rightChildOrLight & ~LIGHT_TREE_NODE_LEAF_BIT;
+            n                   = leaves[ lightIndex - LIGHT_ARRAY_REGULAR_LIGHTS_OFFSET ];
+        }
+        else
+        {
+            uint32_t right = n.rightChildOrLight;
+            n              = MergeNodes( nodes[ i + 1 ], nodes[ right ], right );
+        }
+    }
+}
+
+void RTGL1::LightTree::Rebuild()
+{
+    const auto lightCount = uint32_t( leaves.size() );
+
+    nodes.resize( GetMaxNodeCount( lightCount ) );
+    order.resize( lightCount );
+    std::iota( order.begin(), order.end(), 0 );
+
+    std::vector< uint32_t > topNodes;
+    std::vector< Subtree >  subtrees;
+    SplitTopLevels( 0, 0, lightCount, 0, topNodes, subtrees );
+
+    if( subtrees.size() == 1 )
+    {
+        BuildSubtree( subtrees[ 0 ].nodeIndex, subtrees[ 0 ].begin, subtrees[ 0 ].end );
+    }
+    else
+    {
+        std::vector< std::future< void > > tasks;
+        tasks.reserve( subtrees.size() );
+
+        for( const Subtree& s : subtrees )
+        {
+            tasks.push_back(
+                workers.Push( [ this, s ]() { BuildSubtree( s.nodeIndex, s.begin, s.end ); } ) );
+        }
+
+        for( auto& t : tasks )
+        {
+            t.get();
+        }
+    }
+
+    // subtree roots are ready, so the top nodes can be merged bottom-up
+    for( auto it = topNodes.rbegin(); it != topNodes.rend(); ++it )
+    {
+        uint32_t right = nodes[ *it ].rightChildOrLight;
+        nodes[ *it ]   = MergeNodes( nodes[ *it + 1 ], nodes[ right ], right );
+    }
+}
+
+uint32_t RTGL1::LightTree::SplitRange( uint32_t begin, uint32_t end )
+{
+    assert( end - begin >= 2 );
+
+    float cmin[ 3 ] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float cmax[ 3 ] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+    for( uint32_t i = begin; i < end; i++ )
+    {
+        const RgFloat3D& c = centroids[ order[ i ] ];
+        for( int a = 0; a < 3; a++ )
+        {
+            cmin[ a ] = std::min( cmin[ a ], c.data[ a ] );
+            cmax[ a ] = std::max( cmax[ a ], c.data[ a ] );
+        }
+    }
+
+    int axis = 0;
+    for( int a = 1; a < 3; a++ )
+    {
+        if( cmax[ a ] - cmin[ a ] > cmax[ axis ] - cmin[ axis ] )
+        {
+            axis = a;
+        }
+    }
+
+    // median split keeps the tree balanced, so its depth is log2 of the light count
+    uint32_t mid = begin + ( end - begin ) / 2;
+
+    std::nth_element( order.begin() + begin,
+                      order.begin() + mid,
+                      order.begin() + end,
+                      [ this, axis ]( uint32_t x, uint32_t y ) {
+                          return centroids[ x ].data[ axis ] < centroids[ y ].data[ axis ];
+                      } );
+
+    return mid;
+}
+
+void RTGL1::LightTree::SplitTopLevels( uint32_t                 nodeIndex,
+                                       uint32_t                 begin,
+                                       uint32_t                 end,
+                                       uint32_t                 depth,
+                                       std::vector< uint32_t >& topNodes,
+                                       std::vector< Subtree >&  subtrees )
+{
+    if( depth >= PARALLEL_SPLIT_DEPTH || end - begin < MIN_PARALLEL_LIGHT_COUNT )
+    {
+        subtrees.push_back( { nodeIndex, begin, end } );
+        return;
+    }
+
+    uint32_t mid   = SplitRange( begin, end );
+    uint32_t right = GetRightChild( nodeIndex, begin, mid );
+
+    topNodes.push_back( nodeIndex );
+    nodes[ nodeIndex ].rightChildOrLight = right;
+
+    SplitTopLevels( nodeIndex + 1, begin, mid, depth + 1, topNodes, subtrees );
+    SplitTopLevels( right, mid, end, depth + 1, topNodes, subtrees );
+}
+
+void RTGL1::LightTree::BuildSubtree( uint32_t nodeIndex, uint32_t begin, uint32_t end )
+{
+    if( end - begin == 1 )
+    {
+        nodes[ nodeIndex ] = leaves[ order[ begin ] ];
+        return;
+    }
+
+    uint32_t mid   = SplitRange( begin, end );
+    uint32_t right = GetRightChild( nodeIndex, begin, mid );
+
+    BuildSubtree( nodeIndex + 1, begin, mid );
+    BuildSubtree( right, mid, end );
+
+    nodes[ nodeIndex ] = MergeNodes( nodes[ nodeIndex + 1 ], nodes[ right ], right );
+}
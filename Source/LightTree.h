@@ -0,0 +1,94 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "RTGL1/RTGL1.h"
+#include "Generated/ShaderCommonC.h"
+#include "LightDefs.h"
+#include "ThreadPool.h"
+
+#include <span>
+#include <vector>
+
+namespace RTGL1
+{
+
+// Light BVH over regular lights for importance sampling of large light counts.
+// Each node bounds the positions and emission directions of its lights, and sums their power.
+// Top levels are split on the caller's thread, and the subtrees are built on worker threads.
+class LightTree
+{
+public:
+    LightTree();
+    ~LightTree() = default;
+
+    LightTree( const LightTree& other )                = delete;
+    LightTree( LightTree&& other ) noexcept            = delete;
+    LightTree& operator=( const LightTree& other )     = delete;
+    LightTree& operator=( LightTree&& other ) noexcept = delete;
+
+    // 'lights' are regular lights, the first is at LIGHT_ARRAY_REGULAR_LIGHTS_OFFSET.
+    // If the lights have the same unique IDs in the same order as in the previous call,
+    // the tree is not rebuilt, but only its bounds and power are refit.
+    // Returns the node count.
+    uint32_t Build( std::span< const ShLightEncoded > lights,
+                    std::span< const UniqueLightID >  uniqueIDs );
+
+    const ShLightTreeNode* GetNodes() const { return nodes.data(); }
+
+    static constexpr uint32_t GetMaxNodeCount( uint32_t lightCount )
+    {
+        return lightCount > 0 ? lightCount * 2 - 1 : 0;
+    }
+
+private:
+    struct Subtree
+    {
+        uint32_t nodeIndex;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    void Rebuild();
+    void Refit();
+
+    uint32_t SplitRange( uint32_t begin, uint32_t end );
+    void     SplitTopLevels( uint32_t                 nodeIndex,
+                             uint32_t                 begin,
+                             uint32_t                 end,
+                             uint32_t                 depth,
+                             std::vector< uint32_t >& topNodes,
+                             std::vector< Subtree >&  subtrees );
+    void     BuildSubtree( uint32_t nodeIndex, uint32_t begin, uint32_t end );
+
+private:
+    std::vector< ShLightTreeNode > leaves;
+    std::vector< RgFloat3D >       centroids;
+    std::vector< uint32_t >        order;
+    std::vector< ShLightTreeNode > nodes;
+
+    std::vector< UniqueLightID > prevUniqueIDs;
+    uint32_t                     refitCount;
+
+    ThreadPool workers;
+};
+
+}
@@ -0,0 +1,122 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+RTGL1::MappedFile::MappedFile( const std::filesystem::path& path )
+{
+    HANDLE f = CreateFileW( path.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL,
+                            nullptr );
+    if( f == INVALID_HANDLE_VALUE )
+    {
+        return;
+    }
+    hFile = f;
+
+    LARGE_INTEGER fileSize;
+    if( !GetFileSizeEx( f, &fileSize ) || fileSize.QuadPart == 0 )
+    {
+        return;
+    }
+
+    hMapping = CreateFileMappingW( f, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    if( !hMapping )
+    {
+        return;
+    }
+
+    void* ptr = MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+    if( !ptr )
+    {
+        return;
+    }
+
+    data = static_cast< const std::byte* >( ptr );
+    size = size_t( fileSize.QuadPart );
+}
+
+RTGL1::MappedFile::~MappedFile()
+{
+    if( data )
+    {
+        UnmapViewOfFile( data );
+    }
+    if( hMapping )
+    {
+        CloseHandle( hMapping );
+    }
+    if( hFile )
+    {
+        CloseHandle( hFile );
+    }
+}
+
+#else
+
+RTGL1::MappedFile::MappedFile( const std::filesystem::path& path )
+{
+    int fd = open( path.c_str(), O_RDONLY | O_CLOEXEC );
+    if( fd < 0 )
+    {
+        return;
+    }
+
+    struct stat st = {};
+    if( fstat( fd, &st ) == 0 && st.st_size > 0 )
+    {
+        void* ptr = mmap( nullptr, size_t( st.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+        if( ptr != MAP_FAILED )
+        {
+            data = static_cast< const std::byte* >( ptr );
+            size = size_t( st.st_size );
+        }
+    }
+
+    // mapping is valid after closing the descriptor
+    close( fd );
+}
+
+RTGL1::MappedFile::~MappedFile()
+{
+    if( data )
+    {
+        munmap( const_cast< std::byte* >( data ), size );
+    }
+}
+
+#endif // _WIN32
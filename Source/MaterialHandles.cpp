@@ -0,0 +1,113 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "MaterialHandles.h"
+
+#include "TextureManager.h"
+#include "TextureMeta.h"
+#include "Utils.h"
+
+namespace
+{
+
+// 0 is reserved for RG_NO_MATERIAL_HANDLE
+RgMaterialHandle ToHandle( uint32_t index )
+{
+    return RgMaterialHandle( index + 1 );
+}
+
+}
+
+RgMaterialHandle RTGL1::MaterialHandleTable::Intern( const char*               pTextureName,
+                                                     const TextureManager&     textureManager,
+                                                     const TextureMetaManager& textureMeta )
+{
+    if( Utils::IsCstrEmpty( pTextureName ) )
+    {
+        return RG_NO_MATERIAL_HANDLE;
+    }
+
+    auto [ iter, isNew ] =
+        nameToIndex.emplace( std::string( pTextureName ), uint32_t( entries.size() ) );
+
+    if( isNew )
+    {
+        Entry& entry = entries.emplace_back( Entry{
+            .textureName = iter->first,
+            .textures    = {},
+            .meta        = nullptr,
+        } );
+        Resolve( entry, textureManager, textureMeta );
+    }
+
+    return ToHandle( iter->second );
+}
+
+auto RTGL1::MaterialHandleTable::Access( RgMaterialHandle handle ) const -> const Entry*
+{
+    if( handle == RG_NO_MATERIAL_HANDLE || handle > entries.size() )
+    {
+        return nullptr;
+    }
+
+    return &entries[ handle - 1 ];
+}
+
+void RTGL1::MaterialHandleTable::Refresh( const char*               pTextureName,
+                                          const TextureManager&     textureManager,
+                                          const TextureMetaManager& textureMeta )
+{
+    if( Utils::IsCstrEmpty( pTextureName ) )
+    {
+        return;
+    }
+
+    auto iter = nameToIndex.find( pTextureName );
+    if( iter != nameToIndex.end() )
+    {
+        Resolve( entries[ iter->second ], textureManager, textureMeta );
+    }
+}
+
+void RTGL1::MaterialHandleTable::RefreshIfChanged( const TextureManager&     textureManager,
+                                                   const TextureMetaManager& textureMeta )
+{
+    if( materialsGeneration == textureManager.GetMaterialsGeneration() &&
+        metaGeneration == textureMeta.GetGeneration() )
+    {
+        return;
+    }
+
+    for( Entry& entry : entries )
+    {
+        Resolve( entry, textureManager, textureMeta );
+    }
+
+    materialsGeneration = textureManager.GetMaterialsGeneration();
+    metaGeneration      = textureMeta.GetGeneration();
+}
+
+void RTGL1::MaterialHandleTable::Resolve( Entry&                    entry,
+                                          const TextureManager&     textureManager,
+                                          const TextureMetaManager& textureMeta )
+{
+    entry.textures = textureManager.GetMaterialTextures( entry.textureName.c_str() );
+    entry.meta     = textureMeta.Find( entry.textureName.c_str() );
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Common.h"
+#include "Containers.h"
+#include "Material.h"
+
+#include <string>
+#include <vector>
+
+namespace RTGL1
+{
+
+class TextureManager;
+class TextureMetaManager;
+struct TextureMeta;
+
+// Texture names that were resolved to RgMaterialHandle by the user.
+// Each handle caches the results of the lookups by its name. The cache is
+// re-resolved, if generation counters of the texture / meta managers have changed,
+// so handles stay valid after the materials were reloaded or deleted.
+class MaterialHandleTable
+{
+public:
+    struct Entry
+    {
+        std::string        textureName;
+        MaterialTextures   textures;
+        const TextureMeta* meta;
+    };
+
+public:
+    MaterialHandleTable()  = default;
+    ~MaterialHandleTable() = default;
+
+    MaterialHandleTable( const MaterialHandleTable& other )                = delete;
+    MaterialHandleTable( MaterialHandleTable&& other ) noexcept            = delete;
+    MaterialHandleTable& operator=( const MaterialHandleTable& other )     = delete;
+    MaterialHandleTable& operator=( MaterialHandleTable&& other ) noexcept = delete;
+
+    RgMaterialHandle Intern( const char*               pTextureName,
+                             const TextureManager&     textureManager,
+                             const TextureMetaManager& textureMeta );
+
+    // Null, if the handle is invalid
+    const Entry* Access( RgMaterialHandle handle ) const;
+
+    // Re-resolve one name, if it was interned. Must be called if
+    // a material with that name was created or destroyed in the middle of a frame
+    void Refresh( const char*               pTextureName,
+                  const TextureManager&     textureManager,
+                  const TextureMetaManager& textureMeta );
+    // Re-resolve all names, if any of the managers was changed since the last call
+    void RefreshIfChanged( const TextureManager&     textureManager,
+                           const TextureMetaManager& textureMeta );
+
+private:
+    static void Resolve( Entry&                    entry,
+                         const TextureManager&     textureManager,
+                         const TextureMetaManager& textureMeta );
+
+private:
+    std::vector< Entry >                        entries;
+    rgl::unordered_map< std::string, uint32_t > nameToIndex;
+
+    // generations of the managers, that the entries were resolved with
+    uint64_t materialsGeneration{ 0 };
+    uint64_t metaGeneration{ 0 };
+};
+
+}
@@ -240,6 +240,39 @@ VkPhysicalDevice RTGL1::MemoryAllocator::GetPhysicalDevice()
     return physDevice->Get();
 }
 
+void RTGL1::MemoryAllocator::SetConcurrentQueueFamilies( uint32_t graphicsFamily,
+                                                         uint32_t computeFamily )
+{
+    assert( bufAllocs.empty() && imgAllocs.empty() );
+
+    concurrentQueueFamilies.clear();
+
+    if( graphicsFamily != computeFamily )
+    {
+        concurrentQueueFamilies = { graphicsFamily, computeFamily };
+    }
+}
+
+void RTGL1::MemoryAllocator::ApplySharingMode( VkBufferCreateInfo& info ) const
+{
+    if( !concurrentQueueFamilies.empty() )
+    {
+        info.sharingMode           = VK_SHARING_MODE_CONCURRENT;
+        info.queueFamilyIndexCount = uint32_t( concurrentQueueFamilies.size() );
+        info.pQueueFamilyIndices   = concurrentQueueFamilies.data();
+    }
+}
+
+void RTGL1::MemoryAllocator::ApplySharingMode( VkImageCreateInfo& info ) const
+{
+    if( !concurrentQueueFamilies.empty() )
+    {
+        info.sharingMode           = VK_SHARING_MODE_CONCURRENT;
+        info.queueFamilyIndexCount = uint32_t( concurrentQueueFamilies.size() );
+        info.pQueueFamilyIndices   = concurrentQueueFamilies.data();
+    }
+}
+
 VkDeviceMemory RTGL1::MemoryAllocator::AllocDedicated( const VkMemoryRequirements& memReqs,
                                                        VkMemoryPropertyFlags       properties,
                                                        AllocType                   allocType,
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "Common.h"
 #include "Containers.h"
 #include "PhysicalDevice.h"
@@ -52,6 +54,12 @@ public:
     VkDevice         GetDevice();
     VkPhysicalDevice GetPhysicalDevice();
 
+    // Resources that use ApplySharingMode are shared between these queue families
+    // without ownership transfers. Must be set before creating such resources
+    void             SetConcurrentQueueFamilies( uint32_t graphicsFamily, uint32_t computeFamily );
+    void             ApplySharingMode( VkBufferCreateInfo& info ) const;
+    void             ApplySharingMode( VkImageCreateInfo& info ) const;
+
 
     // If addressQuery=true device address can be queried
     VkDeviceMemory   AllocDedicated( const VkMemoryRequirements& memReqs,
@@ -95,6 +103,9 @@ private:
     // maps for freeing corresponding allocations
     rgl::unordered_map< VkBuffer, VmaAllocation > bufAllocs;
     rgl::unordered_map< VkImage, VmaAllocation >  imgAllocs;
+
+    // if empty, resources are exclusive to a queue family
+    std::vector< uint32_t >                       concurrentQueueFamilies;
 };
 
 }
\ No newline at end of file
@@ -28,7 +28,11 @@
 using namespace RTGL1;
 
 PhysicalDevice::PhysicalDevice( VkInstance instance )
-    : physDevice( VK_NULL_HANDLE ), memoryProperties{}, rtPipelineProperties{}, asProperties{}
+    : physDevice( VK_NULL_HANDLE )
+    , properties{}
+    , memoryProperties{}
+    , rtPipelineProperties{}
+    , asProperties{}
 {
     std::vector< VkPhysicalDevice > physicalDevices;
     {
@@ -77,6 +81,7 @@ PhysicalDevice::PhysicalDevice( VkInstance instance )
             };
 
             vkGetPhysicalDeviceProperties2( physDevice, &deviceProp2 );
+            properties = deviceProp2.properties;
             vkGetPhysicalDeviceMemoryProperties( physDevice, &memoryProperties );
 
             break;
@@ -137,6 +142,11 @@ uint32_t PhysicalDevice::GetMemoryTypeIndex( uint32_t memoryTypeBits,
                            std::to_string( requirementsMask ) + ")" );
 }
 
+const VkPhysicalDeviceProperties& PhysicalDevice::GetProperties() const
+{
+    return properties;
+}
+
 const VkPhysicalDeviceMemoryProperties& PhysicalDevice::GetMemoryProperties() const
 {
     return memoryProperties;
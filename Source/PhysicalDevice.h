@@ -38,6 +38,7 @@ public:
 
     VkPhysicalDevice Get() const;
     uint32_t         GetMemoryTypeIndex( uint32_t memoryTypeBits, VkFlags requirementsMask ) const;
+    const VkPhysicalDeviceProperties&                         GetProperties() const;
     const VkPhysicalDeviceMemoryProperties&                   GetMemoryProperties() const;
     const VkPhysicalDeviceRayTracingPipelinePropertiesKHR&    GetRTPipelineProperties() const;
     const VkPhysicalDeviceAccelerationStructurePropertiesKHR& GetASProperties() const;
@@ -45,6 +46,7 @@ public:
 private:
     // selected physical device
     VkPhysicalDevice                                   physDevice;
+    VkPhysicalDeviceProperties                         properties;
     VkPhysicalDeviceMemoryProperties                   memoryProperties;
     VkPhysicalDeviceRayTracingPipelinePropertiesKHR    rtPipelineProperties;
     VkPhysicalDeviceAccelerationStructurePropertiesKHR asProperties;
@@ -0,0 +1,150 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "PipelineCache.h"
+
+#include "PhysicalDevice.h"
+
+#include <fstream>
+
+RTGL1::PipelineCache::PipelineCache( VkDevice              _device,
+                                     const PhysicalDevice& _physDevice,
+                                     std::filesystem::path _folder )
+    : device( _device ), cache( VK_NULL_HANDLE ), vendorID( 0 ), deviceID( 0 ), uuid{}
+{
+    const VkPhysicalDeviceProperties& props = _physDevice.GetProperties();
+
+    vendorID = props.vendorID;
+    deviceID = props.deviceID;
+    memcpy( uuid, props.pipelineCacheUUID, VK_UUID_SIZE );
+
+    {
+        std::string name;
+        for( uint8_t b : uuid )
+        {
+            name += std::format( "{:02x}", b );
+        }
+        filePath = std::move( _folder ) / ( name + ".bin" );
+    }
+
+    const std::vector< uint8_t > initialData = LoadData();
+
+    VkPipelineCacheCreateInfo info = {
+        .sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize = initialData.size(),
+        .pInitialData    = initialData.empty() ? nullptr : initialData.data(),
+    };
+
+    VkResult r = vkCreatePipelineCache( device, &info, nullptr, &cache );
+    VK_CHECKERROR( r );
+
+    SET_DEBUG_NAME( device, cache, VK_OBJECT_TYPE_PIPELINE_CACHE, "Pipeline cache" );
+}
+
+RTGL1::PipelineCache::~PipelineCache()
+{
+    Save();
+    vkDestroyPipelineCache( device, cache, nullptr );
+}
+
+std::vector< uint8_t > RTGL1::PipelineCache::LoadData() const
+{
+    std::error_code ec;
+    if( !std::filesystem::exists( filePath, ec ) )
+    {
+        return {};
+    }
+
+    std::ifstream          file( filePath, std::ios::binary );
+    std::vector< uint8_t > data( std::istreambuf_iterator< char >( file ), {} );
+
+    if( !IsCompatible( data ) )
+    {
+        debug::Warning( "Ignoring incompatible pipeline cache: {}", filePath.string() );
+        return {};
+    }
+
+    debug::Verbose( "Loaded pipeline cache: {}", filePath.string() );
+    return data;
+}
+
+bool RTGL1::PipelineCache::IsCompatible( const std::vector< uint8_t >& data ) const
+{
+    // drivers must validate the data, but some of them crash on a corrupted one
+    VkPipelineCacheHeaderVersionOne header = {};
+
+    if( data.size() < sizeof( header ) )
+    {
+        return false;
+    }
+    memcpy( &header, data.data(), sizeof( header ) );
+
+    return header.headerSize >= sizeof( header ) && header.headerSize <= data.size() &&
+           header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header.vendorID == vendorID && header.deviceID == deviceID &&
+           memcmp( header.pipelineCacheUUID, uuid, VK_UUID_SIZE ) == 0;
+}
+
+void RTGL1::PipelineCache::Save() const
+{
+    size_t   size = 0;
+    VkResult r    = vkGetPipelineCacheData( device, cache, &size, nullptr );
+
+    if( r != VK_SUCCESS || size == 0 )
+    {
+        return;
+    }
+
+    std::vector< uint8_t > data( size );
+    r = vkGetPipelineCacheData( device, cache, &size, data.data() );
+
+    if( r != VK_SUCCESS )
+    {
+        return;
+    }
+    data.resize( size );
+
+    std::error_code ec;
+    std::filesystem::create_directories( filePath.parent_path(), ec );
+    if( ec )
+    {
+        debug::Warning( "Failed to create pipeline cache folder: {}", ec.message() );
+        return;
+    }
+
+    auto tempPath = std::filesystem::path( filePath ).concat( ".tmp" );
+    {
+        auto file = std::ofstream( tempPath, std::ios::binary | std::ios::trunc );
+        if( !file )
+        {
+            debug::Warning( "Failed to write pipeline cache: {}", tempPath.string() );
+            return;
+        }
+
+        file.write( reinterpret_cast< const char* >( data.data() ), std::streamsize( data.size() ) );
+    }
+
+    // rename to not leave partially written file
+    std::filesystem::rename( tempPath, filePath, ec );
+    if( ec )
+    {
+        debug::Warning( "Failed to save pipeline cache: {}", ec.message() );
+    }
+}
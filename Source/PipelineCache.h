@@ -0,0 +1,65 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Common.h"
+
+#include <filesystem>
+#include <vector>
+
+namespace RTGL1
+{
+
+class PhysicalDevice;
+
+// Single VkPipelineCache for all pipelines. Its data is stored in a file
+// which name is a driver's pipelineCacheUUID, so a driver update invalidates it.
+class PipelineCache
+{
+public:
+    PipelineCache( VkDevice device, const PhysicalDevice& physDevice, std::filesystem::path folder );
+    ~PipelineCache();
+
+    PipelineCache( const PipelineCache& other )                = delete;
+    PipelineCache( PipelineCache&& other ) noexcept            = delete;
+    PipelineCache& operator=( const PipelineCache& other )     = delete;
+    PipelineCache& operator=( PipelineCache&& other ) noexcept = delete;
+
+    VkPipelineCache Get() const { return cache; }
+
+    // Write the current cache data to the disk
+    void Save() const;
+
+private:
+    std::vector< uint8_t > LoadData() const;
+    bool                   IsCompatible( const std::vector< uint8_t >& data ) const;
+
+private:
+    VkDevice              device;
+    VkPipelineCache       cache;
+    std::filesystem::path filePath;
+
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint8_t  uuid[ VK_UUID_SIZE ];
+};
+
+}
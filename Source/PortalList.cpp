@@ -77,9 +77,15 @@ void RTGL1::PortalList::SubmitForFrame( VkCommandBuffer cmd, uint32_t frameIndex
     CmdLabel label( cmd, "Copying portal infos" );
 
     buffer->CopyFromStaging( cmd, frameIndex );
+    hasPortals = uploadedIndices.any();
     uploadedIndices.reset();
 }
 
+bool RTGL1::PortalList::HasPortals() const
+{
+    return hasPortals;
+}
+
 VkDescriptorSet RTGL1::PortalList::GetDescSet( uint32_t frameIndex ) const
 {
     return descSet;
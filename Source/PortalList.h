@@ -46,6 +46,8 @@ public:
 
     // void                  Upload( uint32_t frameIndex, const RgPortalUploadInfo& info );
     void                  SubmitForFrame( VkCommandBuffer cmd, uint32_t frameIndex );
+    // if any portal was submitted in the current frame
+    bool                  HasPortals() const;
 
     VkDescriptorSet       GetDescSet( uint32_t frameIndex ) const;
     VkDescriptorSetLayout GetDescSetLayout() const;
@@ -62,5 +64,6 @@ private:
     VkDescriptorSet                             descSet;
 
     std::bitset< detail::PORTAL_LIST_BITCOUNT > uploadedIndices;
+    bool                                        hasPortals{ false };
 };
 }
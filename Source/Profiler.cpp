@@ -0,0 +1,586 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Profiler.h"
+
+#include "RgException.h"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+namespace RTGL1
+{
+namespace
+{
+    // two queries per scope, and the frame begin / end queries
+    constexpr uint32_t MaxQueriesPerFrame = 512;
+    // per-call records for the trace; entry point totals are not limited
+    constexpr uint32_t MaxCpuCallsPerFrame = 1024;
+    constexpr size_t   HistoryLength       = 64;
+
+    // only one instance can exist, so label hooks and CPU scopes don't need its pointer
+    std::atomic< Profiler* > g_profiler{ nullptr };
+    // to distinguish the thread local storage of a recreated instance
+    std::atomic< uint64_t >  g_lastInstanceId{ 0 };
+
+    double ToMs( std::chrono::steady_clock::duration d )
+    {
+        return std::chrono::duration< double, std::milli >( d ).count();
+    }
+
+    double ToUs( std::chrono::steady_clock::duration d )
+    {
+        return std::chrono::duration< double, std::micro >( d ).count();
+    }
+
+    uint32_t CurrentThreadId()
+    {
+        return uint32_t( std::hash< std::thread::id >{}( std::this_thread::get_id() ) );
+    }
+
+    std::string EscapeJson( std::string_view str )
+    {
+        std::string r;
+        r.reserve( str.size() );
+        for( char c : str )
+        {
+            if( c == '"' || c == '\\' )
+            {
+                r.push_back( '\\' );
+                r.push_back( c );
+            }
+            else if( static_cast< unsigned char >( c ) < 0x20 )
+            {
+                // control characters must be escaped in JSON strings
+                r += std::format( "\\u{:04x}", static_cast< unsigned char >( c ) );
+            }
+            else
+            {
+                r.push_back( c );
+            }
+        }
+        return r;
+    }
+}
+}
+
+RTGL1::Profiler::Profiler( VkDevice         _device,
+                           VkPhysicalDevice physDevice,
+                           uint32_t         graphicsQueueFamilyIndex )
+    : device( _device )
+    , queryPools{}
+    , timestampPeriodNs( 0 )
+    , timestampMask( 0 )
+    , frames{}
+    , currentFrameIndex( 0 )
+    , hasPrevFrame( false )
+    , activeCmd( VK_NULL_HANDLE )
+    , instanceId( ++g_lastInstanceId )
+{
+    VkPhysicalDeviceProperties props = {};
+    vkGetPhysicalDeviceProperties( physDevice, &props );
+
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties( physDevice, &familyCount, nullptr );
+    std::vector< VkQueueFamilyProperties > families( familyCount );
+    vkGetPhysicalDeviceQueueFamilyProperties( physDevice, &familyCount, families.data() );
+
+    const uint32_t validBits = graphicsQueueFamilyIndex < familyCount
+                                   ? families[ graphicsQueueFamilyIndex ].timestampValidBits
+                                   : 0;
+
+    if( validBits == 0 || props.limits.timestampPeriod <= 0.0f )
+    {
+        debug::Warning( "Profiler: Graphics queue doesn't support timestamps, "
+                        "only CPU timers are available" );
+    }
+    else
+    {
+        timestampPeriodNs = props.limits.timestampPeriod;
+        timestampMask     = validBits >= 64 ? UINT64_MAX : ( uint64_t( 1 ) << validBits ) - 1;
+
+        for( VkQueryPool& pool : queryPools )
+        {
+            VkQueryPoolCreateInfo info = {
+                .sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+                .queryType  = VK_QUERY_TYPE_TIMESTAMP,
+                .queryCount = MaxQueriesPerFrame,
+            };
+
+            VkResult r = vkCreateQueryPool( device, &info, nullptr, &pool );
+            VK_CHECKERROR( r );
+
+            SET_DEBUG_NAME( device, pool, VK_OBJECT_TYPE_QUERY_POOL, "Profiler timestamps" );
+        }
+    }
+
+    assert( g_profiler == nullptr );
+    g_profiler = this;
+}
+
+RTGL1::Profiler::~Profiler()
+{
+    g_profiler = nullptr;
+
+    for( VkQueryPool pool : queryPools )
+    {
+        if( pool != VK_NULL_HANDLE )
+        {
+            vkDestroyQueryPool( device, pool, nullptr );
+        }
+    }
+}
+
+void RTGL1::Profiler::BeginFrame( VkCommandBuffer cmd, uint32_t frameIndex, uint32_t frameId )
+{
+    const auto now = Clock::now();
+
+    // everything that was called since the previous BeginFrame belongs to the previous frame
+    if( hasPrevFrame )
+    {
+        Frame& prev      = frames[ currentFrameIndex ];
+        prev.cpuDuration = now - prev.cpuStart;
+
+        TakeThreadCalls( prev );
+    }
+
+    // fence of the frame slot was waited, so its queries are available
+    ResolveFrame( frameIndex );
+
+    Frame& f = frames[ frameIndex ];
+    f        = Frame{
+               .recorded = true,
+               .frameId  = frameId,
+               .cpuStart = now,
+    };
+
+    currentFrameIndex = frameIndex;
+    hasPrevFrame      = true;
+
+    openScopes.clear();
+    activeCmd = cmd;
+
+    if( VkQueryPool pool = queryPools[ frameIndex ] )
+    {
+        vkCmdResetQueryPool( cmd, pool, 0, MaxQueriesPerFrame );
+        vkCmdWriteTimestamp( cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, pool, 0 );
+        f.queryCount = 1;
+    }
+}
+
+void RTGL1::Profiler::EndFrame( VkCommandBuffer cmd )
+{
+    if( cmd == VK_NULL_HANDLE || cmd != activeCmd )
+    {
+        return;
+    }
+
+    // labels that were not ended, must still write their queries
+    while( !openScopes.empty() )
+    {
+        EndGpuScope( cmd );
+    }
+
+    Frame& f = frames[ currentFrameIndex ];
+
+    if( VkQueryPool pool = queryPools[ currentFrameIndex ] )
+    {
+        // one query is always kept for the frame end
+        assert( f.queryCount < MaxQueriesPerFrame );
+
+        vkCmdWriteTimestamp( cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, pool, f.queryCount );
+        f.frameEndQuery = f.queryCount;
+        f.queryCount++;
+    }
+
+    activeCmd = VK_NULL_HANDLE;
+}
+
+void RTGL1::Profiler::ContinueFrame( VkCommandBuffer cmd )
+{
+    if( activeCmd != VK_NULL_HANDLE )
+    {
+        // queries are in the same pool, so the open scopes can be ended in the new cmd
+        activeCmd = cmd;
+    }
+}
+
+void RTGL1::Profiler::BeginGpuScope( VkCommandBuffer cmd, const char* pName )
+{
+    Frame&      f    = frames[ currentFrameIndex ];
+    VkQueryPool pool = queryPools[ currentFrameIndex ];
+
+    // keep nesting consistent, even if the scope is not measured
+    if( pool == VK_NULL_HANDLE || f.queryCount + 2 >= MaxQueriesPerFrame )
+    {
+        openScopes.push_back( UINT32_MAX );
+        return;
+    }
+
+    // end query is reserved beforehand, so nested scopes don't need a stack of queries
+    f.gpuScopes.push_back( GpuScope{
+        .name       = pName,
+        .depth      = uint32_t( openScopes.size() ),
+        .beginQuery = f.queryCount,
+        .endQuery   = f.queryCount + 1,
+    } );
+    f.queryCount += 2;
+
+    openScopes.push_back( uint32_t( f.gpuScopes.size() - 1 ) );
+
+    vkCmdWriteTimestamp(
+        cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, pool, f.gpuScopes.back().beginQuery );
+}
+
+void RTGL1::Profiler::EndGpuScope( VkCommandBuffer cmd )
+{
+    if( openScopes.empty() )
+    {
+        return;
+    }
+
+    uint32_t scopeIndex = openScopes.back();
+    openScopes.pop_back();
+
+    if( scopeIndex == UINT32_MAX )
+    {
+        return;
+    }
+
+    vkCmdWriteTimestamp( cmd,
+                         VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                         queryPools[ currentFrameIndex ],
+                         frames[ currentFrameIndex ].gpuScopes[ scopeIndex ].endQuery );
+}
+
+void RTGL1::Profiler::ResolveFrame( uint32_t frameIndex )
+{
+    Frame& f = frames[ frameIndex ];
+
+    if( !f.recorded )
+    {
+        return;
+    }
+
+    FrameResult result = {
+        .frameId        = f.frameId,
+        .cpuStart       = f.cpuStart,
+        .cpuFrameTimeMs = ToMs( f.cpuDuration ),
+        .gpuFrameTimeMs = 0,
+        .gpuScopes      = {},
+        .cpuCalls       = std::move( f.cpuCalls ),
+        .entryPoints    = std::move( f.entryPoints ),
+    };
+
+    VkQueryPool pool = queryPools[ frameIndex ];
+
+    if( pool != VK_NULL_HANDLE && f.queryCount > 0 )
+    {
+        std::vector< uint64_t > timestamps( f.queryCount );
+
+        // not VK_SUCCESS, if the frame's command buffer was not submitted
+        VkResult r = vkGetQueryPoolResults( device,
+                                            pool,
+                                            0,
+                                            f.queryCount,
+                                            timestamps.size() * sizeof( uint64_t ),
+                                            timestamps.data(),
+                                            sizeof( uint64_t ),
+                                            VK_QUERY_RESULT_64_BIT );
+
+        if( r == VK_SUCCESS )
+        {
+            auto toMs = [ & ]( uint32_t query ) {
+                uint64_t ticks = ( timestamps[ query ] - timestamps[ 0 ] ) & timestampMask;
+                return double( ticks ) * timestampPeriodNs / 1000000.0;
+            };
+
+            result.gpuScopes.reserve( f.gpuScopes.size() );
+            for( GpuScope& s : f.gpuScopes )
+            {
+                double start = toMs( s.beginQuery );
+
+                result.gpuScopes.push_back( GpuScopeResult{
+                    .name       = std::move( s.name ),
+                    .depth      = s.depth,
+                    .startMs    = start,
+                    .durationMs = std::max( toMs( s.endQuery ) - start, 0.0 ),
+                } );
+            }
+
+            if( f.frameEndQuery != UINT32_MAX )
+            {
+                result.gpuFrameTimeMs = toMs( f.frameEndQuery );
+            }
+        }
+    }
+
+    f.recorded = false;
+
+    history.push_back( std::move( result ) );
+    while( history.size() > HistoryLength )
+    {
+        history.pop_front();
+    }
+}
+
+auto RTGL1::Profiler::GetThreadCalls() -> ThreadCalls&
+{
+    thread_local std::shared_ptr< ThreadCalls > local;
+    thread_local uint64_t                       localInstanceId = 0;
+
+    if( localInstanceId != instanceId )
+    {
+        local           = std::make_shared< ThreadCalls >();
+        local->threadId = CurrentThreadId();
+        localInstanceId = instanceId;
+
+        // only once per thread
+        auto lock = std::lock_guard( threadCallsMutex );
+        threadCalls.push_back( local );
+    }
+
+    return *local;
+}
+
+void RTGL1::Profiler::AddCpuCall( const char*       pName,
+                                  Clock::time_point start,
+                                  Clock::duration   duration )
+{
+    ThreadCalls& tc = GetThreadCalls();
+
+    // names are string literals, so pointers can be compared
+    auto e = std::ranges::find( tc.entryPoints, pName, &EntryPoint::name );
+    if( e == tc.entryPoints.end() )
+    {
+        tc.entryPoints.push_back( EntryPoint{ .name = pName, .callCount = 0, .total = {} } );
+        e = std::prev( tc.entryPoints.end() );
+    }
+    e->callCount++;
+    e->total += duration;
+
+    if( tc.cpuCalls.size() < MaxCpuCallsPerFrame )
+    {
+        tc.cpuCalls.push_back( CpuCall{
+            .name     = pName,
+            .threadId = tc.threadId,
+            .start    = start,
+            .duration = duration,
+        } );
+    }
+}
+
+void RTGL1::Profiler::TakeThreadCalls( Frame& dst )
+{
+    auto lock = std::lock_guard( threadCallsMutex );
+
+    for( auto& tc : threadCalls )
+    {
+        for( const CpuCall& c : tc->cpuCalls )
+        {
+            if( dst.cpuCalls.size() >= MaxCpuCallsPerFrame )
+            {
+                break;
+            }
+            dst.cpuCalls.push_back( c );
+        }
+
+        for( const EntryPoint& src : tc->entryPoints )
+        {
+            auto e = std::ranges::find( dst.entryPoints, src.name, &EntryPoint::name );
+            if( e == dst.entryPoints.end() )
+            {
+                dst.entryPoints.push_back( src );
+            }
+            else
+            {
+                e->callCount += src.callCount;
+                e->total += src.total;
+            }
+        }
+
+        tc->cpuCalls.clear();
+        tc->entryPoints.clear();
+    }
+
+    // storage of the exited threads is referenced only here
+    std::erase_if( threadCalls, []( const auto& tc ) { return tc.use_count() == 1; } );
+
+    std::ranges::sort( dst.cpuCalls, std::less{}, &CpuCall::start );
+}
+
+bool RTGL1::Profiler::GetLatestGpuFrameTime( uint32_t* pFrameId, double* pGpuFrameTimeMs ) const
+{
+    if( history.empty() )
+    {
+        return false;
+    }
+
+    *pFrameId        = history.back().frameId;
+    *pGpuFrameTimeMs = history.back().gpuFrameTimeMs;
+    return true;
+}
+
+void RTGL1::Profiler::GetFrameStatistics( RgFrameStatistics* pResult )
+{
+    outGpuScopes.clear();
+    outEntryPoints.clear();
+
+    if( history.empty() )
+    {
+        *pResult = RgFrameStatistics{};
+        return;
+    }
+
+    const FrameResult& latest = history.back();
+
+    for( const GpuScopeResult& s : latest.gpuScopes )
+    {
+        outGpuScopes.push_back( RgFrameStatisticsScope{
+            .pName      = s.name.c_str(),
+            .depth      = s.depth,
+            .startMs    = s.startMs,
+            .durationMs = s.durationMs,
+        } );
+    }
+
+    for( const EntryPoint& e : latest.entryPoints )
+    {
+        outEntryPoints.push_back( RgFrameStatisticsEntryPoint{
+            .pName     = e.name,
+            .callCount = e.callCount,
+            .totalMs   = ToMs( e.total ),
+        } );
+    }
+
+    *pResult = RgFrameStatistics{
+        .frameId         = latest.frameId,
+        .cpuFrameTimeMs  = latest.cpuFrameTimeMs,
+        .gpuFrameTimeMs  = latest.gpuFrameTimeMs,
+        .pGpuScopes      = outGpuScopes.data(),
+        .gpuScopeCount   = uint32_t( outGpuScopes.size() ),
+        .pEntryPoints    = outEntryPoints.data(),
+        .entryPointCount = uint32_t( outEntryPoints.size() ),
+    };
+}
+
+bool RTGL1::Profiler::DumpChromeTrace( const char* pFilePath ) const
+{
+    std::ofstream file( pFilePath, std::ios::out | std::ios::trunc );
+    if( !file.is_open() )
+    {
+        return false;
+    }
+
+    constexpr uint32_t CpuPid = 0;
+    constexpr uint32_t GpuPid = 1;
+
+    file << "{\"traceEvents\":[\n";
+    file << std::format( "{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":{},"
+                         "\"args\":{{\"name\":\"CPU\"}}}},\n",
+                         CpuPid );
+    file << std::format( "{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":{},"
+                         "\"args\":{{\"name\":\"GPU\"}}}}",
+                         GpuPid );
+
+    const auto epoch = history.empty() ? Clock::time_point{} : history.front().cpuStart;
+
+    auto writeEvent = [ &file ]( std::string_view name,
+                                 uint32_t         pid,
+                                 uint32_t         tid,
+                                 double           tsUs,
+                                 double           durUs ) {
+        file << std::format( ",\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":{},\"tid\":{},"
+                             "\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                             EscapeJson( name ),
+                             pid,
+                             tid,
+                             tsUs,
+                             durUs );
+    };
+
+    for( const FrameResult& frame : history )
+    {
+        const double frameTs = ToUs( frame.cpuStart - epoch );
+
+        writeEvent( std::format( "Frame {}", frame.frameId ),
+                    CpuPid,
+                    0,
+                    frameTs,
+                    frame.cpuFrameTimeMs * 1000.0 );
+
+        for( const CpuCall& c : frame.cpuCalls )
+        {
+            writeEvent( c.name, CpuPid, c.threadId, ToUs( c.start - epoch ), ToUs( c.duration ) );
+        }
+
+        // GPU clock is not synchronized with CPU, so GPU frame is aligned to its CPU start
+        if( frame.gpuFrameTimeMs > 0 )
+        {
+            writeEvent( std::format( "Frame {}", frame.frameId ),
+                        GpuPid,
+                        0,
+                        frameTs,
+                        frame.gpuFrameTimeMs * 1000.0 );
+        }
+
+        for( const GpuScopeResult& s : frame.gpuScopes )
+        {
+            writeEvent(
+                s.name, GpuPid, 0, frameTs + s.startMs * 1000.0, s.durationMs * 1000.0 );
+        }
+    }
+
+    file << "\n]}\n";
+    return file.good();
+}
+
+void RTGL1::Profiler::OnBeginCmdLabel( VkCommandBuffer cmd, const char* pName )
+{
+    Profiler* p = g_profiler;
+
+    if( p != nullptr && cmd != VK_NULL_HANDLE && cmd == p->activeCmd )
+    {
+        p->BeginGpuScope( cmd, pName != nullptr ? pName : "" );
+    }
+}
+
+void RTGL1::Profiler::OnEndCmdLabel( VkCommandBuffer cmd )
+{
+    Profiler* p = g_profiler;
+
+    if( p != nullptr && cmd != VK_NULL_HANDLE && cmd == p->activeCmd )
+    {
+        p->EndGpuScope( cmd );
+    }
+}
+
+RTGL1::Profiler::CpuScope::CpuScope( const char* pName ) : name( pName ), start( Clock::now() ) {}
+
+RTGL1::Profiler::CpuScope::~CpuScope()
+{
+    if( Profiler* p = g_profiler )
+    {
+        p->AddCpuCall( name, start, Clock::now() - start );
+    }
+}
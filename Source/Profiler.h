@@ -0,0 +1,197 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Common.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace RTGL1
+{
+
+// Per-pass GPU timestamps and per-API-entry-point CPU timers.
+// GPU scopes are taken from the command buffer labels (CmdLabel, BeginCmdLabel),
+// so every labeled pass of the frame's command buffer is measured automatically.
+// GPU results of a frame are read back when its frame slot is reused,
+// i.e. the statistics are MAX_FRAMES_IN_FLIGHT frames late.
+class Profiler
+{
+public:
+    Profiler( VkDevice device, VkPhysicalDevice physDevice, uint32_t graphicsQueueFamilyIndex );
+    ~Profiler();
+
+    Profiler( const Profiler& other )                = delete;
+    Profiler( Profiler&& other ) noexcept            = delete;
+    Profiler& operator=( const Profiler& other )     = delete;
+    Profiler& operator=( Profiler&& other ) noexcept = delete;
+
+    // Must be called at the start of the frame's command buffer,
+    // after the fence of the frame slot was waited
+    void BeginFrame( VkCommandBuffer cmd, uint32_t frameIndex, uint32_t frameId );
+    void EndFrame( VkCommandBuffer cmd );
+    // The frame continues in another command buffer of the same queue
+    void ContinueFrame( VkCommandBuffer cmd );
+
+    // Statistics of the latest frame, which results are available.
+    // Pointers are valid until the next BeginFrame
+    void GetFrameStatistics( RgFrameStatistics* pResult );
+    // GPU time of the latest frame, which results are available;
+    // false, if there's no such frame yet
+    bool GetLatestGpuFrameTime( uint32_t* pFrameId, double* pGpuFrameTimeMs ) const;
+    // Write the history of the latest frames in Chrome trace event format
+    bool DumpChromeTrace( const char* pFilePath ) const;
+
+    // Hooks for command buffer labels; only the labels
+    // of the current frame's command buffer are measured
+    static void OnBeginCmdLabel( VkCommandBuffer cmd, const char* pName );
+    static void OnEndCmdLabel( VkCommandBuffer cmd );
+
+    class CpuScope
+    {
+    public:
+        // pName must be a string literal
+        explicit CpuScope( const char* pName );
+        ~CpuScope();
+
+        CpuScope( const CpuScope& other )                = delete;
+        CpuScope( CpuScope&& other ) noexcept            = delete;
+        CpuScope& operator=( const CpuScope& other )     = delete;
+        CpuScope& operator=( CpuScope&& other ) noexcept = delete;
+
+    private:
+        const char*                           name;
+        std::chrono::steady_clock::time_point start;
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct GpuScope
+    {
+        std::string name;
+        uint32_t    depth;
+        uint32_t    beginQuery;
+        uint32_t    endQuery;
+    };
+
+    struct CpuCall
+    {
+        const char*       name;
+        uint32_t          threadId;
+        Clock::time_point start;
+        Clock::duration   duration;
+    };
+
+    struct EntryPoint
+    {
+        const char*     name;
+        uint32_t        callCount;
+        Clock::duration total;
+    };
+
+    // CPU calls of one thread, that were made since the last BeginFrame
+    struct ThreadCalls
+    {
+        uint32_t                  threadId;
+        std::vector< CpuCall >    cpuCalls;
+        std::vector< EntryPoint > entryPoints;
+    };
+
+    struct Frame
+    {
+        bool              recorded{ false };
+        uint32_t          frameId{ 0 };
+        Clock::time_point cpuStart{};
+        Clock::duration   cpuDuration{};
+
+        std::vector< GpuScope > gpuScopes;
+        uint32_t                queryCount{ 0 };
+        uint32_t                frameEndQuery{ UINT32_MAX };
+
+        std::vector< CpuCall >    cpuCalls;
+        std::vector< EntryPoint > entryPoints;
+    };
+
+    struct GpuScopeResult
+    {
+        std::string name;
+        uint32_t    depth;
+        double      startMs;
+        double      durationMs;
+    };
+
+    struct FrameResult
+    {
+        uint32_t          frameId;
+        Clock::time_point cpuStart;
+        double            cpuFrameTimeMs;
+        double            gpuFrameTimeMs;
+
+        std::vector< GpuScopeResult > gpuScopes;
+        std::vector< CpuCall >        cpuCalls;
+        std::vector< EntryPoint >     entryPoints;
+    };
+
+private:
+    void         AddCpuCall( const char* pName, Clock::time_point start, Clock::duration duration );
+    ThreadCalls& GetThreadCalls();
+    void         TakeThreadCalls( Frame& dst );
+    void ResolveFrame( uint32_t frameIndex );
+
+    void BeginGpuScope( VkCommandBuffer cmd, const char* pName );
+    void EndGpuScope( VkCommandBuffer cmd );
+
+private:
+    VkDevice    device;
+    VkQueryPool queryPools[ MAX_FRAMES_IN_FLIGHT ];
+    double      timestampPeriodNs;
+    uint64_t    timestampMask;
+
+    Frame    frames[ MAX_FRAMES_IN_FLIGHT ];
+    uint32_t currentFrameIndex;
+    bool     hasPrevFrame;
+
+    // command buffer, which labels are measured; scopes are only modified
+    // by the thread that records that command buffer
+    std::atomic< VkCommandBuffer > activeCmd;
+    std::vector< uint32_t >        openScopes;
+
+    // CPU calls of the frame that is being recorded, accumulated by each thread in its own
+    // storage without locking. They are taken on BeginFrame: it's called by rgStartFrame,
+    // so by the API contract, no other thread is in an API call at that moment
+    uint64_t                                      instanceId;
+    std::mutex                                    threadCallsMutex;
+    std::vector< std::shared_ptr< ThreadCalls > > threadCalls;
+
+    std::deque< FrameResult > history;
+
+    // storage for GetFrameStatistics
+    std::vector< RgFrameStatisticsScope >      outGpuScopes;
+    std::vector< RgFrameStatisticsEntryPoint > outEntryPoints;
+};
+
+}
@@ -73,10 +73,14 @@ Queues::Queues( VkPhysicalDevice physDevice, VkSurfaceKHR surface )
     {
         auto     flags = queueFamilyProperties[ i ].queueFlags;
 
-        VkBool32 presentSupported;
-        VkResult r =
-            vkGetPhysicalDeviceSurfaceSupportKHR( physDevice, i, surface, &presentSupported );
-        VK_CHECKERROR( r );
+        // if headless, there's nothing to present to
+        VkBool32 presentSupported = VK_TRUE;
+        if( surface != VK_NULL_HANDLE )
+        {
+            VkResult r =
+                vkGetPhysicalDeviceSurfaceSupportKHR( physDevice, i, surface, &presentSupported );
+            VK_CHECKERROR( r );
+        }
 
         if( ( flags & VK_QUEUE_GRAPHICS_BIT ) != 0 && ( flags & VK_QUEUE_COMPUTE_BIT ) != 0 &&
             ( flags & VK_QUEUE_TRANSFER_BIT ) != 0 && presentSupported )
@@ -21,6 +21,7 @@
 #include "VulkanDevice.h"
 #include "RgException.h"
 
+#include "Profiler.h"
 #include "TextureExporter.h"
 
 namespace
@@ -194,70 +195,121 @@ static auto Call( RgInstance rgInstance, Func f, Args&&... args )
 }
 
 
+// Same as Call, but the time of the call is measured by the frame profiler
+template< typename Func, typename... Args >
+static auto ProfiledCall( const char* pName, RgInstance rgInstance, Func f, Args&&... args )
+{
+    auto scope = RTGL1::Profiler::CpuScope( pName );
+    return Call( rgInstance, f, std::forward< Args >( args )... );
+}
+
+
 
 RgResult rgUploadMeshPrimitive( RgInstance instance, const RgMeshInfo* pMesh, const RgMeshPrimitiveInfo* pPrimitive )
 {
-    return Call( instance, &RTGL1::VulkanDevice::UploadMeshPrimitive, pMesh, pPrimitive );
+    return ProfiledCall( __func__, instance, &RTGL1::VulkanDevice::UploadMeshPrimitive, pMesh, pPrimitive );
+}
+
+RgResult rgUploadMeshPrimitives( RgInstance instance, const RgMeshInfo* pMesh, const RgMeshPrimitiveInfo* pPrimitives, uint32_t primitiveCount )
+{
+    return ProfiledCall( __func__, instance, &RTGL1::VulkanDevice::UploadMeshPrimitives, pMesh, pPrimitives, primitiveCount );
+}
+
+RgResult rgUploadMeshes( RgInstance instance, const RgMeshPrimitivesUploadInfo* pMeshes, uint32_t meshCount )
+{
+    return ProfiledCall( __func__, instance, &RTGL1::VulkanDevice::UploadMeshes, pMeshes, meshCount );
+}
+
+RgResult rgUploadStaticSector( RgInstance instance, const RgStaticSectorUploadInfo* pInfo )
+{
+    return ProfiledCall( __func__, instance, &RTGL1::VulkanDevice::UploadStaticSector, pInfo );
+}
+
+RgResult rgRemoveStaticSector( RgInstance instance, const char* pSectorName )
+{
+    return ProfiledCall( __func__, instance, &RTGL1::VulkanDevice::RemoveStaticSector, pSectorName );
 }
 
 RgResult rgUploadNonWorldPrimitive( RgInstance instance, const RgMeshPrimitiveInfo* pPrimitive, const float* pViewProjection, const RgViewport* pViewport )
 {
-    return Call( instance, &RTGL1::VulkanDevice::UploadNonWorldPrimitive, pPrimitive, pViewProjection, pViewport );
+    return ProfiledCall( __func__, instance, &RTGL1::VulkanDevice::UploadNonWorldPrimitive, pPrimitive, pViewProjection, pViewport );
 }
 
 RgResult rgUploadDecal( RgInstance instance, const RgDecalUploadInfo* pInfo )
 {
-    return Call( instance, &RTGL1::VulkanDevice::UploadDecal, pInfo );
+    return ProfiledCall( __func__, instance, &RTGL1::VulkanDevice::UploadDecal, pInfo );
 }
 
 RgResult rgUploadLensFlare( RgInstance instance, const RgLensFlareUploadInfo* pInfo )
 {
-    return Call( instance, &RTGL1::VulkanDevice::UploadLensFlare, pInfo );
+    return ProfiledCall( __func__, instance, &RTGL1::VulkanDevice::UploadLensFlare, pInfo );
 }
 
 RgResult rgUploadDirectionalLight( RgInstance instance, const RgDirectionalLightUploadInfo* pInfo )
 {
-    return Call( instance, &RTGL1::VulkanDevice::UploadDirectionalLight, pInfo );
+    return ProfiledCall( __func__, instance, &RTGL1::VulkanDevice::UploadDirectionalLight, pInfo );
 }
 
 RgResult rgUploadSphericalLight( RgInstance instance, const RgSphericalLightUploadInfo* pInfo )
 {
-    return Call( instance, &RTGL1::VulkanDevice::UploadSphericalLight, pInfo );
+    return ProfiledCall( __func__, instance, &RTGL1::VulkanDevice::UploadSphericalLight, pInfo );
 }
 
 RgResult rgUploadSpotLight( RgInstance instance, const RgSpotLightUploadInfo* pInfo )
 {
-    return Call( instance, &RTGL1::VulkanDevice::UploadSpotlight, pInfo );
+    return ProfiledCall( __func__, instance, &RTGL1::VulkanDevice::UploadSpotlight, pInfo );
 }
 
 RgResult rgUploadPolygonalLight( RgInstance instance, const RgPolygonalLightUploadInfo* pInfo )
 {
-    return Call( instance, &RTGL1::VulkanDevice::UploadPolygonalLight, pInfo );
+    return ProfiledCall( __func__, instance, &RTGL1::VulkanDevice::UploadPolygonalLight, pInfo );
 }
 
 RgResult rgProvideOriginalTexture( RgInstance instance, const RgOriginalTextureInfo* pInfo )
 {
-    return Call( instance, &RTGL1::VulkanDevice::ProvideOriginalTexture, pInfo );
+    return ProfiledCall( __func__, instance, &RTGL1::VulkanDevice::ProvideOriginalTexture, pInfo );
 }
 
 RgResult rgProvideOriginalCubemapTexture( RgInstance instance, const RgOriginalCubemapInfo* pInfo )
 {
-    return Call( instance, &RTGL1::VulkanDevice::ProvideOriginalCubemapTexture, pInfo );
+    return ProfiledCall( __func__, instance, &RTGL1::VulkanDevice::ProvideOriginalCubemapTexture, pInfo );
 }
 
 RgResult rgMarkOriginalTextureAsDeleted( RgInstance instance, const char* pTextureName )
 {
-    return Call( instance, &RTGL1::VulkanDevice::MarkOriginalTextureAsDeleted, pTextureName );
+    return ProfiledCall( __func__, instance, &RTGL1::VulkanDevice::MarkOriginalTextureAsDeleted, pTextureName );
+}
+
+RgResult rgGetMaterialHandle( RgInstance instance, const char* pTextureName, RgMaterialHandle* pResult )
+{
+    return ProfiledCall( __func__, instance, &RTGL1::VulkanDevice::GetMaterialHandle, pTextureName, pResult );
 }
 
 RgResult rgStartFrame( RgInstance instance, const RgStartFrameInfo* pInfo )
 {
-    return Call( instance, &RTGL1::VulkanDevice::StartFrame, pInfo );
+    return ProfiledCall( __func__, instance, &RTGL1::VulkanDevice::StartFrame, pInfo );
 }
 
 RgResult rgDrawFrame( RgInstance instance, const RgDrawFrameInfo* pInfo )
 {
-    return Call( instance, &RTGL1::VulkanDevice::DrawFrame, pInfo );
+    return ProfiledCall( __func__, instance, &RTGL1::VulkanDevice::DrawFrame, pInfo );
+}
+
+RgResult rgGetFrameStatistics( RgInstance instance, RgFrameStatistics* pResult )
+{
+    return Call( instance, &RTGL1::VulkanDevice::GetFrameStatistics, pResult );
+}
+
+RgResult rgDumpFrameStatistics( RgInstance instance, const char* pFilePath )
+{
+    return Call( instance, &RTGL1::VulkanDevice::DumpFrameStatistics, pFilePath );
+}
+
+RgResult rgReadbackFinalImage( RgInstance                      instance,
+                               const RgReadbackFinalImageInfo* pInfo,
+                               RgReadbackFinalImageResult*     pResult )
+{
+    return Call( instance, &RTGL1::VulkanDevice::ReadbackFinalImage, pInfo, pResult );
 }
 
 RgPrimitiveVertex* rgUtilScratchAllocForVertices( RgInstance instance, uint32_t vertexCount )
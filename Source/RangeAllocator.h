@@ -0,0 +1,104 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <optional>
+
+namespace RTGL1
+{
+
+// Allocator of element ranges in [begin, end), with first-fit strategy.
+// Adjacent free ranges are merged back, when a range is freed.
+class RangeAllocator
+{
+public:
+    RangeAllocator() = default;
+    RangeAllocator( uint32_t begin, uint32_t end )
+    {
+        if( end > begin )
+        {
+            freeRanges.emplace( begin, end - begin );
+        }
+    }
+
+    // Returns the first element of the range, or null if there's no free range of such size
+    std::optional< uint32_t > Allocate( uint32_t count )
+    {
+        assert( count > 0 );
+
+        for( auto it = freeRanges.begin(); it != freeRanges.end(); ++it )
+        {
+            auto [ offset, size ] = *it;
+
+            if( size >= count )
+            {
+                freeRanges.erase( it );
+                if( size > count )
+                {
+                    freeRanges.emplace( offset + count, size - count );
+                }
+                return offset;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    void Free( uint32_t offset, uint32_t count )
+    {
+        assert( count > 0 );
+
+        auto next = freeRanges.lower_bound( offset );
+        assert( next == freeRanges.end() || offset + count <= next->first );
+
+        // merge with the next range
+        if( next != freeRanges.end() && offset + count == next->first )
+        {
+            count += next->second;
+            next = freeRanges.erase( next );
+        }
+
+        // merge with the previous range
+        if( next != freeRanges.begin() )
+        {
+            auto prev = std::prev( next );
+            assert( prev->first + prev->second <= offset );
+
+            if( prev->first + prev->second == offset )
+            {
+                prev->second += count;
+                return;
+            }
+        }
+
+        freeRanges.emplace_hint( next, offset, count );
+    }
+
+private:
+    // first element to element count
+    std::map< uint32_t, uint32_t > freeRanges;
+};
+
+}
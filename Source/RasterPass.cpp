@@ -77,8 +77,7 @@ RTGL1::RasterPass::RasterPass( VkDevice                    _device,
                                                  false,
                                                  _instanceInfo.rasterizedVertexColorGamma );
 
-    depthCopying = std::make_shared< DepthCopying >(
-        device, DEPTH_FORMAT, _shaderManager, _storageFramebuffers );
+    depthCopying = std::make_shared< DepthCopying >( device, DEPTH_FORMAT, _storageFramebuffers );
 }
 
 RTGL1::RasterPass::~RasterPass()
@@ -21,13 +21,22 @@
 #include "RasterizedDataCollector.h"
 
 #include <algorithm>
+#include <numeric>
 
 #include "GeomInfoManager.h"
+#include "Matrix.h"
 #include "RgException.h"
 #include "Utils.h"
+#include "VertexKernels.h"
 
 #include "Generated/ShaderCommonC.h"
 
+namespace
+{
+// upper bound of draws per frame for all raster types
+constexpr uint32_t MAX_DRAW_COUNT = 16384;
+}
+
 std::array< VkVertexInputAttributeDescription, 3 > RTGL1::RasterizedDataCollector::GetVertexLayout()
 {
     return { {
@@ -67,9 +76,15 @@ RTGL1::RasterizedDataCollector::RasterizedDataCollector(
     , textureMgr( std::move( _textureMgr ) )
     , curVertexCount( 0 )
     , curIndexCount( 0 )
+    , curDrawCount( 0 )
+    , descPool( VK_NULL_HANDLE )
+    , descSetLayout( VK_NULL_HANDLE )
+    , descSet( VK_NULL_HANDLE )
 {
-    vertexBuffer = std::make_shared< AutoBuffer >( _allocator );
-    indexBuffer  = std::make_shared< AutoBuffer >( _allocator );
+    vertexBuffer   = std::make_shared< AutoBuffer >( _allocator );
+    indexBuffer    = std::make_shared< AutoBuffer >( _allocator );
+    drawBuffer     = std::make_shared< AutoBuffer >( _allocator );
+    indirectBuffer = std::make_shared< AutoBuffer >( _allocator );
 
     _maxVertexCount = std::max( _maxVertexCount, 64u );
     _maxIndexCount  = std::max( _maxIndexCount, 64u );
@@ -80,6 +95,97 @@ RTGL1::RasterizedDataCollector::RasterizedDataCollector(
     indexBuffer->Create( _maxIndexCount * sizeof( uint32_t ),
                          VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
                          "Rasterizer index buffer" );
+    drawBuffer->Create( MAX_DRAW_COUNT * sizeof( ShRasterizedDraw ),
+                        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                        "Rasterizer draw buffer" );
+    indirectBuffer->Create( MAX_DRAW_COUNT * sizeof( VkDrawIndexedIndirectCommand ),
+                            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                            "Rasterizer indirect buffer" );
+
+    CreateDescriptors();
+}
+
+RTGL1::RasterizedDataCollector::~RasterizedDataCollector()
+{
+    vkDestroyDescriptorPool( device, descPool, nullptr );
+    vkDestroyDescriptorSetLayout( device, descSetLayout, nullptr );
+}
+
+void RTGL1::RasterizedDataCollector::CreateDescriptors()
+{
+    {
+        VkDescriptorPoolSize poolSize = {
+            .type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = 1,
+        };
+
+        VkDescriptorPoolCreateInfo poolInfo = {
+            .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .maxSets       = 1,
+            .poolSizeCount = 1,
+            .pPoolSizes    = &poolSize,
+        };
+
+        VkResult r = vkCreateDescriptorPool( device, &poolInfo, nullptr, &descPool );
+        VK_CHECKERROR( r );
+
+        SET_DEBUG_NAME(
+            device, descPool, VK_OBJECT_TYPE_DESCRIPTOR_POOL, "Rasterizer draws desc pool" );
+    }
+    {
+        VkDescriptorSetLayoutBinding binding = {
+            .binding         = BINDING_RASTERIZED_DRAWS,
+            .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = 1,
+            .stageFlags      = VK_SHADER_STAGE_VERTEX_BIT,
+        };
+
+        VkDescriptorSetLayoutCreateInfo info = {
+            .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .bindingCount = 1,
+            .pBindings    = &binding,
+        };
+
+        VkResult r = vkCreateDescriptorSetLayout( device, &info, nullptr, &descSetLayout );
+        VK_CHECKERROR( r );
+
+        SET_DEBUG_NAME( device,
+                        descSetLayout,
+                        VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT,
+                        "Rasterizer draws desc set layout" );
+    }
+    {
+        VkDescriptorSetAllocateInfo allocInfo = {
+            .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .descriptorPool     = descPool,
+            .descriptorSetCount = 1,
+            .pSetLayouts        = &descSetLayout,
+        };
+
+        VkResult r = vkAllocateDescriptorSets( device, &allocInfo, &descSet );
+        VK_CHECKERROR( r );
+
+        SET_DEBUG_NAME( device, descSet, VK_OBJECT_TYPE_DESCRIPTOR_SET, "Rasterizer draws desc set" );
+    }
+    {
+        VkDescriptorBufferInfo b = {
+            .buffer = drawBuffer->GetDeviceLocal(),
+            .offset = 0,
+            .range  = VK_WHOLE_SIZE,
+        };
+
+        VkWriteDescriptorSet w = {
+            .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet          = descSet,
+            .dstBinding      = BINDING_RASTERIZED_DRAWS,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo     = &b,
+        };
+
+        vkUpdateDescriptorSets( device, 1, &w, 0, nullptr );
+    }
 }
 
 namespace RTGL1
@@ -152,7 +258,8 @@ namespace
         static_assert( offsetof( ShVertex, texCoord ) == offsetof( RgPrimitiveVertex, texCoord ) );
         static_assert( offsetof( ShVertex, color ) == offsetof( RgPrimitiveVertex, color ) );
 
-        memcpy( dstVerts, info.pVertices, sizeof( ShVertex ) * info.vertexCount );
+        VertexKernels::StreamCopy(
+            dstVerts, info.pVertices, sizeof( ShVertex ) * info.vertexCount );
     }
 
     bool IndicesExist( const RgMeshPrimitiveInfo& info )
@@ -161,8 +268,37 @@ namespace
     }
     void CopyIndices( const RgMeshPrimitiveInfo& info, uint32_t* dstIndices )
     {
-        assert( IndicesExist( info ) && dstIndices );
-        memcpy( dstIndices, info.pIndices, info.indexCount * sizeof( uint32_t ) );
+        assert( dstIndices );
+
+        if( IndicesExist( info ) )
+        {
+            VertexKernels::StreamCopy(
+                dstIndices, info.pIndices, info.indexCount * sizeof( uint32_t ) );
+        }
+        else
+        {
+            // every draw is indexed to be batched with vkCmdDrawIndexedIndirect
+            std::iota( dstIndices, dstIndices + info.vertexCount, 0u );
+        }
+    }
+
+    // Opaque geometry that writes depth can be drawn in any order
+    bool CanBeReordered( PipelineStateFlags s )
+    {
+        return ( s & PipelineStateFlagBits::DEPTH_TEST ) &&
+               ( s & PipelineStateFlagBits::DEPTH_WRITE ) &&
+               !( s & PipelineStateFlagBits::TRANSLUCENT ) &&
+               !( s & PipelineStateFlagBits::ADDITIVE );
+    }
+
+    bool AreViewportsSame( const std::optional< VkViewport >& a,
+                           const std::optional< VkViewport >& b )
+    {
+        if( a && b )
+        {
+            return Utils::AreViewportsSame( *a, *b );
+        }
+        return !a && !b;
     }
 }
 }
@@ -172,10 +308,18 @@ void RTGL1::RasterizedDataCollector::AddPrimitive( uint32_t                   fr
                                                    const RgTransform&         transform,
                                                    const RgMeshPrimitiveInfo& info,
                                                    const float*               pViewProjection,
-                                                   const RgViewport*          pViewport )
+                                                   const RgViewport*          pViewport,
+                                                   const MaterialTextures*    pBaseTextures )
 {
     assert( info.vertexCount > 0 && info.pVertices != nullptr );
 
+    if( curDrawCount >= MAX_DRAW_COUNT )
+    {
+        debug::Error( "Too many rasterized primitives in a frame: the limit is {}",
+                      MAX_DRAW_COUNT );
+        return;
+    }
+
     if( curVertexCount + info.vertexCount >= vertexBuffer->GetSize() / sizeof( ShVertex ) )
     {
         assert( 0 && "Increase the size of \"rasterizedMaxVertexCount\". Vertex buffer size "
@@ -183,15 +327,14 @@ void RTGL1::RasterizedDataCollector::AddPrimitive( uint32_t                   fr
         return;
     }
 
-    if( IndicesExist( info ) )
+    // if there are no indices, they are generated
+    const uint32_t indexCount = IndicesExist( info ) ? info.indexCount : info.vertexCount;
+
+    if( curIndexCount + indexCount >= indexBuffer->GetSize() / sizeof( uint32_t ) )
     {
-        if( curIndexCount + info.indexCount >= indexBuffer->GetSize() / sizeof( uint32_t ) )
-        {
-            assert( 0 &&
-                    "Increase the size of \"rasterizedMaxIndexCount\". Index buffer size reached "
-                    "the limit." );
-            return;
-        }
+        assert( 0 && "Increase the size of \"rasterizedMaxIndexCount\". Index buffer size reached "
+                     "the limit." );
+        return;
     }
 
 
@@ -206,23 +349,41 @@ void RTGL1::RasterizedDataCollector::AddPrimitive( uint32_t                   fr
 
 
     // copy index data
-    const uint32_t indexCount = IndicesExist( info ) ? info.indexCount : 0;
-    const uint32_t firstIndex = IndicesExist( info ) ? curIndexCount : 0;
+    const uint32_t firstIndex = curIndexCount;
 
-    if( IndicesExist( info ) )
     {
         auto* indicesBase = indexBuffer->GetMappedAs< uint32_t* >( frameIndex );
         CopyIndices( info, &indicesBase[ firstIndex ] );
     }
 
 
-    const auto textures = textureMgr->GetTexturesForLayers( info );
+    const auto textures = pBaseTextures
+                              ? textureMgr->GetTexturesForLayers( info, *pBaseTextures )
+                              : textureMgr->GetTexturesForLayers( info );
     const auto colors   = textureMgr->GetColorForLayers( info );
 
     const RgEditorPBRInfo* pbrInfo = ( info.pEditorInfo && info.pEditorInfo->pbrInfoExists )
                                          ? &info.pEditorInfo->pbrInfo
                                          : nullptr;
 
+    // per-draw constants, fetched in a vertex shader by firstInstance
+    const uint32_t drawIndex = curDrawCount;
+
+    {
+        auto& dst = drawBuffer->GetMappedAs< ShRasterizedDraw* >( frameIndex )[ drawIndex ];
+
+        Matrix::ToMat4Transposed( dst.model, transform );
+        if( pViewProjection )
+        {
+            memcpy( dst.viewProj, pViewProjection, 16 * sizeof( float ) );
+        }
+        dst.useViewProj          = pViewProjection ? 1 : 0;
+        dst.packedColor          = colors[ 0 ];
+        dst.textureIndex         = textures[ 0 ].indices[ TEXTURE_ALBEDO_ALPHA_INDEX ];
+        dst.emissiveTextureIndex = textures[ 0 ].indices[ TEXTURE_EMISSIVE_INDEX ];
+        dst.emissiveMult         = Utils::Saturate( info.emissive );
+    }
+
     PushInfo( rasterType ) = {
         .transform = transform,
         .flags     = GeomInfoManager::GetPrimitiveFlags( info ),
@@ -245,6 +406,7 @@ void RTGL1::RasterizedDataCollector::AddPrimitive( uint32_t                   fr
         .firstVertex = firstVertex,
         .indexCount  = indexCount,
         .firstIndex  = firstIndex,
+        .drawIndex   = drawIndex,
 
         .roughnessFactor = Utils::Saturate( pbrInfo ? pbrInfo->roughnessDefault : 1.0f ),
         .metallicFactor  = Utils::Saturate( pbrInfo ? pbrInfo->metallicDefault : 0.0f ),
@@ -257,8 +419,9 @@ void RTGL1::RasterizedDataCollector::AddPrimitive( uint32_t                   fr
         .pipelineState = ToPipelineState( rasterType, info ),
     };
 
-    curVertexCount += info.vertexCount;
-    curIndexCount += info.indexCount;
+    curVertexCount += vertexCount;
+    curIndexCount += indexCount;
+    curDrawCount++;
 }
 
 RTGL1::RasterizedDataCollector::DrawInfo& RTGL1::RasterizedDataCollector::PushInfo(
@@ -288,14 +451,110 @@ void RTGL1::RasterizedDataCollector::Clear( uint32_t frameIndex )
     swapchainDrawInfos.clear();
     skyDrawInfos.clear();
 
+    rasterDrawBatches.clear();
+    swapchainDrawBatches.clear();
+    skyDrawBatches.clear();
+
     curVertexCount = 0;
     curIndexCount  = 0;
+    curDrawCount   = 0;
 }
 
 void RTGL1::RasterizedDataCollector::CopyFromStaging( VkCommandBuffer cmd, uint32_t frameIndex )
 {
+    auto* commands = indirectBuffer->GetMappedAs< VkDrawIndexedIndirectCommand* >( frameIndex );
+
+    uint32_t commandCount = 0;
+    commandCount += MakeBatches( rasterDrawInfos, commands, commandCount, rasterDrawBatches );
+    commandCount += MakeBatches( skyDrawInfos, commands, commandCount, skyDrawBatches );
+    commandCount += MakeBatches( swapchainDrawInfos, commands, commandCount, swapchainDrawBatches );
+    assert( commandCount == curDrawCount );
+
     vertexBuffer->CopyFromStaging( cmd, frameIndex, sizeof( ShVertex ) * curVertexCount );
     indexBuffer->CopyFromStaging( cmd, frameIndex, sizeof( uint32_t ) * curIndexCount );
+    drawBuffer->CopyFromStaging( cmd, frameIndex, sizeof( ShRasterizedDraw ) * curDrawCount );
+    indirectBuffer->CopyFromStaging(
+        cmd, frameIndex, sizeof( VkDrawIndexedIndirectCommand ) * commandCount );
+}
+
+uint32_t RTGL1::RasterizedDataCollector::MakeBatches( const std::vector< DrawInfo >& drawInfos,
+                                                      VkDrawIndexedIndirectCommand*  dstCommands,
+                                                      uint32_t                       firstCommand,
+                                                      std::vector< DrawBatch >& outBatches ) const
+{
+    outBatches.clear();
+
+    if( drawInfos.empty() )
+    {
+        return 0;
+    }
+
+    std::vector< uint32_t > order( drawInfos.size() );
+    std::iota( order.begin(), order.end(), 0u );
+
+    // to minimize state changes, opaque depth-writing draws are sorted by pipeline, but only
+    // within a run of such draws with the same viewport: translucent and not depth-tested
+    // (e.g. HUD) draws are order-dependent, so nothing can be moved across them
+    auto canBeInSameRun = [ & ]( uint32_t prev, uint32_t cur ) {
+        return CanBeReordered( drawInfos[ cur ].pipelineState ) &&
+               AreViewportsSame( drawInfos[ prev ].viewport, drawInfos[ cur ].viewport );
+    };
+
+    for( auto runBegin = order.begin(); runBegin != order.end(); )
+    {
+        auto runEnd = std::next( runBegin );
+
+        if( CanBeReordered( drawInfos[ *runBegin ].pipelineState ) )
+        {
+            while( runEnd != order.end() && canBeInSameRun( *std::prev( runEnd ), *runEnd ) )
+            {
+                ++runEnd;
+            }
+
+            std::stable_sort( runBegin, runEnd, [ & ]( uint32_t a, uint32_t b ) {
+                return drawInfos[ a ].pipelineState < drawInfos[ b ].pipelineState;
+            } );
+        }
+
+        runBegin = runEnd;
+    }
+
+    uint32_t cmdIndex = firstCommand;
+
+    for( uint32_t i : order )
+    {
+        const DrawInfo& info = drawInfos[ i ];
+
+        dstCommands[ cmdIndex ] = {
+            .indexCount    = info.indexCount,
+            .instanceCount = 1,
+            .firstIndex    = info.firstIndex,
+            .vertexOffset  = int32_t( info.firstVertex ),
+            .firstInstance = info.drawIndex,
+        };
+
+        const bool sameAsPrev = !outBatches.empty() &&
+                                outBatches.back().pipelineState == info.pipelineState &&
+                                AreViewportsSame( outBatches.back().viewport, info.viewport );
+
+        if( sameAsPrev )
+        {
+            outBatches.back().commandCount++;
+        }
+        else
+        {
+            outBatches.push_back( DrawBatch{
+                .pipelineState = info.pipelineState,
+                .viewport      = info.viewport,
+                .firstCommand  = cmdIndex,
+                .commandCount  = 1,
+            } );
+        }
+
+        cmdIndex++;
+    }
+
+    return cmdIndex - firstCommand;
 }
 
 VkBuffer RTGL1::RasterizedDataCollector::GetVertexBuffer() const
@@ -308,6 +567,21 @@ VkBuffer RTGL1::RasterizedDataCollector::GetIndexBuffer() const
     return indexBuffer->GetDeviceLocal();
 }
 
+VkBuffer RTGL1::RasterizedDataCollector::GetIndirectBuffer() const
+{
+    return indirectBuffer->GetDeviceLocal();
+}
+
+VkDescriptorSetLayout RTGL1::RasterizedDataCollector::GetDescSetLayout() const
+{
+    return descSetLayout;
+}
+
+VkDescriptorSet RTGL1::RasterizedDataCollector::GetDescSet() const
+{
+    return descSet;
+}
+
 const std::vector< RTGL1::RasterizedDataCollector::DrawInfo >& RTGL1::RasterizedDataCollector::
     GetRasterDrawInfos() const
 {
@@ -325,3 +599,21 @@ const std::vector< RTGL1::RasterizedDataCollector::DrawInfo >& RTGL1::Rasterized
 {
     return skyDrawInfos;
 }
+
+const std::vector< RTGL1::RasterizedDataCollector::DrawBatch >& RTGL1::RasterizedDataCollector::
+    GetRasterDrawBatches() const
+{
+    return rasterDrawBatches;
+}
+
+const std::vector< RTGL1::RasterizedDataCollector::DrawBatch >& RTGL1::RasterizedDataCollector::
+    GetSwapchainDrawBatches() const
+{
+    return swapchainDrawBatches;
+}
+
+const std::vector< RTGL1::RasterizedDataCollector::DrawBatch >& RTGL1::RasterizedDataCollector::
+    GetSkyDrawBatches() const
+{
+    return skyDrawBatches;
+}
@@ -91,6 +91,8 @@ public:
         uint32_t                    firstVertex = 0;
         uint32_t                    indexCount  = 0;
         uint32_t                    firstIndex  = 0;
+        // index in the buffer of ShRasterizedDraw
+        uint32_t                    drawIndex   = 0;
 
         float                       roughnessFactor = 1.0f;
         float                       metallicFactor  = 0.0f;
@@ -103,13 +105,22 @@ public:
         PipelineStateFlags          pipelineState = 0;
     };
 
+    // Consecutive indirect draw commands with the same pipeline and viewport
+    struct DrawBatch
+    {
+        PipelineStateFlags          pipelineState;
+        std::optional< VkViewport > viewport;
+        uint32_t                    firstCommand;
+        uint32_t                    commandCount;
+    };
+
 public:
     explicit RasterizedDataCollector( VkDevice                           device,
                                       std::shared_ptr< MemoryAllocator > allocator,
                                       std::shared_ptr< TextureManager >  textureMgr,
                                       uint32_t                           maxVertexCount,
                                       uint32_t                           maxIndexCount );
-    ~RasterizedDataCollector() = default;
+    ~RasterizedDataCollector();
 
     RasterizedDataCollector( const RasterizedDataCollector& other )     = delete;
     RasterizedDataCollector( RasterizedDataCollector&& other ) noexcept = delete;
@@ -121,14 +132,21 @@ public:
                                            const RgTransform&         transform,
                                            const RgMeshPrimitiveInfo& info,
                                            const float*               pViewProjection,
-                                           const RgViewport*          pViewport );
+                                           const RgViewport*          pViewport,
+                                           const MaterialTextures*    pBaseTextures );
 
     void                     Clear( uint32_t frameIndex );
 
+    // Sorts the draws into batches and copies per-draw data and indirect commands
     void                     CopyFromStaging( VkCommandBuffer cmd, uint32_t frameIndex );
 
     [[nodiscard]] VkBuffer   GetVertexBuffer() const;
     [[nodiscard]] VkBuffer   GetIndexBuffer() const;
+    [[nodiscard]] VkBuffer   GetIndirectBuffer() const;
+
+    // Storage buffer of ShRasterizedDraw, accessed with gl_InstanceIndex
+    [[nodiscard]] VkDescriptorSetLayout GetDescSetLayout() const;
+    [[nodiscard]] VkDescriptorSet       GetDescSet() const;
 
     static uint32_t          GetVertexStride();
     static std::array< VkVertexInputAttributeDescription, 3 > GetVertexLayout();
@@ -137,22 +155,45 @@ public:
     const std::vector< DrawInfo >&                            GetSwapchainDrawInfos() const;
     const std::vector< DrawInfo >&                            GetSkyDrawInfos() const;
 
+    // Valid after CopyFromStaging
+    const std::vector< DrawBatch >&                           GetRasterDrawBatches() const;
+    const std::vector< DrawBatch >&                           GetSwapchainDrawBatches() const;
+    const std::vector< DrawBatch >&                           GetSkyDrawBatches() const;
+
 protected:
     DrawInfo& PushInfo( GeometryRasterType rasterType );
 
+private:
+    void     CreateDescriptors();
+    uint32_t MakeBatches( const std::vector< DrawInfo >& drawInfos,
+                          VkDrawIndexedIndirectCommand*  dstCommands,
+                          uint32_t                       firstCommand,
+                          std::vector< DrawBatch >&      outBatches ) const;
+
 private:
     VkDevice                          device;
     std::shared_ptr< TextureManager > textureMgr;
 
     std::shared_ptr< AutoBuffer >     vertexBuffer;
     std::shared_ptr< AutoBuffer >     indexBuffer;
+    std::shared_ptr< AutoBuffer >     drawBuffer;
+    std::shared_ptr< AutoBuffer >     indirectBuffer;
 
     uint32_t                          curVertexCount;
     uint32_t                          curIndexCount;
+    uint32_t                          curDrawCount;
 
     std::vector< DrawInfo >           rasterDrawInfos;
     std::vector< DrawInfo >           swapchainDrawInfos;
     std::vector< DrawInfo >           skyDrawInfos;
+
+    std::vector< DrawBatch >          rasterDrawBatches;
+    std::vector< DrawBatch >          swapchainDrawBatches;
+    std::vector< DrawBatch >          skyDrawBatches;
+
+    VkDescriptorPool                  descPool;
+    VkDescriptorSetLayout             descSetLayout;
+    VkDescriptorSet                   descSet;
 };
 
 }
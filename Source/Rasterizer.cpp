@@ -26,39 +26,7 @@
 #include "CmdLabel.h"
 #include "RenderResolutionHelper.h"
 
-namespace
-{
-
-struct RasterizedPushConst
-{
-    float    vp[ 16 ];
-    uint32_t packedColor;
-    uint32_t textureIndex;
-    uint32_t emissiveTextureIndex;
-    float    emissiveMult;
-
-    explicit RasterizedPushConst( const RTGL1::RasterizedDataCollector::DrawInfo& info,
-                                  const float*                                    defaultViewProj )
-        : vp{}
-        , packedColor{ info.colorFactor_base }
-        , textureIndex( info.texture_base )
-        , emissiveTextureIndex( info.texture_base_E )
-        , emissiveMult( info.emissive )
-    {
-        float model[ 16 ] = RG_MATRIX_TRANSPOSED( info.transform );
-        RTGL1::Matrix::Multiply(
-            vp, model, info.viewProj ? info.viewProj->Get() : defaultViewProj );
-    }
-};
-
-static_assert( offsetof( RasterizedPushConst, vp ) == 0 );
-static_assert( offsetof( RasterizedPushConst, packedColor ) == 64 );
-static_assert( offsetof( RasterizedPushConst, textureIndex ) == 68 );
-static_assert( offsetof( RasterizedPushConst, emissiveTextureIndex ) == 72 );
-static_assert( offsetof( RasterizedPushConst, emissiveMult ) == 76 );
-static_assert( sizeof( RasterizedPushConst ) == 80 );
-
-}
+#include <array>
 
 RTGL1::Rasterizer::Rasterizer( VkDevice                                _device,
                                VkPhysicalDevice                        _physDevice,
@@ -71,12 +39,15 @@ RTGL1::Rasterizer::Rasterizer( VkDevice                                _device,
                                std::shared_ptr< MemoryAllocator >      _allocator,
                                std::shared_ptr< Framebuffers >         _storageFramebuffers,
                                std::shared_ptr< CommandBufferManager > _cmdManager,
-                               const RgInstanceCreateInfo&             _instanceInfo )
+                               const RgInstanceCreateInfo&             _instanceInfo,
+                               bool                                    _pipelineFallback,
+                               std::shared_ptr< SecondaryCmdRecorder > _secondaryRecorder )
     : device( _device )
     , rasterPassPipelineLayout( VK_NULL_HANDLE )
     , swapchainPassPipelineLayout( VK_NULL_HANDLE )
     , allocator( std::move( _allocator ) )
     , cmdManager( std::move( _cmdManager ) )
+    , secondaryRecorder( std::move( _secondaryRecorder ) )
     , storageFramebuffers( std::move( _storageFramebuffers ) )
 {
     collector =
@@ -88,11 +59,17 @@ RTGL1::Rasterizer::Rasterizer( VkDevice                                _device,
 
     VkDescriptorSetLayout layouts[] = {
         _textureManager->GetDescSetLayout(),
+        collector->GetDescSetLayout(),
         _uniform.GetDescSetLayout(),
         _tonemapping.GetDescSetLayout(),
         _volumetric.GetDescSetLayout(),
     };
-    CreatePipelineLayouts( layouts, std::size( layouts ), _textureManager->GetDescSetLayout() );
+    VkDescriptorSetLayout swapchainLayouts[] = {
+        _textureManager->GetDescSetLayout(),
+        collector->GetDescSetLayout(),
+    };
+    CreatePipelineLayouts(
+        layouts, std::size( layouts ), swapchainLayouts, std::size( swapchainLayouts ) );
 
     rasterPass = std::make_shared< RasterPass >( device,
                                                  _physDevice,
@@ -121,6 +98,12 @@ RTGL1::Rasterizer::Rasterizer( VkDevice                                _device,
                                                  *storageFramebuffers,
                                                  *_textureManager,
                                                  _instanceInfo );
+
+    // rasterized geometry is not known beforehand, so instead of stalling
+    // on a new state combination, draw it with a similar pipeline for a few frames
+    rasterPass->GetRasterPipelines()->SetFallbackToClosest( _pipelineFallback );
+    rasterPass->GetSkyRasterPipelines()->SetFallbackToClosest( _pipelineFallback );
+    swapchainPass->GetSwapchainPipelines()->SetFallbackToClosest( _pipelineFallback );
 }
 
 RTGL1::Rasterizer::~Rasterizer()
@@ -131,6 +114,11 @@ RTGL1::Rasterizer::~Rasterizer()
 
 void RTGL1::Rasterizer::PrepareForFrame( uint32_t frameIndex )
 {
+    if( secondaryRecorder )
+    {
+        secondaryRecorder->PrepareForFrame( frameIndex );
+    }
+
     collector->Clear( frameIndex );
     lensFlares->PrepareForFrame( frameIndex );
 }
@@ -140,9 +128,11 @@ void RTGL1::Rasterizer::Upload( uint32_t                   frameIndex,
                                 const RgTransform&         transform,
                                 const RgMeshPrimitiveInfo& info,
                                 const float*               pViewProjection,
-                                const RgViewport*          pViewport )
+                                const RgViewport*          pViewport,
+                                const MaterialTextures*    pBaseTextures )
 {
-    collector->AddPrimitive( frameIndex, rasterType, transform, info, pViewProjection, pViewport );
+    collector->AddPrimitive(
+        frameIndex, rasterType, transform, info, pViewProjection, pViewport, pBaseTextures );
 }
 
 void RTGL1::Rasterizer::UploadLensFlare( uint32_t                     frameIndex,
@@ -188,12 +178,12 @@ namespace
     }
 
 
-    void SetViewportIfNew( VkCommandBuffer                          cmd,
-                           const RasterizedDataCollector::DrawInfo& info,
-                           const VkViewport&                        defaultViewport,
-                           VkViewport&                              curViewport )
+    void SetViewportIfNew( VkCommandBuffer                    cmd,
+                           const std::optional< VkViewport >& viewport,
+                           const VkViewport&                  defaultViewport,
+                           VkViewport&                        curViewport )
     {
-        const VkViewport newViewport = info.viewport.value_or( defaultViewport );
+        const VkViewport newViewport = viewport.value_or( defaultViewport );
 
         if( !Utils::AreViewportsSame( curViewport, newViewport ) )
         {
@@ -201,6 +191,37 @@ namespace
             curViewport = newViewport;
         }
     }
+
+
+    // All combinations that RasterizedDataCollector can produce for triangles
+    std::vector< PipelineStateFlags > GetExpectedPipelineStates( bool withDepth )
+    {
+        std::vector< PipelineStateFlags > states;
+
+        for( bool alphaTest : { false, true } )
+        {
+            for( bool translucent : { false, true } )
+            {
+                for( bool additive : { false, true } )
+                {
+                    PipelineStateFlags s = 0;
+                    s = alphaTest ? s | PipelineStateFlagBits::ALPHA_TEST : s;
+                    s = translucent ? s | PipelineStateFlagBits::TRANSLUCENT : s;
+                    s = additive ? s | PipelineStateFlagBits::ADDITIVE : s;
+
+                    if( withDepth )
+                    {
+                        s = s | PipelineStateFlagBits::DEPTH_TEST;
+                        s = translucent ? s : s | PipelineStateFlagBits::DEPTH_WRITE;
+                    }
+
+                    states.push_back( s );
+                }
+            }
+        }
+
+        return states;
+    }
 }
 }
 
@@ -214,8 +235,8 @@ struct RasterLensFlares
 
 struct RasterDrawParams
 {
-    RasterizerPipelines&                                 pipelines;
-    std::span< const RasterizedDataCollector::DrawInfo > drawInfos{};
+    RasterizerPipelines&                                  pipelines;
+    std::span< const RasterizedDataCollector::DrawBatch > drawBatches{};
 
     VkRenderPass                      renderPass{ VK_NULL_HANDLE };
     VkFramebuffer                     framebuffer{ VK_NULL_HANDLE };
@@ -223,14 +244,196 @@ struct RasterDrawParams
     uint32_t                          height{ 0 };
     VkBuffer                          vertexBuffer{ VK_NULL_HANDLE };
     VkBuffer                          indexBuffer{ VK_NULL_HANDLE };
-    std::span< VkDescriptorSet >      descSets{};
-    float*                            defaultViewProj{ nullptr };
+    VkBuffer                          indirectBuffer{ VK_NULL_HANDLE };
+    // stored by value, so the params can be passed to a worker thread
+    std::array< VkDescriptorSet, 5 >  descSets{};
+    uint32_t                          descSetCount{ 0 };
+    std::array< float, 16 >           defaultViewProj{};
     // not the best way to optionally draw lens flares with a world pass
     std::optional< RasterLensFlares > flaresParams{};
 };
 
 }
 
+namespace RTGL1
+{
+namespace
+{
+    enum SecondaryCmdSlot : uint32_t
+    {
+        SLOT_SKY,
+        SLOT_WORLD,
+        SLOT_SWAPCHAIN,
+    };
+    static_assert( SLOT_SWAPCHAIN + 1 == Rasterizer::SecondaryCmdSlotCount );
+}
+}
+
+RTGL1::RasterDrawParams RTGL1::Rasterizer::MakeSkyParams(
+    uint32_t                      frameIndex,
+    const TextureManager&         textureManager,
+    const float*                  view,
+    const RgFloat3D&              skyViewerPos,
+    const float*                  proj,
+    const RgFloat2D&              jitter,
+    const RenderResolutionHelper& renderResolution ) const
+{
+    float skyView[ 16 ];
+    Matrix::SetNewViewerPosition( skyView, view, skyViewerPos.data );
+
+    float jitterredProj[ 16 ];
+    ApplyJitter( jitterredProj, proj, jitter, renderResolution );
+
+    RasterDrawParams params = {
+        .pipelines      = *rasterPass->GetSkyRasterPipelines(),
+        .drawBatches    = collector->GetSkyDrawBatches(),
+        .renderPass     = rasterPass->GetSkyRenderPass(),
+        .framebuffer    = rasterPass->GetSkyFramebuffer( frameIndex ),
+        .width          = renderResolution.Width(),
+        .height         = renderResolution.Height(),
+        .vertexBuffer   = collector->GetVertexBuffer(),
+        .indexBuffer    = collector->GetIndexBuffer(),
+        .indirectBuffer = collector->GetIndirectBuffer(),
+        .descSets       = { textureManager.GetDescSet( frameIndex ), collector->GetDescSet() },
+        .descSetCount   = 2,
+    };
+    Matrix::Multiply( params.defaultViewProj.data(), skyView, jitterredProj );
+
+    return params;
+}
+
+RTGL1::RasterDrawParams RTGL1::Rasterizer::MakeWorldParams(
+    uint32_t                      frameIndex,
+    const TextureManager&         textureManager,
+    const GlobalUniform&          uniform,
+    const Tonemapping&            tonemapping,
+    const Volumetric&             volumetric,
+    const float*                  view,
+    const float*                  proj,
+    const RgFloat2D&              jitter,
+    const RenderResolutionHelper& renderResolution ) const
+{
+    float jitterredProj[ 16 ];
+    ApplyJitter( jitterredProj, proj, jitter, renderResolution );
+
+    RasterDrawParams params = {
+        .pipelines      = *rasterPass->GetRasterPipelines(),
+        .drawBatches    = collector->GetRasterDrawBatches(),
+        .renderPass     = rasterPass->GetWorldRenderPass(),
+        .framebuffer    = rasterPass->GetWorldFramebuffer( frameIndex ),
+        .width          = renderResolution.Width(),
+        .height         = renderResolution.Height(),
+        .vertexBuffer   = collector->GetVertexBuffer(),
+        .indexBuffer    = collector->GetIndexBuffer(),
+        .indirectBuffer = collector->GetIndirectBuffer(),
+        .descSets       = { textureManager.GetDescSet( frameIndex ),
+                            collector->GetDescSet(),
+                            uniform.GetDescSet( frameIndex ),
+                            tonemapping.GetDescSet(),
+                            volumetric.GetDescSet( frameIndex ) },
+        .descSetCount   = 5,
+        .flaresParams   = RasterLensFlares{ .textureManager = &textureManager },
+    };
+    Matrix::Multiply( params.defaultViewProj.data(), view, jitterredProj );
+
+    return params;
+}
+
+RTGL1::RasterDrawParams RTGL1::Rasterizer::MakeSwapchainParams(
+    uint32_t              frameIndex,
+    VkFramebuffer         framebuffer,
+    const TextureManager& textureManager,
+    const float*          view,
+    const float*          proj,
+    uint32_t              swapchainWidth,
+    uint32_t              swapchainHeight ) const
+{
+    RasterDrawParams params = {
+        .pipelines      = *swapchainPass->GetSwapchainPipelines(),
+        .drawBatches    = collector->GetSwapchainDrawBatches(),
+        .renderPass     = swapchainPass->GetSwapchainRenderPass(),
+        .framebuffer    = framebuffer,
+        .width          = swapchainWidth,
+        .height         = swapchainHeight,
+        .vertexBuffer   = collector->GetVertexBuffer(),
+        .indexBuffer    = collector->GetIndexBuffer(),
+        .indirectBuffer = collector->GetIndirectBuffer(),
+        .descSets       = { textureManager.GetDescSet( frameIndex ), collector->GetDescSet() },
+        .descSetCount   = 2,
+    };
+    Matrix::Multiply( params.defaultViewProj.data(), view, proj );
+
+    return params;
+}
+
+void RTGL1::Rasterizer::RecordInParallel( uint32_t                      frameIndex,
+                                          bool                          withSky,
+                                          const TextureManager&         textureManager,
+                                          const GlobalUniform&          uniform,
+                                          const Tonemapping&            tonemapping,
+                                          const Volumetric&             volumetric,
+                                          const float*                  view,
+                                          const RgFloat3D&              skyViewerPos,
+                                          const float*                  proj,
+                                          const RgFloat2D&              jitter,
+                                          const RenderResolutionHelper& renderResolution,
+                                          uint32_t                      swapchainWidth,
+                                          uint32_t                      swapchainHeight )
+{
+    if( !secondaryRecorder )
+    {
+        return;
+    }
+
+    auto recordIfNeeded = [ this, frameIndex ]( uint32_t slot, const RasterDrawParams& params ) {
+        if( HasDraws( params ) )
+        {
+            secondaryRecorder->Record(
+                slot,
+                frameIndex,
+                params.renderPass,
+                params.framebuffer,
+                [ this, frameIndex, params ]( VkCommandBuffer secondary ) {
+                    RecordDraws( secondary, frameIndex, params );
+                } );
+        }
+    };
+
+    if( withSky )
+    {
+        recordIfNeeded(
+            SLOT_SKY,
+            MakeSkyParams(
+                frameIndex, textureManager, view, skyViewerPos, proj, jitter, renderResolution ) );
+    }
+
+    recordIfNeeded( SLOT_WORLD,
+                    MakeWorldParams( frameIndex,
+                                     textureManager,
+                                     uniform,
+                                     tonemapping,
+                                     volumetric,
+                                     view,
+                                     proj,
+                                     jitter,
+                                     renderResolution ) );
+
+    // the image to draw in depends on post-effects, so the framebuffer is not known yet
+    recordIfNeeded( SLOT_SWAPCHAIN,
+                    MakeSwapchainParams( frameIndex,
+                                         VK_NULL_HANDLE,
+                                         textureManager,
+                                         view,
+                                         proj,
+                                         swapchainWidth,
+                                         swapchainHeight ) );
+}
+
+VkCommandBuffer RTGL1::Rasterizer::AcquireRecorded( uint32_t slot )
+{
+    return secondaryRecorder ? secondaryRecorder->Acquire( slot ) : VK_NULL_HANDLE;
+}
+
 void RTGL1::Rasterizer::DrawSkyToAlbedo( VkCommandBuffer               cmd,
                                          uint32_t                      frameIndex,
                                          const TextureManager&         textureManager,
@@ -247,34 +450,11 @@ void RTGL1::Rasterizer::DrawSkyToAlbedo( VkCommandBuffer               cmd,
     storageFramebuffers->BarrierOne( cmd, frameIndex, FI::FB_IMAGE_INDEX_ALBEDO );
 
 
-    float skyView[ 16 ];
-    Matrix::SetNewViewerPosition( skyView, view, skyViewerPos.data );
-
-    float jitterredProj[ 16 ];
-    ApplyJitter( jitterredProj, proj, jitter, renderResolution );
-
-    float defaultSkyViewProj[ 16 ];
-    Matrix::Multiply( defaultSkyViewProj, skyView, jitterredProj );
-
-
-    VkDescriptorSet sets[] = {
-        textureManager.GetDescSet( frameIndex ),
-    };
-
-    const RasterDrawParams params = {
-        .pipelines       = *rasterPass->GetSkyRasterPipelines(),
-        .drawInfos       = collector->GetSkyDrawInfos(),
-        .renderPass      = rasterPass->GetSkyRenderPass(),
-        .framebuffer     = rasterPass->GetSkyFramebuffer( frameIndex ),
-        .width           = renderResolution.Width(),
-        .height          = renderResolution.Height(),
-        .vertexBuffer    = collector->GetVertexBuffer(),
-        .indexBuffer     = collector->GetIndexBuffer(),
-        .descSets        = sets,
-        .defaultViewProj = defaultSkyViewProj,
-    };
-
-    Draw( cmd, frameIndex, params );
+    Draw( cmd,
+          frameIndex,
+          MakeSkyParams(
+              frameIndex, textureManager, view, skyViewerPos, proj, jitter, renderResolution ),
+          AcquireRecorded( SLOT_SKY ) );
 }
 
 void RTGL1::Rasterizer::DrawToFinalImage( VkCommandBuffer               cmd,
@@ -311,35 +491,18 @@ void RTGL1::Rasterizer::DrawToFinalImage( VkCommandBuffer               cmd,
                                  renderResolution.Height() );
 
 
-    float jitterredProj[ 16 ];
-    ApplyJitter( jitterredProj, proj, jitter, renderResolution );
-
-
-    float defaultViewProj[ 16 ];
-    Matrix::Multiply( defaultViewProj, view, jitterredProj );
-
-    VkDescriptorSet sets[] = {
-        textureManager.GetDescSet( frameIndex ),
-        uniform.GetDescSet( frameIndex ),
-        tonemapping.GetDescSet(),
-        volumetric.GetDescSet( frameIndex ),
-    };
-
-    const RasterDrawParams params = {
-        .pipelines       = *rasterPass->GetRasterPipelines(),
-        .drawInfos       = collector->GetRasterDrawInfos(),
-        .renderPass      = rasterPass->GetWorldRenderPass(),
-        .framebuffer     = rasterPass->GetWorldFramebuffer( frameIndex ),
-        .width           = renderResolution.Width(),
-        .height          = renderResolution.Height(),
-        .vertexBuffer    = collector->GetVertexBuffer(),
-        .indexBuffer     = collector->GetIndexBuffer(),
-        .descSets        = sets,
-        .defaultViewProj = defaultViewProj,
-        .flaresParams    = RasterLensFlares{ .textureManager = &textureManager },
-    };
-
-    Draw( cmd, frameIndex, params );
+    Draw( cmd,
+          frameIndex,
+          MakeWorldParams( frameIndex,
+                           textureManager,
+                           uniform,
+                           tonemapping,
+                           volumetric,
+                           view,
+                           proj,
+                           jitter,
+                           renderResolution ),
+          AcquireRecorded( SLOT_WORLD ) );
 }
 
 void RTGL1::Rasterizer::DrawToSwapchain( VkCommandBuffer       cmd,
@@ -354,63 +517,41 @@ void RTGL1::Rasterizer::DrawToSwapchain( VkCommandBuffer       cmd,
     CmdLabel label( cmd, "Rasterized to swapchain" );
 
 
-    float defaultViewProj[ 16 ];
-    Matrix::Multiply( defaultViewProj, view, proj );
-
-
-    VkDescriptorSet sets[] = {
-        textureManager.GetDescSet( frameIndex ),
-    };
-
-    const RasterDrawParams params = {
-        .pipelines       = *swapchainPass->GetSwapchainPipelines(),
-        .drawInfos       = collector->GetSwapchainDrawInfos(),
-        .renderPass      = swapchainPass->GetSwapchainRenderPass(),
-        .framebuffer     = swapchainPass->GetSwapchainFramebuffer( imageToDrawIn, frameIndex ),
-        .width           = swapchainWidth,
-        .height          = swapchainHeight,
-        .vertexBuffer    = collector->GetVertexBuffer(),
-        .indexBuffer     = collector->GetIndexBuffer(),
-        .descSets        = sets,
-        .defaultViewProj = defaultViewProj,
-    };
+    Draw( cmd,
+          frameIndex,
+          MakeSwapchainParams( frameIndex,
+                               swapchainPass->GetSwapchainFramebuffer( imageToDrawIn, frameIndex ),
+                               textureManager,
+                               view,
+                               proj,
+                               swapchainWidth,
+                               swapchainHeight ),
+          AcquireRecorded( SLOT_SWAPCHAIN ) );
+}
 
-    Draw( cmd, frameIndex, params );
+bool RTGL1::Rasterizer::HasDraws( const RasterDrawParams& drawParams ) const
+{
+    return !drawParams.drawBatches.empty() ||
+           ( drawParams.flaresParams && lensFlares->GetCullingInputCount() > 0 );
 }
 
 void RTGL1::Rasterizer::Draw( VkCommandBuffer         cmd,
                               uint32_t                frameIndex,
-                              const RasterDrawParams& drawParams )
+                              const RasterDrawParams& drawParams,
+                              VkCommandBuffer         recordedDraws )
 {
     assert( drawParams.framebuffer != VK_NULL_HANDLE );
 
-    const bool draw           = !drawParams.drawInfos.empty();
-    const bool drawLensFlares = drawParams.flaresParams && lensFlares->GetCullingInputCount() > 0;
-
-    if( !draw && !drawLensFlares )
+    if( !HasDraws( drawParams ) )
     {
         return;
     }
 
-    if( drawLensFlares )
+    if( drawParams.flaresParams && lensFlares->GetCullingInputCount() > 0 )
     {
         lensFlares->SyncForDraw( cmd, frameIndex );
     }
 
-    const VkViewport defaultViewport = {
-        .x        = 0,
-        .y        = 0,
-        .width    = static_cast< float >( drawParams.width ),
-        .height   = static_cast< float >( drawParams.height ),
-        .minDepth = 0.0f,
-        .maxDepth = 1.0f,
-    };
-
-    const VkRect2D defaultRenderArea = {
-        .offset = { 0, 0 },
-        .extent = { drawParams.width, drawParams.height },
-    };
-
     const VkClearValue clear[] = {
         {
             .color = { .float32 = { 0.0f, 0.0f, 0.0f, 0.0 } },
@@ -420,28 +561,66 @@ void RTGL1::Rasterizer::Draw( VkCommandBuffer         cmd,
         },
     };
 
+    const VkRect2D renderArea = {
+        .offset = { 0, 0 },
+        .extent = { drawParams.width, drawParams.height },
+    };
+
     VkRenderPassBeginInfo beginInfo = {
         .sType           = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
         .renderPass      = drawParams.renderPass,
         .framebuffer     = drawParams.framebuffer,
-        .renderArea      = defaultRenderArea,
+        .renderArea      = renderArea,
         .clearValueCount = std::size( clear ),
         .pClearValues    = clear,
     };
 
-    vkCmdBeginRenderPass( cmd, &beginInfo, VK_SUBPASS_CONTENTS_INLINE );
+    if( recordedDraws != VK_NULL_HANDLE )
+    {
+        vkCmdBeginRenderPass( cmd, &beginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS );
+        vkCmdExecuteCommands( cmd, 1, &recordedDraws );
+    }
+    else
+    {
+        vkCmdBeginRenderPass( cmd, &beginInfo, VK_SUBPASS_CONTENTS_INLINE );
+        RecordDraws( cmd, frameIndex, drawParams );
+    }
+
+    vkCmdEndRenderPass( cmd );
+}
+
+void RTGL1::Rasterizer::RecordDraws( VkCommandBuffer         cmd,
+                                     uint32_t                frameIndex,
+                                     const RasterDrawParams& drawParams )
+{
+    const bool draw           = !drawParams.drawBatches.empty();
+    const bool drawLensFlares = drawParams.flaresParams && lensFlares->GetCullingInputCount() > 0;
+
+    const VkViewport defaultViewport = {
+        .x        = 0,
+        .y        = 0,
+        .width    = static_cast< float >( drawParams.width ),
+        .height   = static_cast< float >( drawParams.height ),
+        .minDepth = 0.0f,
+        .maxDepth = 1.0f,
+    };
+
+    const VkRect2D defaultRenderArea = {
+        .offset = { 0, 0 },
+        .extent = { drawParams.width, drawParams.height },
+    };
 
 
     if( draw )
     {
         VkPipeline curPipeline = drawParams.pipelines.BindPipelineIfNew(
-            cmd, VK_NULL_HANDLE, drawParams.drawInfos[ 0 ].pipelineState );
+            cmd, VK_NULL_HANDLE, drawParams.drawBatches[ 0 ].pipelineState );
 
         vkCmdBindDescriptorSets( cmd,
                                  VK_PIPELINE_BIND_POINT_GRAPHICS,
                                  drawParams.pipelines.GetPipelineLayout(),
                                  0,
-                                 uint32_t( drawParams.descSets.size() ),
+                                 drawParams.descSetCount,
                                  drawParams.descSets.data(),
                                  0,
                                  nullptr );
@@ -456,34 +635,25 @@ void RTGL1::Rasterizer::Draw( VkCommandBuffer         cmd,
         VkViewport curViewport = defaultViewport;
 
 
-        for( const auto& info : drawParams.drawInfos )
+        // per-draw data is in a storage buffer, only the default view-projection is pushed
+        vkCmdPushConstants( cmd,
+                            drawParams.pipelines.GetPipelineLayout(),
+                            VK_SHADER_STAGE_VERTEX_BIT,
+                            0,
+                            16 * sizeof( float ),
+                            drawParams.defaultViewProj.data() );
+
+        for( const auto& batch : drawParams.drawBatches )
         {
-            SetViewportIfNew( cmd, info, defaultViewport, curViewport );
+            SetViewportIfNew( cmd, batch.viewport, defaultViewport, curViewport );
             curPipeline =
-                drawParams.pipelines.BindPipelineIfNew( cmd, curPipeline, info.pipelineState );
+                drawParams.pipelines.BindPipelineIfNew( cmd, curPipeline, batch.pipelineState );
 
-            // push const
-            {
-                RasterizedPushConst push( info, drawParams.defaultViewProj );
-
-                vkCmdPushConstants( cmd,
-                                    drawParams.pipelines.GetPipelineLayout(),
-                                    VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                                    0,
-                                    sizeof( push ),
-                                    &push );
-            }
-
-            // draw
-            if( info.indexCount > 0 )
-            {
-                vkCmdDrawIndexed(
-                    cmd, info.indexCount, 1, info.firstIndex, int32_t( info.firstVertex ), 0 );
-            }
-            else
-            {
-                vkCmdDraw( cmd, info.vertexCount, 1, info.firstVertex, 0 );
-            }
+            vkCmdDrawIndexedIndirect( cmd,
+                                      drawParams.indirectBuffer,
+                                      batch.firstCommand * sizeof( VkDrawIndexedIndirectCommand ),
+                                      batch.commandCount,
+                                      sizeof( VkDrawIndexedIndirectCommand ) );
         }
     }
 
@@ -493,12 +663,11 @@ void RTGL1::Rasterizer::Draw( VkCommandBuffer         cmd,
         vkCmdSetScissor( cmd, 0, 1, &defaultRenderArea );
         vkCmdSetViewport( cmd, 0, 1, &defaultViewport );
 
-        lensFlares->Draw(
-            cmd, frameIndex, *drawParams.flaresParams->textureManager, drawParams.defaultViewProj );
+        lensFlares->Draw( cmd,
+                          frameIndex,
+                          *drawParams.flaresParams->textureManager,
+                          drawParams.defaultViewProj.data() );
     }
-
-
-    vkCmdEndRenderPass( cmd );
 }
 
 const std::shared_ptr< RTGL1::RenderCubemap >& RTGL1::Rasterizer::GetRenderCubemap() const
@@ -512,6 +681,13 @@ void RTGL1::Rasterizer::OnShaderReload( const ShaderManager* shaderManager )
     swapchainPass->OnShaderReload( shaderManager );
     renderCubemap->OnShaderReload( shaderManager );
     lensFlares->OnShaderReload( shaderManager );
+
+    const auto withDepth    = GetExpectedPipelineStates( true );
+    const auto withoutDepth = GetExpectedPipelineStates( false );
+
+    rasterPass->GetRasterPipelines()->Warmup( withDepth );
+    rasterPass->GetSkyRasterPipelines()->Warmup( withDepth );
+    swapchainPass->GetSwapchainPipelines()->Warmup( withoutDepth );
 }
 
 void RTGL1::Rasterizer::OnFramebuffersSizeChange( const ResolutionState& resolutionState )
@@ -530,12 +706,14 @@ void RTGL1::Rasterizer::OnFramebuffersSizeChange( const ResolutionState& resolut
 
 void RTGL1::Rasterizer::CreatePipelineLayouts( VkDescriptorSetLayout* allLayouts,
                                                size_t                 count,
-                                               VkDescriptorSetLayout  texturesSetLayout )
+                                               VkDescriptorSetLayout* swapchainLayouts,
+                                               size_t                 swapchainCount )
 {
+    // default view-projection matrix
     const VkPushConstantRange pushConst = {
-        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
         .offset     = 0,
-        .size       = sizeof( RasterizedPushConst ),
+        .size       = 16 * sizeof( float ),
     };
 
     {
@@ -560,8 +738,8 @@ void RTGL1::Rasterizer::CreatePipelineLayouts( VkDescriptorSetLayout* allLayouts
     {
         VkPipelineLayoutCreateInfo layoutInfo = {
             .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-            .setLayoutCount         = 1,
-            .pSetLayouts            = &texturesSetLayout,
+            .setLayoutCount         = static_cast< uint32_t >( swapchainCount ),
+            .pSetLayouts            = swapchainLayouts,
             .pushConstantRangeCount = 1,
             .pPushConstantRanges    = &pushConst,
         };
@@ -29,6 +29,7 @@
 #include "RasterizerPipelines.h"
 #include "RasterPass.h"
 #include "RenderCubemap.h"
+#include "SecondaryCmdRecorder.h"
 #include "SwapchainPass.h"
 #include "Tonemapping.h"
 #include "Volumetric.h"
@@ -59,7 +60,9 @@ public:
                          std::shared_ptr< MemoryAllocator >      allocator,
                          std::shared_ptr< Framebuffers >         storageFramebuffers,
                          std::shared_ptr< CommandBufferManager > cmdManager,
-                         const RgInstanceCreateInfo&             instanceInfo );
+                         const RgInstanceCreateInfo&             instanceInfo,
+                         bool                                    pipelineFallback,
+                         std::shared_ptr< SecondaryCmdRecorder > secondaryRecorder );
     ~Rasterizer() override;
 
     Rasterizer( const Rasterizer& other )                = delete;
@@ -73,13 +76,34 @@ public:
                  const RgTransform&         transform,
                  const RgMeshPrimitiveInfo& info,
                  const float*               pViewProjection,
-                 const RgViewport*          pViewport );
+                 const RgViewport*          pViewport,
+                 const MaterialTextures*    pBaseTextures = nullptr );
     void UploadLensFlare( uint32_t                     frameIndex,
                           const RgLensFlareUploadInfo& info,
                           float                        emissiveMult,
                           const TextureManager&        textureManager );
     void SubmitForFrame( VkCommandBuffer cmd, uint32_t frameIndex );
 
+    // Sky, world and swapchain passes
+    static constexpr uint32_t SecondaryCmdSlotCount = 3;
+
+    // If secondaryRecorder exists, start recording the draws of the passes on worker threads.
+    // Must be called after SubmitForFrame with the same arguments as for the Draw* functions,
+    // which then only execute the recorded cmds
+    void RecordInParallel( uint32_t                      frameIndex,
+                           bool                          withSky,
+                           const TextureManager&         textureManager,
+                           const GlobalUniform&          uniform,
+                           const Tonemapping&            tonemapping,
+                           const Volumetric&             volumetric,
+                           const float*                  view,
+                           const RgFloat3D&              skyViewerPos,
+                           const float*                  proj,
+                           const RgFloat2D&              jitter,
+                           const RenderResolutionHelper& renderResolution,
+                           uint32_t                      swapchainWidth,
+                           uint32_t                      swapchainHeight );
+
     void DrawSkyToCubemap( VkCommandBuffer       cmd,
                            uint32_t              frameIndex,
                            const TextureManager& textureManager,
@@ -122,11 +146,46 @@ public:
     uint32_t GetLensFlareCullingInputCount() const;
 
 private:
-    void Draw( VkCommandBuffer cmd, uint32_t frameIndex, const RasterDrawParams& drawParams );
+    RasterDrawParams MakeSkyParams( uint32_t                      frameIndex,
+                                    const TextureManager&         textureManager,
+                                    const float*                  view,
+                                    const RgFloat3D&              skyViewerPos,
+                                    const float*                  proj,
+                                    const RgFloat2D&              jitter,
+                                    const RenderResolutionHelper& renderResolution ) const;
+    RasterDrawParams MakeWorldParams( uint32_t                      frameIndex,
+                                      const TextureManager&         textureManager,
+                                      const GlobalUniform&          uniform,
+                                      const Tonemapping&            tonemapping,
+                                      const Volumetric&             volumetric,
+                                      const float*                  view,
+                                      const float*                  proj,
+                                      const RgFloat2D&              jitter,
+                                      const RenderResolutionHelper& renderResolution ) const;
+    RasterDrawParams MakeSwapchainParams( uint32_t              frameIndex,
+                                          VkFramebuffer         framebuffer,
+                                          const TextureManager& textureManager,
+                                          const float*          view,
+                                          const float*          proj,
+                                          uint32_t              swapchainWidth,
+                                          uint32_t              swapchainHeight ) const;
+
+    bool HasDraws( const RasterDrawParams& drawParams ) const;
+    // If recordedDraws is not null, it's executed instead of recording the draws inline
+    void Draw( VkCommandBuffer         cmd,
+               uint32_t                frameIndex,
+               const RasterDrawParams& drawParams,
+               VkCommandBuffer         recordedDraws );
+    // Render pass contents, every state is set, so it can be recorded to a secondary cmd
+    void RecordDraws( VkCommandBuffer         cmd,
+                      uint32_t                frameIndex,
+                      const RasterDrawParams& drawParams );
+    VkCommandBuffer AcquireRecorded( uint32_t slot );
 
     void CreatePipelineLayouts( VkDescriptorSetLayout* allLayouts,
                                 size_t                 count,
-                                VkDescriptorSetLayout  texturesSetLayout );
+                                VkDescriptorSetLayout* swapchainLayouts,
+                                size_t                 swapchainCount );
 
 private:
     VkDevice         device;
@@ -135,6 +194,8 @@ private:
 
     std::shared_ptr< MemoryAllocator >      allocator;
     std::shared_ptr< CommandBufferManager > cmdManager;
+    // null, if draws are recorded inline
+    std::shared_ptr< SecondaryCmdRecorder > secondaryRecorder;
     std::shared_ptr< Framebuffers >         storageFramebuffers;
 
     std::shared_ptr< RasterPass >    rasterPass;
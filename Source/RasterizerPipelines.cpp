@@ -21,6 +21,8 @@
 #include "RasterizerPipelines.h"
 
 #include <array>
+#include <bit>
+#include <climits>
 
 #include "RasterizedDataCollector.h"
 #include "RgException.h"
@@ -42,24 +44,22 @@ RTGL1::RasterizerPipelines::RasterizerPipelines( VkDevice             _device,
     , renderPass( _renderPass )
     , vertShaderStage{}
     , fragShaderStage{}
-    , pipelineCache( VK_NULL_HANDLE )
+    , pipelineCache( _shaderManager.GetPipelineCache() )
+    , fallbackToClosest( false )
     , nonDynamicViewport( _pViewport ? std::optional( *_pViewport ) : std::nullopt )
     , nonDynamicScissors( _pScissors ? std::optional( *_pScissors ) : std::nullopt )
     , applyVertexColorGamma( _applyVertexColorGamma )
     , isWorld( _isWorld )
 {
-    VkPipelineCacheCreateInfo info = { .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
-
-    VkResult r = vkCreatePipelineCache( device, &info, nullptr, &pipelineCache );
-    VK_CHECKERROR( r );
-
     OnShaderReload( &_shaderManager );
 }
 
 RTGL1::RasterizerPipelines::~RasterizerPipelines()
 {
+    WaitForCompilations();
+    compileWorker.reset();
+
     DestroyAllPipelines();
-    vkDestroyPipelineCache( device, pipelineCache, nullptr );
 }
 
 void RTGL1::RasterizerPipelines::DestroyAllPipelines()
@@ -74,25 +74,162 @@ void RTGL1::RasterizerPipelines::DestroyAllPipelines()
 
 void RTGL1::RasterizerPipelines::OnShaderReload( const ShaderManager* shaderManager )
 {
+    // background compilations use the old shader stages
+    WaitForCompilations();
+
+    std::vector< PipelineStateFlags > used;
+    used.reserve( pipelines.size() );
+    for( const auto& p : pipelines )
+    {
+        used.push_back( p.first );
+    }
+
     DestroyAllPipelines();
 
     vertShaderStage = shaderManager->GetStageInfo( shaderNameVert.c_str() );
     fragShaderStage = shaderManager->GetStageInfo( shaderNameFrag.c_str() );
+
+    // permutations that were in use, most likely will be needed again
+    Warmup( used );
 }
 
-VkPipeline RTGL1::RasterizerPipelines::GetPipeline( PipelineStateFlags pipelineState )
+void RTGL1::RasterizerPipelines::Warmup( std::span< const PipelineStateFlags > pipelineStates )
 {
-    auto f = pipelines.find( pipelineState );
+    auto lock = std::lock_guard( pipelinesMutex );
 
-    if( f == pipelines.end() )
+    for( PipelineStateFlags s : pipelineStates )
     {
-        VkPipeline p = CreatePipeline( pipelineState );
+        QueueCompilation( s );
+    }
+}
 
-        pipelines[ pipelineState ] = p;
-        return p;
+void RTGL1::RasterizerPipelines::SetFallbackToClosest( bool enable )
+{
+    fallbackToClosest = enable;
+}
+
+void RTGL1::RasterizerPipelines::QueueCompilation( PipelineStateFlags pipelineState )
+{
+    if( pipelines.contains( pipelineState ) || pendingPipelines.contains( pipelineState ) )
+    {
+        return;
+    }
+
+    if( !compileWorker )
+    {
+        compileWorker = std::make_unique< ThreadPool >( 1 );
+    }
+
+    // errors are not reported from here: if a compilation fails,
+    // the same permutation is created on the render thread, and throws there
+    std::erase_if( compileTasks, []( const std::future< void >& f ) { return IsReady( f ); } );
+
+    pendingPipelines.insert( pipelineState );
+
+    compileTasks.push_back( compileWorker->Push( [ this, pipelineState ]() {
+        VkPipeline p = VK_NULL_HANDLE;
+        try
+        {
+            p = CreatePipeline( pipelineState );
+        }
+        catch( ... )
+        {
+            auto lock = std::lock_guard( pipelinesMutex );
+            pendingPipelines.erase( pipelineState );
+            throw;
+        }
+
+        auto lock = std::lock_guard( pipelinesMutex );
+        pendingPipelines.erase( pipelineState );
+
+        // render thread could have created it meanwhile
+        if( !pipelines.emplace( pipelineState, p ).second )
+        {
+            vkDestroyPipeline( device, p, nullptr );
+        }
+    } ) );
+}
+
+VkPipeline RTGL1::RasterizerPipelines::FindClosestPipeline( PipelineStateFlags pipelineState ) const
+{
+    // other topology can't be substituted
+    constexpr auto mustMatch = PipelineStateFlags( PipelineStateFlagBits::DRAW_AS_LINES );
+    // blending and alpha test mismatch is more noticeable than depth state mismatch
+    constexpr auto visible = PipelineStateFlags( PipelineStateFlagBits::ALPHA_TEST ) |
+                             PipelineStateFlags( PipelineStateFlagBits::TRANSLUCENT ) |
+                             PipelineStateFlags( PipelineStateFlagBits::ADDITIVE );
+
+    VkPipeline closest      = VK_NULL_HANDLE;
+    int        closestScore = INT_MAX;
+
+    for( const auto& [ state, p ] : pipelines )
+    {
+        PipelineStateFlags diff = state ^ pipelineState;
+        if( diff & mustMatch )
+        {
+            continue;
+        }
+
+        int score = std::popcount( diff ) + std::popcount( diff & visible );
+        if( score < closestScore )
+        {
+            closest      = p;
+            closestScore = score;
+        }
+    }
+
+    return closest;
+}
+
+void RTGL1::RasterizerPipelines::WaitForCompilations()
+{
+    std::vector< std::future< void > > toWait;
+    {
+        auto lock = std::lock_guard( pipelinesMutex );
+        toWait.swap( compileTasks );
+    }
+
+    for( auto& f : toWait )
+    {
+        f.wait();
+    }
+}
+
+VkPipeline RTGL1::RasterizerPipelines::GetPipeline( PipelineStateFlags pipelineState )
+{
+    {
+        auto lock = std::lock_guard( pipelinesMutex );
+
+        auto f = pipelines.find( pipelineState );
+        if( f != pipelines.end() )
+        {
+            return f->second;
+        }
+
+        if( fallbackToClosest )
+        {
+            VkPipeline closest = FindClosestPipeline( pipelineState );
+            if( closest != VK_NULL_HANDLE )
+            {
+                QueueCompilation( pipelineState );
+                return closest;
+            }
+        }
+    }
+
+    // nothing to substitute, so block until it's created
+    VkPipeline p = CreatePipeline( pipelineState );
+
+    auto lock = std::lock_guard( pipelinesMutex );
+
+    // background compilation could have finished meanwhile
+    auto [ iter, inserted ] = pipelines.emplace( pipelineState, p );
+    if( !inserted )
+    {
+        vkDestroyPipeline( device, p, nullptr );
     }
 
-    return f->second;
+    return iter->second;
 }
 
 VkPipelineLayout RTGL1::RasterizerPipelines::GetPipelineLayout()
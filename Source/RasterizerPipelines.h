@@ -24,6 +24,9 @@
 #include "Containers.h"
 #include "ShaderManager.h"
 #include "RasterizedDataCollector.h"
+#include "ThreadPool.h"
+
+#include <span>
 
 namespace RTGL1
 {
@@ -56,12 +59,25 @@ public:
                                   VkPipeline         oldPipeline,
                                   PipelineStateFlags pipelineState );
 
+    // Compile the permutations on a background thread,
+    // so their first use doesn't stall the draw recording
+    void Warmup( std::span< const PipelineStateFlags > pipelineStates );
+
+    // If true, a permutation that is not built yet is queued for background compilation,
+    // and the closest already built one is used instead, until the compilation is done
+    void SetFallbackToClosest( bool enable );
+
 
 private:
     [[nodiscard]] VkPipeline CreatePipeline( PipelineStateFlags pipelineState ) const;
     VkPipeline               GetPipeline( PipelineStateFlags pipelineState );
     void                     DestroyAllPipelines();
 
+    // pipelinesMutex must be locked
+    void       QueueCompilation( PipelineStateFlags pipelineState );
+    VkPipeline FindClosestPipeline( PipelineStateFlags pipelineState ) const;
+    void       WaitForCompilations();
+
 private:
     VkDevice device;
 
@@ -74,8 +90,15 @@ private:
     VkPipelineShaderStageCreateInfo fragShaderStage;
 
     rgl::unordered_map< PipelineStateFlags, VkPipeline > pipelines;
+    rgl::unordered_set< PipelineStateFlags >             pendingPipelines;
+    std::mutex                                           pipelinesMutex;
     VkPipelineCache                                      pipelineCache;
 
+    // created on first use, as most permutation sets are never warmed up
+    std::unique_ptr< ThreadPool >      compileWorker;
+    std::vector< std::future< void > > compileTasks;
+    bool                               fallbackToClosest;
+
     std::optional< VkViewport > nonDynamicViewport;
     std::optional< VkRect2D >   nonDynamicScissors;
 
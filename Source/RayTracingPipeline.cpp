@@ -56,7 +56,6 @@ namespace
 RTGL1::RayTracingPipeline::RayTracingPipeline( VkDevice                           _device,
                                                std::shared_ptr< PhysicalDevice >  _physDevice,
                                                std::shared_ptr< MemoryAllocator > _allocator,
-                                               const ShaderManager&               _shaderManager,
                                                Scene&                             _scene,
                                                const GlobalUniform&               _uniform,
                                                const TextureManager&              _textureManager,
@@ -68,12 +67,14 @@ RTGL1::RayTracingPipeline::RayTracingPipeline( VkDevice
                                                const RenderCubemap&               _renderCubemap,
                                                const PortalList&                  _portalList,
                                                const Volumetric&                  _volumetric,
-                                               const RgInstanceCreateInfo&        _rgInfo )
+                                               const RgInstanceCreateInfo&        _rgInfo,
+                                               bool                               _useLightTree )
     : device( _device )
     , physDevice( std::move( _physDevice ) )
+    , allocator( std::move( _allocator ) )
     , rtPipelineLayout( VK_NULL_HANDLE )
-    , rtPipeline( VK_NULL_HANDLE )
-    , copySBTFromStaging( false )
+    , currentFeatures( 0 )
+    , instanceFeatures( _useLightTree ? RT_FEATURE_LIGHT_TREE : 0 )
     , groupBaseAlignment( 0 )
     , handleSize( 0 )
     , alignedHandleSize( 0 )
@@ -81,8 +82,6 @@ RTGL1::RayTracingPipeline::RayTracingPipeline( VkDevice
     , hitGroupCount( 0 )
     , missShaderCount( 0 )
 {
-    shaderBindingTable = std::make_shared< AutoBuffer >( std::move( _allocator ) );
-
     // all set layouts to be used
     VkDescriptorSetLayout setLayouts[] = {
         // ray tracing acceleration structures
@@ -122,12 +121,12 @@ RTGL1::RayTracingPipeline::RayTracingPipeline( VkDevice
     shaderStageInfos = {
         ShaderStageInfo{ "RGenPrimary",         SpecConst{ _rgInfo.primaryRaysMaxAlbedoLayers, _rgInfo.lightmapTexCoordLayerIndex } },
         ShaderStageInfo{ "RGenReflRefr",        SpecConst{ _rgInfo.primaryRaysMaxAlbedoLayers, _rgInfo.lightmapTexCoordLayerIndex } },
-        ShaderStageInfo{ "RGenDirect",          std::nullopt },
+        ShaderStageInfo{ "RGenDirect",          SpecConst{} },
         ShaderStageInfo{ "RGenIndirectInit",    SpecConst{ _rgInfo.indirectIlluminationMaxAlbedoLayers, _rgInfo.lightmapTexCoordLayerIndex } },
         ShaderStageInfo{ "RGenIndirectFinal",   SpecConst{ _rgInfo.indirectIlluminationMaxAlbedoLayers, _rgInfo.lightmapTexCoordLayerIndex } },
-        ShaderStageInfo{ "RGenGradients",       std::nullopt },
-        ShaderStageInfo{ "RInitialReservoirs",  std::nullopt },
-        ShaderStageInfo{ "RVolumetric",         std::nullopt },
+        ShaderStageInfo{ "RGenGradients",       SpecConst{} },
+        ShaderStageInfo{ "RInitialReservoirs",  SpecConst{} },
+        ShaderStageInfo{ "RVolumetric",         SpecConst{} },
         ShaderStageInfo{ "RMiss",               std::nullopt },
         ShaderStageInfo{ "RMissShadow",         std::nullopt },
         ShaderStageInfo{ "RClsOpaque",          std::nullopt },
@@ -171,17 +170,19 @@ RTGL1::RayTracingPipeline::RayTracingPipeline( VkDevice
     // alpha tested and then opaque
     AddHitGroup( toIndex( "RClsOpaque" ), toIndex( "RAlphaTest" ) ); assert( hitGroupCount - 1 == SBT_INDEX_HITGROUP_ALPHA_TESTED );
 
-    CreatePipeline( &_shaderManager );
-    CreateSBT();
+    // per-frame features are assumed to be disabled, until SetFeatures
+    currentFeatures = instanceFeatures;
+    CreateSBT( variants[ currentFeatures ] );
 }
 
 RTGL1::RayTracingPipeline::~RayTracingPipeline()
 {
-    DestroyPipeline();
+    DestroyPipelines();
     vkDestroyPipelineLayout( device, rtPipelineLayout, nullptr );
 }
 
-void RTGL1::RayTracingPipeline::CreatePipeline( const ShaderManager* shaderManager )
+VkPipeline RTGL1::RayTracingPipeline::CreatePipeline( const ShaderManager* shaderManager,
+                                                      uint32_t             features ) const
 {
     std::vector< VkPipelineShaderStageCreateInfo > stages;
     for( const auto& s : shaderStageInfos )
@@ -201,25 +202,38 @@ void RTGL1::RayTracingPipeline::CreatePipeline( const ShaderManager* shaderManag
             .offset     = offsetof( SpecConst, lightmapLayerIndex ),
             .size       = sizeof( SpecConst::lightmapLayerIndex ),
         },
+        {
+            .constantID = 2,
+            .offset     = offsetof( SpecConst, features ),
+            .size       = sizeof( SpecConst::features ),
+        },
     };
-    static_assert( SpecConst::MemberCount == 2 );
-    static_assert( specEntryCommonDef[ 0 ].size + specEntryCommonDef[ 1 ].size ==
+    static_assert( SpecConst::MemberCount == 3 );
+    static_assert( specEntryCommonDef[ 0 ].size + specEntryCommonDef[ 1 ].size +
+                       specEntryCommonDef[ 2 ].size ==
                    sizeof( SpecConst ) );
 
 
+    // fixed size, as specInfos reference the elements
+    std::vector< SpecConst > specConsts( shaderStageInfos.size() );
+
     std::vector< VkSpecializationInfo > specInfos;
-    for( const auto& s : shaderStageInfos )
+    for( size_t i = 0; i < shaderStageInfos.size(); i++ )
     {
+        const auto&          s = shaderStageInfos[ i ];
         VkSpecializationInfo specInfo;
 
         if( s.specConst )
         {
+            specConsts[ i ]          = s.specConst.value();
+            specConsts[ i ].features = features;
+
             specInfo = {
                 .mapEntryCount = std::size( specEntryCommonDef ),
                 .pMapEntries   = specEntryCommonDef,
-                .dataSize      = sizeof( s.specConst.value() ),
+                .dataSize      = sizeof( SpecConst ),
                 // need to be careful with addresses
-                .pData = &( s.specConst.value() ),
+                .pData = &specConsts[ i ],
             };
         }
         else
@@ -256,20 +270,32 @@ void RTGL1::RayTracingPipeline::CreatePipeline( const ShaderManager* shaderManag
         .layout                       = rtPipelineLayout,
     };
 
-    VkResult r = svkCreateRayTracingPipelinesKHR(
-        device, VK_NULL_HANDLE, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &rtPipeline );
+    VkPipeline rtPipeline = VK_NULL_HANDLE;
+
+    VkResult r = svkCreateRayTracingPipelinesKHR( device,
+                                                  VK_NULL_HANDLE,
+                                                  shaderManager->GetPipelineCache(),
+                                                  1,
+                                                  &pipelineInfo,
+                                                  nullptr,
+                                                  &rtPipeline );
 
     VK_CHECKERROR( r );
     SET_DEBUG_NAME( device, rtPipeline, VK_OBJECT_TYPE_PIPELINE, "Ray tracing pipeline" );
+
+    return rtPipeline;
 }
 
-void RTGL1::RayTracingPipeline::DestroyPipeline()
+void RTGL1::RayTracingPipeline::DestroyPipelines()
 {
-    vkDestroyPipeline( device, rtPipeline, nullptr );
-    rtPipeline = VK_NULL_HANDLE;
+    for( auto& [ features, v ] : variants )
+    {
+        vkDestroyPipeline( device, v.pipeline, nullptr );
+        v.pipeline = VK_NULL_HANDLE;
+    }
 }
 
-void RTGL1::RayTracingPipeline::CreateSBT()
+void RTGL1::RayTracingPipeline::CreateSBT( Variant& variant )
 {
     uint32_t groupCount = uint32_t( shaderGroups.size() );
     groupBaseAlignment  = physDevice->GetRTPipelineProperties().shaderGroupBaseAlignment;
@@ -279,18 +305,24 @@ void RTGL1::RayTracingPipeline::CreateSBT()
 
     uint32_t sbtSize = alignedHandleSize * groupCount;
 
-    shaderBindingTable->Create( sbtSize,
+    variant.shaderBindingTable = std::make_shared< AutoBuffer >( allocator );
+    variant.shaderBindingTable->Create( sbtSize,
                                 VK_BUFFER_USAGE_SHADER_BINDING_TABLE_BIT_KHR |
                                     VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
                                 "SBT",
                                 1 );
+}
+
+void RTGL1::RayTracingPipeline::FillSBT( Variant& variant )
+{
+    uint32_t groupCount = uint32_t( shaderGroups.size() );
 
     std::vector< uint8_t > shaderHandles( uint64_t( handleSize * groupCount ) );
     VkResult               r = svkGetRayTracingShaderGroupHandlesKHR(
-        device, rtPipeline, 0, groupCount, shaderHandles.size(), shaderHandles.data() );
+        device, variant.pipeline, 0, groupCount, shaderHandles.size(), shaderHandles.data() );
     VK_CHECKERROR( r );
 
-    auto* mapped = shaderBindingTable->GetMappedAs< uint8_t* >( 0 );
+    auto* mapped = variant.shaderBindingTable->GetMappedAs< uint8_t* >( 0 );
 
     for( uint32_t i = 0; i < groupCount; i++ )
     {
@@ -299,23 +331,56 @@ void RTGL1::RayTracingPipeline::CreateSBT()
                 handleSize );
     }
 
-    copySBTFromStaging = true;
+    variant.copySBTFromStaging = true;
 }
 
-void RTGL1::RayTracingPipeline::DestroySBT()
+void RTGL1::RayTracingPipeline::CreateVariantPipeline( const ShaderManager* shaderManager,
+                                                       uint32_t             features )
 {
-    shaderBindingTable->Destroy();
+    Variant& v = variants.at( features );
+    assert( v.pipeline == VK_NULL_HANDLE && v.shaderBindingTable );
+
+    v.pipeline = CreatePipeline( shaderManager, features );
+    FillSBT( v );
+}
+
+void RTGL1::RayTracingPipeline::SetFeatures( const ShaderManager* shaderManager,
+                                             uint32_t             frameFeatures )
+{
+    const uint32_t features = instanceFeatures | frameFeatures;
+
+    if( features == currentFeatures )
+    {
+        return;
+    }
+
+    auto found = variants.find( features );
+
+    if( found == variants.end() )
+    {
+        CreateSBT( variants[ features ] );
+        CreateVariantPipeline( shaderManager, features );
+    }
+    else if( found->second.pipeline == VK_NULL_HANDLE )
+    {
+        // was destroyed on shader reload
+        CreateVariantPipeline( shaderManager, features );
+    }
+
+    currentFeatures = features;
 }
 
 void RTGL1::RayTracingPipeline::Bind( VkCommandBuffer cmd )
 {
-    if( copySBTFromStaging )
+    Variant& v = variants.at( currentFeatures );
+
+    if( v.copySBTFromStaging )
     {
-        shaderBindingTable->CopyFromStaging( cmd, 0 );
-        copySBTFromStaging = false;
+        v.shaderBindingTable->CopyFromStaging( cmd, 0 );
+        v.copySBTFromStaging = false;
     }
 
-    vkCmdBindPipeline( cmd, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, rtPipeline );
+    vkCmdBindPipeline( cmd, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, v.pipeline );
 }
 
 void RTGL1::RayTracingPipeline::GetEntries( uint32_t                         sbtRayGenIndex,
@@ -333,7 +398,8 @@ void RTGL1::RayTracingPipeline::GetEntries( uint32_t                         sbt
             sbtRayGenIndex == SBT_INDEX_RAYGEN_INITIAL_RESERVOIRS ||
             sbtRayGenIndex == SBT_INDEX_RAYGEN_VOLUMETRIC );
 
-    VkDeviceAddress bufferAddress = shaderBindingTable->GetDeviceAddress();
+    VkDeviceAddress bufferAddress =
+        variants.at( currentFeatures ).shaderBindingTable->GetDeviceAddress();
 
     uint64_t        offset = 0;
 
@@ -373,11 +439,12 @@ VkPipelineLayout RTGL1::RayTracingPipeline::GetLayout() const
 
 void RTGL1::RayTracingPipeline::OnShaderReload( const ShaderManager* shaderManager )
 {
-    DestroySBT();
-    DestroyPipeline();
+    DestroyPipelines();
 
-    CreatePipeline( shaderManager );
-    CreateSBT();
+    // SBT size depends only on the group count, so the buffers are reused;
+    // no allocations here, as it can be called from a worker thread.
+    // Other variants are recreated lazily, in SetFeatures
+    CreateVariantPipeline( shaderManager, currentFeatures );
 }
 
 void RTGL1::RayTracingPipeline::AddGeneralGroup( uint32_t generalIndex )
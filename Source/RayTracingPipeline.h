@@ -40,7 +40,6 @@ public:
     RayTracingPipeline( VkDevice                           device,
                         std::shared_ptr< PhysicalDevice >  physDevice,
                         std::shared_ptr< MemoryAllocator > allocator,
-                        const ShaderManager&               shaderManager,
                         Scene&                             scene,
                         const GlobalUniform&               uniform,
                         const TextureManager&              textureManager,
@@ -52,7 +51,8 @@ public:
                         const RenderCubemap&               renderCubemap,
                         const PortalList&                  portalList,
                         const Volumetric&                  volumetric,
-                        const RgInstanceCreateInfo&        rgInfo );
+                        const RgInstanceCreateInfo&        rgInfo,
+                        bool                               useLightTree );
     ~RayTracingPipeline() override;
 
     RayTracingPipeline( const RayTracingPipeline& other )     = delete;
@@ -60,6 +60,10 @@ public:
     RayTracingPipeline& operator=( const RayTracingPipeline& other ) = delete;
     RayTracingPipeline& operator=( RayTracingPipeline&& other ) noexcept = delete;
 
+    // Select a pipeline variant specialized on RT_FEATURE_* bits.
+    // A variant is created only once per combination, so toggling back doesn't recompile.
+    void                SetFeatures( const ShaderManager* shaderManager, uint32_t frameFeatures );
+
     void                Bind( VkCommandBuffer cmd );
 
     void                GetEntries( uint32_t                         sbtRayGenIndex,
@@ -72,10 +76,18 @@ public:
     void                OnShaderReload( const ShaderManager* shaderManager ) override;
 
 private:
-    void CreatePipeline( const ShaderManager* shaderManager );
-    void DestroyPipeline();
-    void CreateSBT();
-    void DestroySBT();
+    struct Variant
+    {
+        VkPipeline                    pipeline{ VK_NULL_HANDLE };
+        std::shared_ptr< AutoBuffer > shaderBindingTable{};
+        bool                          copySBTFromStaging{ false };
+    };
+
+    VkPipeline CreatePipeline( const ShaderManager* shaderManager, uint32_t features ) const;
+    void       DestroyPipelines();
+    void       CreateSBT( Variant& variant );
+    void       FillSBT( Variant& variant );
+    void       CreateVariantPipeline( const ShaderManager* shaderManager, uint32_t features );
 
     void AddGeneralGroup( uint32_t generalIndex );
 
@@ -91,30 +103,34 @@ private:
     {
         uint32_t maxAlbedoLayers{ 0 };
         uint32_t lightmapLayerIndex{ 0 };
+        // RT_FEATURE_* bits, filled on pipeline creation
+        uint32_t features{ 0 };
 
-        constexpr static int MemberCount = 2;
+        constexpr static int MemberCount = 3;
     };
 
     struct ShaderStageInfo
     {
         std::string_view           name{};
-        // One uint specialization const to use in the shader.
-        // Must exist throughout class lifetime, as CreatePipeline can be called any time.
+        // Specialization consts to use in the shader, features are set per variant
         std::optional< SpecConst > specConst{};
     };
 
 private:
     VkDevice                                            device;
     std::shared_ptr< PhysicalDevice >                   physDevice;
+    std::shared_ptr< MemoryAllocator >                  allocator;
 
     std::vector< ShaderStageInfo >                      shaderStageInfos;
 
     std::vector< VkRayTracingShaderGroupCreateInfoKHR > shaderGroups;
     VkPipelineLayout                                    rtPipelineLayout;
-    VkPipeline                                          rtPipeline;
 
-    std::shared_ptr< AutoBuffer >                       shaderBindingTable;
-    bool                                                copySBTFromStaging;
+    // all variants are kept, as the previous ones can still be in use by the frames in flight
+    rgl::unordered_map< uint32_t, Variant >             variants;
+    uint32_t                                            currentFeatures;
+    // features that are set once, on instance creation
+    uint32_t                                            instanceFeatures;
 
     uint32_t                                            groupBaseAlignment;
     uint32_t                                            handleSize;
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
@@ -44,7 +45,8 @@ public:
     void                    Setup( const RgDrawFrameRenderResolutionParams& params,
                                    uint32_t                                 windowWidth,
                                    uint32_t                                 windowHeight,
-                                   const std::shared_ptr< DLSS >&           dlss )
+                                   const std::shared_ptr< DLSS >&           dlss,
+                                   float                                    dynamicScale = 1.0f )
     {
         renderWidth  = windowWidth;
         renderHeight = windowHeight;
@@ -157,6 +159,20 @@ public:
                 renderHeight = params.customRenderSize.height;
             }
         }
+
+        // framebuffers are allocated for the max size, a dynamic one uses only a part of them
+        maxRenderWidth  = renderWidth;
+        maxRenderHeight = renderHeight;
+
+        if( params.dynamicResolutionTargetMs > 0.0f && renderWidth > 0 && renderHeight > 0 )
+        {
+            dynamicScale = std::clamp( dynamicScale, 0.0f, 1.0f );
+
+            renderWidth = std::clamp(
+                uint32_t( float( maxRenderWidth ) * dynamicScale ), 1u, maxRenderWidth );
+            renderHeight = std::clamp(
+                uint32_t( float( maxRenderHeight ) * dynamicScale ), 1u, maxRenderHeight );
+        }
     }
 
     float GetMipLodBias( float nativeBias = 0.0f ) const
@@ -178,6 +194,10 @@ public:
     uint32_t Width() const { return renderWidth + renderWidth % 2; }
     uint32_t Height() const { return renderHeight; }
 
+    // Size that framebuffers are allocated for, Width() / Height() are not greater
+    uint32_t MaxWidth() const { return maxRenderWidth + maxRenderWidth % 2; }
+    uint32_t MaxHeight() const { return maxRenderHeight; }
+
     uint32_t UpscaledWidth() const { return upscaledWidth; }
     uint32_t UpscaledHeight() const { return upscaledHeight; }
 
@@ -221,10 +241,19 @@ public:
         return ResolutionState{ Width(), Height(), UpscaledWidth(), UpscaledHeight() };
     }
 
+    ResolutionState GetMaxResolutionState() const
+    {
+        assert( MaxWidth() % 2 == 0 );
+        return ResolutionState{ MaxWidth(), MaxHeight(), UpscaledWidth(), UpscaledHeight() };
+    }
+
 private:
     uint32_t                 renderWidth  = 0;
     uint32_t                 renderHeight = 0;
 
+    uint32_t                 maxRenderWidth  = 0;
+    uint32_t                 maxRenderHeight = 0;
+
     uint32_t                 upscaledWidth  = 0;
     uint32_t                 upscaledHeight = 0;
 
@@ -33,10 +33,13 @@ RTGL1::Scene::Scene( VkDevice                                _device,
                      std::shared_ptr< MemoryAllocator >&     _allocator,
                      std::shared_ptr< CommandBufferManager > _cmdManager,
                      const GlobalUniform&                    _uniform,
-                     const ShaderManager&                    _shaderManager,
                      bool                                    _enableTexCoordLayer1,
                      bool                                    _enableTexCoordLayer2,
-                     bool                                    _enableTexCoordLayer3 )
+                     bool                                    _enableTexCoordLayer3,
+                     bool                                    _enableStaticInstancing,
+                     uint32_t                                _dynamicBlasMaxRefitCount,
+                     float                                   _staticSectorShare,
+                     bool                                    _compactStaticVertices )
 {
     VertexCollectorFilterTypeFlags_Init();
 
@@ -49,10 +52,13 @@ RTGL1::Scene::Scene( VkDevice                                _device,
                                                geomInfoMgr,
                                                _enableTexCoordLayer1,
                                                _enableTexCoordLayer2,
-                                               _enableTexCoordLayer3 );
+                                               _enableTexCoordLayer3,
+                                               _enableStaticInstancing,
+                                               _dynamicBlasMaxRefitCount,
+                                               _staticSectorShare,
+                                               _compactStaticVertices );
 
-    vertPreproc =
-        std::make_shared< VertexPreprocessing >( _device, _uniform, *asManager, _shaderManager );
+    vertPreproc = std::make_shared< VertexPreprocessing >( _device, _uniform, *asManager );
 }
 
 void RTGL1::Scene::PrepareForFrame( VkCommandBuffer cmd,
@@ -76,6 +82,9 @@ void RTGL1::Scene::SubmitForFrame( VkCommandBuffer                         cmd,
                                    bool     allowGeometryWithSkyFlag,
                                    bool     disableRTGeometry )
 {
+    // sectors that were submitted since the last frame
+    asManager->BuildStaticSectors( cmd );
+
     // always submit dynamic geometry on the frame ending
     asManager->SubmitDynamicGeometry( makingDynamic, cmd, frameIndex );
 
@@ -84,9 +93,9 @@ void RTGL1::Scene::SubmitForFrame( VkCommandBuffer                         cmd,
     geomInfoMgr->CopyFromStaging( cmd, frameIndex );
 
 
-    // prepare tlas infos, and fill uniform with info about that tlas
-    const auto [ prepare, push ] = asManager->PrepareForBuildingTLAS( frameIndex,
-                                                                      *uniform->GetData(),
+    // prepare tlas infos, and upload geometry info offsets of each tlas instance
+    const auto [ prepare, push ] = asManager->PrepareForBuildingTLAS( cmd,
+                                                                      frameIndex,
                                                                       uniformData_rayCullMaskWorld,
                                                                       allowGeometryWithSkyFlag,
                                                                       disableRTGeometry,
@@ -107,7 +116,8 @@ RTGL1::UploadResult RTGL1::Scene::UploadPrimitive( uint32_t                   fr
                                                    const RgMeshInfo&          mesh,
                                                    const RgMeshPrimitiveInfo& primitive,
                                                    const TextureManager&      textureManager,
-                                                   bool                       isStatic )
+                                                   bool                       isStatic,
+                                                   const MaterialTextures*    pBaseTextures )
 {
     uint64_t uniqueID = UniqueID::MakeForPrimitive( mesh, primitive );
 
@@ -133,8 +143,14 @@ RTGL1::UploadResult RTGL1::Scene::UploadPrimitive( uint32_t                   fr
         return UploadResult::Fail;
     }
 
-    if( !asManager->AddMeshPrimitive(
-            frameIndex, mesh, primitive, uniqueID, isStatic, textureManager, *geomInfoMgr ) )
+    if( !asManager->AddMeshPrimitive( frameIndex,
+                                      mesh,
+                                      primitive,
+                                      uniqueID,
+                                      isStatic,
+                                      textureManager,
+                                      *geomInfoMgr,
+                                      pBaseTextures ) )
     {
         return UploadResult::Fail;
     }
@@ -144,6 +160,38 @@ RTGL1::UploadResult RTGL1::Scene::UploadPrimitive( uint32_t                   fr
                : ( mesh.isExportable ? UploadResult::ExportableDynamic : UploadResult::Dynamic );
 }
 
+bool RTGL1::Scene::AreStaticSectorsEnabled() const
+{
+    return asManager->AreStaticSectorsEnabled();
+}
+
+void RTGL1::Scene::BeginStaticSector( std::string_view sectorName )
+{
+    asManager->BeginStaticSector( sectorName );
+}
+
+bool RTGL1::Scene::UploadStaticSectorPrimitive( const RgMeshInfo&          mesh,
+                                                const RgMeshPrimitiveInfo& primitive,
+                                                const TextureManager&      textureManager,
+                                                const MaterialTextures*    pBaseTextures )
+{
+    // sectors don't share IDs with the static scene, as they are independent of it
+    uint64_t uniqueID = UniqueID::MakeForPrimitive( mesh, primitive );
+
+    return asManager->AddStaticSectorPrimitive(
+        mesh, primitive, uniqueID, textureManager, pBaseTextures );
+}
+
+void RTGL1::Scene::SubmitStaticSector( uint32_t frameIndex )
+{
+    asManager->SubmitStaticSector( frameIndex );
+}
+
+bool RTGL1::Scene::RemoveStaticSector( uint32_t frameIndex, std::string_view sectorName )
+{
+    return asManager->RemoveStaticSector( frameIndex, sectorName );
+}
+
 RTGL1::UploadResult RTGL1::Scene::UploadLight( uint32_t               frameIndex,
                                                const GenericLightPtr& light,
                                                LightManager*          lightManager,
@@ -186,10 +234,22 @@ RTGL1::UploadResult RTGL1::Scene::UploadLight( uint32_t               frameIndex
 void RTGL1::Scene::SubmitStaticLights( uint32_t          frameIndex,
                                        LightManager&     lightManager,
                                        bool              isUnderwater,
-                                       RgColor4DPacked32 underwaterColor ) const
+                                       RgColor4DPacked32 underwaterColor )
 {
+    if( staticLightsChanged )
+    {
+        lightManager.SetStaticLights( staticLights );
+        staticLightsChanged = false;
+    }
+
     for( const GenericLight& l : staticLights )
     {
+        // already in the light manager's static block
+        if( LightManager::IsCacheableStatic( l ) )
+        {
+            continue;
+        }
+
         std::visit(
             [ & ]< typename T >( const T& specific ) {
 
@@ -238,6 +298,8 @@ bool RTGL1::Scene::InsertPrimitiveInfo( uint64_t                   uniqueID,
     }
     else
     {
+        auto lock = std::lock_guard( dynamicUniqueIDsMutex );
+
         if( !staticUniqueIDs.contains( uniqueID ) )
         {
             auto [ iter, isNew ] = dynamicUniqueIDs.emplace( uniqueID );
@@ -286,6 +348,7 @@ bool RTGL1::Scene::InsertLightInfo( bool isStatic, const GenericLightPtr& light
         std::visit(
             [ this ]( auto&& specific ) { return this->staticLights.push_back( *specific ); },
             light );
+        staticLightsChanged = true;
         return true;
     }
     else
@@ -303,6 +366,7 @@ void RTGL1::Scene::NewScene( VkCommandBuffer           cmd,
     staticUniqueIDs.clear();
     staticMeshNames.clear();
     staticLights.clear();
+    staticLightsChanged = true;
 
     textureManager.FreeAllImportedMaterials( frameIndex );
 
@@ -27,6 +27,7 @@
 #include "VertexPreprocessing.h"
 #include "TextureMeta.h"
 
+#include <mutex>
 #include <variant>
 
 namespace RTGL1
@@ -49,10 +50,13 @@ public:
                     std::shared_ptr< MemoryAllocator >&     allocator,
                     std::shared_ptr< CommandBufferManager > cmdManager,
                     const GlobalUniform&                    uniform,
-                    const ShaderManager&                    shaderManager,
                     bool                                    enableTexCoordLayer1,
                     bool                                    enableTexCoordLayer2,
-                    bool                                    enableTexCoordLayer3 );
+                    bool                                    enableTexCoordLayer3,
+                    bool                                    enableStaticInstancing,
+                    uint32_t                                dynamicBlasMaxRefitCount,
+                    float                                   staticSectorShare,
+                    bool                                    compactStaticVertices );
     ~Scene() = default;
 
     Scene( const Scene& other )                = delete;
@@ -68,11 +72,23 @@ public:
                          bool                                    allowGeometryWithSkyFlag,
                          bool                                    disableRTGeometry );
 
+    // If pBaseTextures is not null, it's used instead of the lookup by primitive.pTextureName
     UploadResult UploadPrimitive( uint32_t                   frameIndex,
                                   const RgMeshInfo&          mesh,
                                   const RgMeshPrimitiveInfo& primitive,
                                   const TextureManager&      textureManager,
-                                  bool                       isStatic );
+                                  bool                       isStatic,
+                                  const MaterialTextures*    pBaseTextures = nullptr );
+
+    // Static sectors are kept until removed, and are not affected by NewScene
+    bool AreStaticSectorsEnabled() const;
+    void BeginStaticSector( std::string_view sectorName );
+    bool UploadStaticSectorPrimitive( const RgMeshInfo&          mesh,
+                                      const RgMeshPrimitiveInfo& primitive,
+                                      const TextureManager&      textureManager,
+                                      const MaterialTextures*    pBaseTextures );
+    void SubmitStaticSector( uint32_t frameIndex );
+    bool RemoveStaticSector( uint32_t frameIndex, std::string_view sectorName );
 
     UploadResult UploadLight( uint32_t               frameIndex,
                               const GenericLightPtr& light,
@@ -82,7 +98,7 @@ public:
     void SubmitStaticLights( uint32_t          frameIndex,
                              LightManager&     lightManager,
                              bool              isUnderwater,
-                             RgColor4DPacked32 underwaterColor ) const;
+                             RgColor4DPacked32 underwaterColor );
 
     void NewScene( VkCommandBuffer           cmd,
                    uint32_t                  frameIndex,
@@ -114,9 +130,13 @@ private:
 
     // Dynamic indices are cleared every frame
     rgl::unordered_set< uint64_t >    dynamicUniqueIDs;
+    // dynamic primitives can be uploaded from multiple threads
+    std::mutex                        dynamicUniqueIDsMutex;
     rgl::unordered_set< uint64_t >    staticUniqueIDs;
     rgl::unordered_set< std::string > staticMeshNames;
     std::vector< GenericLight >       staticLights;
+    // if true, static lights must be encoded again by the light manager
+    bool                              staticLightsChanged{ false };
 
     StaticGeometryToken  makingStatic{};
     DynamicGeometryToken makingDynamic{};
@@ -0,0 +1,383 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "SceneCache.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace RTGL1::scenecache
+{
+namespace
+{
+    constexpr char     Magic[ 8 ]       = { 'R', 'G', 'S', 'C', 'E', 'N', 'E', '\0' };
+    constexpr uint64_t SectionAlignment = 16;
+
+    enum SectionIndex
+    {
+        SECTION_STRINGS,
+        SECTION_DEPENDENCIES,
+        SECTION_MESHES,
+        SECTION_PRIMITIVES,
+        SECTION_MATERIALS,
+        SECTION_VERTICES,
+        SECTION_INDICES,
+        SECTION_DIR_LIGHTS,
+        SECTION_SPHERE_LIGHTS,
+        SECTION_SPOT_LIGHTS,
+        SECTION_COUNT
+    };
+
+    struct Section
+    {
+        uint64_t offset;
+        uint64_t count;
+    };
+
+    struct Header
+    {
+        char     magic[ 8 ];
+        uint32_t version;
+        uint32_t _padding0;
+        uint64_t key;
+        Section  sections[ SECTION_COUNT ];
+    };
+
+    // FNV-1a
+    struct Hasher
+    {
+        uint64_t value = 14695981039346656037ull;
+
+        void Add( const void* data, size_t size )
+        {
+            auto bytes = static_cast< const uint8_t* >( data );
+            for( size_t i = 0; i < size; i++ )
+            {
+                value ^= bytes[ i ];
+                value *= 1099511628211ull;
+            }
+        }
+
+        template< typename T >
+            requires( std::is_trivially_copyable_v< T > )
+        void Add( const T& v )
+        {
+            Add( &v, sizeof( T ) );
+        }
+    };
+
+    uint64_t AlignUp( uint64_t v )
+    {
+        return ( v + SectionAlignment - 1 ) / SectionAlignment * SectionAlignment;
+    }
+
+    template< typename T >
+    bool MakeSection( std::span< const T >&        dst,
+                      std::span< const std::byte > bytes,
+                      const Section&               section )
+    {
+        if( section.offset % SectionAlignment != 0 || section.offset > bytes.size() )
+        {
+            return false;
+        }
+
+        if( section.count > ( bytes.size() - section.offset ) / sizeof( T ) )
+        {
+            return false;
+        }
+
+        dst = std::span( reinterpret_cast< const T* >( bytes.data() + section.offset ),
+                         size_t( section.count ) );
+        return true;
+    }
+
+    template< typename T >
+    void CopySection( std::vector< std::byte >& dst, Section& section, const std::vector< T >& src )
+    {
+        static_assert( std::is_trivially_copyable_v< T > );
+
+        section = Section{
+            .offset = AlignUp( dst.size() ),
+            .count  = src.size(),
+        };
+
+        dst.resize( section.offset + src.size() * sizeof( T ) );
+        if( !src.empty() )
+        {
+            memcpy( dst.data() + section.offset, src.data(), src.size() * sizeof( T ) );
+        }
+    }
+}
+}
+
+uint32_t RTGL1::scenecache::Builder::AddString( std::string_view str )
+{
+    // first char is always null
+    if( str.empty() )
+    {
+        return 0;
+    }
+
+    auto offset = uint32_t( strings.size() );
+    strings.insert( strings.end(), str.begin(), str.end() );
+    strings.push_back( '\0' );
+    return offset;
+}
+
+void RTGL1::scenecache::Builder::AddDependency( const std::filesystem::path& path )
+{
+    std::error_code ec;
+    auto            lastWriteTime = std::filesystem::last_write_time( path, ec );
+    auto            fileSize      = std::filesystem::file_size( path, ec );
+
+    if( ec )
+    {
+        return;
+    }
+
+    dependencies.push_back( Dependency{
+        .pathStr       = AddString( path.string() ),
+        .lastWriteTime = int64_t( lastWriteTime.time_since_epoch().count() ),
+        .fileSize      = uint64_t( fileSize ),
+    } );
+}
+
+uint32_t RTGL1::scenecache::Builder::AddMesh( std::string_view   name,
+                                              uint32_t           uniqueObjectID,
+                                              const RgTransform& transform )
+{
+    meshes.push_back( Mesh{
+        .nameStr        = AddString( name ),
+        .uniqueObjectID = uniqueObjectID,
+        .transform      = transform,
+    } );
+    return uint32_t( meshes.size() - 1 );
+}
+
+uint32_t RTGL1::scenecache::Builder::AddMaterial( const Material& material )
+{
+    materials.push_back( material );
+    return uint32_t( materials.size() - 1 );
+}
+
+void RTGL1::scenecache::Builder::AddPrimitive( uint32_t                              meshIndex,
+                                               uint32_t                              primitiveIndexInMesh,
+                                               RgMeshPrimitiveFlags                  flags,
+                                               RgMeshPrimitiveFlags                  extraFlags,
+                                               uint32_t                              materialIndex,
+                                               std::span< const RgPrimitiveVertex > primVertices,
+                                               std::span< const uint32_t >          primIndices )
+{
+    primitives.push_back( Primitive{
+        .meshIndex            = meshIndex,
+        .primitiveIndexInMesh = primitiveIndexInMesh,
+        .flags                = flags,
+        .extraFlags           = extraFlags,
+        .materialIndex        = materialIndex,
+        .vertexCount          = uint32_t( primVertices.size() ),
+        .indexCount           = uint32_t( primIndices.size() ),
+        .firstVertex          = vertices.size(),
+        .firstIndex           = indices.size(),
+    } );
+
+    vertices.insert( vertices.end(), primVertices.begin(), primVertices.end() );
+    indices.insert( indices.end(), primIndices.begin(), primIndices.end() );
+}
+
+void RTGL1::scenecache::Builder::AddLight( const RgDirectionalLightUploadInfo& light )
+{
+    dirLights.push_back( light );
+}
+
+void RTGL1::scenecache::Builder::AddLight( const RgSphericalLightUploadInfo& light )
+{
+    sphereLights.push_back( light );
+}
+
+void RTGL1::scenecache::Builder::AddLight( const RgSpotLightUploadInfo& light )
+{
+    spotLights.push_back( light );
+}
+
+std::vector< std::byte > RTGL1::scenecache::Builder::Finish( uint64_t key ) const
+{
+    Header header = {
+        .version = Version,
+        .key     = key,
+    };
+    memcpy( header.magic, Magic, sizeof( Magic ) );
+
+    auto result = std::vector< std::byte >( sizeof( Header ) );
+
+    CopySection( result, header.sections[ SECTION_STRINGS ], strings );
+    CopySection( result, header.sections[ SECTION_DEPENDENCIES ], dependencies );
+    CopySection( result, header.sections[ SECTION_MESHES ], meshes );
+    CopySection( result, header.sections[ SECTION_PRIMITIVES ], primitives );
+    CopySection( result, header.sections[ SECTION_MATERIALS ], materials );
+    CopySection( result, header.sections[ SECTION_VERTICES ], vertices );
+    CopySection( result, header.sections[ SECTION_INDICES ], indices );
+    CopySection( result, header.sections[ SECTION_DIR_LIGHTS ], dirLights );
+    CopySection( result, header.sections[ SECTION_SPHERE_LIGHTS ], sphereLights );
+    CopySection( result, header.sections[ SECTION_SPOT_LIGHTS ], spotLights );
+
+    memcpy( result.data(), &header, sizeof( Header ) );
+    return result;
+}
+
+auto RTGL1::scenecache::View::Make( std::span< const std::byte > bytes, uint64_t expectedKey )
+    -> std::optional< View >
+{
+    if( bytes.size() < sizeof( Header ) )
+    {
+        return std::nullopt;
+    }
+
+    Header header;
+    memcpy( &header, bytes.data(), sizeof( Header ) );
+
+    if( memcmp( header.magic, Magic, sizeof( Magic ) ) != 0 || header.version != Version ||
+        header.key != expectedKey )
+    {
+        return std::nullopt;
+    }
+
+    View v = {};
+
+    // clang-format off
+    bool ok =
+        MakeSection( v.strings,         bytes, header.sections[ SECTION_STRINGS ] ) &&
+        MakeSection( v.dependencies,    bytes, header.sections[ SECTION_DEPENDENCIES ] ) &&
+        MakeSection( v.meshes,          bytes, header.sections[ SECTION_MESHES ] ) &&
+        MakeSection( v.primitives,      bytes, header.sections[ SECTION_PRIMITIVES ] ) &&
+        MakeSection( v.materials,       bytes, header.sections[ SECTION_MATERIALS ] ) &&
+        MakeSection( v.vertices,        bytes, header.sections[ SECTION_VERTICES ] ) &&
+        MakeSection( v.indices,         bytes, header.sections[ SECTION_INDICES ] ) &&
+        MakeSection( v.dirLights,       bytes, header.sections[ SECTION_DIR_LIGHTS ] ) &&
+        MakeSection( v.sphereLights,    bytes, header.sections[ SECTION_SPHERE_LIGHTS ] ) &&
+        MakeSection( v.spotLights,      bytes, header.sections[ SECTION_SPOT_LIGHTS ] );
+    // clang-format on
+
+    if( !ok || v.strings.empty() || v.strings.back() != '\0' )
+    {
+        return std::nullopt;
+    }
+
+    for( const Primitive& p : v.primitives )
+    {
+        if( p.meshIndex >= v.meshes.size() ||
+            ( p.materialIndex != NoMaterial && p.materialIndex >= v.materials.size() ) ||
+            p.firstVertex + p.vertexCount > v.vertices.size() ||
+            p.firstIndex + p.indexCount > v.indices.size() )
+        {
+            return std::nullopt;
+        }
+    }
+
+    return v;
+}
+
+bool RTGL1::scenecache::View::AreDependenciesUpToDate() const
+{
+    for( const Dependency& d : dependencies )
+    {
+        std::error_code ec;
+        auto            path          = std::filesystem::path( String( d.pathStr ) );
+        auto            lastWriteTime = std::filesystem::last_write_time( path, ec );
+        auto            fileSize      = std::filesystem::file_size( path, ec );
+
+        if( ec || int64_t( lastWriteTime.time_since_epoch().count() ) != d.lastWriteTime ||
+            uint64_t( fileSize ) != d.fileSize )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+const char* RTGL1::scenecache::View::String( uint32_t str ) const
+{
+    return str < strings.size() ? &strings[ str ] : "";
+}
+
+uint64_t RTGL1::scenecache::MakeKey( const std::filesystem::path& gltfPath,
+                                     const RgTransform&           worldTransform,
+                                     float                        oneGameUnitInMeters )
+{
+    std::error_code ec;
+    auto            lastWriteTime = std::filesystem::last_write_time( gltfPath, ec );
+    auto            fileSize      = std::filesystem::file_size( gltfPath, ec );
+
+    if( ec )
+    {
+        return 0;
+    }
+
+    Hasher h;
+    {
+        h.Add( Version );
+        // in case if the structs were changed
+        h.Add( sizeof( Header ) );
+        h.Add( sizeof( Mesh ) );
+        h.Add( sizeof( Primitive ) );
+        h.Add( sizeof( Material ) );
+        h.Add( sizeof( RgPrimitiveVertex ) );
+        h.Add( sizeof( RgDirectionalLightUploadInfo ) );
+        h.Add( sizeof( RgSphericalLightUploadInfo ) );
+        h.Add( sizeof( RgSpotLightUploadInfo ) );
+
+        std::string p = gltfPath.generic_string();
+        h.Add( p.data(), p.size() );
+        h.Add( int64_t( lastWriteTime.time_since_epoch().count() ) );
+        h.Add( uint64_t( fileSize ) );
+        h.Add( worldTransform );
+        h.Add( oneGameUnitInMeters );
+    }
+    return h.value;
+}
+
+std::filesystem::path RTGL1::scenecache::MakeCachePath( const std::filesystem::path& gltfPath )
+{
+    return std::filesystem::path( gltfPath ).replace_extension( ".rgcache" );
+}
+
+bool RTGL1::scenecache::WriteToFile( const std::filesystem::path& path,
+                                     std::span< const std::byte > bytes )
+{
+    auto tempPath = std::filesystem::path( path ).concat( ".tmp" );
+    {
+        auto file = std::ofstream( tempPath, std::ios::binary | std::ios::trunc );
+        if( !file )
+        {
+            return false;
+        }
+
+        file.write( reinterpret_cast< const char* >( bytes.data() ),
+                    std::streamsize( bytes.size() ) );
+        if( !file )
+        {
+            return false;
+        }
+    }
+
+    // rename to not leave partially written file
+    std::error_code ec;
+    std::filesystem::rename( tempPath, path, ec );
+    return !ec;
+}
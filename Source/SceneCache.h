@@ -0,0 +1,152 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Common.h"
+#include "Const.h"
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace RTGL1::scenecache
+{
+
+// Binary representation of an imported GLTF scene, that can be memory-mapped,
+// and directly used for uploading, without any parsing / conversion.
+// All sections are arrays of POD structs, strings are offsets into a char section.
+
+constexpr uint32_t Version = 1;
+
+constexpr uint32_t NoMaterial = UINT32_MAX;
+
+struct Dependency
+{
+    uint32_t pathStr;
+    uint32_t _padding0;
+    int64_t  lastWriteTime;
+    uint64_t fileSize;
+};
+
+struct Mesh
+{
+    uint32_t    nameStr;
+    uint32_t    uniqueObjectID;
+    RgTransform transform;
+};
+
+struct Primitive
+{
+    uint32_t             meshIndex;
+    uint32_t             primitiveIndexInMesh;
+    // flags that are set before and after TextureMetaManager::Modify
+    RgMeshPrimitiveFlags flags;
+    RgMeshPrimitiveFlags extraFlags;
+    uint32_t             materialIndex;
+    uint32_t             vertexCount;
+    uint32_t             indexCount;
+    uint32_t             _padding0;
+    uint64_t             firstVertex;
+    uint64_t             firstIndex;
+};
+
+struct Material
+{
+    uint32_t             nameStr;
+    uint32_t             fullPathStr[ TEXTURES_PER_MATERIAL_COUNT ];
+    RgSamplerFilter      filter[ TEXTURES_PER_MATERIAL_COUNT ];
+    RgSamplerAddressMode addressModeU[ TEXTURES_PER_MATERIAL_COUNT ];
+    RgSamplerAddressMode addressModeV[ TEXTURES_PER_MATERIAL_COUNT ];
+    RgTextureSwizzling   pbrSwizzling;
+    RgColor4DPacked32    color;
+    float                emissiveMult;
+    float                metallicFactor;
+    float                roughnessFactor;
+};
+
+class Builder
+{
+public:
+    uint32_t AddString( std::string_view str );
+    void     AddDependency( const std::filesystem::path& path );
+    uint32_t AddMesh( std::string_view name, uint32_t uniqueObjectID, const RgTransform& transform );
+    uint32_t AddMaterial( const Material& material );
+    void     AddPrimitive( uint32_t                              meshIndex,
+                           uint32_t                              primitiveIndexInMesh,
+                           RgMeshPrimitiveFlags                  flags,
+                           RgMeshPrimitiveFlags                  extraFlags,
+                           uint32_t                              materialIndex,
+                           std::span< const RgPrimitiveVertex > vertices,
+                           std::span< const uint32_t >          indices );
+    void     AddLight( const RgDirectionalLightUploadInfo& light );
+    void     AddLight( const RgSphericalLightUploadInfo& light );
+    void     AddLight( const RgSpotLightUploadInfo& light );
+
+    std::vector< std::byte > Finish( uint64_t key ) const;
+
+private:
+    std::vector< char >                         strings{ '\0' };
+    std::vector< Dependency >                   dependencies;
+    std::vector< Mesh >                         meshes;
+    std::vector< Primitive >                    primitives;
+    std::vector< Material >                     materials;
+    std::vector< RgPrimitiveVertex >            vertices;
+    std::vector< uint32_t >                     indices;
+    std::vector< RgDirectionalLightUploadInfo > dirLights;
+    std::vector< RgSphericalLightUploadInfo >   sphereLights;
+    std::vector< RgSpotLightUploadInfo >        spotLights;
+};
+
+// Non-owning, points to the validated bytes
+class View
+{
+public:
+    static std::optional< View > Make( std::span< const std::byte > bytes, uint64_t expectedKey );
+
+    // If any of the source files were changed after the cache creation
+    bool AreDependenciesUpToDate() const;
+
+    const char* String( uint32_t str ) const;
+
+    std::span< const Dependency >                   dependencies;
+    std::span< const Mesh >                         meshes;
+    std::span< const Primitive >                    primitives;
+    std::span< const Material >                     materials;
+    std::span< const RgPrimitiveVertex >            vertices;
+    std::span< const uint32_t >                     indices;
+    std::span< const RgDirectionalLightUploadInfo > dirLights;
+    std::span< const RgSphericalLightUploadInfo >   sphereLights;
+    std::span< const RgSpotLightUploadInfo >        spotLights;
+    std::span< const char >                         strings;
+};
+
+// Identifies the source file, and the parameters that are baked into the cache
+uint64_t MakeKey( const std::filesystem::path& gltfPath,
+                  const RgTransform&           worldTransform,
+                  float                        oneGameUnitInMeters );
+
+std::filesystem::path MakeCachePath( const std::filesystem::path& gltfPath );
+
+bool WriteToFile( const std::filesystem::path& path, std::span< const std::byte > bytes );
+
+}
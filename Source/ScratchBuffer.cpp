@@ -55,6 +55,7 @@ VkDeviceAddress ScratchBuffer::GetScratchAddress(VkDeviceSize scratchSize)
 
     // couldn't find chunk, create new one
     AddChunk(std::max(SCRATCH_CHUNK_BUFFER_SIZE, alignedSize));
+    chunks.back().currentOffset = alignedSize;
     return chunks.back().buffer.GetAddress();
 }
 
@@ -0,0 +1,148 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "SecondaryCmdRecorder.h"
+
+#include <utility>
+
+RTGL1::SecondaryCmdRecorder::SecondaryCmdRecorder( VkDevice _device,
+                                                   uint32_t queueFamilyIndex,
+                                                   uint32_t slotCount )
+    : device( _device ), slots( slotCount ), workers( slotCount )
+{
+    for( Slot& slot : slots )
+    {
+        for( uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++ )
+        {
+            VkCommandPoolCreateInfo poolInfo = {
+                .sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+                .flags            = 0,
+                .queueFamilyIndex = queueFamilyIndex,
+            };
+
+            VkResult r = vkCreateCommandPool( device, &poolInfo, nullptr, &slot.pools[ i ] );
+            VK_CHECKERROR( r );
+
+            VkCommandBufferAllocateInfo allocInfo = {
+                .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                .commandPool        = slot.pools[ i ],
+                .level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+                .commandBufferCount = 1,
+            };
+
+            r = vkAllocateCommandBuffers( device, &allocInfo, &slot.cmds[ i ] );
+            VK_CHECKERROR( r );
+        }
+    }
+}
+
+RTGL1::SecondaryCmdRecorder::~SecondaryCmdRecorder()
+{
+    WaitPending();
+
+    for( Slot& slot : slots )
+    {
+        for( VkCommandPool p : slot.pools )
+        {
+            vkDestroyCommandPool( device, p, nullptr );
+        }
+    }
+}
+
+void RTGL1::SecondaryCmdRecorder::PrepareForFrame( uint32_t frameIndex )
+{
+    WaitPending();
+
+    // fence of the frame slot was waited, so its cmds are not in use
+    for( Slot& slot : slots )
+    {
+        vkResetCommandPool( device, slot.pools[ frameIndex ], 0 );
+    }
+}
+
+void RTGL1::SecondaryCmdRecorder::Record( uint32_t                                 slotIndex,
+                                          uint32_t                                 frameIndex,
+                                          VkRenderPass                             renderPass,
+                                          VkFramebuffer                            framebuffer,
+                                          std::function< void( VkCommandBuffer ) > func )
+{
+    assert( slotIndex < slots.size() );
+    assert( frameIndex < MAX_FRAMES_IN_FLIGHT );
+
+    Slot& slot = slots[ slotIndex ];
+    assert( !slot.pending.valid() );
+
+    VkCommandBuffer cmd = slot.cmds[ frameIndex ];
+
+    slot.pendingCmd = cmd;
+    slot.pending    = workers.Push( [ cmd, renderPass, framebuffer, f = std::move( func ) ]() {
+        VkCommandBufferInheritanceInfo inheritanceInfo = {
+            .sType       = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+            .renderPass  = renderPass,
+            .subpass     = 0,
+            .framebuffer = framebuffer,
+        };
+
+        VkCommandBufferBeginInfo beginInfo = {
+            .sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+                     VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+            .pInheritanceInfo = &inheritanceInfo,
+        };
+
+        VkResult r = vkBeginCommandBuffer( cmd, &beginInfo );
+        VK_CHECKERROR( r );
+
+        f( cmd );
+
+        r = vkEndCommandBuffer( cmd );
+        VK_CHECKERROR( r );
+    } );
+}
+
+VkCommandBuffer RTGL1::SecondaryCmdRecorder::Acquire( uint32_t slotIndex )
+{
+    assert( slotIndex < slots.size() );
+    Slot& slot = slots[ slotIndex ];
+
+    if( !slot.pending.valid() )
+    {
+        return VK_NULL_HANDLE;
+    }
+
+    VkCommandBuffer cmd = std::exchange( slot.pendingCmd, VK_NULL_HANDLE );
+
+    // rethrows, if recording has failed
+    slot.pending.get();
+    return cmd;
+}
+
+void RTGL1::SecondaryCmdRecorder::WaitPending()
+{
+    for( Slot& slot : slots )
+    {
+        if( slot.pending.valid() )
+        {
+            slot.pending.wait();
+            slot.pending    = {};
+            slot.pendingCmd = VK_NULL_HANDLE;
+        }
+    }
+}
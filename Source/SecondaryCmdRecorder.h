@@ -0,0 +1,77 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Common.h"
+#include "ThreadPool.h"
+
+#include <vector>
+
+namespace RTGL1
+{
+
+// Records render pass contents into secondary command buffers on worker threads,
+// so the main thread can record other work meanwhile. Each slot has its own
+// command pool per frame, as a pool can't be used by several threads at once.
+class SecondaryCmdRecorder
+{
+public:
+    SecondaryCmdRecorder( VkDevice device, uint32_t queueFamilyIndex, uint32_t slotCount );
+    ~SecondaryCmdRecorder();
+
+    SecondaryCmdRecorder( const SecondaryCmdRecorder& other )                = delete;
+    SecondaryCmdRecorder( SecondaryCmdRecorder&& other ) noexcept            = delete;
+    SecondaryCmdRecorder& operator=( const SecondaryCmdRecorder& other )     = delete;
+    SecondaryCmdRecorder& operator=( SecondaryCmdRecorder&& other ) noexcept = delete;
+
+    // Drops the recordings that were not acquired, and resets the pools of the frame slot
+    void PrepareForFrame( uint32_t frameIndex );
+
+    // Start recording func on a worker thread. The contents are for the first subpass
+    // of renderPass; framebuffer can be null, if it's not known yet
+    void Record( uint32_t                                 slot,
+                 uint32_t                                 frameIndex,
+                 VkRenderPass                             renderPass,
+                 VkFramebuffer                            framebuffer,
+                 std::function< void( VkCommandBuffer ) > func );
+
+    // Wait until the slot is recorded and return its cmd, the slot becomes empty.
+    // Null, if nothing was recorded to the slot
+    VkCommandBuffer Acquire( uint32_t slot );
+
+private:
+    void WaitPending();
+
+private:
+    struct Slot
+    {
+        VkCommandPool       pools[ MAX_FRAMES_IN_FLIGHT ] = {};
+        VkCommandBuffer     cmds[ MAX_FRAMES_IN_FLIGHT ]  = {};
+        std::future< void > pending{};
+        VkCommandBuffer     pendingCmd{ VK_NULL_HANDLE };
+    };
+
+    VkDevice            device;
+    std::vector< Slot > slots;
+    ThreadPool          workers;
+};
+
+}
@@ -20,11 +20,16 @@
 
 #include "ShaderManager.h"
 
+#include <exception>
 #include <fstream>
 #include <vector>
 #include <cstring>
 #include "RgException.h"
 
+#ifdef RG_USE_EMBEDDED_SHADERS
+#include "EmbeddedShaders.h"
+#endif
+
 using namespace RTGL1;
 
 struct ShaderModuleDefinition
@@ -98,10 +103,15 @@ static ShaderModuleDefinition G_SHADERS[] =
 
 // clang-format on
 
-ShaderManager::ShaderManager( VkDevice _device, std::filesystem::path _shaderFolderPath )
-    : device( _device ), shaderFolderPath( std::move( _shaderFolderPath ) )
+ShaderManager::ShaderManager( VkDevice                         _device,
+                              std::filesystem::path            _shaderFolderPath,
+                              std::shared_ptr< PipelineCache > _pipelineCache )
+    : device( _device )
+    , shaderFolderPath( std::move( _shaderFolderPath ) )
+    , pipelineCache( std::move( _pipelineCache ) )
+    , pipelineWorkers( 0 )
 {
-    LoadShaderModules();
+    LoadShaderModules( true );
 }
 
 ShaderManager::~ShaderManager()
@@ -114,14 +124,23 @@ void ShaderManager::ReloadShaders()
     vkDeviceWaitIdle( device );
 
     UnloadShaderModules();
-    LoadShaderModules();
+    // hot-reload always reads the files, to pick up the rebuilt shaders
+    LoadShaderModules( false );
 
     NotifySubscribersAboutReload();
 
     vkDeviceWaitIdle( device );
+
+    // pipelines were recreated, so keep the new ones
+    pipelineCache->Save();
 }
 
-void ShaderManager::LoadShaderModules()
+void ShaderManager::CreateSubscriberPipelines()
+{
+    NotifySubscribersAboutReload();
+}
+
+void ShaderManager::LoadShaderModules( bool allowEmbedded )
 {
     for( auto& s : G_SHADERS )
     {
@@ -134,9 +153,19 @@ void ShaderManager::LoadShaderModules()
             s.stage = GetStageByExtension( s.filename );
         }
 
-        auto path = shaderFolderPath / s.filename;
+        VkShaderModule m = VK_NULL_HANDLE;
+
+        if( allowEmbedded )
+        {
+            m = LoadModuleFromEmbedded( s.filename );
+        }
 
-        VkShaderModule m = LoadModuleFromFile( path.c_str() );
+        if( m == VK_NULL_HANDLE )
+        {
+            auto path = shaderFolderPath / s.filename;
+
+            m = LoadModuleFromFile( path.c_str() );
+        }
         SET_DEBUG_NAME( device, m, VK_OBJECT_TYPE_SHADER_MODULE, s.name.data() );
 
         modules[ s.name ] = { m, s.stage };
@@ -185,6 +214,11 @@ VkPipelineShaderStageCreateInfo ShaderManager::GetStageInfo( std::string_view na
     };
 }
 
+VkPipelineCache ShaderManager::GetPipelineCache() const
+{
+    return pipelineCache->Get();
+}
+
 VkShaderModule ShaderManager::LoadModuleFromFile( const std::filesystem::path& path )
 {
     std::ifstream          shaderFile( path, std::ios::binary );
@@ -200,6 +234,22 @@ VkShaderModule ShaderManager::LoadModuleFromFile( const std::filesystem::path& p
                                  uint32_t( shaderSource.size() ) );
 }
 
+VkShaderModule ShaderManager::LoadModuleFromEmbedded( std::string_view filename )
+{
+#ifdef RG_USE_EMBEDDED_SHADERS
+    for( const EmbeddedShader& e : GetEmbeddedShaders() )
+    {
+        if( e.filename == filename )
+        {
+            return LoadModuleFromMemory( e.code, e.codeSize );
+        }
+    }
+#endif
+
+    // not embedded, fallback to the file
+    return VK_NULL_HANDLE;
+}
+
 VkShaderModule ShaderManager::LoadModuleFromMemory( const uint32_t* pCode, uint32_t codeSize )
 {
     VkShaderModule shaderModule;
@@ -255,11 +305,35 @@ void ShaderManager::Subscribe( std::shared_ptr< IShaderDependency > subscriber )
 
 void ShaderManager::NotifySubscribersAboutReload()
 {
+    std::vector< std::future< void > > tasks;
+
     for( auto& ws : subscribers )
     {
         if( auto s = ws.lock() )
         {
-            s->OnShaderReload( this );
+            tasks.push_back( pipelineWorkers.Push( [ this, s ]() { s->OnShaderReload( this ); } ) );
         }
     }
+
+    // wait for all, even if some have failed, as they reference this
+    std::exception_ptr firstError;
+    for( auto& t : tasks )
+    {
+        try
+        {
+            t.get();
+        }
+        catch( ... )
+        {
+            if( !firstError )
+            {
+                firstError = std::current_exception();
+            }
+        }
+    }
+
+    if( firstError )
+    {
+        std::rethrow_exception( firstError );
+    }
 }
@@ -23,6 +23,8 @@
 #include "Common.h"
 #include "Containers.h"
 #include "IShaderDependency.h"
+#include "PipelineCache.h"
+#include "ThreadPool.h"
 #include "UserFunction.h"
 
 #include <filesystem>
@@ -36,7 +38,9 @@ namespace RTGL1
 class ShaderManager
 {
 public:
-    explicit ShaderManager( VkDevice device, std::filesystem::path shaderFolderPath );
+    explicit ShaderManager( VkDevice                         device,
+                            std::filesystem::path            shaderFolderPath,
+                            std::shared_ptr< PipelineCache > pipelineCache );
     ~ShaderManager();
 
     ShaderManager( const ShaderManager& other )                = delete;
@@ -46,10 +50,16 @@ public:
 
     void ReloadShaders();
 
+    // Create pipelines of all subscribers, must be called once after all subscriptions
+    void CreateSubscriberPipelines();
+
     VkShaderModule                  GetShaderModule( std::string_view name ) const;
     VkShaderStageFlagBits           GetModuleStage( std::string_view name ) const;
     VkPipelineShaderStageCreateInfo GetStageInfo( std::string_view name ) const;
 
+    // Shared cache that must be used for all pipeline creations
+    VkPipelineCache                 GetPipelineCache() const;
+
     // Subscribe to shader reload event.
     // shared_ptr will be transformed to weak_ptr
     void Subscribe( std::shared_ptr< IShaderDependency > subscriber );
@@ -65,8 +75,10 @@ private:
     static VkShaderStageFlagBits GetStageByExtension( std::string_view name );
 
     VkShaderModule LoadModuleFromFile( const std::filesystem::path& path );
+    VkShaderModule LoadModuleFromEmbedded( std::string_view filename );
     VkShaderModule LoadModuleFromMemory( const uint32_t* pCode, uint32_t codeSize );
-    void           LoadShaderModules();
+    // if allowEmbedded, SPIR-V compiled into the library is preferred over the files
+    void           LoadShaderModules( bool allowEmbedded );
     void           UnloadShaderModules();
 
     void NotifySubscribersAboutReload();
@@ -75,6 +87,10 @@ private:
     VkDevice              device;
     std::filesystem::path shaderFolderPath;
 
+    std::shared_ptr< PipelineCache > pipelineCache;
+    // subscribers create their pipelines in parallel
+    ThreadPool                       pipelineWorkers;
+
     rgl::unordered_map< std::filesystem::path, ShaderModule > modules;
 
     std::list< std::weak_ptr< IShaderDependency > > subscribers;
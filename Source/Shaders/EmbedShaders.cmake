@@ -0,0 +1,76 @@
+# Copyright (c) 2023 Sultim Tsyrendashiev
+# 
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+# 
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+# 
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+# Writes a C++ source file with SPIR-V binaries as arrays, see EmbeddedShaders.h
+#   SPV_FILES : comma-separated list of .spv files
+#   OUTPUT    : path to the C++ source file
+
+if (NOT SPV_FILES OR NOT OUTPUT)
+    message(FATAL_ERROR "SPV_FILES and OUTPUT must be specified")
+endif()
+
+string(REPLACE "," ";" SpvFiles "${SPV_FILES}")
+
+set(Arrays "")
+set(Entries "")
+set(Index 0)
+
+foreach(SpvFile ${SpvFiles})
+    get_filename_component(SpvName ${SpvFile} NAME)
+
+    file(READ ${SpvFile} SpvHex HEX)
+    string(LENGTH "${SpvHex}" SpvHexLength)
+    math(EXPR SpvSize "${SpvHexLength} / 2")
+
+    math(EXPR SpvSizeRemainder "${SpvSize} % 4")
+    if (SpvSize EQUAL 0 OR NOT SpvSizeRemainder EQUAL 0)
+        message(FATAL_ERROR "Invalid SPIR-V file: ${SpvFile}")
+    endif()
+
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," SpvBytes "${SpvHex}")
+    string(REGEX REPLACE "(0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,)"
+        "\\1\n    " SpvBytes "${SpvBytes}")
+
+    string(APPEND Arrays
+        "alignas( uint32_t ) const uint8_t g_Spv${Index}[] = {\n    ${SpvBytes}\n};\n\n")
+    string(APPEND Entries
+        "    { \"${SpvName}\", reinterpret_cast< const uint32_t* >( g_Spv${Index} ), ${SpvSize} },\n")
+
+    math(EXPR Index "${Index} + 1")
+endforeach()
+
+set(Content "// Generated by EmbedShaders.cmake, don't modify\n\n")
+string(APPEND Content "#include \"EmbeddedShaders.h\"\n\n")
+string(APPEND Content "#include <cstdint>\n\n")
+string(APPEND Content "namespace\n{\n\n${Arrays}")
+string(APPEND Content "const RTGL1::EmbeddedShader g_EmbeddedShaders[] = {\n${Entries}};\n\n}\n\n")
+string(APPEND Content "std::span< const RTGL1::EmbeddedShader > RTGL1::GetEmbeddedShaders()\n{\n")
+string(APPEND Content "    return g_EmbeddedShaders;\n}\n")
+
+# don't touch the file if nothing changed, to not recompile it
+if (EXISTS ${OUTPUT})
+    file(READ ${OUTPUT} OldContent)
+    if (OldContent STREQUAL Content)
+        return()
+    endif()
+endif()
+
+file(WRITE ${OUTPUT} "${Content}")
@@ -0,0 +1,134 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LIGHT_TREE_H_
+#define LIGHT_TREE_H_
+
+#include "Random.h"
+
+#ifndef RT_FEATURES
+    #define RT_FEATURES 0xFFFFFFFF
+#endif
+
+
+// Conservative estimate of the light coming from a node to a sphere at 'position'
+float getLightTreeNodeImportance(const ShLightTreeNode node, const vec3 position, float radius)
+{
+    const vec3 center = (node.aabbMin + node.aabbMax) * 0.5;
+    const float halfDiagonalSq = lengthSquared(node.aabbMax - node.aabbMin) * 0.25;
+
+    const vec3 toPosition = position - center;
+    const float distSq = lengthSquared(toPosition);
+
+    // inside the bounds, any direction is possible
+    if (distSq <= halfDiagonalSq + radius * radius)
+    {
+        return node.power / max(halfDiagonalSq + radius * radius, 0.0001);
+    }
+
+    const float dist = sqrt(distSq);
+    const float cosTheta = dot(node.coneAxis, toPosition / dist);
+
+    // Conty Estevez, A., Kulla, C. Importance Sampling of Many Lights with Adaptive Tree Splitting
+    const float theta = acos(clamp(cosTheta, -1.0, 1.0));
+    const float thetaCone = acos(clamp(node.coneCosAngle, -1.0, 1.0));
+    const float thetaBounds = asin(clamp((sqrt(halfDiagonalSq) + radius) / dist, 0.0, 1.0));
+
+    const float thetaPrime = max(theta - thetaCone - thetaBounds, 0.0);
+    if (thetaPrime >= M_PI * 0.5)
+    {
+        return 0.0;
+    }
+
+    return node.power * cos(thetaPrime) / distSq;
+}
+
+// Returns light index, or LIGHT_INDEX_NONE if no light contributes to the sphere.
+// Only regular lights are in the tree.
+uint sampleLightTree(const vec3 position, float radius, uint rndBits, out float oneOverSourcePdf)
+{
+    oneOverSourcePdf = 0.0;
+
+    if (globalUniform.lightTreeNodeCount == 0)
+    {
+        return LIGHT_INDEX_NONE;
+    }
+
+    // 24 bits to keep the precision while rescaling on each level
+    float rnd = float(rndBits >> 8) / float(1 << 24);
+    float pdf = 1.0;
+    uint nodeIndex = 0;
+
+    for (int depth = 0; depth < LIGHT_TREE_MAX_DEPTH; depth++)
+    {
+        const uint rightChildOrLight = lightTreeNodes[nodeIndex].rightChildOrLight;
+
+        if ((rightChildOrLight & LIGHT_TREE_NODE_LEAF_BIT) != 0)
+        {
+            oneOverSourcePdf = 1.0 / pdf;
+            return rightChildOrLight & ~LIGHT_TREE_NODE_LEAF_BIT;
+        }
+
+        // left child is right after its parent
+        const uint left = nodeIndex + 1;
+        const uint right = rightChildOrLight;
+
+        const float wLeft = getLightTreeNodeImportance(lightTreeNodes[left], position, radius);
+        const float wRight = getLightTreeNodeImportance(lightTreeNodes[right], position, radius);
+
+        if (wLeft + wRight <= 0.0)
+        {
+            return LIGHT_INDEX_NONE;
+        }
+
+        const float pLeft = wLeft / (wLeft + wRight);
+
+        if (rnd < pLeft)
+        {
+            nodeIndex = left;
+            pdf *= pLeft;
+            rnd = rnd / pLeft;
+        }
+        else
+        {
+            nodeIndex = right;
+            pdf *= 1.0 - pLeft;
+            rnd = (rnd - pLeft) / (1.0 - pLeft);
+        }
+        rnd = min(rnd, 0.99999994);
+    }
+
+    return LIGHT_INDEX_NONE;
+}
+
+// Light tree, if it exists; otherwise, uniform distribution as a coarse source pdf
+uint sampleRegularLight(const vec3 position, float radius, uint seed, uint salt, out float oneOverSourcePdf)
+{
+    if ((RT_FEATURES & RT_FEATURE_LIGHT_TREE) != 0 && globalUniform.lightTreeNodeCount > 0)
+    {
+        return sampleLightTree(position, radius, wellonsLowBias32(seed + salt), oneOverSourcePdf);
+    }
+
+    float rnd = rnd16(seed, salt);
+    oneOverSourcePdf = globalUniform.lightCount;
+    return LIGHT_ARRAY_REGULAR_LIGHTS_OFFSET + clamp(uint(rnd * globalUniform.lightCount), 0, globalUniform.lightCount - 1);
+}
+
+#endif // LIGHT_TREE_H_
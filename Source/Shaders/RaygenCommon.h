@@ -24,6 +24,10 @@
 #extension GL_EXT_ray_tracing : require
 #extension GL_EXT_control_flow_attributes : require
 
+// RT_FEATURE_* bits, the pipeline is specialized on them to strip unused features
+layout (constant_id = 2) const uint rtFeatures = 0xFFFFFFFF;
+#define RT_FEATURES rtFeatures
+
 
 
 #include "ShaderCommonGLSLFunc.h"
@@ -54,6 +58,7 @@
 #include "Surface.inl"
 #include "Light.h"
 #include "LightGrid.h"
+#include "LightTree.h"
 #include "Media.h"
 #include "RayCone.h"
 
@@ -430,13 +435,15 @@ Reservoir calcInitialReservoir(uint seed, uint salt, const Surface surf, const v
     {      
         for (int i = 0; i < INITIAL_SAMPLES; i++)
         {
-            // uniform distribution as a coarse source pdf
-            float rnd = rnd16(seed, salt++);
-            uint xi = LIGHT_ARRAY_REGULAR_LIGHTS_OFFSET + clamp(uint(rnd * globalUniform.lightCount), 0, globalUniform.lightCount - 1);
-            float oneOverSourcePdf_xi = globalUniform.lightCount;
+            float oneOverSourcePdf_xi;
+            uint xi = sampleRegularLight(surf.position, 0.0, seed, salt++, oneOverSourcePdf_xi);
 
-            LightSample lightSample = sampleLight(lightSources[xi], surf.position, pointRnd);
-            float targetPdf_xi = targetPdfForLightSample(lightSample, surf);
+            float targetPdf_xi = 0.0;
+            if (xi != LIGHT_INDEX_NONE)
+            {
+                LightSample lightSample = sampleLight(lightSources[xi], surf.position, pointRnd);
+                targetPdf_xi = targetPdfForLightSample(lightSample, surf);
+            }
 
             float rndRis = rnd16(seed, salt++);
             updateReservoir(regularReservoir, xi, targetPdf_xi, oneOverSourcePdf_xi, rndRis);
@@ -425,8 +425,9 @@ void main()
         uint newRayMedia =
             getNewRayMedia( i, currentRayMedia, h.geometryInstanceFlags, h.roughness );
 
-        bool isPortal =
-            isPortalFromFlags( h.geometryInstanceFlags ) && h.portalIndex != PORTAL_INDEX_NONE;
+        bool isPortal = ( RT_FEATURES & RT_FEATURE_PORTALS ) != 0 &&
+                        isPortalFromFlags( h.geometryInstanceFlags ) &&
+                        h.portalIndex != PORTAL_INDEX_NONE;
         bool toRefract = isRefractFromFlags( h.geometryInstanceFlags, h.roughness );
         bool toReflect = isReflectFromFlags( h.geometryInstanceFlags, h.roughness );
 
@@ -140,6 +140,13 @@ bool rgi_TryGetPixOffset(const ivec2 pix, out uint offset)
     return offset >= 0 && offset < uint(globalUniform.renderWidth) * uint(globalUniform.renderHeight);
 }
 
+// previous frame could be rendered in another size, if dynamic resolution is enabled
+bool rgi_TryGetPixOffset_Prev(const ivec2 pix, out uint offset)
+{
+    offset = pix.y * uint(globalUniform.prevRenderWidth) + pix.x;
+    return offset >= 0 && offset < uint(globalUniform.prevRenderWidth) * uint(globalUniform.prevRenderHeight);
+}
+
 void restirIndirect_StoreInitialSample(const ivec2 pix, const SampleIndirect s, float oneOverSourcePdf)
 {
     uint offset;
@@ -247,7 +254,7 @@ ReservoirIndirect restirIndirect_LoadReservoir_Prev(const ivec2 pix)
     ReservoirIndirect r;
 
     uint offset;
-    if (!rgi_TryGetPixOffset(pix, offset))
+    if (!rgi_TryGetPixOffset_Prev(pix, offset))
     {
         r = emptyReservoirIndirect();
         return r;
@@ -26,16 +26,30 @@ layout (location = 2) in vec2 texCoord;
 
 layout (location = 0) out vec4 outColor;
 layout (location = 1) out vec2 outTexCoord;
+layout (location = 2) flat out uint outTextureIndex;
+layout (location = 3) flat out uint outEmissiveTextureIndex;
+layout (location = 4) flat out float outEmissiveMult;
+
+#define DESC_SET_RASTERIZED_DRAWS 1
+#include "ShaderCommonGLSLFunc.h"
+
+// per-draw data, indexed by firstInstance of the indirect draw command
+layout (set = DESC_SET_RASTERIZED_DRAWS, binding = BINDING_RASTERIZED_DRAWS) readonly buffer RasterizedDraws_BT
+{
+    ShRasterizedDraw rasterizedDraws[];
+};
 
 layout(push_constant) uniform RasterizerVert_BT 
 {
-    layout(offset = 0) mat4 viewProj;
+    layout(offset = 0) mat4 defaultViewProj;
 } rasterizerVertInfo;
 
 layout (constant_id = 0) const uint applyVertexColorGamma = 0;
 
 void main()
 {
+    const ShRasterizedDraw draw = rasterizedDraws[gl_InstanceIndex];
+
     if (applyVertexColorGamma != 0)
     {
         outColor = vec4(pow(color.rgb, vec3(2.2)), color.a);
@@ -44,7 +58,13 @@ void main()
     {
         outColor = color;
     }
+    outColor *= unpackUintColor(draw.packedColor);
+
+    outTexCoord             = texCoord;
+    outTextureIndex         = draw.textureIndex;
+    outEmissiveTextureIndex = draw.emissiveTextureIndex;
+    outEmissiveMult         = draw.emissiveMult;
 
-    outTexCoord = texCoord;
-    gl_Position = rasterizerVertInfo.viewProj * vec4(position, 1.0);
+    const mat4 viewProj = draw.useViewProj != 0 ? draw.viewProj : rasterizerVertInfo.defaultViewProj;
+    gl_Position = viewProj * draw.model * vec4(position, 1.0);
 }
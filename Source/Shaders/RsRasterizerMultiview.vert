@@ -31,10 +31,15 @@ layout (location = 2) in vec2 texCoord;
 
 layout (location = 0) out vec4 outColor;
 layout (location = 1) out vec2 outTexCoord;
+layout (location = 2) flat out uint outTextureIndex;
+layout (location = 3) flat out uint outEmissiveTextureIndex;
+layout (location = 4) flat out float outEmissiveMult;
 
 layout(push_constant) uniform RasterizerVert_BT 
 {
-    layout(offset = 0) mat4 model;
+    layout(offset = 0)  mat4 model;
+    layout(offset = 64) uint packedColor;
+    layout(offset = 68) uint textureIndex;
 } rasterizerVertInfo;
 
 layout (constant_id = 0) const uint applyVertexColorGamma = 0;
@@ -49,8 +54,12 @@ void main()
     {
         outColor = color;
     }
+    outColor *= unpackUintColor(rasterizerVertInfo.packedColor);
 
-    outTexCoord = texCoord;
+    outTexCoord             = texCoord;
+    outTextureIndex         = rasterizerVertInfo.textureIndex;
+    outEmissiveTextureIndex = MATERIAL_NO_TEXTURE;
+    outEmissiveMult         = 0.0;
 
     const mat4 viewProj = globalUniform.viewProjCubemap[gl_ViewIndex];
     gl_Position = viewProj * rasterizerVertInfo.model * vec4(position, 1.0);
@@ -22,6 +22,7 @@
 
 layout (location = 0) in vec4 vertColor;
 layout (location = 1) in vec2 vertTexCoord;
+layout (location = 2) flat in uint vertTextureIndex;
 
 layout (location = 0) out vec4 outColor;
 
@@ -29,14 +30,6 @@ layout (location = 0) out vec4 outColor;
 #define DESC_SET_TEXTURES 0
 #include "ShaderCommonGLSLFunc.h"
 
-layout(push_constant) uniform RasterizerFrag_BT 
-{
-    layout(offset = 64) uint packedColor;
-    layout(offset = 68) uint textureIndex;
-    layout(offset = 72) uint emissiveTextureIndex;
-    layout(offset = 76) uint emissiveMult;
-} rasterizerFragInfo;
-
 layout (constant_id = 0) const uint alphaTest = 0;
 
 #define ALPHA_THRESHOLD 0.5
@@ -44,10 +37,10 @@ layout (constant_id = 0) const uint alphaTest = 0;
 
 void main()
 {
-    vec4 albedoAlpha = getTextureSample(rasterizerFragInfo.textureIndex, vertTexCoord);
+    vec4 albedoAlpha = getTextureSample(vertTextureIndex, vertTexCoord);
 
 
-    outColor = unpackUintColor( rasterizerFragInfo.packedColor ) * vertColor * albedoAlpha;
+    outColor = vertColor * albedoAlpha;
 
 
     if (alphaTest != 0)
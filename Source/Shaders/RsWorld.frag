@@ -22,40 +22,29 @@
 
 layout( location = 0 ) in vec4 vertColor;
 layout( location = 1 ) in vec2 vertTexCoord;
+layout( location = 2 ) flat in uint vertTextureIndex;
+layout( location = 3 ) flat in uint vertEmissiveTextureIndex;
+layout( location = 4 ) flat in float vertEmissiveMult;
 
 layout( location = 0 ) out vec4 outColor;
 layout( location = 1 ) out vec3 outScreenEmission;
 layout( location = 2 ) out float outReactivity;
 
 #define DESC_SET_TEXTURES       0
-#define DESC_SET_GLOBAL_UNIFORM 1
-#define DESC_SET_TONEMAPPING    2
-#define DESC_SET_VOLUMETRIC     3
+#define DESC_SET_GLOBAL_UNIFORM 2
+#define DESC_SET_TONEMAPPING    3
+#define DESC_SET_VOLUMETRIC     4
 #include "ShaderCommonGLSLFunc.h"
 #include "Exposure.h"
 #include "Volumetric.h"
 
-layout( push_constant ) uniform RasterizerFrag_BT
-{
-    layout( offset = 64 ) uint  packedColor;
-    layout( offset = 68 ) uint  textureIndex;
-    layout( offset = 72 ) uint  emissiveTextureIndex;
-    layout( offset = 76 ) float emissiveMult;
-}
-rasterizerFragInfo;
-
 layout( constant_id = 0 ) const uint alphaTest = 0;
 
 #define ALPHA_THRESHOLD 0.5
 
-vec4 baseColor()
-{
-    return vertColor * unpackUintColor( rasterizerFragInfo.packedColor );
-}
-
 void main()
 {
-    vec4 ldrColor = baseColor() * getTextureSample( rasterizerFragInfo.textureIndex, vertTexCoord );
+    vec4 ldrColor = vertColor * getTextureSample( vertTextureIndex, vertTexCoord );
 
     outReactivity = 0.9 * ldrColor.a;
     outColor      = ldrColor;
@@ -87,16 +76,15 @@ void main()
 
     {
         vec3 ldrEmis;
-        if( rasterizerFragInfo.emissiveTextureIndex != MATERIAL_NO_TEXTURE )
+        if( vertEmissiveTextureIndex != MATERIAL_NO_TEXTURE )
         {
-            ldrEmis = baseColor().rgb *
-                      getTextureSample( rasterizerFragInfo.emissiveTextureIndex, vertTexCoord ).rgb;
+            ldrEmis = vertColor.rgb * getTextureSample( vertEmissiveTextureIndex, vertTexCoord ).rgb;
         }
         else
         {
             ldrEmis = ldrColor.rgb;
         }
-        ldrEmis *= rasterizerFragInfo.emissiveMult;
+        ldrEmis *= vertEmissiveMult;
 
         outScreenEmission = ldrEmis;
     }
@@ -88,25 +88,29 @@ vec4 getTextureSampleGrad(uint textureIndex, const vec2 texCoord, const vec2 dPd
 
 
 
-// instanceID is assumed to be < 256 (i.e. 8 bits ) and 
-// instanceCustomIndexEXT is 24 bits by Vulkan spec
+// instanceID is assumed to be < 2^24 and
+// instanceCustomIndexEXT contains only INSTANCE_CUSTOM_INDEX_FLAG_* (i.e. 8 bits)
 uint packInstanceIdAndCustomIndex(int instanceID, int instanceCustomIndexEXT)
 {
-    return (instanceID << 24) | instanceCustomIndexEXT;
+#if MAX_TOP_LEVEL_INSTANCE_COUNT > (1 << 24)
+    #error Instance ID must fit into 24 bits
+#endif
+
+    return (instanceID << 8) | (instanceCustomIndexEXT & 0xFF);
 }
 
 ivec2 unpackInstanceIdAndCustomIndex(uint instanceIdAndIndex)
 {
     return ivec2(
-        instanceIdAndIndex >> 24,
-        instanceIdAndIndex & 0xFFFFFF
+        instanceIdAndIndex >> 8,
+        instanceIdAndIndex & 0xFF
     );
 }
 
 void unpackInstanceIdAndCustomIndex(uint instanceIdAndIndex, out int instanceId, out int instanceCustomIndexEXT)
 {
-    instanceId = int(instanceIdAndIndex >> 24);
-    instanceCustomIndexEXT = int(instanceIdAndIndex & 0xFFFFFF);
+    instanceId = int(instanceIdAndIndex >> 8);
+    instanceCustomIndexEXT = int(instanceIdAndIndex & 0xFF);
 }
 
 uint packGeometryAndPrimitiveIndex(int geometryIndex, int primitiveIndex)
@@ -198,6 +202,11 @@ layout(set = DESC_SET_LIGHT_SOURCES, binding = BINDING_INITIAL_LIGHTS_GRID_PREV)
 {
     ShLightInCell initialLightsGrid_Prev[];
 };
+
+layout(set = DESC_SET_LIGHT_SOURCES, binding = BINDING_LIGHT_TREE_NODES) readonly buffer LightTreeNodes_BT
+{
+    ShLightTreeNode lightTreeNodes[];
+};
 #endif
 
 
@@ -272,8 +281,10 @@ vec2 getPrevScreenPos(const vec2 motionCurToPrev, const ivec2 pix)
 {
     const vec2 screenSize = vec2(globalUniform.renderWidth / float(CHECKERBOARD_SEPARATOR_DIVISOR), globalUniform.renderHeight);
     const vec2 invScreenSize = vec2(1.0 / screenSize.x, 1.0 / screenSize.y);
+    // with dynamic resolution, previous frame could be rendered in another size
+    const vec2 prevScreenSize = vec2(globalUniform.prevRenderWidth / float(CHECKERBOARD_SEPARATOR_DIVISOR), globalUniform.prevRenderHeight);
    
-    return ((vec2(pix) + vec2(0.5)) * invScreenSize + motionCurToPrev) * screenSize;
+    return ((vec2(pix) + vec2(0.5)) * invScreenSize + motionCurToPrev) * prevScreenSize;
 }
 
 vec2 getPrevScreenPos(sampler2D motionSampler, const ivec2 pix)
@@ -292,6 +303,18 @@ vec2 getCurScreenPos(sampler2D motionSampler, const ivec2 prevPix)
     return ((vec2(prevPix) + vec2(0.5)) * invScreenSize - motionCurToPrev) * screenSize;
 }
 */
+
+// Framebuffers can be bigger than the render size (dynamic resolution),
+// so [0..1] coords of the render area must be remapped before sampling,
+// and clamped to not filter texels outside of it
+vec2 getRenderAreaUV(sampler2D framebufSampler, const vec2 uv)
+{
+    const vec2 scale = vec2(globalUniform.renderWidth / globalUniform.maxRenderWidth,
+                            globalUniform.renderHeight / globalUniform.maxRenderHeight);
+    const vec2 halfTexel = 0.5 / vec2(textureSize(framebufSampler, 0));
+
+    return min(uv * scale, scale - halfTexel);
+}
 #endif // DESC_SET_FRAMEBUFFERS
 #endif // DESC_SET_GLOBAL_UNIFORM
 
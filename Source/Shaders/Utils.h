@@ -139,6 +139,32 @@ vec3 decodeNormal(uint _packed)
     );
 }
 
+// Octahedral mapping, 16 bits per component
+uint encodeNormalOctahedral(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+
+    vec2 e = n.xy;
+    if (n.z < 0.0)
+    {
+        e = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+
+    return packSnorm2x16(e);
+}
+
+vec3 decodeNormalOctahedral(uint _packed)
+{
+    const vec2 e = unpackSnorm2x16(_packed);
+
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    const float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+
+    return normalize(n);
+}
+
 vec3 safeNormalize(const vec3 v)
 {
     const float len = length(v);
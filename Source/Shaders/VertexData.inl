@@ -31,6 +31,18 @@ layout(
     ShVertex g_staticVertices[];
 };
 
+// Same buffer, if globalUniform.staticVerticesCompact is set
+layout(
+    set = DESC_SET_VERTEX_DATA,
+    binding = BINDING_VERTEX_BUFFER_STATIC)
+    #ifndef VERTEX_BUFFER_WRITEABLE
+    readonly 
+    #endif
+    buffer VertexBufferStaticCompact_BT
+{
+    ShVertexCompact g_staticVerticesCompact[];
+};
+
 layout(
     set = DESC_SET_VERTEX_DATA,
     binding = BINDING_VERTEX_BUFFER_DYNAMIC)
@@ -78,6 +90,15 @@ layout(
     int geomIndexPrevToCur[];
 };
 
+layout(
+    set = DESC_SET_VERTEX_DATA,
+    binding = BINDING_TLAS_INSTANCES)
+    readonly 
+    buffer TlasInstances_BT
+{
+    ShTlasInstance tlasInstances[];
+};
+
 layout(
     set = DESC_SET_VERTEX_DATA,
     binding = BINDING_PREV_POSITIONS_BUFFER_DYNAMIC)
@@ -152,14 +173,43 @@ layout(
 
 vec3 getStaticVerticesPositions(uint index)
 {
+    if (globalUniform.staticVerticesCompact != 0)
+    {
+        return vec3(g_staticVerticesCompact[index].position[0],
+                    g_staticVerticesCompact[index].position[1],
+                    g_staticVerticesCompact[index].position[2]);
+    }
     return g_staticVertices[index].position.xyz;
 }
 
 vec3 getStaticVerticesNormals(uint index)
 {
+    if (globalUniform.staticVerticesCompact != 0)
+    {
+        return decodeNormalOctahedral(g_staticVerticesCompact[index].normalPacked);
+    }
     return g_staticVertices[index].normal.xyz;
 }
 
+ShVertex getStaticVertex(uint index)
+{
+    if (globalUniform.staticVerticesCompact != 0)
+    {
+        const ShVertexCompact c = g_staticVerticesCompact[index];
+
+        ShVertex v;
+        v.position = vec4(c.position[0], c.position[1], c.position[2], 0.0);
+        v.normal   = vec4(decodeNormalOctahedral(c.normalPacked), 0.0);
+        // tangents are not stored, makeTriangle calculates them per triangle
+        v.tangent  = vec4(0.0);
+        v.texCoord = unpackHalf2x16(c.texCoordPacked);
+        v.color    = c.color;
+        v._padding = 0;
+        return v;
+    }
+    return g_staticVertices[index];
+}
+
 vec3 getDynamicVerticesPositions(uint index)
 {
     return g_dynamicVertices[index].position.xyz;
@@ -173,6 +223,11 @@ vec3 getDynamicVerticesNormals(uint index)
 #ifdef VERTEX_BUFFER_WRITEABLE
 void setStaticVerticesNormals(uint index, vec3 value)
 {
+    if (globalUniform.staticVerticesCompact != 0)
+    {
+        g_staticVerticesCompact[index].normalPacked = encodeNormalOctahedral(value);
+        return;
+    }
     g_staticVertices[index].normal = vec4(value, 0.0);
 }
 
@@ -297,13 +352,13 @@ ShTriangle makeTriangle(const ShVertex a, const ShVertex b, const ShVertex c)
 // Get geometry index in "geometryInstances" array by instanceID, localGeometryIndex.
 int getGeometryIndex(int instanceID, int localGeometryIndex)
 {
-    return globalUniform.instanceGeomInfoOffset[instanceID / 4][instanceID % 4] + localGeometryIndex;
+    return tlasInstances[instanceID].geomInfoOffset + localGeometryIndex;
 }
 
 bool getCurrentGeometryIndexByPrev(int prevInstanceID, int prevLocalGeometryIndex, out int curFrameGlobalGeomIndex)
 {
     // get previous frame's global geom index
-    const int prevFrameGeomIndex = globalUniform.instanceGeomInfoOffsetPrev[prevInstanceID / 4][prevInstanceID % 4] + prevLocalGeometryIndex;
+    const int prevFrameGeomIndex = tlasInstances[prevInstanceID].geomInfoOffsetPrev + prevLocalGeometryIndex;
     
     // try to find global geom index in current frame by it
     curFrameGlobalGeomIndex = geomIndexPrevToCur[prevFrameGeomIndex];
@@ -396,9 +451,9 @@ ShTriangle getTriangle(int instanceID, int instanceCustomIndex, int localGeometr
             const uvec3 vertIndices = getVertIndicesStatic(inst.baseVertexIndex, inst.baseIndexIndex, primitiveId);
         
             tr = makeTriangle(
-                g_staticVertices[vertIndices[0]],
-                g_staticVertices[vertIndices[1]],
-                g_staticVertices[vertIndices[2]]);
+                getStaticVertex(vertIndices[0]),
+                getStaticVertex(vertIndices[1]),
+                getStaticVertex(vertIndices[2]));
         }
 
         if( ( inst.flags & GEOM_INST_FLAG_EXISTS_LAYER1 ) != 0 )
@@ -41,8 +41,8 @@
 
 
 // translate from local to global geom index
-const int geomIndexOffset = globalUniform.instanceGeomInfoOffset[tlasInstanceIndex / 4][tlasInstanceIndex % 4];
-const int geomCount = globalUniform.instanceGeomCount[tlasInstanceIndex / 4][tlasInstanceIndex % 4];
+const int geomIndexOffset = tlasInstances[tlasInstanceIndex].geomInfoOffset;
+const int geomCount = tlasInstances[tlasInstanceIndex].geomCount;
 
 for (uint localGeomIndex = gl_LocalInvocationID.x; localGeomIndex < geomCount; localGeomIndex += gl_WorkGroupSize.x)
 {
@@ -38,8 +38,7 @@ struct CasPush
 
 RTGL1::Sharpening::Sharpening(
     VkDevice _device,
-    const std::shared_ptr<const Framebuffers> &_framebuffers,
-    const std::shared_ptr<const ShaderManager> &_shaderManager)
+    const std::shared_ptr<const Framebuffers> &_framebuffers)
 :
     device(_device),
     pipelineLayout(VK_NULL_HANDLE),
@@ -52,7 +51,6 @@ RTGL1::Sharpening::Sharpening(
     };
 
     CreatePipelineLayout(setLayouts.data(), setLayouts.size());
-    CreatePipelines(_shaderManager.get());
 }
 
 RTGL1::Sharpening::~Sharpening()
@@ -187,7 +185,7 @@ void RTGL1::Sharpening::CreatePipelines(const ShaderManager *shaderManager)
             data.isSourcePing = b;
             data.useSimpleSharp = t == RG_RENDER_SHARPEN_TECHNIQUE_NAIVE;
 
-            VkResult r = vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &plInfo, nullptr, GetPipeline(t, b));
+            VkResult r = vkCreateComputePipelines(device, shaderManager->GetPipelineCache(), 1, &plInfo, nullptr, GetPipeline(t, b));
             VK_CHECKERROR(r);
 
             SET_DEBUG_NAME(device, *GetPipeline(t, b), VK_OBJECT_TYPE_PIPELINE, data.useSimpleSharp ? "Simple sharpening" : "CAS");
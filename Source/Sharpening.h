@@ -36,8 +36,7 @@ class Sharpening final : public IShaderDependency
 public:
     Sharpening(
         VkDevice device,
-        const std::shared_ptr<const Framebuffers> &framebuffers,
-        const std::shared_ptr<const ShaderManager> &shaderManager);
+        const std::shared_ptr<const Framebuffers> &framebuffers);
     ~Sharpening() override;
 
     Sharpening(const Sharpening &other) = delete;
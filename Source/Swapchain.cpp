@@ -59,6 +59,7 @@ RTGL1::Swapchain::Swapchain( VkDevice                                _device,
     , surfaceExtent{ UINT32_MAX, UINT32_MAX }
     , isVsync( true )
     , swapchain( VK_NULL_HANDLE )
+    , headlessExtent{ 0, 0 }
     , currentSwapchainIndex( UINT32_MAX )
 {
     VkResult r;
@@ -124,8 +125,46 @@ RTGL1::Swapchain::Swapchain( VkDevice                                _device,
     }
 }
 
+RTGL1::Swapchain::Swapchain( VkDevice                                _device,
+                             std::shared_ptr< MemoryAllocator >      _allocator,
+                             std::shared_ptr< CommandBufferManager > _cmdManager,
+                             const RgHeadlessCreateInfo&             headlessInfo )
+    : device( _device )
+    , surface( VK_NULL_HANDLE )
+    , physDevice( VK_NULL_HANDLE )
+    , cmdManager( std::move( _cmdManager ) )
+    , allocator( std::move( _allocator ) )
+    , surfaceFormat{ VK_FORMAT_R8G8B8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR }
+    , presentModeVsync( VK_PRESENT_MODE_FIFO_KHR )
+    , presentModeImmediate( VK_PRESENT_MODE_FIFO_KHR )
+    , requestedVsync( true )
+    , surfaceExtent{ UINT32_MAX, UINT32_MAX }
+    , isVsync( true )
+    , swapchain( VK_NULL_HANDLE )
+    , headlessExtent{ headlessInfo.width, headlessInfo.height }
+    , currentSwapchainIndex( UINT32_MAX )
+{
+    assert( !IsNullExtent( headlessExtent ) );
+}
+
+bool RTGL1::Swapchain::IsHeadless() const
+{
+    return surface == VK_NULL_HANDLE;
+}
+
+VkImageLayout RTGL1::Swapchain::GetIdleLayout() const
+{
+    // present layout requires VK_KHR_swapchain
+    return IsHeadless() ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+}
+
 bool RTGL1::Swapchain::IsExtentOptimal() const
 {
+    if( IsHeadless() )
+    {
+        return true;
+    }
+
     VkSurfaceCapabilitiesKHR surfCapabilities;
 
     VkResult                 r =
@@ -144,6 +183,11 @@ bool RTGL1::Swapchain::IsExtentOptimal() const
 
 VkExtent2D RTGL1::Swapchain::GetOptimalExtent() const
 {
+    if( IsHeadless() )
+    {
+        return headlessExtent;
+    }
+
     VkSurfaceCapabilitiesKHR surfCapabilities;
 
     VkResult                 r =
@@ -176,6 +220,18 @@ void RTGL1::Swapchain::AcquireImage( VkSemaphore imageAvailableSemaphore )
 {
     VkExtent2D requestedExtent = GetOptimalExtent();
 
+    if( IsHeadless() )
+    {
+        if( requestedExtent != surfaceExtent )
+        {
+            TryRecreate( requestedExtent, isVsync );
+        }
+
+        // there's no presentation engine, so images are just reused in order
+        currentSwapchainIndex = ( currentSwapchainIndex + 1 ) % GetImageCount();
+        return;
+    }
+
     // if requested params are different
     if( requestedExtent != surfaceExtent || requestedVsync != isVsync )
     {
@@ -236,7 +292,7 @@ void RTGL1::Swapchain::BlitForPresent( VkCommandBuffer cmd,
                                1 };
 
     VkImage       swapchainImage       = swapchainImages[ currentSwapchainIndex ];
-    VkImageLayout swapchainImageLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    VkImageLayout swapchainImageLayout = GetIdleLayout();
 
     // set layout for blit
     Utils::BarrierImage( cmd,
@@ -294,7 +350,7 @@ void RTGL1::Swapchain::BlitPreviousForPresent( VkCommandBuffer cmd )
                 .srcAccessMask       = VK_ACCESS_2_NONE,
                 .dstStageMask        = VK_PIPELINE_STAGE_2_COPY_BIT,
                 .dstAccessMask       = VK_ACCESS_2_TRANSFER_READ_BIT,
-                .oldLayout           = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                .oldLayout           = GetIdleLayout(),
                 .newLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
                 .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                 .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
@@ -312,7 +368,7 @@ void RTGL1::Swapchain::BlitPreviousForPresent( VkCommandBuffer cmd )
                 .srcAccessMask       = VK_ACCESS_2_NONE,
                 .dstStageMask        = VK_PIPELINE_STAGE_2_COPY_BIT,
                 .dstAccessMask       = VK_ACCESS_2_TRANSFER_WRITE_BIT,
-                .oldLayout           = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                .oldLayout           = GetIdleLayout(),
                 .newLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                 .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                 .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
@@ -372,7 +428,7 @@ void RTGL1::Swapchain::BlitPreviousForPresent( VkCommandBuffer cmd )
                 .dstStageMask        = VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT,
                 .dstAccessMask       = VK_ACCESS_2_NONE,
                 .oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                .newLayout           = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                .newLayout           = GetIdleLayout(),
                 .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                 .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                 .image               = src,
@@ -390,7 +446,7 @@ void RTGL1::Swapchain::BlitPreviousForPresent( VkCommandBuffer cmd )
                 .dstStageMask        = VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT,
                 .dstAccessMask       = VK_ACCESS_2_NONE,
                 .oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                .newLayout           = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                .newLayout           = GetIdleLayout(),
                 .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                 .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                 .image               = dst,
@@ -435,6 +491,14 @@ bool RTGL1::Swapchain::TryRecreate( const VkExtent2D& newExtent, bool vsync )
 
     cmdManager->WaitDeviceIdle();
 
+    if( IsHeadless() )
+    {
+        DestroyWithoutSwapchain();
+        CreateHeadless( newExtent.width, newExtent.height );
+
+        return true;
+    }
+
     VkSwapchainKHR old = DestroyWithoutSwapchain();
     Create( newExtent.width, newExtent.height, vsync, old );
 
@@ -507,11 +571,68 @@ void RTGL1::Swapchain::Create( uint32_t       newWidth,
     VK_CHECKERROR( r );
 
     swapchainImages.resize( imageCount );
-    swapchainViews.resize( imageCount );
 
     r = vkGetSwapchainImagesKHR( device, swapchain, &imageCount, swapchainImages.data() );
     VK_CHECKERROR( r );
 
+    CreateViewsAndSetLayouts();
+}
+
+void RTGL1::Swapchain::CreateHeadless( uint32_t newWidth, uint32_t newHeight )
+{
+    this->surfaceExtent = { newWidth, newHeight };
+
+    assert( swapchainImages.empty() );
+    assert( swapchainViews.empty() );
+    assert( headlessMemories.empty() );
+
+    // enough to keep the previous image, for BlitPreviousForPresent and wipe effect
+    const uint32_t imageCount = MAX_FRAMES_IN_FLIGHT;
+
+    swapchainImages.resize( imageCount );
+    headlessMemories.resize( imageCount );
+
+    for( uint32_t i = 0; i < imageCount; i++ )
+    {
+        VkImageCreateInfo imageInfo = {
+            .sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType     = VK_IMAGE_TYPE_2D,
+            .format        = surfaceFormat.format,
+            .extent        = { surfaceExtent.width, surfaceExtent.height, 1 },
+            .mipLevels     = 1,
+            .arrayLayers   = 1,
+            .samples       = VK_SAMPLE_COUNT_1_BIT,
+            .tiling        = VK_IMAGE_TILING_OPTIMAL,
+            .usage         = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                     VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+            .sharingMode   = VK_SHARING_MODE_EXCLUSIVE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        };
+
+        VkResult r = vkCreateImage( device, &imageInfo, nullptr, &swapchainImages[ i ] );
+        VK_CHECKERROR( r );
+
+        VkMemoryRequirements memReqs;
+        vkGetImageMemoryRequirements( device, swapchainImages[ i ], &memReqs );
+
+        headlessMemories[ i ] = allocator->AllocDedicated( memReqs,
+                                                           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                                           MemoryAllocator::AllocType::DEFAULT,
+                                                           "Headless swapchain image" );
+
+        r = vkBindImageMemory( device, swapchainImages[ i ], headlessMemories[ i ], 0 );
+        VK_CHECKERROR( r );
+    }
+
+    CreateViewsAndSetLayouts();
+}
+
+void RTGL1::Swapchain::CreateViewsAndSetLayouts()
+{
+    const uint32_t imageCount = uint32_t( swapchainImages.size() );
+
+    swapchainViews.resize( imageCount );
+
     for( uint32_t i = 0; i < imageCount; i++ )
     {
         VkImageViewCreateInfo viewInfo = {
@@ -527,7 +648,7 @@ void RTGL1::Swapchain::Create( uint32_t       newWidth,
                                   .layerCount     = 1 },
         };
 
-        r = vkCreateImageView( device, &viewInfo, nullptr, &swapchainViews[ i ] );
+        VkResult r = vkCreateImageView( device, &viewInfo, nullptr, &swapchainViews[ i ] );
         VK_CHECKERROR( r );
 
         SET_DEBUG_NAME( device, swapchainImages[ i ], VK_OBJECT_TYPE_IMAGE, "Swapchain image" );
@@ -544,7 +665,7 @@ void RTGL1::Swapchain::Create( uint32_t       newWidth,
                              0,
                              0,
                              VK_IMAGE_LAYOUT_UNDEFINED,
-                             VK_IMAGE_LAYOUT_PRESENT_SRC_KHR );
+                             GetIdleLayout() );
     }
 
     cmdManager->Submit( cmd );
@@ -556,14 +677,18 @@ void RTGL1::Swapchain::Create( uint32_t       newWidth,
 void RTGL1::Swapchain::Destroy()
 {
     VkSwapchainKHR old = DestroyWithoutSwapchain();
-    vkDestroySwapchainKHR( device, old, nullptr );
+
+    if( old != VK_NULL_HANDLE )
+    {
+        vkDestroySwapchainKHR( device, old, nullptr );
+    }
 }
 
 VkSwapchainKHR RTGL1::Swapchain::DestroyWithoutSwapchain()
 {
     vkDeviceWaitIdle( device );
 
-    if( swapchain != VK_NULL_HANDLE )
+    if( !swapchainImages.empty() )
     {
         CallDestroySubscribers();
     }
@@ -573,6 +698,21 @@ VkSwapchainKHR RTGL1::Swapchain::DestroyWithoutSwapchain()
         vkDestroyImageView( device, v, nullptr );
     }
 
+    // swapchain images are owned by the swapchain, but headless ones by this class
+    if( IsHeadless() )
+    {
+        for( VkImage i : swapchainImages )
+        {
+            vkDestroyImage( device, i, nullptr );
+        }
+
+        for( VkDeviceMemory m : headlessMemories )
+        {
+            MemoryAllocator::FreeDedicated( device, m );
+        }
+        headlessMemories.clear();
+    }
+
     swapchainViews.clear();
     swapchainImages.clear();
 
@@ -26,6 +26,7 @@
 #include "Common.h"
 #include "CommandBufferManager.h"
 #include "ISwapchainDependency.h"
+#include "MemoryAllocator.h"
 
 namespace RTGL1
 {
@@ -37,6 +38,11 @@ public:
                VkSurfaceKHR                            surface,
                VkPhysicalDevice                        physDevice,
                std::shared_ptr< CommandBufferManager > cmdManager );
+    // Headless: images are created by the library, and nothing is presented
+    Swapchain( VkDevice                                device,
+               std::shared_ptr< MemoryAllocator >      allocator,
+               std::shared_ptr< CommandBufferManager > cmdManager,
+               const RgHeadlessCreateInfo&             headlessInfo );
     ~Swapchain();
 
     Swapchain( const Swapchain& other )     = delete;
@@ -46,6 +52,7 @@ public:
 
     bool       RequestVsync( bool enable );
 
+    // If headless, imageAvailableSemaphore is not signaled
     void       AcquireImage( VkSemaphore imageAvailableSemaphore );
     void       BlitForPresent( VkCommandBuffer cmd,
                                VkImage         srcImage,
@@ -71,6 +78,9 @@ public:
     VkSwapchainKHR     GetHandle() const;
 
     bool               IsExtentOptimal() const;
+    bool               IsHeadless() const;
+    // Layout of the images between the frames
+    VkImageLayout      GetIdleLayout() const;
 
 private:
     VkExtent2D     GetOptimalExtent() const;
@@ -82,6 +92,8 @@ private:
                            uint32_t       newHeight,
                            bool           vsync,
                            VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE );
+    void           CreateHeadless( uint32_t newWidth, uint32_t newHeight );
+    void           CreateViewsAndSetLayouts();
     void           Destroy();
     // Destroy dresources but not the swapchain itself. Old swapchain is returned.
     VkSwapchainKHR DestroyWithoutSwapchain();
@@ -94,6 +106,7 @@ private:
     VkSurfaceKHR                                       surface;
     VkPhysicalDevice                                   physDevice;
     std::shared_ptr< CommandBufferManager >            cmdManager;
+    std::shared_ptr< MemoryAllocator >                 allocator;
 
     VkSurfaceFormatKHR                                 surfaceFormat;
     VkPresentModeKHR                                   presentModeVsync;
@@ -107,6 +120,9 @@ private:
     VkSwapchainKHR                                     swapchain;
     std::vector< VkImage >                             swapchainImages;
     std::vector< VkImageView >                         swapchainViews;
+    // only if headless
+    VkExtent2D                                         headlessExtent;
+    std::vector< VkDeviceMemory >                      headlessMemories;
 
     uint32_t                                           currentSwapchainIndex;
 
@@ -46,6 +46,9 @@ static_assert( TEXTURES_PER_MATERIAL_COUNT == 4 );
 
 constexpr bool PreferExistingMaterials = true;
 
+// Limit staging memory that is used by streamed textures in one frame
+constexpr uint64_t MaxStreamedBytesPerFrame = 32 * 1024 * 1024;
+
 template< typename T >
 constexpr const T* DefaultIfNull( const T* pData, const T* pDefault )
 {
@@ -67,7 +70,7 @@ bool ContainsTextures( const MaterialTextures& m )
 auto FindEmptySlot( std::vector< Texture >& textures )
 {
     return std::ranges::find_if( textures, []( const Texture& t ) {
-        return t.image == VK_NULL_HANDLE && t.view == VK_NULL_HANDLE;
+        return t.image == VK_NULL_HANDLE && t.view == VK_NULL_HANDLE && !t.reserved;
     } );
 }
 
@@ -109,6 +112,11 @@ TextureManager::TextureManager( VkDevice                                _device,
 
     textures.resize( TEXTURE_COUNT_MAX );
 
+    if( _config.asyncTextureLoading )
+    {
+        loaderPool = std::make_unique< ThreadPool >( _config.textureLoaderThreadCount );
+    }
+
     // submit cmd to create empty texture
     {
         VkCommandBuffer cmd = cmdManager->StartGraphicsCmd();
@@ -254,6 +262,10 @@ uint32_t TextureManager::CreateDirtMaskTexture( VkCommandBuffer              cmd
 
 TextureManager::~TextureManager()
 {
+    // wait for loader threads, and free all the data that wasn't uploaded
+    loaderPool.reset();
+    pendingTextures.clear();
+
     for( auto& texture : textures )
     {
         assert( ( texture.image == VK_NULL_HANDLE && texture.view == VK_NULL_HANDLE ) ||
@@ -348,6 +360,120 @@ void TextureManager::TryHotReload( VkCommandBuffer cmd, uint32_t frameIndex )
     texturesToReload.clear();
 }
 
+void TextureManager::UploadStreamed( VkCommandBuffer cmd, uint32_t frameIndex )
+{
+    uint64_t uploadedBytes = 0;
+
+    for( auto it = pendingTextures.begin(); it != pendingTextures.end(); )
+    {
+        if( uploadedBytes >= MaxStreamedBytesPerFrame )
+        {
+            break;
+        }
+
+        if( !IsReady( it->loaded ) )
+        {
+            ++it;
+            continue;
+        }
+
+        // remove from the list first, so it's not processed again, if an upload throws
+        PendingTexture p = std::move( *it );
+        it               = pendingTextures.erase( it );
+
+        std::unique_ptr< StreamedTexture > st;
+        try
+        {
+            st = p.loaded.get();
+        }
+        catch( const std::exception& e )
+        {
+            // treat as a file that failed to load
+            debug::Warning( "Texture loader thread failed: {}", e.what() );
+        }
+
+        if( p.cancelled )
+        {
+            continue;
+        }
+
+        auto targetSlot = textures.begin() + p.slot;
+        assert( targetSlot->reserved && targetSlot->image == VK_NULL_HANDLE );
+
+        std::optional< ImageLoader::ResultInfo > result;
+        std::filesystem::path                    filepath;
+        const char*                              debugName = "";
+
+        if( st )
+        {
+            filepath  = st->ovrd.path;
+            debugName = st->ovrd.debugname;
+        }
+
+        if( st && st->ovrd.result )
+        {
+            result = st->ovrd.result;
+        }
+        else
+        {
+            debug::Warning( "Failed to load texture file: {}", filepath.string() );
+
+            if( !p.fallbackPixels.empty() )
+            {
+                // original pixels, as if the file didn't exist
+                const auto dataSize = uint32_t( p.fallbackPixels.size() );
+
+                result = ImageLoader::ResultInfo{
+                    .levelOffsets   = { 0 },
+                    .levelSizes     = { dataSize },
+                    .levelCount     = 1,
+                    .isPregenerated = false,
+                    .pData          = p.fallbackPixels.data(),
+                    .dataSize       = dataSize,
+                    .baseSize       = p.fallbackSize,
+                    .format         = VK_FORMAT_R8G8B8A8_SRGB,
+                };
+            }
+        }
+
+        uint32_t tindex = EMPTY_TEXTURE_INDEX;
+
+        if( result )
+        {
+            constexpr bool isUpdateable = false;
+
+            uploadedBytes += result->dataSize;
+
+            try
+            {
+                tindex = PrepareTexture( cmd,
+                                         frameIndex,
+                                         result,
+                                         p.samplerHandle,
+                                         true,
+                                         debugName,
+                                         isUpdateable,
+                                         p.swizzling,
+                                         std::move( filepath ),
+                                         targetSlot );
+            }
+            catch( ... )
+            {
+                ReleaseFailedSlot( p.slot );
+                throw;
+            }
+        }
+
+        // must match, so materials' indices are correct
+        assert( tindex == p.slot || tindex == EMPTY_TEXTURE_INDEX );
+
+        if( tindex == EMPTY_TEXTURE_INDEX )
+        {
+            ReleaseFailedSlot( p.slot );
+        }
+    }
+}
+
 void TextureManager::SubmitDescriptors( uint32_t                         frameIndex,
                                         const RgDrawFrameTexturesParams& texturesParams,
                                         bool                             forceUpdateAllDescriptors )
@@ -416,17 +542,6 @@ bool TextureManager::TryCreateMaterial( VkCommandBuffer              cmd,
     }
 
 
-    // clang-format off
-    TextureOverrides ovrd[] = {
-        TextureOverrides( ovrdFolder, info.pTextureName, postfixes[ 0 ], info.pPixels, info.size, VK_FORMAT_R8G8B8A8_SRGB, OnlyKTX2LoaderIfNonDevMode() ),
-        TextureOverrides( ovrdFolder, info.pTextureName, postfixes[ 1 ], nullptr, {}, VK_FORMAT_R8G8B8A8_UNORM, OnlyKTX2LoaderIfNonDevMode() ),
-        TextureOverrides( ovrdFolder, info.pTextureName, postfixes[ 2 ], nullptr, {}, VK_FORMAT_R8G8B8A8_UNORM, OnlyKTX2LoaderIfNonDevMode() ),
-        TextureOverrides( ovrdFolder, info.pTextureName, postfixes[ 3 ], nullptr, {}, VK_FORMAT_R8G8B8A8_SRGB, OnlyKTX2LoaderIfNonDevMode() ),
-    };
-    static_assert( std::size( ovrd ) == TEXTURES_PER_MATERIAL_COUNT );
-    // clang-format on
-
-
     SamplerManager::Handle samplers[] = {
         SamplerManager::Handle( info.filter, info.addressModeU, info.addressModeV ),
         SamplerManager::Handle( info.filter, info.addressModeU, info.addressModeV ),
@@ -449,10 +564,103 @@ bool TextureManager::TryCreateMaterial( VkCommandBuffer              cmd,
     static_assert( TEXTURE_OCCLUSION_ROUGHNESS_METALLIC_INDEX == 1 );
 
 
+    if( loaderPool )
+    {
+        return TryCreateMaterialStreamed( cmd, frameIndex, info, ovrdFolder, samplers, swizzlings );
+    }
+
+
+    // clang-format off
+    TextureOverrides ovrd[] = {
+        TextureOverrides( ovrdFolder, info.pTextureName, postfixes[ 0 ], info.pPixels, info.size, VK_FORMAT_R8G8B8A8_SRGB, OnlyKTX2LoaderIfNonDevMode() ),
+        TextureOverrides( ovrdFolder, info.pTextureName, postfixes[ 1 ], nullptr, {}, VK_FORMAT_R8G8B8A8_UNORM, OnlyKTX2LoaderIfNonDevMode() ),
+        TextureOverrides( ovrdFolder, info.pTextureName, postfixes[ 2 ], nullptr, {}, VK_FORMAT_R8G8B8A8_UNORM, OnlyKTX2LoaderIfNonDevMode() ),
+        TextureOverrides( ovrdFolder, info.pTextureName, postfixes[ 3 ], nullptr, {}, VK_FORMAT_R8G8B8A8_SRGB, OnlyKTX2LoaderIfNonDevMode() ),
+    };
+    static_assert( std::size( ovrd ) == TEXTURES_PER_MATERIAL_COUNT );
+    // clang-format on
+
+
     MakeMaterial( cmd, frameIndex, info.pTextureName, ovrd, samplers, swizzlings );
     return true;
 }
 
+bool TextureManager::TryCreateMaterialStreamed(
+    VkCommandBuffer                                  cmd,
+    uint32_t                                         frameIndex,
+    const RgOriginalTextureInfo&                     info,
+    const std::filesystem::path&                     ovrdFolder,
+    std::span< SamplerManager::Handle >              samplers,
+    std::span< std::optional< RgTextureSwizzling > > swizzlings )
+{
+    assert( loaderPool );
+
+    constexpr VkFormat formats[] = {
+        VK_FORMAT_R8G8B8A8_SRGB,
+        VK_FORMAT_R8G8B8A8_UNORM,
+        VK_FORMAT_R8G8B8A8_UNORM,
+        VK_FORMAT_R8G8B8A8_SRGB,
+    };
+    static_assert( std::size( formats ) == TEXTURES_PER_MATERIAL_COUNT );
+
+    constexpr bool isUpdateable = false;
+
+    MaterialTextures mtextures = {};
+    for( uint32_t i = 0; i < TEXTURES_PER_MATERIAL_COUNT; i++ )
+    {
+        // only check that the file exists, reading is done by loader threads
+        auto filepath = TextureOverrides::FindFile(
+            ovrdFolder, info.pTextureName, postfixes[ i ], OnlyKTX2LoaderIfNonDevMode() );
+
+        if( filepath )
+        {
+            const bool hasFallback = ( i == TEXTURE_ALBEDO_ALPHA_INDEX );
+
+            mtextures.indices[ i ] = StartStreaming( std::move( *filepath ),
+                                                     Utils::IsSRGB( formats[ i ] ),
+                                                     samplers[ i ],
+                                                     swizzlings[ i ],
+                                                     info.pTextureName,
+                                                     hasFallback ? info.pPixels : nullptr,
+                                                     hasFallback ? info.size : RgExtent2D{} );
+        }
+        else if( i == TEXTURE_ALBEDO_ALPHA_INDEX )
+        {
+            // original pixels are already in memory, so upload them immediately
+            TextureOverrides ovrd( ovrdFolder,
+                                   info.pTextureName,
+                                   postfixes[ i ],
+                                   info.pPixels,
+                                   info.size,
+                                   formats[ i ],
+                                   OnlyKTX2LoaderIfNonDevMode() );
+
+            mtextures.indices[ i ] = PrepareTexture( cmd,
+                                                     frameIndex,
+                                                     ovrd.result,
+                                                     samplers[ i ],
+                                                     true,
+                                                     ovrd.debugname,
+                                                     isUpdateable,
+                                                     swizzlings[ i ],
+                                                     std::move( ovrd.path ),
+                                                     FindEmptySlot( textures ) );
+        }
+        else
+        {
+            mtextures.indices[ i ] = EMPTY_TEXTURE_INDEX;
+        }
+    }
+
+    InsertMaterial( frameIndex,
+                    info.pTextureName,
+                    Material{
+                        .textures     = mtextures,
+                        .isUpdateable = isUpdateable,
+                    } );
+    return true;
+}
+
 void TextureManager::MakeMaterial( VkCommandBuffer                                  cmd,
                                    uint32_t                                         frameIndex,
                                    std::string_view                                 materialName,
@@ -534,17 +742,6 @@ bool TextureManager::TryCreateImportedMaterial( VkCommandBuffer
         return false;
     }
 
-    // clang-format off
-    TextureOverrides ovrd[] = {
-        TextureOverrides( fullPaths[ 0 ], true, AnyImageLoader() ),
-        TextureOverrides( fullPaths[ 1 ], false, AnyImageLoader() ),
-        TextureOverrides( fullPaths[ 2 ], false, AnyImageLoader() ),
-        TextureOverrides( fullPaths[ 3 ], true, AnyImageLoader() ),
-    };
-    static_assert( std::size( ovrd ) == TEXTURES_PER_MATERIAL_COUNT );
-    // clang-format on
-
-
     std::optional< RgTextureSwizzling > swizzlings[] = {
         std::nullopt,
         std::optional( customPbrSwizzling ),
@@ -557,6 +754,44 @@ bool TextureManager::TryCreateImportedMaterial( VkCommandBuffer
     // to free later / to prevent export from ExportOriginalMaterialTextures
     importedMaterials.insert( materialName );
 
+
+    if( loaderPool )
+    {
+        constexpr bool isSRGB[] = { true, false, false, true };
+        static_assert( std::size( isSRGB ) == TEXTURES_PER_MATERIAL_COUNT );
+
+        MaterialTextures mtextures = {};
+        for( uint32_t i = 0; i < TEXTURES_PER_MATERIAL_COUNT; i++ )
+        {
+            mtextures.indices[ i ] = std::filesystem::is_regular_file( fullPaths[ i ] )
+                                         ? StartStreaming( fullPaths[ i ],
+                                                           isSRGB[ i ],
+                                                           samplers[ i ],
+                                                           swizzlings[ i ],
+                                                           materialName )
+                                         : EMPTY_TEXTURE_INDEX;
+        }
+
+        InsertMaterial( frameIndex,
+                        materialName,
+                        Material{
+                            .textures     = mtextures,
+                            .isUpdateable = false,
+                        } );
+        return true;
+    }
+
+
+    // clang-format off
+    TextureOverrides ovrd[] = {
+        TextureOverrides( fullPaths[ 0 ], true, AnyImageLoader() ),
+        TextureOverrides( fullPaths[ 1 ], false, AnyImageLoader() ),
+        TextureOverrides( fullPaths[ 2 ], false, AnyImageLoader() ),
+        TextureOverrides( fullPaths[ 3 ], true, AnyImageLoader() ),
+    };
+    static_assert( std::size( ovrd ) == TEXTURES_PER_MATERIAL_COUNT );
+    // clang-format on
+
     MakeMaterial( cmd, frameIndex, materialName, ovrd, samplers, swizzlings );
     return true;
 }
@@ -657,6 +892,7 @@ void TextureManager::InsertMaterial( uint32_t         frameIndex,
                                      const Material&  material )
 {
     auto [ iter, insertednew ] = materials.insert( { std::string( materialName ), material } );
+    materialsGeneration++;
 
     if( !insertednew )
     {
@@ -685,7 +921,14 @@ void TextureManager::DestroyMaterialTextures( uint32_t frameIndex, const Materia
     {
         if( t != EMPTY_TEXTURE_INDEX )
         {
-            AddToBeDestroyed( frameIndex, textures[ t ] );
+            if( textures[ t ].reserved )
+            {
+                CancelStreaming( textures[ t ] );
+            }
+            else
+            {
+                AddToBeDestroyed( frameIndex, textures[ t ] );
+            }
         }
     }
 }
@@ -705,10 +948,118 @@ bool TextureManager::TryDestroyMaterial( uint32_t frameIndex, const char* materi
 
     DestroyMaterialTextures( frameIndex, it->second );
     materials.erase( it );
+    materialsGeneration++;
 
     return true;
 }
 
+uint32_t TextureManager::StartStreaming( std::filesystem::path               filepath,
+                                         bool                                isSRGB,
+                                         SamplerManager::Handle              samplerHandle,
+                                         std::optional< RgTextureSwizzling > swizzling,
+                                         std::string_view                    debugName,
+                                         const void*                         fallbackPixels,
+                                         RgExtent2D                          fallbackSize )
+{
+    assert( loaderPool );
+
+    auto targetSlot = FindEmptySlot( textures );
+
+    if( targetSlot == textures.end() )
+    {
+        debug::Warning( "Reached texture limit: {}, while loading {}",
+                        textures.size(),
+                        filepath.string() );
+        return EMPTY_TEXTURE_INDEX;
+    }
+
+    // empty slot is bound to the empty texture in SubmitDescriptors,
+    // so it's safe to return the index immediately
+    targetSlot->reserved = true;
+
+    auto loaded = loaderPool->Push(
+        [ filepath = std::move( filepath ), isSRGB, debugName = std::string( debugName ) ]() {
+            return std::make_unique< StreamedTexture >( filepath, isSRGB, debugName );
+        } );
+
+    auto slot = uint32_t( std::distance( textures.begin(), targetSlot ) );
+
+    // the caller's memory is not valid after the call, so copy
+    auto fallback = std::vector< uint8_t >();
+    if( fallbackPixels )
+    {
+        constexpr size_t bytesPerPixel = 4;
+
+        const auto* src = static_cast< const uint8_t* >( fallbackPixels );
+        fallback.assign(
+            src, src + bytesPerPixel * size_t( fallbackSize.width ) * fallbackSize.height );
+    }
+
+    pendingTextures.push_back( PendingTexture{
+        .slot           = slot,
+        .samplerHandle  = samplerHandle,
+        .swizzling      = swizzling,
+        .loaded         = std::move( loaded ),
+        .cancelled      = false,
+        .fallbackPixels = std::move( fallback ),
+        .fallbackSize   = fallbackSize,
+    } );
+
+    return slot;
+}
+
+void TextureManager::CancelStreaming( Texture& reservedSlot )
+{
+    assert( reservedSlot.reserved && reservedSlot.image == VK_NULL_HANDLE );
+
+    auto slot = uint32_t( std::distance( textures.data(), &reservedSlot ) );
+
+    for( auto& p : pendingTextures )
+    {
+        if( p.slot == slot )
+        {
+            p.cancelled = true;
+        }
+    }
+
+    // free the slot
+    reservedSlot = {};
+}
+
+void TextureManager::ReleaseFailedSlot( uint32_t slot )
+{
+    assert( textures[ slot ].reserved && textures[ slot ].image == VK_NULL_HANDLE );
+
+    // slot can be taken by another texture, so materials must not refer to it
+    for( auto& [ name, material ] : materials )
+    {
+        for( auto& t : material.textures.indices )
+        {
+            if( t == slot )
+            {
+                t = EMPTY_TEXTURE_INDEX;
+            }
+        }
+    }
+    materialsGeneration++;
+
+    textures[ slot ] = {};
+}
+
+TextureManager::StreamedTexture::StreamedTexture( const std::filesystem::path& path,
+                                                  bool                         isSRGB,
+                                                  std::string_view             debugName )
+    : loaderKtx{}
+    , loaderRaw{}
+    , ovrd( path,
+            isSRGB,
+            MakeFileType( path ) == FileType::KTX2
+                ? TextureOverrides::Loader( std::tuple{ &loaderKtx } )
+                : TextureOverrides::Loader( std::tuple{ &loaderRaw } ) )
+{
+    Utils::SafeCstrCopy( ovrd.debugname, debugName );
+}
+
 void TextureManager::DestroyTexture( const Texture& texture )
 {
     assert( texture.image != VK_NULL_HANDLE && texture.view != VK_NULL_HANDLE );
@@ -779,9 +1130,15 @@ uint32_t TextureManager::GetDirtMaskTextureIndex() const
 
 std::array< MaterialTextures, 4 > TextureManager::GetTexturesForLayers(
     const RgMeshPrimitiveInfo& primitive ) const
+{
+    return GetTexturesForLayers( primitive, GetMaterialTextures( primitive.pTextureName ) );
+}
+
+std::array< MaterialTextures, 4 > TextureManager::GetTexturesForLayers(
+    const RgMeshPrimitiveInfo& primitive, const MaterialTextures& baseTextures ) const
 {
     return {
-        GetMaterialTextures( primitive.pTextureName ),
+        baseTextures,
         GetMaterialTextures( IF_LAYER_EXISTS( layer1, pTextureName, nullptr ) ),
         GetMaterialTextures( IF_LAYER_EXISTS( layer2, pTextureName, nullptr ) ),
         GetMaterialTextures( IF_LAYER_EXISTS( layer3, pTextureName, nullptr ) ),
@@ -21,6 +21,7 @@
 #pragma once
 
 #include <array>
+#include <deque>
 #include <list>
 #include <string>
 
@@ -36,6 +37,7 @@
 #include "TextureDescriptors.h"
 #include "TextureOverrides.h"
 #include "TextureUploader.h"
+#include "ThreadPool.h"
 
 namespace RTGL1
 {
@@ -65,6 +67,8 @@ public:
 
     void PrepareForFrame( uint32_t frameIndex );
     void TryHotReload( VkCommandBuffer cmd, uint32_t frameIndex );
+    // Upload textures that were loaded by the background threads
+    void UploadStreamed( VkCommandBuffer cmd, uint32_t frameIndex );
 
     void SubmitDescriptors( uint32_t                         frameIndex,
                             const RgDrawFrameTexturesParams& texturesParams,
@@ -94,9 +98,15 @@ public:
     auto GetDirtMaskTextureIndex() const -> uint32_t;
 
     auto GetMaterialTextures( const char* materialName ) const -> MaterialTextures;
+    // Incremented each time a material is created or destroyed
+    auto GetMaterialsGeneration() const -> uint64_t { return materialsGeneration; }
 
     auto GetTexturesForLayers( const RgMeshPrimitiveInfo& primitive ) const
         -> std::array< MaterialTextures, 4 >;
+    // Same, but the textures of primitive.pTextureName were already found
+    auto GetTexturesForLayers( const RgMeshPrimitiveInfo& primitive,
+                               const MaterialTextures&    baseTextures ) const
+        -> std::array< MaterialTextures, 4 >;
 
     auto GetColorForLayers( const RgMeshPrimitiveInfo& primitive ) const
         -> std::array< RgColor4DPacked32, 4 >;
@@ -126,6 +136,31 @@ private:
         bool             isUpdateable;
     };
 
+    // Owns the data of a texture file that was read on a loader thread
+    struct StreamedTexture
+    {
+        explicit StreamedTexture( const std::filesystem::path& path,
+                                  bool                         isSRGB,
+                                  std::string_view             debugName );
+
+        ImageLoader      loaderKtx;
+        ImageLoaderDev   loaderRaw;
+        TextureOverrides ovrd;
+    };
+
+    struct PendingTexture
+    {
+        uint32_t                                           slot;
+        SamplerManager::Handle                             samplerHandle;
+        std::optional< RgTextureSwizzling >                swizzling;
+        std::future< std::unique_ptr< StreamedTexture > > loaded;
+        // True, if the material was destroyed before the texture was loaded
+        bool                                               cancelled;
+        // Copy of the original RGBA8 sRGB pixels to upload, if the file fails to load
+        std::vector< uint8_t >                             fallbackPixels;
+        RgExtent2D                                         fallbackSize;
+    };
+
 private:
     void     CreateEmptyTexture( VkCommandBuffer cmd, uint32_t frameIndex );
     uint32_t CreateWaterNormalTexture( VkCommandBuffer              cmd,
@@ -135,6 +170,13 @@ private:
                                     uint32_t                     frameIndex,
                                     const std::filesystem::path& filepath );
 
+    bool TryCreateMaterialStreamed( VkCommandBuffer                                  cmd,
+                                    uint32_t                                         frameIndex,
+                                    const RgOriginalTextureInfo&                     info,
+                                    const std::filesystem::path&                     ovrdFolder,
+                                    std::span< SamplerManager::Handle >              samplers,
+                                    std::span< std::optional< RgTextureSwizzling > > swizzlings );
+
     void MakeMaterial( VkCommandBuffer                                  cmd,
                        uint32_t                                         frameIndex,
                        std::string_view                                 materialName,
@@ -153,6 +195,22 @@ private:
                              std::filesystem::path&&                         filepath,
                              std::vector< Texture >::iterator                targetSlot );
 
+    // Reserve a slot and start loading the file on a loader thread.
+    // The slot is bound to the empty texture, until the file is uploaded.
+    // If fallbackPixels is not null, they're copied and uploaded instead,
+    // in case the file fails to load.
+    uint32_t StartStreaming( std::filesystem::path               filepath,
+                             bool                                isSRGB,
+                             SamplerManager::Handle              samplerHandle,
+                             std::optional< RgTextureSwizzling > swizzling,
+                             std::string_view                    debugName,
+                             const void*                         fallbackPixels = nullptr,
+                             RgExtent2D                          fallbackSize   = {} );
+    void     CancelStreaming( Texture& reservedSlot );
+    // Free a reserved slot, which texture couldn't be uploaded,
+    // and make materials refer to the empty texture instead
+    void     ReleaseFailedSlot( uint32_t slot );
+
     void DestroyTexture( const Texture& texture );
     void AddToBeDestroyed( uint32_t frameIndex, Texture& texture );
 
@@ -213,9 +271,14 @@ private:
     std::vector< Texture >               texturesToDestroy[ MAX_FRAMES_IN_FLIGHT ];
     std::vector< std::filesystem::path > texturesToReload;
 
+    // Null, if textures are loaded synchronously
+    std::unique_ptr< ThreadPool > loaderPool;
+    std::deque< PendingTexture >  pendingTextures;
+
     // TODO: string keys pool
     rgl::unordered_map< std::string, Material > materials;
     rgl::unordered_set< std::string >           importedMaterials;
+    uint64_t                                    materialsGeneration{ 0 };
 
     uint32_t waterNormalTextureIndex;
     uint32_t dirtMaskTextureIndex;
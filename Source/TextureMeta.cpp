@@ -65,10 +65,19 @@ RTGL1::TextureMetaManager::TextureMetaManager( std::filesystem::path _databaseFo
 
 auto RTGL1::TextureMetaManager::Access( const char* pTextureName ) const
     -> std::optional< TextureMeta >
+{
+    if( const TextureMeta* meta = Find( pTextureName ) )
+    {
+        return *meta;
+    }
+    return std::nullopt;
+}
+
+auto RTGL1::TextureMetaManager::Find( const char* pTextureName ) const -> const TextureMeta*
 {
     if( Utils::IsCstrEmpty( pTextureName ) )
     {
-        return std::nullopt;
+        return nullptr;
     }
 
     auto strTextureName = std::string( pTextureName );
@@ -76,17 +85,17 @@ auto RTGL1::TextureMetaManager::Access( const char* pTextureName ) const
         auto found = dataScene.find( strTextureName );
         if( found != dataScene.end() )
         {
-            return found->second;
+            return &found->second;
         }
     }
     {
         auto found = dataGlobal.find( strTextureName );
         if( found != dataGlobal.end() )
         {
-            return found->second;
+            return &found->second;
         }
     }
-    return std::nullopt;
+    return nullptr;
 }
 
 void RTGL1::TextureMetaManager::RereadFromFiles( std::filesystem::path sceneFile )
@@ -95,6 +104,7 @@ void RTGL1::TextureMetaManager::RereadFromFiles( std::filesystem::path sceneFile
 
     dataGlobal.clear();
     dataScene.clear();
+    generation++;
 
     auto reread = [ this ]( const std::filesystem::path& filepath, auto& data ) {
         if( !std::filesystem::exists( filepath ) )
@@ -130,10 +140,18 @@ void RTGL1::TextureMetaManager::RereadFromFiles( std::filesystem::path sceneFile
 bool RTGL1::TextureMetaManager::Modify( RgMeshPrimitiveInfo& prim,
                                         RgEditorInfo&        editor,
                                         bool                 isStatic ) const
+{
+    return Modify( prim, editor, isStatic, Find( prim.pTextureName ) );
+}
+
+bool RTGL1::TextureMetaManager::Modify( RgMeshPrimitiveInfo& prim,
+                                        RgEditorInfo&        editor,
+                                        bool                 isStatic,
+                                        const TextureMeta*   meta ) const
 {
     assert( prim.pEditorInfo == &editor );
 
-    if( auto meta = Access( prim.pTextureName ) )
+    if( meta )
     {
         if( meta->forceGenerateNormals )
         {
@@ -42,7 +42,16 @@ public:
     TextureMetaManager& operator=( TextureMetaManager&& other ) noexcept = delete;
 
     bool Modify( RgMeshPrimitiveInfo& prim, RgEditorInfo& editor, bool isStatic ) const;
+    // Same, but with the meta that was already found for prim.pTextureName
+    bool Modify( RgMeshPrimitiveInfo& prim,
+                 RgEditorInfo&        editor,
+                 bool                 isStatic,
+                 const TextureMeta*   meta ) const;
     std::optional< TextureMeta > Access( const char* pTextureName ) const;
+    // Pointer is valid until the next reread
+    const TextureMeta*           Find( const char* pTextureName ) const;
+    // Incremented on each reread, as it invalidates the pointers returned by Find
+    uint64_t                     GetGeneration() const { return generation; }
 
     void RereadFromFiles( std::string_view currentSceneName );
     void OnFileChanged( FileType type, const std::filesystem::path& filepath ) override;
@@ -58,6 +67,8 @@ private:
 
     rgl::unordered_map< std::string, TextureMeta > dataGlobal;
     rgl::unordered_map< std::string, TextureMeta > dataScene;
+
+    uint64_t generation{ 0 };
 };
 
 }
\ No newline at end of file
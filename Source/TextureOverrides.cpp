@@ -107,6 +107,44 @@ namespace loader
             return LoadByIndex< I + 1 >( loaders, ovrdFolder, name, postfix, outPath );
         }
 
+        template< size_t I, typename Loaders >
+            requires( I >= std::tuple_size_v< Loaders > )
+        auto FindByIndex( const Loaders&,
+                          const std::filesystem::path&,
+                          std::string_view,
+                          std::string_view )
+        {
+            return std::optional< std::filesystem::path >{};
+        }
+
+        template< size_t I, typename Loaders >
+            requires( I < std::tuple_size_v< Loaders > )
+        auto FindByIndex( const Loaders&               loaders,
+                          const std::filesystem::path& ovrdFolder,
+                          std::string_view             name,
+                          std::string_view             postfix )
+        {
+            if( std::get< I >( loaders ) )
+            {
+                using LoaderType = std::remove_pointer_t< std::tuple_element_t< I, Loaders > >;
+
+                auto basePath = ovrdFolder / LoaderType::GetFolder();
+
+                for( const char* ext : LoaderType::GetExtensions() )
+                {
+                    auto filepath =
+                        TextureOverrides::GetTexturePath( basePath, name, postfix, ext );
+
+                    if( std::filesystem::is_regular_file( filepath ) )
+                    {
+                        return std::optional( std::move( filepath ) );
+                    }
+                }
+            }
+
+            return FindByIndex< I + 1 >( loaders, ovrdFolder, name, postfix );
+        }
+
         template< size_t I, typename Loaders >
             requires( I >= std::tuple_size_v< Loaders > )
         auto LoadByFullPathByIndex( Loaders&, const std::filesystem::path& )
@@ -140,6 +178,15 @@ namespace loader
         return detail::LoadByIndex< 0 >( loaders, ovrdFolder, name, postfix, outPath );
     }
 
+    template< typename Loaders >
+    auto Find( const Loaders&               loaders,
+               const std::filesystem::path& ovrdFolder,
+               std::string_view             name,
+               std::string_view             postfix )
+    {
+        return detail::FindByIndex< 0 >( loaders, ovrdFolder, name, postfix );
+    }
+
     template< typename Loaders >
     auto Load( Loaders& loaders, const std::filesystem::path& fullpath )
     {
@@ -241,6 +288,17 @@ TextureOverrides::~TextureOverrides()
     std::visit( []( auto&& specific ) { loader::FreeLoaded( specific ); }, iloader );
 }
 
+std::optional< std::filesystem::path > TextureOverrides::FindFile(
+    const std::filesystem::path& ovrdFolder,
+    std::string_view             name,
+    std::string_view             postfix,
+    const Loader&                loader )
+{
+    return std::visit(
+        [ & ]( auto&& specific ) { return loader::Find( specific, ovrdFolder, name, postfix ); },
+        loader );
+}
+
 std::filesystem::path TextureOverrides::GetTexturePath( std::filesystem::path basePath,
                                                         std::string_view      name,
                                                         std::string_view      postfix,
@@ -57,6 +57,13 @@ struct TextureOverrides
     TextureOverrides& operator=( const TextureOverrides& other )     = delete;
     TextureOverrides& operator=( TextureOverrides&& other ) noexcept = delete;
 
+    // Find the file that would be loaded by the first constructor,
+    // without reading its contents.
+    static std::optional< std::filesystem::path > FindFile( const std::filesystem::path& ovrdFolder,
+                                                            std::string_view             name,
+                                                            std::string_view             postfix,
+                                                            const Loader&                loader );
+
     static std::filesystem::path GetTexturePath( std::filesystem::path basePath,
                                                  std::string_view      name,
                                                  std::string_view      postfix,
@@ -0,0 +1,78 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+RTGL1::ThreadPool::ThreadPool( uint32_t threadCount )
+{
+    if( threadCount == 0 )
+    {
+        threadCount = GetDefaultThreadCount();
+    }
+
+    workers.reserve( threadCount );
+    for( uint32_t i = 0; i < threadCount; i++ )
+    {
+        workers.emplace_back( [ this ]( std::stop_token stoken ) { WorkerLoop( stoken ); } );
+    }
+}
+
+RTGL1::ThreadPool::~ThreadPool()
+{
+    for( auto& w : workers )
+    {
+        w.request_stop();
+    }
+    cv.notify_all();
+
+    // jthread joins on destruction
+    workers.clear();
+}
+
+uint32_t RTGL1::ThreadPool::GetDefaultThreadCount()
+{
+    // leave one core for the main thread
+    uint32_t hw = std::thread::hardware_concurrency();
+    return std::max( 1u, hw > 1 ? hw - 1 : 1u );
+}
+
+void RTGL1::ThreadPool::WorkerLoop( std::stop_token stoken )
+{
+    while( true )
+    {
+        std::function< void() > task;
+        {
+            auto lock = std::unique_lock( mutex );
+
+            // returns false, only if stop was requested
+            if( !cv.wait( lock, stoken, [ this ]() { return !tasks.empty(); } ) )
+            {
+                return;
+            }
+
+            task = std::move( tasks.front() );
+            tasks.pop_front();
+        }
+
+        task();
+    }
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace RTGL1
+{
+
+// Fixed set of worker threads that execute pushed tasks in FIFO order.
+class ThreadPool
+{
+public:
+    // If threadCount is 0, it's chosen from the hardware concurrency
+    explicit ThreadPool( uint32_t threadCount );
+    ~ThreadPool();
+
+    ThreadPool( const ThreadPool& other )                = delete;
+    ThreadPool( ThreadPool&& other ) noexcept            = delete;
+    ThreadPool& operator=( const ThreadPool& other )     = delete;
+    ThreadPool& operator=( ThreadPool&& other ) noexcept = delete;
+
+    template< typename Func >
+    auto Push( Func&& f ) -> std::future< std::invoke_result_t< Func > >
+    {
+        using ReturnType = std::invoke_result_t< Func >;
+
+        // std::function requires copyable callables, so keep the task in a shared_ptr
+        auto task =
+            std::make_shared< std::packaged_task< ReturnType() > >( std::forward< Func >( f ) );
+        auto fut = task->get_future();
+        {
+            auto lock = std::lock_guard( mutex );
+            tasks.emplace_back( [ task ]() { ( *task )(); } );
+        }
+        cv.notify_one();
+
+        return fut;
+    }
+
+    uint32_t GetThreadCount() const { return uint32_t( workers.size() ); }
+
+    static uint32_t GetDefaultThreadCount();
+
+private:
+    void WorkerLoop( std::stop_token stoken );
+
+private:
+    std::vector< std::jthread >           workers;
+    std::mutex                            mutex;
+    std::condition_variable_any           cv;
+    std::deque< std::function< void() > > tasks;
+};
+
+// Non-blocking check, if the future already holds a value
+template< typename T >
+bool IsReady( const std::future< T >& f )
+{
+    return f.valid() && f.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready;
+}
+
+}
@@ -29,7 +29,6 @@
 
 RTGL1::Tonemapping::Tonemapping( VkDevice                                      _device,
                                  std::shared_ptr< Framebuffers >               _framebuffers,
-                                 const std::shared_ptr< const ShaderManager >& _shaderManager,
                                  const std::shared_ptr< const GlobalUniform >& _uniform,
                                  const std::shared_ptr< MemoryAllocator >&     _allocator )
     : device( _device ), framebuffers( std::move( _framebuffers ) )
@@ -42,7 +41,6 @@ RTGL1::Tonemapping::Tonemapping( VkDevice                                      _
                                                         tmDescSetLayout };
 
     CreatePipelineLayout( setLayouts.data(), setLayouts.size() );
-    CreatePipelines( _shaderManager.get() );
 }
 
 RTGL1::Tonemapping::~Tonemapping()
@@ -283,7 +281,7 @@ void RTGL1::Tonemapping::CreatePipelines( const ShaderManager* shaderManager )
         plInfo.stage = shaderManager->GetStageInfo( "CLuminanceHistogram" );
 
         r = vkCreateComputePipelines(
-            device, VK_NULL_HANDLE, 1, &plInfo, nullptr, &histogramPipeline );
+            device, shaderManager->GetPipelineCache(), 1, &plInfo, nullptr, &histogramPipeline );
         VK_CHECKERROR( r );
 
         SET_DEBUG_NAME( device,
@@ -296,7 +294,7 @@ void RTGL1::Tonemapping::CreatePipelines( const ShaderManager* shaderManager )
         plInfo.stage = shaderManager->GetStageInfo( "CLuminanceAvg" );
 
         r = vkCreateComputePipelines(
-            device, VK_NULL_HANDLE, 1, &plInfo, nullptr, &avgLuminancePipeline );
+            device, shaderManager->GetPipelineCache(), 1, &plInfo, nullptr, &avgLuminancePipeline );
         VK_CHECKERROR( r );
 
         SET_DEBUG_NAME( device,
@@ -35,7 +35,6 @@ class Tonemapping : public IShaderDependency
 public:
     Tonemapping( VkDevice                                      device,
                  std::shared_ptr< Framebuffers >               framebuffers,
-                 const std::shared_ptr< const ShaderManager >& shaderManager,
                  const std::shared_ptr< const GlobalUniform >& uniform,
                  const std::shared_ptr< MemoryAllocator >&     allocator );
     ~Tonemapping() override;
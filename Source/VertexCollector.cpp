@@ -22,6 +22,7 @@
 
 #include "GeomInfoManager.h"
 #include "Utils.h"
+#include "VertexKernels.h"
 
 #include "Generated/ShaderCommonC.h"
 
@@ -68,11 +69,13 @@ auto MakeUsage( RTGL1::VertexCollectorFilterTypeFlags filter, bool accelStructur
 RTGL1::VertexCollector::VertexCollector( VkDevice         _device,
                                          MemoryAllocator& _allocator,
                                          const uint32_t ( &_maxVertsPerLayer )[ 4 ],
-                                         VertexCollectorFilterTypeFlags _filters )
+                                         VertexCollectorFilterTypeFlags _filters,
+                                         bool                           _compactVertices )
     : device( _device )
     , filtersFlags( _filters )
+    , vertexStride( _compactVertices ? sizeof( ShVertexCompact ) : sizeof( ShVertex ) )
     , bufVertices( _allocator,
-                   _maxVertsPerLayer[ 0 ],
+                   _maxVertsPerLayer[ 0 ] * vertexStride,
                    MakeUsage( _filters ),
                    MakeName( "Vertices", _filters ) )
     , bufIndices( _allocator,
@@ -97,12 +100,14 @@ RTGL1::VertexCollector::VertexCollector( VkDevice         _device,
                          MakeName( "Texcoords Layer3", _filters ) )
 {
     InitFilters( filtersFlags );
+    ReservePersistentRegion( 0.0f );
 }
 
 // device local buffers are shared with the "src" vertex collector
 RTGL1::VertexCollector::VertexCollector( const VertexCollector& _src, MemoryAllocator& _allocator )
     : device( _src.device )
     , filtersFlags( _src.filtersFlags )
+    , vertexStride( _src.vertexStride )
     , bufVertices( _src.bufVertices, _allocator, MakeName( "Vertices", _src.filtersFlags ) )
     , bufIndices( _src.bufIndices, _allocator, MakeName( "Indices", _src.filtersFlags ) )
     , bufTransforms(
@@ -115,6 +120,7 @@ RTGL1::VertexCollector::VertexCollector( const VertexCollector& _src, MemoryAllo
           _src.bufTexcoordLayer3, _allocator, MakeName( "Texcoords Layer3", _src.filtersFlags ) )
 {
     InitFilters( filtersFlags );
+    ReservePersistentRegion( 0.0f );
 }
 
 namespace
@@ -125,6 +131,24 @@ uint32_t AlignUpBy3( uint32_t x )
     return ( ( x + 2 ) / 3 ) * 3;
 }
 
+// Reserve a range of "count" elements, if the counter stays less than "limit".
+// Returns the first element of the range.
+std::optional< uint32_t > BumpAllocate( std::atomic< uint32_t >& counter,
+                                        uint32_t                 count,
+                                        uint32_t                 limit )
+{
+    uint32_t cur = counter.load( std::memory_order_relaxed );
+    do
+    {
+        if( uint64_t( cur ) + count >= limit )
+        {
+            return std::nullopt;
+        }
+    } while( !counter.compare_exchange_weak( cur, cur + count, std::memory_order_relaxed ) );
+
+    return cur;
+}
+
 }
 
 bool RTGL1::VertexCollector::AddPrimitive( uint32_t                          frameIndex,
@@ -141,99 +165,405 @@ bool RTGL1::VertexCollector::AddPrimitive( uint32_t                          fra
         VertexCollectorFilterTypeFlags_GetForGeometry( parentMesh, info, isStatic );
 
 
-    // if exceeds a limit of geometries in a group with specified geomFlags
+    if( geomInfoManager.GetCount( frameIndex ) + 1 >=
+        VertexCollectorFilterTypeFlags_GetAllBottomLevelGeomsCount() )
+    {
+        debug::Error( "Too many geometry infos: the limit is {}",
+                      VertexCollectorFilterTypeFlags_GetAllBottomLevelGeomsCount() );
+        return false;
+    }
+
+    if( isStatic )
+    {
+        assert( geomFlags & FT::CF_STATIC_NON_MOVABLE );
+    }
+    else
+    {
+        assert( geomFlags & FT::CF_DYNAMIC );
+    }
+
+
+    const auto uploaded = UploadPrimitive( isStatic, info );
+    if( !uploaded )
     {
-        if( GetGeometryCount( geomFlags ) + 1 >=
-            VertexCollectorFilterTypeFlags_GetAmountInGlobalArray( geomFlags ) )
+        return false;
+    }
+
+
+    bool transformsFull = false;
+
+    // transform slot is reserved only if the geometry fits into its group
+    auto fnMakeGeometry = [ & ]() -> std::optional< VkAccelerationStructureGeometryKHR > {
+        const auto transformIndex =
+            BumpAllocate( curTransformCount, 1, bufTransforms.GetCapacity() );
+        if( !transformIndex )
         {
-            debug::Error( "Too many geometries in a group ({}-{}-{}). Limit is {}",
-                          uint32_t( geomFlags & FT::MASK_CHANGE_FREQUENCY_GROUP ),
-                          uint32_t( geomFlags & FT::MASK_PASS_THROUGH_GROUP ),
-                          uint32_t( geomFlags & FT::MASK_PRIMARY_VISIBILITY_GROUP ),
-                          VertexCollectorFilterTypeFlags_GetAmountInGlobalArray( geomFlags ) );
-            return false;
+            transformsFull = true;
+            return std::nullopt;
         }
-    }
 
+        static_assert( sizeof( parentMesh.transform ) == sizeof( VkTransformMatrixKHR ) );
+        assert( bufTransforms.mapped );
 
+        memcpy( &bufTransforms.mapped[ *transformIndex ],
+                &parentMesh.transform,
+                sizeof( VkTransformMatrixKHR ) );
 
-    const uint32_t vertIndex      = AlignUpBy3( curVertexCount );
-    const uint32_t indIndex       = AlignUpBy3( curIndexCount );
-    const uint32_t transformIndex = curTransformCount;
-    const uint32_t texcIndex_1    = curTexCoordCount_Layer1;
-    const uint32_t texcIndex_2    = curTexCoordCount_Layer2;
-    const uint32_t texcIndex_3    = curTexCoordCount_Layer3;
+        return MakeASGeometry( *uploaded, geomFlags, *transformIndex );
+    };
 
-    const bool     useIndices    = info.indexCount != 0 && info.pIndices != nullptr;
-    const uint32_t triangleCount = useIndices ? info.indexCount / 3 : info.vertexCount / 3;
 
-    curVertexCount = vertIndex + info.vertexCount;
-    curIndexCount  = indIndex + ( useIndices ? info.indexCount : 0 );
-    curPrimitiveCount += triangleCount;
-    curTransformCount += 1;
-    curTexCoordCount_Layer1 += GeomInfoManager::LayerExists( info, 1 ) ? info.vertexCount : 0;
-    curTexCoordCount_Layer2 += GeomInfoManager::LayerExists( info, 2 ) ? info.vertexCount : 0;
-    curTexCoordCount_Layer3 += GeomInfoManager::LayerExists( info, 3 ) ? info.vertexCount : 0;
+    ShGeometryInstance geomInfo =
+        MakeGeomInfo( parentMesh.transform, info, *uploaded, layerTextures, layerColors );
 
 
+    std::optional< uint32_t > localIndex{};
+    bool                      isAdded;
 
+    // if exceeds a limit of geometries in a group with specified geomFlags
     if( isStatic )
     {
-        if( curVertexCount >= MAX_STATIC_VERTEX_COUNT )
-        {
-            debug::Error( "Too many static vertices: the limit is {}", MAX_STATIC_VERTEX_COUNT );
-            return false;
-        }
-        assert( geomFlags & FT::CF_STATIC_NON_MOVABLE );
+        localIndex = PushGeometry( geomFlags, fnMakeGeometry, uniqueID, *uploaded );
+        isAdded    = localIndex.has_value();
     }
     else
     {
-        if( curVertexCount >= MAX_DYNAMIC_VERTEX_COUNT )
-        {
-            debug::Error( "Too many dynamic vertices: the limit is {}", MAX_DYNAMIC_VERTEX_COUNT );
-            return false;
-        }
-        assert( geomFlags & FT::CF_DYNAMIC );
+        // local index of a dynamic geometry is known only after FlushPendingGeometries,
+        // so that the BLAS geometry order doesn't depend on the order of AddPrimitive calls
+        isAdded = AddPendingGeometry( geomFlags, fnMakeGeometry, uniqueID, *uploaded, geomInfo );
     }
 
-    if( curIndexCount >= MAX_INDEXED_PRIMITIVE_COUNT * 3 )
+    if( transformsFull )
     {
-        debug::Error( "Too many indices: the limit is {}", MAX_INDEXED_PRIMITIVE_COUNT * 3 );
+        debug::Error( "Too many BLAS transforms: the limit is {}", bufTransforms.GetCapacity() );
         return false;
     }
 
-    if( geomInfoManager.GetCount( frameIndex ) + 1 >= MAX_BOTTOM_LEVEL_GEOMETRIES_COUNT )
+    if( !isAdded )
     {
-        debug::Error( "Too many geometry infos: the limit is {}",
-                      MAX_BOTTOM_LEVEL_GEOMETRIES_COUNT );
+        debug::Error( "Too many geometries in a group ({}-{}-{}). Limit is {}",
+                      uint32_t( geomFlags & FT::MASK_CHANGE_FREQUENCY_GROUP ),
+                      uint32_t( geomFlags & FT::MASK_PASS_THROUGH_GROUP ),
+                      uint32_t( geomFlags & FT::MASK_PRIMARY_VISIBILITY_GROUP ),
+                      std::min( VertexCollectorFilterTypeFlags_GetAmountInGlobalArray( geomFlags ),
+                                uint32_t( MAX_BOTTOM_LEVEL_GEOMETRIES_COUNT ) ) );
         return false;
     }
 
 
+    // global geometry index -- for indexing in geom infos buffer
+    // local geometry index -- index of geometry in BLAS
+    if( localIndex )
+    {
+        geomInfoManager.WriteGeomInfo( frameIndex, uniqueID, *localIndex, geomFlags, geomInfo );
+    }
+
+    return true;
+}
+
+void RTGL1::VertexCollector::FlushPendingGeometries( uint32_t         frameIndex,
+                                                     GeomInfoManager& geomInfoManager )
+{
+    for( auto& f : filters )
+    {
+        const VertexCollectorFilterTypeFlags type = f.first;
+
+        f.second->FlushPendingGeometries(
+            [ & ]( uint64_t uniqueID, uint32_t localIndex, ShGeometryInstance& geomInfo ) {
+                geomInfoManager.WriteGeomInfo( frameIndex, uniqueID, localIndex, type, geomInfo );
+            } );
+    }
+}
+
+std::optional< RTGL1::VertexCollector::UploadedPrimitive > RTGL1::VertexCollector::
+    UploadPrimitive( bool isStatic, const RgMeshPrimitiveInfo& info )
+{
+    const bool     useIndices    = info.indexCount != 0 && info.pIndices != nullptr;
+    const uint32_t triangleCount = useIndices ? info.indexCount / 3 : info.vertexCount / 3;
+
+    // reserve ranges, each range start is aligned by 3
+    const uint32_t maxVertexCount = std::min(
+        isStatic ? MAX_STATIC_VERTEX_COUNT : MAX_DYNAMIC_VERTEX_COUNT, transientVertexLimit );
+
+    const auto vertIndex =
+        BumpAllocate( curVertexCount, AlignUpBy3( info.vertexCount ), maxVertexCount );
+    if( !vertIndex )
+    {
+        debug::Error( "Too many {} vertices: the limit is {}",
+                      isStatic ? "static" : "dynamic",
+                      maxVertexCount );
+        return std::nullopt;
+    }
+
+    const auto indIndex = BumpAllocate(
+        curIndexCount, AlignUpBy3( useIndices ? info.indexCount : 0 ), transientIndexLimit );
+    if( !indIndex )
+    {
+        debug::Error( "Too many indices: the limit is {}", transientIndexLimit );
+        return std::nullopt;
+    }
+
+    auto fnReserveTexCoords = [ & ]( uint32_t layer, std::atomic< uint32_t >& counter ) {
+        uint32_t count = GeomInfoManager::LayerExists( info, layer ) ? info.vertexCount : 0;
+        uint32_t limit = transientTexCoordLimit[ layer - 1 ];
+
+        // if buffer is not allocated, the error is reported on copying
+        if( count == 0 || limit == 0 )
+        {
+            return std::optional( counter.fetch_add( count, std::memory_order_relaxed ) );
+        }
+        return BumpAllocate( counter, count, limit );
+    };
+
+    const auto texcIndex_1 = fnReserveTexCoords( 1, curTexCoordCount_Layer1 );
+    const auto texcIndex_2 = fnReserveTexCoords( 2, curTexCoordCount_Layer2 );
+    const auto texcIndex_3 = fnReserveTexCoords( 3, curTexCoordCount_Layer3 );
+    if( !texcIndex_1 || !texcIndex_2 || !texcIndex_3 )
+    {
+        debug::Error( "Too many texture coordinates of additional layers" );
+        return std::nullopt;
+    }
+
+    curPrimitiveCount.fetch_add( triangleCount, std::memory_order_relaxed );
+
 
     // copy data to buffers
-    CopyVertexDataToStaging( info, vertIndex );
-    CopyTexCoordsToStaging( 1, info, texcIndex_1 );
-    CopyTexCoordsToStaging( 2, info, texcIndex_2 );
-    CopyTexCoordsToStaging( 3, info, texcIndex_3 );
+    CopyVertexDataToStaging( info, *vertIndex );
+    CopyTexCoordsToStaging( 1, info, *texcIndex_1 );
+    CopyTexCoordsToStaging( 2, info, *texcIndex_2 );
+    CopyTexCoordsToStaging( 3, info, *texcIndex_3 );
 
     if( useIndices )
     {
         assert( bufIndices.mapped );
-        memcpy(
-            &bufIndices.mapped[ indIndex ], info.pIndices, info.indexCount * sizeof( uint32_t ) );
+        VertexKernels::StreamCopy(
+            &bufIndices.mapped[ *indIndex ], info.pIndices, info.indexCount * sizeof( uint32_t ) );
     }
 
+    return UploadedPrimitive{
+        .vertIndex     = *vertIndex,
+        .vertexCount   = info.vertexCount,
+        .indIndex      = useIndices ? *indIndex : UINT32_MAX,
+        .indexCount    = useIndices ? info.indexCount : 0,
+        .triangleCount = triangleCount,
+        .texcIndex     = { *texcIndex_1, *texcIndex_2, *texcIndex_3 },
+    };
+}
+
+void RTGL1::VertexCollector::ReservePersistentRegion( float fraction )
+{
+    assert( curVertexCount == 0 && curIndexCount == 0 );
+    fraction = std::clamp( fraction, 0.0f, 1.0f );
+
+    auto fnSplit = [ fraction ]( uint32_t capacity, uint32_t& transientLimit ) {
+        // persistent ranges must be aligned by 3 too
+        transientLimit = std::min(
+            capacity, AlignUpBy3( uint32_t( double( capacity ) * ( 1.0 - double( fraction ) ) ) ) );
+        return RangeAllocator( transientLimit, capacity );
+    };
+
+    persistentVertices = fnSplit( bufVertices.GetCapacity() / vertexStride, transientVertexLimit );
+    persistentIndices  = fnSplit( bufIndices.GetCapacity(), transientIndexLimit );
+    persistentTexCoords[ 0 ] =
+        fnSplit( bufTexcoordLayer1.GetCapacity(), transientTexCoordLimit[ 0 ] );
+    persistentTexCoords[ 1 ] =
+        fnSplit( bufTexcoordLayer2.GetCapacity(), transientTexCoordLimit[ 1 ] );
+    persistentTexCoords[ 2 ] =
+        fnSplit( bufTexcoordLayer3.GetCapacity(), transientTexCoordLimit[ 2 ] );
+}
+
+std::optional< RTGL1::VertexCollector::UploadedPrimitive > RTGL1::VertexCollector::
+    UploadPersistentPrimitive( const RgMeshPrimitiveInfo& info )
+{
+    assert( info.vertexCount > 0 );
+    const bool useIndices = info.indexCount != 0 && info.pIndices != nullptr;
+
+    auto prim = UploadedPrimitive{
+        .vertIndex     = UINT32_MAX,
+        .vertexCount   = info.vertexCount,
+        .indIndex      = UINT32_MAX,
+        .indexCount    = useIndices ? info.indexCount : 0,
+        .triangleCount = useIndices ? info.indexCount / 3 : info.vertexCount / 3,
+        .texcIndex     = { UINT32_MAX, UINT32_MAX, UINT32_MAX },
+    };
+
+    bool allocated = true;
+
+    if( auto v = persistentVertices.Allocate( AlignUpBy3( info.vertexCount ) ) )
     {
-        static_assert( sizeof( parentMesh.transform ) == sizeof( VkTransformMatrixKHR ) );
-        assert( bufTransforms.mapped );
+        prim.vertIndex = *v;
+    }
+    else
+    {
+        allocated = false;
+    }
 
-        memcpy( &bufTransforms.mapped[ transformIndex ],
-                &parentMesh.transform,
-                sizeof( VkTransformMatrixKHR ) );
+    if( useIndices && allocated )
+    {
+        if( auto i = persistentIndices.Allocate( AlignUpBy3( info.indexCount ) ) )
+        {
+            prim.indIndex = *i;
+        }
+        else
+        {
+            allocated = false;
+        }
     }
 
+    for( uint32_t layer = 1; layer <= 3 && allocated; layer++ )
+    {
+        if( GeomInfoManager::LayerExists( info, layer ) && transientTexCoordLimit[ layer - 1 ] > 0 )
+        {
+            if( auto t = persistentTexCoords[ layer - 1 ].Allocate( info.vertexCount ) )
+            {
+                prim.texcIndex[ layer - 1 ] = *t;
+            }
+            else
+            {
+                allocated = false;
+            }
+        }
+    }
 
+    if( !allocated )
+    {
+        FreePersistentPrimitive( prim );
+        debug::Error( "Not enough space for persistent static geometry. "
+                      "Recheck \"staticSectorShare\" in the library config" );
+        return std::nullopt;
+    }
+
+    CopyVertexDataToStaging( info, prim.vertIndex );
+    for( uint32_t layer = 1; layer <= 3; layer++ )
+    {
+        if( prim.texcIndex[ layer - 1 ] != UINT32_MAX )
+        {
+            CopyTexCoordsToStaging( layer, info, prim.texcIndex[ layer - 1 ] );
+        }
+    }
+
+    if( useIndices )
+    {
+        assert( bufIndices.mapped );
+        VertexKernels::StreamCopy( &bufIndices.mapped[ prim.indIndex ],
+                                   info.pIndices,
+                                   info.indexCount * sizeof( uint32_t ) );
+    }
+
+    return prim;
+}
+
+void RTGL1::VertexCollector::FreePersistentPrimitive( const UploadedPrimitive& prim )
+{
+    if( prim.vertIndex != UINT32_MAX )
+    {
+        persistentVertices.Free( prim.vertIndex, AlignUpBy3( prim.vertexCount ) );
+    }
+
+    if( prim.indIndex != UINT32_MAX )
+    {
+        persistentIndices.Free( prim.indIndex, AlignUpBy3( prim.indexCount ) );
+    }
+
+    for( uint32_t i = 0; i < 3; i++ )
+    {
+        if( prim.texcIndex[ i ] != UINT32_MAX )
+        {
+            persistentTexCoords[ i ].Free( prim.texcIndex[ i ], prim.vertexCount );
+        }
+    }
+}
+
+void RTGL1::VertexCollector::CopyPersistentFromStaging( VkCommandBuffer                      cmd,
+                                                        std::span< const UploadedPrimitive > prims )
+{
+    std::vector< VkBufferCopy > vertCopies;
+    std::vector< VkBufferCopy > indCopies;
+    std::vector< VkBufferCopy > texcCopies[ 3 ];
+
+    auto fnRegion = []( uint32_t first, uint32_t count, VkDeviceSize elementSize ) {
+        return VkBufferCopy{
+            .srcOffset = first * elementSize,
+            .dstOffset = first * elementSize,
+            .size      = count * elementSize,
+        };
+    };
+
+    for( const UploadedPrimitive& p : prims )
+    {
+        vertCopies.push_back( fnRegion( p.vertIndex, p.vertexCount, vertexStride ) );
+
+        if( p.indIndex != UINT32_MAX )
+        {
+            indCopies.push_back( fnRegion( p.indIndex, p.indexCount, sizeof( uint32_t ) ) );
+        }
+
+        for( uint32_t i = 0; i < 3; i++ )
+        {
+            if( p.texcIndex[ i ] != UINT32_MAX )
+            {
+                texcCopies[ i ].push_back(
+                    fnRegion( p.texcIndex[ i ], p.vertexCount, sizeof( RgFloat2D ) ) );
+            }
+        }
+    }
+
+    std::array< VkBufferMemoryBarrier, 5 > barriers     = {};
+    uint32_t                               barrierCount = 0;
+
+    auto fnCopy = [ & ]( const auto& buf, const std::vector< VkBufferCopy >& regions ) {
+        if( regions.empty() )
+        {
+            return;
+        }
+
+        vkCmdCopyBuffer( cmd,
+                         buf.staging.GetBuffer(),
+                         buf.deviceLocal->GetBuffer(),
+                         uint32_t( regions.size() ),
+                         regions.data() );
+
+        barriers[ barrierCount++ ] = {
+            .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+            .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask       = VK_ACCESS_SHADER_READ_BIT,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer              = buf.deviceLocal->GetBuffer(),
+            .offset              = 0,
+            .size                = VK_WHOLE_SIZE,
+        };
+    };
+
+    fnCopy( bufVertices, vertCopies );
+    fnCopy( bufIndices, indCopies );
+    fnCopy( bufTexcoordLayer1, texcCopies[ 0 ] );
+    fnCopy( bufTexcoordLayer2, texcCopies[ 1 ] );
+    fnCopy( bufTexcoordLayer3, texcCopies[ 2 ] );
+
+    if( barrierCount > 0 )
+    {
+        vkCmdPipelineBarrier( cmd,
+                              VK_PIPELINE_STAGE_TRANSFER_BIT,
+                              VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                                  VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR |
+                                  VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                              0,
+                              0,
+                              nullptr,
+                              barrierCount,
+                              barriers.data(),
+                              0,
+                              nullptr );
+    }
+}
+
+VkAccelerationStructureGeometryKHR RTGL1::VertexCollector::MakeASGeometry(
+    const UploadedPrimitive&       prim,
+    VertexCollectorFilterTypeFlags geomFlags,
+    std::optional< uint32_t >      transformIndex ) const
+{
+    using FT = VertexCollectorFilterTypeFlagBits;
 
     VkAccelerationStructureGeometryKHR geom = {
         .sType        = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR,
@@ -248,54 +578,55 @@ bool RTGL1::VertexCollector::AddPrimitive( uint32_t                          fra
 
             .vertexFormat  = VK_FORMAT_R32G32B32_SFLOAT,
             .vertexData    = {
-                .deviceAddress = bufVertices.deviceLocal->GetAddress() + vertIndex * sizeof( ShVertex ) + offsetof( ShVertex, position ),
+                // position is the first member in both ShVertex and ShVertexCompact
+                .deviceAddress = bufVertices.deviceLocal->GetAddress() + VkDeviceSize( prim.vertIndex ) * vertexStride,
             },
-            .vertexStride  = sizeof( ShVertex ),
-            .maxVertex     = info.vertexCount,
+            .vertexStride  = vertexStride,
+            .maxVertex     = prim.vertexCount,
 
             .indexType     = VK_INDEX_TYPE_NONE_KHR,
             .indexData     = {},
 
-            .transformData = {
-                .deviceAddress = bufTransforms.deviceLocal->GetAddress() + transformIndex * sizeof( VkTransformMatrixKHR ),
-            },
+            // null address means identity
+            .transformData = {},
         };
 
-        if( useIndices )
+        if( transformIndex )
+        {
+            trData.transformData = {
+                .deviceAddress = bufTransforms.deviceLocal->GetAddress() +
+                                 *transformIndex * sizeof( VkTransformMatrixKHR ),
+            };
+        }
+
+        if( prim.indIndex != UINT32_MAX )
         {
             trData.indexType = VK_INDEX_TYPE_UINT32;
             trData.indexData = {
                 .deviceAddress =
-                    bufIndices.deviceLocal->GetAddress() + indIndex * sizeof( uint32_t ),
+                    bufIndices.deviceLocal->GetAddress() + prim.indIndex * sizeof( uint32_t ),
             };
         }
 
         geom.geometry.triangles = trData;
     }
 
+    return geom;
+}
 
-    uint32_t localIndex = PushGeometry( geomFlags, geom );
-
-
-    {
-        VkAccelerationStructureBuildRangeInfoKHR rangeInfo = {
-            .primitiveCount  = triangleCount,
-            .primitiveOffset = 0,
-            .firstVertex     = 0,
-            .transformOffset = 0,
-        };
-        PushRangeInfo( geomFlags, rangeInfo );
-
-        PushPrimitiveCount( geomFlags, triangleCount );
-    }
-
-
+RTGL1::ShGeometryInstance RTGL1::VertexCollector::MakeGeomInfo(
+    const RgTransform&                transform,
+    const RgMeshPrimitiveInfo&        info,
+    const UploadedPrimitive&          prim,
+    std::span< MaterialTextures, 4 >  layerTextures,
+    std::span< RgColor4DPacked32, 4 > layerColors )
+{
     const RgEditorPBRInfo* pbrInfo = ( info.pEditorInfo && info.pEditorInfo->pbrInfoExists )
                                          ? &info.pEditorInfo->pbrInfo
                                          : nullptr;
 
-    ShGeometryInstance geomInfo = {
-        .model     = RG_MATRIX_TRANSPOSED( parentMesh.transform ),
+    return ShGeometryInstance{
+        .model     = RG_MATRIX_TRANSPOSED( transform ),
         .prevModel = { /* set later */ },
 
         .flags = GeomInfoManager::GetPrimitiveFlags( info ),
@@ -315,12 +646,12 @@ bool RTGL1::VertexCollector::AddPrimitive( uint32_t                          fra
         .colorFactor_layer2 = layerColors[ 2 ],
         .colorFactor_layer3 = layerColors[ 3 ],
 
-        .baseVertexIndex     = vertIndex,
-        .baseIndexIndex      = useIndices ? indIndex : UINT32_MAX,
+        .baseVertexIndex     = prim.vertIndex,
+        .baseIndexIndex      = prim.indIndex,
         .prevBaseVertexIndex = { /* set later */ },
         .prevBaseIndexIndex  = { /* set later */ },
-        .vertexCount         = info.vertexCount,
-        .indexCount          = useIndices ? info.indexCount : UINT32_MAX,
+        .vertexCount         = prim.vertexCount,
+        .indexCount          = prim.indIndex != UINT32_MAX ? prim.indexCount : UINT32_MAX,
 
         .roughnessDefault = pbrInfo ? Utils::Saturate( pbrInfo->roughnessDefault ) : 1.0f,
         .metallicDefault  = pbrInfo ? Utils::Saturate( pbrInfo->metallicDefault ) : 0.0f,
@@ -328,26 +659,27 @@ bool RTGL1::VertexCollector::AddPrimitive( uint32_t                          fra
         .emissiveMult = Utils::Saturate( info.emissive ),
 
         // values ignored if doesn't exist
-        .firstVertex_Layer1 = texcIndex_1,
-        .firstVertex_Layer2 = texcIndex_2,
-        .firstVertex_Layer3 = texcIndex_3,
+        .firstVertex_Layer1 = prim.texcIndex[ 0 ],
+        .firstVertex_Layer2 = prim.texcIndex[ 1 ],
+        .firstVertex_Layer3 = prim.texcIndex[ 2 ],
     };
-
-
-    // global geometry index -- for indexing in geom infos buffer
-    // local geometry index -- index of geometry in BLAS
-    geomInfoManager.WriteGeomInfo( frameIndex, uniqueID, localIndex, geomFlags, geomInfo );
-
-    return true;
 }
 
 void RTGL1::VertexCollector::CopyVertexDataToStaging( const RgMeshPrimitiveInfo& info,
                                                       uint32_t                   vertIndex )
 {
     assert( bufVertices.mapped );
-    assert( ( vertIndex + info.vertexCount ) * sizeof( ShVertex ) < bufVertices.staging.GetSize() );
+    assert( VkDeviceSize( vertIndex + info.vertexCount ) * vertexStride <=
+            bufVertices.staging.GetSize() );
 
-    ShVertex* const pDst = &bufVertices.mapped[ vertIndex ];
+    uint8_t* const pDst = &bufVertices.mapped[ VkDeviceSize( vertIndex ) * vertexStride ];
+
+    if( AreVerticesCompact() )
+    {
+        VertexKernels::PackCompact(
+            reinterpret_cast< ShVertexCompact* >( pDst ), info.pVertices, info.vertexCount );
+        return;
+    }
 
     // must be same to copy
     static_assert( std::is_same_v< decltype( info.pVertices ), const RgPrimitiveVertex* > );
@@ -358,7 +690,7 @@ void RTGL1::VertexCollector::CopyVertexDataToStaging( const RgMeshPrimitiveInfo&
     static_assert( offsetof( ShVertex, texCoord ) == offsetof( RgPrimitiveVertex, texCoord ) );
     static_assert( offsetof( ShVertex, color ) == offsetof( RgPrimitiveVertex, color ) );
 
-    memcpy( pDst, info.pVertices, info.vertexCount * sizeof( ShVertex ) );
+    VertexKernels::StreamCopy( pDst, info.pVertices, info.vertexCount * sizeof( ShVertex ) );
 }
 
 void RTGL1::VertexCollector::CopyTexCoordsToStaging( uint32_t                   layerIndex,
@@ -378,7 +710,8 @@ void RTGL1::VertexCollector::CopyTexCoordsToStaging( uint32_t
     {
         if( txc->IsInitialized() && txc->mapped )
         {
-            memcpy( &txc->mapped[ dstTexcoordIndex ], src, info.vertexCount * sizeof( RgFloat2D ) );
+            VertexKernels::StreamCopy(
+                &txc->mapped[ dstTexcoordIndex ], src, info.vertexCount * sizeof( RgFloat2D ) );
         }
         else
         {
@@ -420,7 +753,7 @@ bool RTGL1::VertexCollector::CopyVertexDataFromStaging( VkCommandBuffer cmd )
     VkBufferCopy info = {
         .srcOffset = 0,
         .dstOffset = 0,
-        .size      = curVertexCount * sizeof( ShVertex ),
+        .size      = VkDeviceSize( curVertexCount ) * vertexStride,
     };
 
     vkCmdCopyBuffer(
@@ -539,7 +872,7 @@ bool RTGL1::VertexCollector::CopyFromStaging( VkCommandBuffer cmd )
                 .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                 .buffer              = bufVertices.deviceLocal->GetBuffer(),
                 .offset              = 0,
-                .size                = curVertexCount * sizeof( ShVertex ),
+                .size                = VkDeviceSize( curVertexCount ) * vertexStride,
             };
             copiedAny = true;
         }
@@ -706,6 +1039,14 @@ const std::vector< VkAccelerationStructureBuildRangeInfoKHR >& RTGL1::VertexColl
     return f->second->GetASBuildRangeInfos();
 }
 
+uint64_t RTGL1::VertexCollector::GetTopologyHash( VertexCollectorFilterTypeFlags filter ) const
+{
+    auto f = filters.find( filter );
+    assert( f != filters.end() );
+
+    return f->second->GetTopologyHash();
+}
+
 bool RTGL1::VertexCollector::AreGeometriesEmpty( VertexCollectorFilterTypeFlags flags ) const
 {
     for( const auto& p : filters )
@@ -749,7 +1090,7 @@ void RTGL1::VertexCollector::InsertVertexPreprocessFinishBarrier( VkCommandBuffe
             .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
             .buffer              = bufVertices.deviceLocal->GetBuffer(),
             .offset              = 0,
-            .size                = curVertexCount * sizeof( ShVertex ),
+            .size                = VkDeviceSize( curVertexCount ) * vertexStride,
         };
     }
 
@@ -786,28 +1127,55 @@ void RTGL1::VertexCollector::InsertVertexPreprocessFinishBarrier( VkCommandBuffe
                           nullptr );
 }
 
-uint32_t RTGL1::VertexCollector::PushGeometry( VertexCollectorFilterTypeFlags            type,
-                                               const VkAccelerationStructureGeometryKHR& geom )
+namespace
 {
-    assert( filters.find( type ) != filters.end() );
-
-    return filters[ type ]->PushGeometry( type, geom );
+VkAccelerationStructureBuildRangeInfoKHR MakeBuildRangeInfo(
+    const RTGL1::VertexCollector::UploadedPrimitive& prim )
+{
+    return VkAccelerationStructureBuildRangeInfoKHR{
+        .primitiveCount  = prim.triangleCount,
+        .primitiveOffset = 0,
+        .firstVertex     = 0,
+        .transformOffset = 0,
+    };
+}
 }
 
-void RTGL1::VertexCollector::PushPrimitiveCount( VertexCollectorFilterTypeFlags type,
-                                                 uint32_t                       primCount )
+std::optional< uint32_t > RTGL1::VertexCollector::PushGeometry(
+    VertexCollectorFilterTypeFlags                 type,
+    const VertexCollectorFilter::MakeGeometryFunc& makeGeometry,
+    uint64_t                                       uniqueID,
+    const UploadedPrimitive&                       prim )
 {
-    assert( filters.find( type ) != filters.end() );
+    // filters map is not modified after creation, so lookup is safe from multiple threads
+    auto f = filters.find( type );
+    assert( f != filters.end() );
 
-    filters[ type ]->PushPrimitiveCount( type, primCount );
+    return f->second->PushGeometry( type,
+                                    makeGeometry,
+                                    MakeBuildRangeInfo( prim ),
+                                    uniqueID,
+                                    prim.vertexCount,
+                                    prim.indexCount );
 }
 
-void RTGL1::VertexCollector::PushRangeInfo(
-    VertexCollectorFilterTypeFlags type, const VkAccelerationStructureBuildRangeInfoKHR& rangeInfo )
+bool RTGL1::VertexCollector::AddPendingGeometry(
+    VertexCollectorFilterTypeFlags                 type,
+    const VertexCollectorFilter::MakeGeometryFunc& makeGeometry,
+    uint64_t                                       uniqueID,
+    const UploadedPrimitive&                       prim,
+    const ShGeometryInstance&                      geomInfo )
 {
-    assert( filters.find( type ) != filters.end() );
+    auto f = filters.find( type );
+    assert( f != filters.end() );
 
-    filters[ type ]->PushRangeInfo( type, rangeInfo );
+    return f->second->AddPendingGeometry( type,
+                                          makeGeometry,
+                                          MakeBuildRangeInfo( prim ),
+                                          uniqueID,
+                                          prim.vertexCount,
+                                          prim.indexCount,
+                                          geomInfo );
 }
 
 uint32_t RTGL1::VertexCollector::GetGeometryCount( VertexCollectorFilterTypeFlags type )
@@ -839,6 +1207,11 @@ uint32_t RTGL1::VertexCollector::GetCurrentIndexCount() const
     return curIndexCount;
 }
 
+bool RTGL1::VertexCollector::AreVerticesCompact() const
+{
+    return vertexStride == sizeof( ShVertexCompact );
+}
+
 void RTGL1::VertexCollector::AddFilter( VertexCollectorFilterTypeFlags filterGroup )
 {
     if( filterGroup == ( VertexCollectorFilterTypeFlags )0 )
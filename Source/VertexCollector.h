@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <optional>
 #include <span>
 #include <vector>
@@ -27,6 +28,7 @@
 #include "Buffer.h"
 #include "Common.h"
 #include "Material.h"
+#include "RangeAllocator.h"
 #include "VertexCollectorFilter.h"
 #include "RTGL1/RTGL1.h"
 
@@ -34,19 +36,24 @@ namespace RTGL1
 {
 
 struct ShVertex;
+struct ShGeometryInstance;
 
 class GeomInfoManager;
 
 // The class collects vertex data to buffers with shader struct types.
 // Geometries are passed to the class by chunks and the result of collecting
 // is a vertex buffer with ready data and infos for acceleration structure creation/building.
+// AddPrimitive can be called from multiple threads: ranges in the staging buffers
+// are reserved with atomic counters, and the data is copied without a lock.
+// Dynamic geometries are ordered only in FlushPendingGeometries.
 class VertexCollector
 {
 public:
     explicit VertexCollector( VkDevice         device,
                               MemoryAllocator& allocator,
                               const uint32_t ( &maxVertsPerLayer )[ 4 ],
-                              VertexCollectorFilterTypeFlags filters );
+                              VertexCollectorFilterTypeFlags filters,
+                              bool                           compactVertices = false );
 
     // Create new vertex collector, but with shared device local buffers
     explicit VertexCollector( const VertexCollector& src, MemoryAllocator& allocator );
@@ -68,6 +75,55 @@ public:
                        std::span< RgColor4DPacked32, 4 > layerColors,
                        GeomInfoManager&                  geomInfoManager );
 
+    // Assign local indices to the dynamic geometries, sorted by their unique IDs,
+    // and write their geometry infos. Must be called before building the BLAS-es.
+    void FlushPendingGeometries( uint32_t frameIndex, GeomInfoManager& geomInfoManager );
+
+
+    // Location of a primitive's data in the buffers of this collector
+    struct UploadedPrimitive
+    {
+        uint32_t vertIndex;
+        uint32_t vertexCount;
+        // UINT32_MAX, if primitive doesn't have indices
+        uint32_t indIndex;
+        uint32_t indexCount;
+        uint32_t triangleCount;
+        // for layers 1, 2, 3
+        uint32_t texcIndex[ 3 ];
+    };
+
+    // Copy only vertex, index and texture coordinates data to the staging buffers.
+    // Null, if limits are exceeded.
+    std::optional< UploadedPrimitive > UploadPrimitive( bool                       isStatic,
+                                                        const RgMeshPrimitiveInfo& info );
+
+    // If transformIndex is null, geometry is not transformed inside of a BLAS
+    VkAccelerationStructureGeometryKHR MakeASGeometry(
+        const UploadedPrimitive&       prim,
+        VertexCollectorFilterTypeFlags geomFlags,
+        std::optional< uint32_t >      transformIndex ) const;
+
+    // Reserve the tail of each buffer for the persistent primitives.
+    // Must be called before any upload.
+    void ReservePersistentRegion( float fraction );
+
+    // Same as UploadPrimitive, but the ranges are allocated in the reserved tail,
+    // so they are not affected by Reset, and must be freed by FreePersistentPrimitive.
+    // Not thread-safe. Texture coordinate index is UINT32_MAX, if there's no such layer.
+    std::optional< UploadedPrimitive > UploadPersistentPrimitive( const RgMeshPrimitiveInfo& info );
+    void FreePersistentPrimitive( const UploadedPrimitive& prim );
+    // Copy data of the persistent primitives from staging, and set barrier for the AS build
+    void CopyPersistentFromStaging( VkCommandBuffer                      cmd,
+                                    std::span< const UploadedPrimitive > prims );
+
+
+    static ShGeometryInstance MakeGeomInfo( const RgTransform&                transform,
+                                            const RgMeshPrimitiveInfo&        info,
+                                            const UploadedPrimitive&          prim,
+                                            std::span< MaterialTextures, 4 >  layerTextures,
+                                            std::span< RgColor4DPacked32, 4 > layerColors );
+
 
     // Clear data that was generated while collecting.
     // Should be called when blasGeometries is not needed anymore
@@ -84,6 +140,8 @@ public:
     VkBuffer GetIndexBuffer() const;
     uint32_t GetCurrentVertexCount() const;
     uint32_t GetCurrentIndexCount() const;
+    // True, if vertices are stored as ShVertexCompact instead of ShVertex
+    bool     AreVerticesCompact() const;
 
 
     // Get primitive counts from filters. Null if corresponding filter wasn't found.
@@ -98,6 +156,9 @@ public:
     const std::vector< VkAccelerationStructureBuildRangeInfoKHR >& GetASBuildRangeInfos(
         VertexCollectorFilterTypeFlags filter ) const;
 
+    // Get hash of geometry unique IDs and vertex / index counts of a filter.
+    uint64_t GetTopologyHash( VertexCollectorFilterTypeFlags filter ) const;
+
 
     // Are all geometries for each filter type in "flags" empty?
     bool AreGeometriesEmpty( VertexCollectorFilterTypeFlags flags ) const;
@@ -127,11 +188,16 @@ private:
     void InitFilters( VertexCollectorFilterTypeFlags flags );
 
     void     AddFilter( VertexCollectorFilterTypeFlags filterGroup );
-    uint32_t PushGeometry( VertexCollectorFilterTypeFlags            type,
-                           const VkAccelerationStructureGeometryKHR& geom );
-    void     PushPrimitiveCount( VertexCollectorFilterTypeFlags type, uint32_t primCount );
-    void     PushRangeInfo( VertexCollectorFilterTypeFlags                  type,
-                            const VkAccelerationStructureBuildRangeInfoKHR& rangeInfo );
+    std::optional< uint32_t > PushGeometry(
+        VertexCollectorFilterTypeFlags                 type,
+        const VertexCollectorFilter::MakeGeometryFunc& makeGeometry,
+        uint64_t                                       uniqueID,
+        const UploadedPrimitive&                       prim );
+    bool AddPendingGeometry( VertexCollectorFilterTypeFlags                 type,
+                             const VertexCollectorFilter::MakeGeometryFunc& makeGeometry,
+                             uint64_t                                       uniqueID,
+                             const UploadedPrimitive&                       prim,
+                             const ShGeometryInstance&                      geomInfo );
 
     uint32_t GetGeometryCount( VertexCollectorFilterTypeFlags type );
     uint32_t GetAllGeometryCount() const;
@@ -139,6 +205,8 @@ private:
 private:
     VkDevice                       device;
     VertexCollectorFilterTypeFlags filtersFlags;
+    // sizeof( ShVertex ) or sizeof( ShVertexCompact )
+    uint32_t                       vertexStride;
 
 
     template< typename T >
@@ -196,6 +264,11 @@ private:
 
         [[nodiscard]] bool IsInitialized() const { return deviceLocal != nullptr; }
 
+        [[nodiscard]] uint32_t GetCapacity() const
+        {
+            return IsInitialized() ? uint32_t( deviceLocal->GetSize() / sizeof( T ) ) : 0;
+        }
+
         ~SharedDeviceLocal()
         {
             if( IsInitialized() )
@@ -215,20 +288,30 @@ private:
     };
 
 
-    SharedDeviceLocal< ShVertex >             bufVertices;
+    // raw bytes, as the layout depends on vertexStride
+    SharedDeviceLocal< uint8_t >              bufVertices;
     SharedDeviceLocal< uint32_t >             bufIndices;
     SharedDeviceLocal< VkTransformMatrixKHR > bufTransforms;
     SharedDeviceLocal< RgFloat2D >            bufTexcoordLayer1;
     SharedDeviceLocal< RgFloat2D >            bufTexcoordLayer2;
     SharedDeviceLocal< RgFloat2D >            bufTexcoordLayer3;
 
-    uint32_t curVertexCount{ 0 };
-    uint32_t curIndexCount{ 0 };
-    uint32_t curPrimitiveCount{ 0 };
-    uint32_t curTransformCount{ 0 };
-    uint32_t curTexCoordCount_Layer1{ 0 };
-    uint32_t curTexCoordCount_Layer2{ 0 };
-    uint32_t curTexCoordCount_Layer3{ 0 };
+    std::atomic< uint32_t > curVertexCount{ 0 };
+    std::atomic< uint32_t > curIndexCount{ 0 };
+    std::atomic< uint32_t > curPrimitiveCount{ 0 };
+    std::atomic< uint32_t > curTransformCount{ 0 };
+    std::atomic< uint32_t > curTexCoordCount_Layer1{ 0 };
+    std::atomic< uint32_t > curTexCoordCount_Layer2{ 0 };
+    std::atomic< uint32_t > curTexCoordCount_Layer3{ 0 };
+
+    // elements starting from these are reserved for the persistent primitives
+    uint32_t transientVertexLimit{ 0 };
+    uint32_t transientIndexLimit{ 0 };
+    uint32_t transientTexCoordLimit[ 3 ]{};
+
+    RangeAllocator persistentVertices;
+    RangeAllocator persistentIndices;
+    RangeAllocator persistentTexCoords[ 3 ];
 
     rgl::unordered_map< VertexCollectorFilterTypeFlags, std::shared_ptr< VertexCollectorFilter > >
         filters;
@@ -22,10 +22,24 @@
 
 #include "RgException.h"
 
+#include "Generated/ShaderCommonC.h"
+
+#include <algorithm>
+#include <functional>
+
 using namespace RTGL1;
 
+namespace
+{
+template< class T >
+void HashCombine( uint64_t& seed, const T& v )
+{
+    seed ^= std::hash< T >{}( v ) + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+}
+}
+
 VertexCollectorFilter::VertexCollectorFilter( VertexCollectorFilterTypeFlags _filter )
-    : filter( _filter )
+    : filter( _filter ), topologyHash( 0 )
 {
 }
 
@@ -53,33 +67,117 @@ void VertexCollectorFilter::Reset()
     asGeometries.clear();
     primitiveCounts.clear();
     asBuildRangeInfos.clear();
+    pendingGeometries.clear();
+    topologyHash = 0;
 }
 
-uint32_t VertexCollectorFilter::PushGeometry( VertexCollectorFilterTypeFlags            type,
-                                              const VkAccelerationStructureGeometryKHR& geom )
+bool VertexCollectorFilter::IsFull( VertexCollectorFilterTypeFlags type ) const
 {
-    assert( ( type & filter ) == filter );
+    // pending geometries will take their local indices on flush
+    const auto count = static_cast< uint32_t >( asGeometries.size() + pendingGeometries.size() );
 
-    uint32_t localIndex = ( uint32_t )asGeometries.size();
+    return count + 1 >= VertexCollectorFilterTypeFlags_GetAmountInGlobalArray( type ) ||
+           count + 1 >= MAX_BOTTOM_LEVEL_GEOMETRIES_COUNT;
+}
+
+void VertexCollectorFilter::Append( const VkAccelerationStructureGeometryKHR&       geom,
+                                    const VkAccelerationStructureBuildRangeInfoKHR& rangeInfo,
+                                    uint64_t                                        uniqueID,
+                                    uint32_t                                        vertexCount,
+                                    uint32_t                                        indexCount )
+{
     asGeometries.push_back( geom );
+    asBuildRangeInfos.push_back( rangeInfo );
+    primitiveCounts.push_back( rangeInfo.primitiveCount );
+
+    HashCombine( topologyHash, uniqueID );
+    HashCombine( topologyHash, vertexCount );
+    HashCombine( topologyHash, indexCount );
+}
+
+std::optional< uint32_t > VertexCollectorFilter::PushGeometry(
+    VertexCollectorFilterTypeFlags                  type,
+    const MakeGeometryFunc&                         makeGeometry,
+    const VkAccelerationStructureBuildRangeInfoKHR& rangeInfo,
+    uint64_t                                        uniqueID,
+    uint32_t                                        vertexCount,
+    uint32_t                                        indexCount )
+{
+    assert( ( type & filter ) == filter );
+
+    // all arrays must be modified together, as the geometry index is shared between them
+    auto lock = std::lock_guard( mutex );
+
+    if( IsFull( type ) )
+    {
+        return std::nullopt;
+    }
 
-    assert( localIndex < VertexCollectorFilterTypeFlags_GetAmountInGlobalArray( type ) );
+    auto geom = makeGeometry();
+    if( !geom )
+    {
+        return std::nullopt;
+    }
+
+    auto localIndex = static_cast< uint32_t >( asGeometries.size() );
+    Append( *geom, rangeInfo, uniqueID, vertexCount, indexCount );
 
     return localIndex;
 }
 
-void VertexCollectorFilter::PushPrimitiveCount( VertexCollectorFilterTypeFlags type,
-                                                uint32_t                       primCount )
+bool VertexCollectorFilter::AddPendingGeometry(
+    VertexCollectorFilterTypeFlags                  type,
+    const MakeGeometryFunc&                         makeGeometry,
+    const VkAccelerationStructureBuildRangeInfoKHR& rangeInfo,
+    uint64_t                                        uniqueID,
+    uint32_t                                        vertexCount,
+    uint32_t                                        indexCount,
+    const ShGeometryInstance&                       geomInfo )
 {
     assert( ( type & filter ) == filter );
-    primitiveCounts.push_back( primCount );
+
+    auto lock = std::lock_guard( mutex );
+
+    if( IsFull( type ) )
+    {
+        return false;
+    }
+
+    auto geom = makeGeometry();
+    if( !geom )
+    {
+        return false;
+    }
+
+    pendingGeometries.push_back( PendingGeometry{
+        .uniqueID    = uniqueID,
+        .geom        = *geom,
+        .rangeInfo   = rangeInfo,
+        .vertexCount = vertexCount,
+        .indexCount  = indexCount,
+        .geomInfo    = geomInfo,
+    } );
+
+    return true;
 }
 
-void VertexCollectorFilter::PushRangeInfo(
-    VertexCollectorFilterTypeFlags type, const VkAccelerationStructureBuildRangeInfoKHR& rangeInfo )
+void VertexCollectorFilter::FlushPendingGeometries( const OnFlushFunc& onFlush )
 {
-    assert( ( type & filter ) == filter );
-    asBuildRangeInfos.push_back( rangeInfo );
+    auto lock = std::lock_guard( mutex );
+
+    // the order of AddPendingGeometry calls is not deterministic, if they are
+    // called from multiple threads; but BLAS refit requires the same geometry order
+    std::ranges::stable_sort( pendingGeometries, {}, &PendingGeometry::uniqueID );
+
+    for( auto& p : pendingGeometries )
+    {
+        auto localIndex = static_cast< uint32_t >( asGeometries.size() );
+        Append( p.geom, p.rangeInfo, p.uniqueID, p.vertexCount, p.indexCount );
+
+        onFlush( p.uniqueID, localIndex, p.geomInfo );
+    }
+
+    pendingGeometries.clear();
 }
 
 VertexCollectorFilterTypeFlags VertexCollectorFilter::GetFilter() const
@@ -91,3 +189,8 @@ uint32_t VertexCollectorFilter::GetGeometryCount() const
 {
     return ( uint32_t )asGeometries.size();
 }
+
+uint64_t VertexCollectorFilter::GetTopologyHash() const
+{
+    return topologyHash;
+}
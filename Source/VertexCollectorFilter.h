@@ -20,10 +20,14 @@
 
 #pragma once
 
+#include <functional>
+#include <mutex>
+#include <optional>
 #include <vector>
 
 #include "Common.h"
 #include "VertexCollectorFilterType.h"
+#include "Generated/ShaderCommonC.h"
 
 namespace RTGL1
 {
@@ -47,21 +51,76 @@ public:
 
     void Reset();
 
-    uint32_t PushGeometry( VertexCollectorFilterTypeFlags            type,
-                           const VkAccelerationStructureGeometryKHR& geom );
-    void     PushPrimitiveCount( VertexCollectorFilterTypeFlags type, uint32_t primCount );
-    void     PushRangeInfo( VertexCollectorFilterTypeFlags                  type,
-                            const VkAccelerationStructureBuildRangeInfoKHR& rangeInfo );
+    // Called only if the filter has space for a geometry, so the resources that
+    // the geometry refers to are not reserved in vain. If null, the geometry is not added
+    using MakeGeometryFunc = std::function< std::optional< VkAccelerationStructureGeometryKHR >() >;
+
+    // Thread-safe. Returns local index of the geometry, or null if the filter is full
+    // or makeGeometry has failed.
+    std::optional< uint32_t > PushGeometry(
+        VertexCollectorFilterTypeFlags                  type,
+        const MakeGeometryFunc&                         makeGeometry,
+        const VkAccelerationStructureBuildRangeInfoKHR& rangeInfo,
+        uint64_t                                        uniqueID,
+        uint32_t                                        vertexCount,
+        uint32_t                                        indexCount );
+
+    // Thread-safe. Same as PushGeometry, but the local index is assigned only
+    // in FlushPendingGeometries, so it doesn't depend on the order of the calls.
+    // Returns false, if the filter is full or makeGeometry has failed.
+    bool AddPendingGeometry( VertexCollectorFilterTypeFlags                  type,
+                             const MakeGeometryFunc&                         makeGeometry,
+                             const VkAccelerationStructureBuildRangeInfoKHR& rangeInfo,
+                             uint64_t                                        uniqueID,
+                             uint32_t                                        vertexCount,
+                             uint32_t                                        indexCount,
+                             const ShGeometryInstance&                       geomInfo );
+
+    using OnFlushFunc =
+        std::function< void( uint64_t uniqueID, uint32_t localIndex, ShGeometryInstance& ) >;
+
+    // Push pending geometries sorted by their unique IDs, and call onFlush for each of them.
+    void FlushPendingGeometries( const OnFlushFunc& onFlush );
 
     VertexCollectorFilterTypeFlags GetFilter() const;
     uint32_t                       GetGeometryCount() const;
+    // Hash of the geometry sequence, where each geometry is identified
+    // by its unique ID and vertex / index counts. If two builds have the same
+    // topology hash, then the BLAS can be updated instead of rebuilding.
+    // Pending geometries are flushed in a sorted order, so the hash is stable
+    // even if they were added from multiple threads.
+    uint64_t                       GetTopologyHash() const;
+
+private:
+    bool IsFull( VertexCollectorFilterTypeFlags type ) const;
+    void Append( const VkAccelerationStructureGeometryKHR&       geom,
+                 const VkAccelerationStructureBuildRangeInfoKHR& rangeInfo,
+                 uint64_t                                        uniqueID,
+                 uint32_t                                        vertexCount,
+                 uint32_t                                        indexCount );
 
 private:
+    struct PendingGeometry
+    {
+        uint64_t                                 uniqueID;
+        VkAccelerationStructureGeometryKHR       geom;
+        VkAccelerationStructureBuildRangeInfoKHR rangeInfo;
+        uint32_t                                 vertexCount;
+        uint32_t                                 indexCount;
+        ShGeometryInstance                       geomInfo;
+    };
+
     VertexCollectorFilterTypeFlags filter;
 
     std::vector< uint32_t >                                 primitiveCounts;
     std::vector< VkAccelerationStructureGeometryKHR >       asGeometries;
     std::vector< VkAccelerationStructureBuildRangeInfoKHR > asBuildRangeInfos;
+
+    std::vector< PendingGeometry > pendingGeometries;
+
+    uint64_t topologyHash;
+
+    std::mutex mutex;
 };
 
 }
\ No newline at end of file
@@ -26,17 +26,14 @@
 #include "Const.h"
 #include "Generated/ShaderCommonC.h"
 
-static_assert( MAX_TOP_LEVEL_INSTANCE_COUNT ==
-                   std::size( RTGL1::VertexCollectorFilterGroup_ChangeFrequency ) *
-                       std::size( RTGL1::VertexCollectorFilterGroup_PassThrough ) *
-                       std::size( RTGL1::VertexCollectorFilterGroup_PrimaryVisibility ),
-               "It's recommended for MAX_TOP_LEVEL_INSTANCE_COUNT to be such value" );
+static_assert( MAX_TOP_LEVEL_INSTANCE_COUNT >= RTGL1::VERTEX_COLLECTOR_FILTER_GROUP_COUNT,
+               "Each filter group must be able to have at least one TLAS instance" );
 
 using FlagToIndexType = uint8_t;
 constexpr uint32_t FlagToIndexTypeMaxValue =
     1 << ( 8 /* bits per byte */ * sizeof( FlagToIndexType ) );
 
-static_assert( MAX_TOP_LEVEL_INSTANCE_COUNT < FlagToIndexTypeMaxValue );
+static_assert( RTGL1::VERTEX_COLLECTOR_FILTER_GROUP_COUNT < FlagToIndexTypeMaxValue );
 
 // file scope typedefs
 using FT = RTGL1::VertexCollectorFilterTypeFlagBits;
@@ -77,7 +74,7 @@ void RTGL1::VertexCollectorFilterTypeFlags_Init()
                 assert( pt > 0 && pt <= MAX_FLAG_VALUE_PT );
                 assert( pv > 0 && pv <= MAX_FLAG_VALUE_PV );
 
-                assert( index < MAX_TOP_LEVEL_INSTANCE_COUNT );
+                assert( index < VERTEX_COLLECTOR_FILTER_GROUP_COUNT );
                 assert( index < FlagToIndexTypeMaxValue );
 
                 // flags bits start with 1, not 0
@@ -97,8 +94,17 @@ void RTGL1::VertexCollectorFilterTypeFlags_Init()
 
                 assert( LOWER_BOTTOM_LEVEL_GEOMETRIES_COUNT < MAX_BOTTOM_LEVEL_GEOMETRIES_COUNT );
 
-                uint32_t count = hasLowerAmount ? LOWER_BOTTOM_LEVEL_GEOMETRIES_COUNT
-                                                : MAX_BOTTOM_LEVEL_GEOMETRIES_COUNT;
+                // static world geometry also contains geometry infos of instanced meshes
+                bool hasHigherAmount =
+                    !hasLowerAmount &&
+                    ( flcf & VertexCollectorFilterTypeFlagBits::CF_STATIC_NON_MOVABLE );
+
+                assert( MAX_STATIC_BOTTOM_LEVEL_GEOMETRIES_COUNT >=
+                        MAX_BOTTOM_LEVEL_GEOMETRIES_COUNT );
+
+                uint32_t count = hasLowerAmount    ? LOWER_BOTTOM_LEVEL_GEOMETRIES_COUNT
+                                 : hasHigherAmount ? MAX_STATIC_BOTTOM_LEVEL_GEOMETRIES_COUNT
+                                                   : MAX_BOTTOM_LEVEL_GEOMETRIES_COUNT;
 
                 AmountInGlobalArray[ cf ][ pt ][ pv ] = count;
                 OffsetInGlobalArray[ cf ][ pt ][ pv ] = AllBottomLevelGeomsCount;
@@ -129,7 +135,7 @@ static void GetIndices( RTGL1::VertexCollectorFilterTypeFlags flags,
     pt--;
     pv--;
 
-    assert( FlagToIndex[ cf ][ pt ][ pv ] < MAX_TOP_LEVEL_INSTANCE_COUNT );
+    assert( FlagToIndex[ cf ][ pt ][ pv ] < RTGL1::VERTEX_COLLECTOR_FILTER_GROUP_COUNT );
 }
 
 uint32_t RTGL1::VertexCollectorFilterTypeFlags_GetID( VertexCollectorFilterTypeFlags flags )
@@ -23,6 +23,7 @@
 #include "RTGL1/RTGL1.h"
 
 #include <functional>
+#include <iterator>
 
 namespace RTGL1
 {
@@ -75,6 +76,12 @@ constexpr VertexCollectorFilterTypeFlagBits VertexCollectorFilterGroup_PrimaryVi
     VertexCollectorFilterTypeFlagBits::PV_FIRST_PERSON_VIEWER,
 };
 
+// Amount of all possible filter combinations, i.e. max amount of BLAS groups
+constexpr uint32_t VERTEX_COLLECTOR_FILTER_GROUP_COUNT =
+    std::size( VertexCollectorFilterGroup_ChangeFrequency ) *
+    std::size( VertexCollectorFilterGroup_PassThrough ) *
+    std::size( VertexCollectorFilterGroup_PrimaryVisibility );
+
 
 inline VertexCollectorFilterTypeFlags operator|( VertexCollectorFilterTypeFlagBits a, VertexCollectorFilterTypeFlagBits b )
 {
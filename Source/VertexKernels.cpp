@@ -0,0 +1,328 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "VertexKernels.h"
+#include "VertexKernels_Impl.h"
+
+#include "Generated/ShaderCommonC.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if RG_VERTEX_KERNELS_X86 && defined( _MSC_VER )
+    #include <intrin.h>
+#endif
+
+namespace
+{
+
+uint32_t PackSnorm16( float v )
+{
+    // default rounding mode is to nearest even, same as in SIMD conversions
+    v = std::clamp( v, -1.0f, 1.0f );
+    return uint32_t( int16_t( std::nearbyint( v * 32767.0f ) ) ) & 0xFFFF;
+}
+
+void StreamCopy_Scalar( void* dst, const void* src, size_t size )
+{
+    memcpy( dst, src, size );
+}
+
+void PackCompact_Scalar( RTGL1::ShVertexCompact* dst, const RgPrimitiveVertex* src, uint32_t count )
+{
+    using namespace RTGL1::VertexKernels::detail;
+
+    for( uint32_t i = 0; i < count; i++ )
+    {
+        const RgPrimitiveVertex& v = src[ i ];
+
+        RTGL1::ShVertexCompact c = {
+            .position       = { v.position[ 0 ], v.position[ 1 ], v.position[ 2 ] },
+            .normalPacked   = PackNormalOctahedral( v.normal ),
+            .texCoordPacked = uint32_t( FloatToHalf( v.texCoord[ 0 ] ) ) |
+                              uint32_t( FloatToHalf( v.texCoord[ 1 ] ) ) << 16,
+            .color          = v.color,
+        };
+        memcpy( &dst[ i ], &c, sizeof( RTGL1::ShVertexCompact ) );
+    }
+}
+
+void TransformPositions_Scalar( RgFloat3D*               dst,
+                                const RgPrimitiveVertex* src,
+                                uint32_t                 count,
+                                const RgTransform&       tr )
+{
+    for( uint32_t i = 0; i < count; i++ )
+    {
+        const float* p = src[ i ].position;
+
+        for( uint32_t k = 0; k < 3; k++ )
+        {
+            dst[ i ].data[ k ] = tr.matrix[ k ][ 0 ] * p[ 0 ] + tr.matrix[ k ][ 1 ] * p[ 1 ] +
+                                 tr.matrix[ k ][ 2 ] * p[ 2 ] + tr.matrix[ k ][ 3 ];
+        }
+    }
+}
+
+void PackColors_Scalar( RgColor4DPacked32* dst, const float* rgba, uint32_t count )
+{
+    auto toUint8 = []( float c ) {
+        return uint32_t( std::clamp( int32_t( c * 255.0f ), 0, 255 ) );
+    };
+
+    for( uint32_t i = 0; i < count; i++ )
+    {
+        const float* c = &rgba[ i * 4 ];
+
+        dst[ i ] = ( toUint8( c[ 3 ] ) << 24 ) | ( toUint8( c[ 2 ] ) << 16 ) |
+                   ( toUint8( c[ 1 ] ) << 8 ) | ( toUint8( c[ 0 ] ) );
+    }
+}
+
+void TriangleNormals_Scalar( RgFloat3D*       dstNormals,
+                             float*           dstAreas,
+                             const RgFloat3D* positions,
+                             uint32_t         triangleCount )
+{
+    for( uint32_t t = 0; t < triangleCount; t++ )
+    {
+        const float* a = positions[ t * 3 + 0 ].data;
+        const float* b = positions[ t * 3 + 1 ].data;
+        const float* c = positions[ t * 3 + 2 ].data;
+
+        const float e1[ 3 ] = { b[ 0 ] - a[ 0 ], b[ 1 ] - a[ 1 ], b[ 2 ] - a[ 2 ] };
+        const float e2[ 3 ] = { c[ 0 ] - a[ 0 ], c[ 1 ] - a[ 1 ], c[ 2 ] - a[ 2 ] };
+
+        const float n[ 3 ] = {
+            e1[ 1 ] * e2[ 2 ] - e1[ 2 ] * e2[ 1 ],
+            e1[ 2 ] * e2[ 0 ] - e1[ 0 ] * e2[ 2 ],
+            e1[ 0 ] * e2[ 1 ] - e1[ 1 ] * e2[ 0 ],
+        };
+        const float len = std::sqrt( n[ 0 ] * n[ 0 ] + n[ 1 ] * n[ 1 ] + n[ 2 ] * n[ 2 ] );
+
+        dstNormals[ t ] = { n[ 0 ] / len, n[ 1 ] / len, n[ 2 ] / len };
+        dstAreas[ t ]   = len * 0.5f;
+    }
+}
+
+const RTGL1::VertexKernels::detail::KernelTable& ChooseKernels()
+{
+    using namespace RTGL1::VertexKernels::detail;
+
+#if RG_VERTEX_KERNELS_X86
+    if( IsAVX2Supported() )
+    {
+        return GetAVX2Kernels();
+    }
+    if( IsSSE4Supported() )
+    {
+        return GetSSE4Kernels();
+    }
+#endif
+    return GetScalarKernels();
+}
+
+const RTGL1::VertexKernels::detail::KernelTable& Active()
+{
+    static const auto& kernels = ChooseKernels();
+    return kernels;
+}
+
+}
+
+uint32_t RTGL1::VertexKernels::detail::PackNormalOctahedral( const float n[ 3 ] )
+{
+    const float l1 = std::abs( n[ 0 ] ) + std::abs( n[ 1 ] ) + std::abs( n[ 2 ] );
+    if( !( l1 > 0.0f ) )
+    {
+        return 0;
+    }
+
+    float x = n[ 0 ] / l1;
+    float y = n[ 1 ] / l1;
+
+    // fold the lower hemisphere
+    if( n[ 2 ] < 0.0f )
+    {
+        const float ox = x;
+        x = ( 1.0f - std::abs( y ) ) * ( ox >= 0.0f ? 1.0f : -1.0f );
+        y = ( 1.0f - std::abs( ox ) ) * ( y >= 0.0f ? 1.0f : -1.0f );
+    }
+
+    return PackSnorm16( x ) | ( PackSnorm16( y ) << 16 );
+}
+
+// Round to nearest even, same as F16C
+uint16_t RTGL1::VertexKernels::detail::FloatToHalf( float f )
+{
+    uint32_t x;
+    memcpy( &x, &f, sizeof( float ) );
+
+    const uint32_t sign = ( x >> 16 ) & 0x8000;
+    const uint32_t absx = x & 0x7FFFFFFF;
+
+    // NaN, Inf
+    if( absx >= 0x7F800000 )
+    {
+        return uint16_t( sign | 0x7C00 | ( absx > 0x7F800000 ? 0x200 : 0 ) );
+    }
+    // too big, round to Inf
+    if( absx >= 0x477FF000 )
+    {
+        return uint16_t( sign | 0x7C00 );
+    }
+    // denormal half
+    if( absx < 0x38800000 )
+    {
+        if( absx < 0x33000000 )
+        {
+            return uint16_t( sign );
+        }
+        const uint32_t e     = absx >> 23;
+        const uint32_t m     = ( absx & 0x7FFFFF ) | 0x800000;
+        const uint32_t shift = 126 - e;
+        const uint32_t rem   = m & ( ( 1u << shift ) - 1 );
+        const uint32_t half  = 1u << ( shift - 1 );
+
+        uint32_t h = m >> shift;
+        if( rem > half || ( rem == half && ( h & 1 ) ) )
+        {
+            h++;
+        }
+        return uint16_t( sign | h );
+    }
+
+    // carry from the mantissa to the exponent is correct
+    const uint32_t rem = absx & 0x1FFF;
+
+    uint32_t h = ( absx - 0x38000000 ) >> 13;
+    if( rem > 0x1000 || ( rem == 0x1000 && ( h & 1 ) ) )
+    {
+        h++;
+    }
+    return uint16_t( sign | h );
+}
+
+const RTGL1::VertexKernels::detail::KernelTable& RTGL1::VertexKernels::detail::GetScalarKernels()
+{
+    static const KernelTable table = {
+        .isa                = "Scalar",
+        .streamCopy         = StreamCopy_Scalar,
+        .packCompact        = PackCompact_Scalar,
+        .transformPositions = TransformPositions_Scalar,
+        .packColors         = PackColors_Scalar,
+        .triangleNormals    = TriangleNormals_Scalar,
+    };
+    return table;
+}
+
+#if RG_VERTEX_KERNELS_X86
+
+namespace
+{
+#ifdef _MSC_VER
+void CpuId( int leaf, int subleaf, int ( &regs )[ 4 ] )
+{
+    __cpuidex( regs, leaf, subleaf );
+}
+
+uint64_t GetXCR0()
+{
+    return _xgetbv( 0 );
+}
+#endif
+}
+
+bool RTGL1::VertexKernels::detail::IsSSE4Supported()
+{
+#ifdef _MSC_VER
+    int regs[ 4 ];
+    CpuId( 1, 0, regs );
+    return ( regs[ 2 ] & ( 1 << 19 ) ) != 0;
+#else
+    return __builtin_cpu_supports( "sse4.1" );
+#endif
+}
+
+bool RTGL1::VertexKernels::detail::IsAVX2Supported()
+{
+#ifdef _MSC_VER
+    int regs[ 4 ];
+    CpuId( 1, 0, regs );
+    const bool fma     = ( regs[ 2 ] & ( 1 << 12 ) ) != 0;
+    const bool osxsave = ( regs[ 2 ] & ( 1 << 27 ) ) != 0;
+    const bool f16c    = ( regs[ 2 ] & ( 1 << 29 ) ) != 0;
+    if( !fma || !osxsave || !f16c )
+    {
+        return false;
+    }
+    // OS must save YMM registers
+    if( ( GetXCR0() & 0x6 ) != 0x6 )
+    {
+        return false;
+    }
+    CpuId( 7, 0, regs );
+    return ( regs[ 1 ] & ( 1 << 5 ) ) != 0;
+#else
+    return __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" ) &&
+           __builtin_cpu_supports( "f16c" );
+#endif
+}
+
+#endif // RG_VERTEX_KERNELS_X86
+
+const char* RTGL1::VertexKernels::GetActiveISA()
+{
+    return Active().isa;
+}
+
+void RTGL1::VertexKernels::StreamCopy( void* dst, const void* src, size_t size )
+{
+    Active().streamCopy( dst, src, size );
+}
+
+void RTGL1::VertexKernels::PackCompact( ShVertexCompact*         dst,
+                                        const RgPrimitiveVertex* src,
+                                        uint32_t                 count )
+{
+    Active().packCompact( dst, src, count );
+}
+
+void RTGL1::VertexKernels::TransformPositions( RgFloat3D*               dst,
+                                               const RgPrimitiveVertex* src,
+                                               uint32_t                 count,
+                                               const RgTransform&       transform )
+{
+    Active().transformPositions( dst, src, count, transform );
+}
+
+void RTGL1::VertexKernels::PackColors( RgColor4DPacked32* dst, const float* rgba, uint32_t count )
+{
+    Active().packColors( dst, rgba, count );
+}
+
+void RTGL1::VertexKernels::TriangleNormals( RgFloat3D*       dstNormals,
+                                            float*           dstAreas,
+                                            const RgFloat3D* positions,
+                                            uint32_t         triangleCount )
+{
+    Active().triangleNormals( dstNormals, dstAreas, positions, triangleCount );
+}
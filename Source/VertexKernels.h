@@ -0,0 +1,66 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "RTGL1/RTGL1.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace RTGL1
+{
+
+struct ShVertexCompact;
+
+// Batched vertex processing for the CPU upload paths.
+// Each function has scalar, SSE4.1 and AVX2 (with F16C and FMA) variants,
+// the fastest one that is supported by the CPU is chosen on the first call.
+namespace VertexKernels
+{
+    // "AVX2", "SSE4.1" or "Scalar"
+    const char* GetActiveISA();
+
+    // Copy to mapped staging memory. Big ranges are written with non-temporal stores,
+    // so write-combined memory receives full lines, and the cache is not polluted.
+    void StreamCopy( void* dst, const void* src, size_t size );
+
+    // Positions are copied, normals are octahedral-encoded,
+    // texture coordinates are converted to half floats. Tangents are dropped.
+    void PackCompact( ShVertexCompact* dst, const RgPrimitiveVertex* src, uint32_t count );
+
+    // dst[ i ] = transform * src[ i ].position
+    void TransformPositions( RgFloat3D*               dst,
+                             const RgPrimitiveVertex* src,
+                             uint32_t                 count,
+                             const RgTransform&       transform );
+
+    // Same as Utils::PackColorFromFloat for each RGBA quadruple in "rgba"
+    void PackColors( RgColor4DPacked32* dst, const float* rgba, uint32_t count );
+
+    // Same as Utils::GetNormalAndArea for each triangle in "positions",
+    // i.e. for ( positions[ i * 3 ], positions[ i * 3 + 1 ], positions[ i * 3 + 2 ] )
+    void TriangleNormals( RgFloat3D*       dstNormals,
+                          float*           dstAreas,
+                          const RgFloat3D* positions,
+                          uint32_t         triangleCount );
+}
+
+}
@@ -0,0 +1,234 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "VertexKernels_Impl.h"
+
+#if RG_VERTEX_KERNELS_X86
+
+#include "Generated/ShaderCommonC.h"
+
+#include <cstddef>
+#include <cstring>
+#include <immintrin.h>
+
+namespace
+{
+
+using namespace RTGL1::VertexKernels::detail;
+
+void StreamCopy_AVX2( void* dst, const void* src, size_t size )
+{
+    if( size < StreamCopyThreshold )
+    {
+        memcpy( dst, src, size );
+        return;
+    }
+
+    auto*       d = static_cast< uint8_t* >( dst );
+    const auto* s = static_cast< const uint8_t* >( src );
+
+    // non-temporal stores require an aligned destination
+    const size_t head = ( 32 - ( reinterpret_cast< uintptr_t >( d ) & 31 ) ) & 31;
+    memcpy( d, s, head );
+    d += head;
+    s += head;
+    size -= head;
+
+    for( ; size >= 128; d += 128, s += 128, size -= 128 )
+    {
+        const __m256i a = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( s ) + 0 );
+        const __m256i b = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( s ) + 1 );
+        const __m256i c = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( s ) + 2 );
+        const __m256i e = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( s ) + 3 );
+        _mm256_stream_si256( reinterpret_cast< __m256i* >( d ) + 0, a );
+        _mm256_stream_si256( reinterpret_cast< __m256i* >( d ) + 1, b );
+        _mm256_stream_si256( reinterpret_cast< __m256i* >( d ) + 2, c );
+        _mm256_stream_si256( reinterpret_cast< __m256i* >( d ) + 3, e );
+    }
+
+    for( ; size >= 32; d += 32, s += 32, size -= 32 )
+    {
+        _mm256_stream_si256( reinterpret_cast< __m256i* >( d ),
+                             _mm256_loadu_si256( reinterpret_cast< const __m256i* >( s ) ) );
+    }
+
+    memcpy( d, s, size );
+
+    // non-temporal stores must be visible before the staging buffer is used
+    _mm_sfence();
+}
+
+// Same as PackNormalOctahedral for 8 normals
+__m256i PackNormalOctahedral8( __m256 x, __m256 y, __m256 z )
+{
+    const __m256 zero     = _mm256_setzero_ps();
+    const __m256 one      = _mm256_set1_ps( 1.0f );
+    const __m256 minusOne = _mm256_set1_ps( -1.0f );
+    const __m256 absMask  = _mm256_castsi256_ps( _mm256_set1_epi32( 0x7FFFFFFF ) );
+
+    const __m256 l1 = _mm256_add_ps(
+        _mm256_add_ps( _mm256_and_ps( x, absMask ), _mm256_and_ps( y, absMask ) ),
+        _mm256_and_ps( z, absMask ) );
+
+    const __m256 ox = _mm256_div_ps( x, l1 );
+    const __m256 oy = _mm256_div_ps( y, l1 );
+
+    // fold the lower hemisphere
+    const __m256 signX = _mm256_blendv_ps( minusOne, one, _mm256_cmp_ps( ox, zero, _CMP_GE_OQ ) );
+    const __m256 signY = _mm256_blendv_ps( minusOne, one, _mm256_cmp_ps( oy, zero, _CMP_GE_OQ ) );
+    const __m256 fx    = _mm256_mul_ps( _mm256_sub_ps( one, _mm256_and_ps( oy, absMask ) ), signX );
+    const __m256 fy    = _mm256_mul_ps( _mm256_sub_ps( one, _mm256_and_ps( ox, absMask ) ), signY );
+
+    const __m256 lower = _mm256_cmp_ps( z, zero, _CMP_LT_OQ );
+    __m256       ex    = _mm256_blendv_ps( ox, fx, lower );
+    __m256       ey    = _mm256_blendv_ps( oy, fy, lower );
+
+    const __m256 scale = _mm256_set1_ps( 32767.0f );
+    ex = _mm256_mul_ps( _mm256_min_ps( _mm256_max_ps( ex, minusOne ), one ), scale );
+    ey = _mm256_mul_ps( _mm256_min_ps( _mm256_max_ps( ey, minusOne ), one ), scale );
+
+    const __m256i packed = _mm256_or_si256(
+        _mm256_and_si256( _mm256_cvtps_epi32( ex ), _mm256_set1_epi32( 0xFFFF ) ),
+        _mm256_slli_epi32( _mm256_cvtps_epi32( ey ), 16 ) );
+
+    // zero-length normals are encoded as 0
+    return _mm256_and_si256( packed,
+                             _mm256_castps_si256( _mm256_cmp_ps( l1, zero, _CMP_GT_OQ ) ) );
+}
+
+void PackCompact_AVX2( RTGL1::ShVertexCompact* dst, const RgPrimitiveVertex* src, uint32_t count )
+{
+    static_assert( sizeof( RgPrimitiveVertex ) % sizeof( float ) == 0 );
+    constexpr int stride = sizeof( RgPrimitiveVertex ) / sizeof( float );
+
+    // gather 8 vertices' attributes, offsets are in floats
+    const __m256i indices = _mm256_mullo_epi32( _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 ),
+                                                _mm256_set1_epi32( stride ) );
+
+    uint32_t i = 0;
+
+    for( ; i + 8 <= count; i += 8 )
+    {
+        const RgPrimitiveVertex* v    = &src[ i ];
+        const auto*              base = reinterpret_cast< const float* >( v );
+
+        auto gather = [ & ]( size_t offset ) {
+            return _mm256_i32gather_ps( base + offset / sizeof( float ), indices, 4 );
+        };
+
+        const __m256 nx = gather( offsetof( RgPrimitiveVertex, normal ) + 0 );
+        const __m256 ny = gather( offsetof( RgPrimitiveVertex, normal ) + 4 );
+        const __m256 nz = gather( offsetof( RgPrimitiveVertex, normal ) + 8 );
+        const __m256 tu = gather( offsetof( RgPrimitiveVertex, texCoord ) + 0 );
+        const __m256 tv = gather( offsetof( RgPrimitiveVertex, texCoord ) + 4 );
+
+        // interleave half floats: u | v << 16
+        const __m128i hu = _mm256_cvtps_ph( tu, _MM_FROUND_TO_NEAREST_INT );
+        const __m128i hv = _mm256_cvtps_ph( tv, _MM_FROUND_TO_NEAREST_INT );
+
+        alignas( 32 ) uint32_t normals[ 8 ];
+        alignas( 32 ) uint32_t texCoords[ 8 ];
+        _mm256_store_si256( reinterpret_cast< __m256i* >( normals ),
+                            PackNormalOctahedral8( nx, ny, nz ) );
+        _mm_store_si128( reinterpret_cast< __m128i* >( texCoords ) + 0,
+                         _mm_unpacklo_epi16( hu, hv ) );
+        _mm_store_si128( reinterpret_cast< __m128i* >( texCoords ) + 1,
+                         _mm_unpackhi_epi16( hu, hv ) );
+
+        for( uint32_t k = 0; k < 8; k++ )
+        {
+            const float* p = v[ k ].position;
+
+            RTGL1::ShVertexCompact c = {
+                .position       = { p[ 0 ], p[ 1 ], p[ 2 ] },
+                .normalPacked   = normals[ k ],
+                .texCoordPacked = texCoords[ k ],
+                .color          = v[ k ].color,
+            };
+            memcpy( &dst[ i + k ], &c, sizeof( RTGL1::ShVertexCompact ) );
+        }
+    }
+
+    GetSSE4Kernels().packCompact( &dst[ i ], &src[ i ], count - i );
+}
+
+void TransformPositions_AVX2( RgFloat3D*               dst,
+                              const RgPrimitiveVertex* src,
+                              uint32_t                 count,
+                              const RgTransform&       tr )
+{
+    const auto& m = tr.matrix;
+
+    // same columns in both 128-bit lanes, a lane per vertex
+    auto column = [ & ]( int j ) {
+        return _mm256_setr_ps( m[ 0 ][ j ],
+                               m[ 1 ][ j ],
+                               m[ 2 ][ j ],
+                               0.0f,
+                               m[ 0 ][ j ],
+                               m[ 1 ][ j ],
+                               m[ 2 ][ j ],
+                               0.0f );
+    };
+    const __m256 c0 = column( 0 );
+    const __m256 c1 = column( 1 );
+    const __m256 c2 = column( 2 );
+    const __m256 c3 = column( 3 );
+
+    uint32_t i = 0;
+
+    for( ; i + 2 <= count; i += 2 )
+    {
+        // 4th component is the padding
+        const __m256 p = _mm256_insertf128_ps(
+            _mm256_castps128_ps256( _mm_loadu_ps( src[ i ].position ) ),
+            _mm_loadu_ps( src[ i + 1 ].position ),
+            1 );
+
+        __m256 r = _mm256_fmadd_ps( c0, _mm256_permute_ps( p, _MM_SHUFFLE( 0, 0, 0, 0 ) ), c3 );
+        r        = _mm256_fmadd_ps( c1, _mm256_permute_ps( p, _MM_SHUFFLE( 1, 1, 1, 1 ) ), r );
+        r        = _mm256_fmadd_ps( c2, _mm256_permute_ps( p, _MM_SHUFFLE( 2, 2, 2, 2 ) ), r );
+
+        alignas( 32 ) float result[ 8 ];
+        _mm256_store_ps( result, r );
+        memcpy( dst[ i + 0 ].data, &result[ 0 ], sizeof( RgFloat3D ) );
+        memcpy( dst[ i + 1 ].data, &result[ 4 ], sizeof( RgFloat3D ) );
+    }
+
+    GetSSE4Kernels().transformPositions( &dst[ i ], &src[ i ], count - i, tr );
+}
+
+}
+
+const RTGL1::VertexKernels::detail::KernelTable& RTGL1::VertexKernels::detail::GetAVX2Kernels()
+{
+    static const KernelTable table = {
+        .isa                = "AVX2",
+        .streamCopy         = StreamCopy_AVX2,
+        .packCompact        = PackCompact_AVX2,
+        .transformPositions = TransformPositions_AVX2,
+        // not bound by the vector width
+        .packColors         = GetSSE4Kernels().packColors,
+        .triangleNormals    = GetSSE4Kernels().triangleNormals,
+    };
+    return table;
+}
+
+#endif // RG_VERTEX_KERNELS_X86
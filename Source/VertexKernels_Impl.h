@@ -0,0 +1,67 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "VertexKernels.h"
+
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __x86_64__ ) || defined( __i386__ )
+    #define RG_VERTEX_KERNELS_X86 1
+#else
+    #define RG_VERTEX_KERNELS_X86 0
+#endif
+
+namespace RTGL1::VertexKernels::detail
+{
+
+// Implementations of one instruction set
+struct KernelTable
+{
+    const char* isa;
+
+    void ( *streamCopy )( void* dst, const void* src, size_t size );
+    void ( *packCompact )( ShVertexCompact* dst, const RgPrimitiveVertex* src, uint32_t count );
+    void ( *transformPositions )( RgFloat3D*               dst,
+                                  const RgPrimitiveVertex* src,
+                                  uint32_t                 count,
+                                  const RgTransform&       transform );
+    void ( *packColors )( RgColor4DPacked32* dst, const float* rgba, uint32_t count );
+    void ( *triangleNormals )( RgFloat3D*       dstNormals,
+                               float*           dstAreas,
+                               const RgFloat3D* positions,
+                               uint32_t         triangleCount );
+};
+
+const KernelTable& GetScalarKernels();
+// Must be called only if the CPU supports the instruction set
+const KernelTable& GetSSE4Kernels();
+const KernelTable& GetAVX2Kernels();
+
+bool IsSSE4Supported();
+bool IsAVX2Supported();
+
+// Scalar helpers, SIMD variants must produce the same results
+uint32_t PackNormalOctahedral( const float n[ 3 ] );
+uint16_t FloatToHalf( float f );
+
+// Smaller copies are not worth the non-temporal stores and the fence
+constexpr size_t StreamCopyThreshold = 1024;
+
+}
@@ -0,0 +1,258 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "VertexKernels_Impl.h"
+
+#if RG_VERTEX_KERNELS_X86
+
+#include "Generated/ShaderCommonC.h"
+
+#include <cstring>
+#include <smmintrin.h>
+
+namespace
+{
+
+using namespace RTGL1::VertexKernels::detail;
+
+__m128 Load3( const float* p )
+{
+    // don't read past the end of the array
+    const __m128 xy = _mm_castpd_ps( _mm_load_sd( reinterpret_cast< const double* >( p ) ) );
+    return _mm_movelh_ps( xy, _mm_load_ss( p + 2 ) );
+}
+
+void Store3( float* p, __m128 v )
+{
+    _mm_storel_pi( reinterpret_cast< __m64* >( p ), v );
+    _mm_store_ss( p + 2, _mm_movehl_ps( v, v ) );
+}
+
+void StreamCopy_SSE4( void* dst, const void* src, size_t size )
+{
+    if( size < StreamCopyThreshold )
+    {
+        memcpy( dst, src, size );
+        return;
+    }
+
+    auto*       d = static_cast< uint8_t* >( dst );
+    const auto* s = static_cast< const uint8_t* >( src );
+
+    // non-temporal stores require an aligned destination
+    const size_t head = ( 16 - ( reinterpret_cast< uintptr_t >( d ) & 15 ) ) & 15;
+    memcpy( d, s, head );
+    d += head;
+    s += head;
+    size -= head;
+
+    for( ; size >= 64; d += 64, s += 64, size -= 64 )
+    {
+        const __m128i a = _mm_loadu_si128( reinterpret_cast< const __m128i* >( s ) + 0 );
+        const __m128i b = _mm_loadu_si128( reinterpret_cast< const __m128i* >( s ) + 1 );
+        const __m128i c = _mm_loadu_si128( reinterpret_cast< const __m128i* >( s ) + 2 );
+        const __m128i e = _mm_loadu_si128( reinterpret_cast< const __m128i* >( s ) + 3 );
+        _mm_stream_si128( reinterpret_cast< __m128i* >( d ) + 0, a );
+        _mm_stream_si128( reinterpret_cast< __m128i* >( d ) + 1, b );
+        _mm_stream_si128( reinterpret_cast< __m128i* >( d ) + 2, c );
+        _mm_stream_si128( reinterpret_cast< __m128i* >( d ) + 3, e );
+    }
+
+    for( ; size >= 16; d += 16, s += 16, size -= 16 )
+    {
+        _mm_stream_si128( reinterpret_cast< __m128i* >( d ),
+                          _mm_loadu_si128( reinterpret_cast< const __m128i* >( s ) ) );
+    }
+
+    memcpy( d, s, size );
+
+    // non-temporal stores must be visible before the staging buffer is used
+    _mm_sfence();
+}
+
+// Same as PackNormalOctahedral for 4 normals
+__m128i PackNormalOctahedral4( __m128 x, __m128 y, __m128 z )
+{
+    const __m128 zero     = _mm_setzero_ps();
+    const __m128 one      = _mm_set1_ps( 1.0f );
+    const __m128 minusOne = _mm_set1_ps( -1.0f );
+    const __m128 absMask  = _mm_castsi128_ps( _mm_set1_epi32( 0x7FFFFFFF ) );
+
+    const __m128 l1 = _mm_add_ps( _mm_add_ps( _mm_and_ps( x, absMask ), _mm_and_ps( y, absMask ) ),
+                                  _mm_and_ps( z, absMask ) );
+
+    const __m128 ox = _mm_div_ps( x, l1 );
+    const __m128 oy = _mm_div_ps( y, l1 );
+
+    // fold the lower hemisphere
+    const __m128 signX = _mm_blendv_ps( minusOne, one, _mm_cmpge_ps( ox, zero ) );
+    const __m128 signY = _mm_blendv_ps( minusOne, one, _mm_cmpge_ps( oy, zero ) );
+    const __m128 fx    = _mm_mul_ps( _mm_sub_ps( one, _mm_and_ps( oy, absMask ) ), signX );
+    const __m128 fy    = _mm_mul_ps( _mm_sub_ps( one, _mm_and_ps( ox, absMask ) ), signY );
+
+    const __m128 lower = _mm_cmplt_ps( z, zero );
+    __m128       ex    = _mm_blendv_ps( ox, fx, lower );
+    __m128       ey    = _mm_blendv_ps( oy, fy, lower );
+
+    ex = _mm_mul_ps( _mm_min_ps( _mm_max_ps( ex, minusOne ), one ), _mm_set1_ps( 32767.0f ) );
+    ey = _mm_mul_ps( _mm_min_ps( _mm_max_ps( ey, minusOne ), one ), _mm_set1_ps( 32767.0f ) );
+
+    const __m128i packed =
+        _mm_or_si128( _mm_and_si128( _mm_cvtps_epi32( ex ), _mm_set1_epi32( 0xFFFF ) ),
+                      _mm_slli_epi32( _mm_cvtps_epi32( ey ), 16 ) );
+
+    // zero-length normals are encoded as 0
+    return _mm_and_si128( packed, _mm_castps_si128( _mm_cmpgt_ps( l1, zero ) ) );
+}
+
+void PackCompact_SSE4( RTGL1::ShVertexCompact* dst, const RgPrimitiveVertex* src, uint32_t count )
+{
+    uint32_t i = 0;
+
+    for( ; i + 4 <= count; i += 4 )
+    {
+        const RgPrimitiveVertex* v = &src[ i ];
+
+        __m128 x = _mm_loadu_ps( v[ 0 ].normal );
+        __m128 y = _mm_loadu_ps( v[ 1 ].normal );
+        __m128 z = _mm_loadu_ps( v[ 2 ].normal );
+        __m128 w = _mm_loadu_ps( v[ 3 ].normal );
+        _MM_TRANSPOSE4_PS( x, y, z, w );
+
+        alignas( 16 ) uint32_t normals[ 4 ];
+        _mm_store_si128( reinterpret_cast< __m128i* >( normals ),
+                         PackNormalOctahedral4( x, y, z ) );
+
+        for( uint32_t k = 0; k < 4; k++ )
+        {
+            const float* p = v[ k ].position;
+
+            RTGL1::ShVertexCompact c = {
+                .position       = { p[ 0 ], p[ 1 ], p[ 2 ] },
+                .normalPacked   = normals[ k ],
+                .texCoordPacked = uint32_t( FloatToHalf( v[ k ].texCoord[ 0 ] ) ) |
+                                  uint32_t( FloatToHalf( v[ k ].texCoord[ 1 ] ) ) << 16,
+                .color          = v[ k ].color,
+            };
+            memcpy( &dst[ i + k ], &c, sizeof( RTGL1::ShVertexCompact ) );
+        }
+    }
+
+    GetScalarKernels().packCompact( &dst[ i ], &src[ i ], count - i );
+}
+
+void TransformPositions_SSE4( RgFloat3D*               dst,
+                              const RgPrimitiveVertex* src,
+                              uint32_t                 count,
+                              const RgTransform&       tr )
+{
+    const auto& m = tr.matrix;
+
+    const __m128 c0 = _mm_setr_ps( m[ 0 ][ 0 ], m[ 1 ][ 0 ], m[ 2 ][ 0 ], 0.0f );
+    const __m128 c1 = _mm_setr_ps( m[ 0 ][ 1 ], m[ 1 ][ 1 ], m[ 2 ][ 1 ], 0.0f );
+    const __m128 c2 = _mm_setr_ps( m[ 0 ][ 2 ], m[ 1 ][ 2 ], m[ 2 ][ 2 ], 0.0f );
+    const __m128 c3 = _mm_setr_ps( m[ 0 ][ 3 ], m[ 1 ][ 3 ], m[ 2 ][ 3 ], 0.0f );
+
+    for( uint32_t i = 0; i < count; i++ )
+    {
+        // 4th component is the padding
+        const __m128 p = _mm_loadu_ps( src[ i ].position );
+
+        __m128 r = _mm_mul_ps( c0, _mm_shuffle_ps( p, p, _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+        r = _mm_add_ps( r, _mm_mul_ps( c1, _mm_shuffle_ps( p, p, _MM_SHUFFLE( 1, 1, 1, 1 ) ) ) );
+        r = _mm_add_ps( r, _mm_mul_ps( c2, _mm_shuffle_ps( p, p, _MM_SHUFFLE( 2, 2, 2, 2 ) ) ) );
+        r = _mm_add_ps( r, c3 );
+
+        Store3( dst[ i ].data, r );
+    }
+}
+
+void PackColors_SSE4( RgColor4DPacked32* dst, const float* rgba, uint32_t count )
+{
+    const __m128 scale = _mm_set1_ps( 255.0f );
+
+    auto toInt = [ & ]( uint32_t index ) {
+        // truncation, same as in the scalar version
+        return _mm_cvttps_epi32( _mm_mul_ps( _mm_loadu_ps( &rgba[ index * 4 ] ), scale ) );
+    };
+
+    uint32_t i = 0;
+
+    for( ; i + 4 <= count; i += 4 )
+    {
+        // saturation clamps to [0, 255]
+        const __m128i ab = _mm_packs_epi32( toInt( i + 0 ), toInt( i + 1 ) );
+        const __m128i cd = _mm_packs_epi32( toInt( i + 2 ), toInt( i + 3 ) );
+
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( &dst[ i ] ), _mm_packus_epi16( ab, cd ) );
+    }
+
+    for( ; i < count; i++ )
+    {
+        const __m128i a = _mm_packs_epi32( toInt( i ), _mm_setzero_si128() );
+
+        dst[ i ] = uint32_t( _mm_cvtsi128_si32( _mm_packus_epi16( a, a ) ) );
+    }
+}
+
+void TriangleNormals_SSE4( RgFloat3D*       dstNormals,
+                           float*           dstAreas,
+                           const RgFloat3D* positions,
+                           uint32_t         triangleCount )
+{
+    for( uint32_t t = 0; t < triangleCount; t++ )
+    {
+        const __m128 a = Load3( positions[ t * 3 + 0 ].data );
+        const __m128 b = Load3( positions[ t * 3 + 1 ].data );
+        const __m128 c = Load3( positions[ t * 3 + 2 ].data );
+
+        const __m128 e1 = _mm_sub_ps( b, a );
+        const __m128 e2 = _mm_sub_ps( c, a );
+
+        // cross( e1, e2 ) = e1.yzx * e2.zxy - e1.zxy * e2.yzx
+        const __m128 n = _mm_sub_ps(
+            _mm_mul_ps( _mm_shuffle_ps( e1, e1, _MM_SHUFFLE( 3, 0, 2, 1 ) ),
+                        _mm_shuffle_ps( e2, e2, _MM_SHUFFLE( 3, 1, 0, 2 ) ) ),
+            _mm_mul_ps( _mm_shuffle_ps( e1, e1, _MM_SHUFFLE( 3, 1, 0, 2 ) ),
+                        _mm_shuffle_ps( e2, e2, _MM_SHUFFLE( 3, 0, 2, 1 ) ) ) );
+
+        const __m128 len = _mm_sqrt_ps( _mm_dp_ps( n, n, 0x7F ) );
+
+        Store3( dstNormals[ t ].data, _mm_div_ps( n, len ) );
+        dstAreas[ t ] = _mm_cvtss_f32( len ) * 0.5f;
+    }
+}
+
+}
+
+const RTGL1::VertexKernels::detail::KernelTable& RTGL1::VertexKernels::detail::GetSSE4Kernels()
+{
+    static const KernelTable table = {
+        .isa                = "SSE4.1",
+        .streamCopy         = StreamCopy_SSE4,
+        .packCompact        = PackCompact_SSE4,
+        .transformPositions = TransformPositions_SSE4,
+        .packColors         = PackColors_SSE4,
+        .triangleNormals    = TriangleNormals_SSE4,
+    };
+    return table;
+}
+
+#endif // RG_VERTEX_KERNELS_X86
@@ -26,8 +26,7 @@
 
 RTGL1::VertexPreprocessing::VertexPreprocessing( VkDevice             _device,
                                                  const GlobalUniform& _uniform,
-                                                 const ASManager&     _asManager,
-                                                 const ShaderManager& _shaderManager )
+                                                 const ASManager&     _asManager )
     : device( _device )
 {
     VkDescriptorSetLayout setLayouts[] = {
@@ -36,7 +35,6 @@ RTGL1::VertexPreprocessing::VertexPreprocessing( VkDevice             _device,
     };
 
     CreatePipelineLayout( setLayouts, std::size( setLayouts ) );
-    CreatePipelines( &_shaderManager );
 }
 
 RTGL1::VertexPreprocessing::~VertexPreprocessing()
@@ -155,7 +153,7 @@ void RTGL1::VertexPreprocessing::CreatePipelines( const ShaderManager* shaderMan
         specInfoDataOnlyDynamic = VERT_PREPROC_MODE_ONLY_DYNAMIC;
 
         r = vkCreateComputePipelines(
-            device, VK_NULL_HANDLE, 1, &plInfo, nullptr, &pipelineOnlyDynamic );
+            device, shaderManager->GetPipelineCache(), 1, &plInfo, nullptr, &pipelineOnlyDynamic );
         VK_CHECKERROR( r );
 
         SET_DEBUG_NAME( device,
@@ -167,8 +165,12 @@ void RTGL1::VertexPreprocessing::CreatePipelines( const ShaderManager* shaderMan
     {
         specInfoDataOnlyDynamic = VERT_PREPROC_MODE_DYNAMIC_AND_MOVABLE;
 
-        r = vkCreateComputePipelines(
-            device, VK_NULL_HANDLE, 1, &plInfo, nullptr, &pipelineDynamicAndMovable );
+        r = vkCreateComputePipelines( device,
+                                      shaderManager->GetPipelineCache(),
+                                      1,
+                                      &plInfo,
+                                      nullptr,
+                                      &pipelineDynamicAndMovable );
         VK_CHECKERROR( r );
 
         SET_DEBUG_NAME( device,
@@ -180,7 +182,8 @@ void RTGL1::VertexPreprocessing::CreatePipelines( const ShaderManager* shaderMan
     {
         specInfoDataOnlyDynamic = VERT_PREPROC_MODE_ALL;
 
-        r = vkCreateComputePipelines( device, VK_NULL_HANDLE, 1, &plInfo, nullptr, &pipelineAll );
+        r = vkCreateComputePipelines(
+            device, shaderManager->GetPipelineCache(), 1, &plInfo, nullptr, &pipelineAll );
         VK_CHECKERROR( r );
 
         SET_DEBUG_NAME( device,
@@ -35,8 +35,7 @@ class VertexPreprocessing : public IShaderDependency
 public:
     VertexPreprocessing( VkDevice             device,
                          const GlobalUniform& uniform,
-                         const ASManager&     asManager,
-                         const ShaderManager& shaderManager );
+                         const ASManager&     asManager );
 
     ~VertexPreprocessing() override;
 
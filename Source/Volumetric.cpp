@@ -35,7 +35,6 @@ constexpr VkFormat ILLUMINATION_VOLUME_FORMAT = VK_FORMAT_B10G11R11_UFLOAT_PACK3
 RTGL1::Volumetric::Volumetric( VkDevice              _device,
                                CommandBufferManager& _cmdManager,
                                MemoryAllocator&      _allocator,
-                               const ShaderManager&  _shaderManager,
                                const GlobalUniform&  _uniform,
                                const BlueNoise&      _rnd,
                                const Framebuffers&   _framebuffers )
@@ -46,7 +45,6 @@ RTGL1::Volumetric::Volumetric( VkDevice              _device,
     CreateDescriptors();
     UpdateDescriptors();
     CreatePipelineLayouts( _uniform, _rnd, _framebuffers );
-    CreatePipelines( _shaderManager );
 }
 
 RTGL1::Volumetric::~Volumetric()
@@ -608,7 +606,12 @@ void RTGL1::Volumetric::CreatePipelines( const ShaderManager& shaderManager )
         };
 
         VkResult r =
-            vkCreateComputePipelines( device, VK_NULL_HANDLE, 1, &info, nullptr, &processPipeline );
+            vkCreateComputePipelines( device,
+                                      shaderManager.GetPipelineCache(),
+                                      1,
+                                      &info,
+                                      nullptr,
+                                      &processPipeline );
         VK_CHECKERROR( r );
 
         SET_DEBUG_NAME(
@@ -624,7 +627,12 @@ void RTGL1::Volumetric::CreatePipelines( const ShaderManager& shaderManager )
         };
 
         VkResult r =
-            vkCreateComputePipelines( device, VK_NULL_HANDLE, 1, &info, nullptr, &accumPipeline );
+            vkCreateComputePipelines( device,
+                                      shaderManager.GetPipelineCache(),
+                                      1,
+                                      &info,
+                                      nullptr,
+                                      &accumPipeline );
         VK_CHECKERROR( r );
 
         SET_DEBUG_NAME(
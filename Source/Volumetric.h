@@ -35,7 +35,6 @@ public:
     Volumetric( VkDevice              device,
                 CommandBufferManager& cmdManager,
                 MemoryAllocator&      allocator,
-                const ShaderManager&  shaderManager,
                 const GlobalUniform&  uniform,
                 const BlueNoise&      rnd,
                 const Framebuffers&   framebuffers );
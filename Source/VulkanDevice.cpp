@@ -30,6 +30,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <span>
 
 VkCommandBuffer RTGL1::VulkanDevice::BeginFrame( const RgStartFrameInfo& info )
 {
@@ -49,7 +50,9 @@ VkCommandBuffer RTGL1::VulkanDevice::BeginFrame( const RgStartFrameInfo& info )
     swapchain->RequestVsync( vsync );
     swapchain->AcquireImage( imageAvailableSemaphores[ frameIndex ] );
 
-    VkSemaphore semaphoreToWaitOnSubmit = imageAvailableSemaphores[ frameIndex ];
+    // nothing to wait, if there's no presentation engine
+    VkSemaphore semaphoreToWaitOnSubmit =
+        swapchain->IsHeadless() ? VK_NULL_HANDLE : imageAvailableSemaphores[ frameIndex ];
 
 
     // if out-of-frame cmd exist, submit it
@@ -111,9 +114,19 @@ VkCommandBuffer RTGL1::VulkanDevice::BeginFrame( const RgStartFrameInfo& info )
     }
 
     VkCommandBuffer cmd = cmdManager->StartGraphicsCmd();
+    if( profiler )
+    {
+        profiler->BeginFrame( cmd, frameIndex, frameId );
+    }
     BeginCmdLabel( cmd, "Prepare for frame" );
 
+    if( observer )
+    {
+        observer->DispatchChanges();
+    }
+
     textureManager->TryHotReload( cmd, frameIndex );
+    textureManager->UploadStreamed( cmd, frameIndex );
     lightManager->PrepareForFrame( cmd, frameIndex );
     scene->PrepareForFrame( cmd,
                             frameIndex,
@@ -136,6 +149,9 @@ VkCommandBuffer RTGL1::VulkanDevice::BeginFrame( const RgStartFrameInfo& info )
             Utils::PackColorFromFloat( uniform->GetData()->volumeUnderwaterColor ) );
     }
 
+    // materials / meta could be changed, before any primitive is uploaded
+    materialHandles.RefreshIfChanged( *textureManager, *textureMetaManager );
+
     return cmd;
 }
 
@@ -165,14 +181,6 @@ void RTGL1::VulkanDevice::FillUniform( RTGL1::ShGlobalUniform* gu,
         gu->cameraPosition[ 2 ] = gu->invView[ 14 ];
     }
 
-    {
-        static_assert( sizeof( gu->instanceGeomInfoOffset ) ==
-                       sizeof( gu->instanceGeomInfoOffsetPrev ) );
-        memcpy( gu->instanceGeomInfoOffsetPrev,
-                gu->instanceGeomInfoOffset,
-                sizeof( gu->instanceGeomInfoOffset ) );
-    }
-
     {
         gu->frameId   = frameId;
         gu->timeDelta = static_cast< float >(
@@ -181,8 +189,20 @@ void RTGL1::VulkanDevice::FillUniform( RTGL1::ShGlobalUniform* gu,
     }
 
     {
-        gu->renderWidth  = static_cast< float >( renderResolution.Width() );
-        gu->renderHeight = static_cast< float >( renderResolution.Height() );
+        // with dynamic resolution, history was rendered in a different size
+        gu->prevRenderWidth  = gu->renderWidth;
+        gu->prevRenderHeight = gu->renderHeight;
+
+        gu->renderWidth     = static_cast< float >( renderResolution.Width() );
+        gu->renderHeight    = static_cast< float >( renderResolution.Height() );
+        gu->maxRenderWidth  = static_cast< float >( renderResolution.MaxWidth() );
+        gu->maxRenderHeight = static_cast< float >( renderResolution.MaxHeight() );
+
+        if( gu->prevRenderWidth <= 0 || gu->prevRenderHeight <= 0 )
+        {
+            gu->prevRenderWidth  = gu->renderWidth;
+            gu->prevRenderHeight = gu->renderHeight;
+        }
         // render width must be always even for checkerboarding!
         assert( ( int )gu->renderWidth % 2 == 0 );
 
@@ -215,9 +235,15 @@ void RTGL1::VulkanDevice::FillUniform( RTGL1::ShGlobalUniform* gu,
         gu->lightCount     = lightManager->GetLightCount();
         gu->lightCountPrev = lightManager->GetLightCountPrev();
 
+        gu->lightTreeNodeCount = lightManager->GetLightTreeNodeCount();
+
         gu->directionalLightExists = lightManager->DoesDirectionalLightExist();
     }
 
+    {
+        gu->staticVerticesCompact = scene->GetASManager()->AreStaticVerticesCompact();
+    }
+
     {
         const auto& params = AccessParams< RgDrawFrameSkyParams >( drawInfo );
 
@@ -513,13 +539,31 @@ void RTGL1::VulkanDevice::Render( VkCommandBuffer cmd, const RgDrawFrameInfo& dr
                            drawInfo.disableRayTracedGeometry );
 
 
-    framebuffers->PrepareForSize( renderResolution.GetResolutionState() );
+    framebuffers->PrepareForSize( renderResolution.GetResolutionState(),
+                                  renderResolution.GetMaxResolutionState() );
 
 
     if( !drawInfo.disableRasterization )
     {
         rasterizer->SubmitForFrame( cmd, frameIndex );
 
+        // if enabled, draws are recorded on worker threads, while this thread
+        // records ray tracing, and the results are executed in the render passes below
+        rasterizer->RecordInParallel(
+            frameIndex,
+            uniform->GetData()->skyType == RG_SKY_TYPE_RASTERIZED_GEOMETRY,
+            *textureManager,
+            *uniform,
+            *tonemapping,
+            *volumetric,
+            uniform->GetData()->view,
+            AccessParams< RgDrawFrameSkyParams >( drawInfo ).skyViewerPosition,
+            uniform->GetData()->projection,
+            jitter,
+            renderResolution,
+            renderResolution.UpscaledWidth(),
+            renderResolution.UpscaledHeight() );
+
         // draw rasterized sky to albedo before tracing primary rays
         if( uniform->GetData()->skyType == RG_SKY_TYPE_RASTERIZED_GEOMETRY )
         {
@@ -538,11 +582,36 @@ void RTGL1::VulkanDevice::Render( VkCommandBuffer cmd, const RgDrawFrameInfo& dr
 
 
     {
-        lightGrid->Build( cmd, frameIndex, uniform, blueNoise, lightManager );
+        if( asyncCompute )
+        {
+            // light grid depends only on the lights and uniform uploaded above,
+            // so it's built on the compute queue while primary rays are traced;
+            // vertex preprocessing stays in scene->SubmitForFrame on the graphics queue:
+            // primary rays read its output right away, so there's nothing to overlap with,
+            // but it would require vertex and geometry info buffers to be shared
+            cmd = asyncCompute->Fork( cmd, currentFrameState.GetSemaphoreForWaitAndRemove() );
+            ContinueFrame( cmd );
+
+            lightGrid->Build(
+                asyncCompute->GetComputeCmd(), frameIndex, uniform, blueNoise, lightManager );
+        }
+        else
+        {
+            lightGrid->Build( cmd, frameIndex, uniform, blueNoise, lightManager );
+        }
 
         decalManager->SubmitForFrame( cmd, frameIndex );
         portalList->SubmitForFrame( cmd, frameIndex );
 
+        {
+            uint32_t features = 0;
+            features |= portalList->HasPortals() ? RT_FEATURE_PORTALS : 0;
+            features |= uniform->GetData()->illumVolumeEnable ? RT_FEATURE_ILLUMINATION_VOLUME : 0;
+
+            // pipeline is recompiled only if such combination wasn't used before
+            rtPipeline->SetFeatures( shaderManager.get(), features );
+        }
+
         float volumetricMaxHistoryLen =
             AccessParams< RgDrawFrameRenderResolutionParams >( drawInfo ).resetUpscalerHistory
                 ? 0
@@ -564,6 +633,7 @@ void RTGL1::VulkanDevice::Render( VkCommandBuffer cmd, const RgDrawFrameInfo& dr
                                               *portalList,
                                               *volumetric );
 
+        framebuffers->BeginPhase( cmd, FB_PASS_PHASE_PRIMARY );
         pathTracer->TracePrimaryRays( params );
 
         // draw decals on top of primary surface
@@ -574,14 +644,26 @@ void RTGL1::VulkanDevice::Render( VkCommandBuffer cmd, const RgDrawFrameInfo& dr
             pathTracer->TraceReflectionRefractionRays( params );
         }
 
+        if( asyncCompute )
+        {
+            cmd = asyncCompute->Join( cmd,
+                                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                                          VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR );
+            ContinueFrame( cmd );
+        }
+
+        framebuffers->BeginPhase( cmd, FB_PASS_PHASE_LIGHTING );
         lightManager->BarrierLightGrid( cmd, frameIndex );
         pathTracer->CalculateInitialReservoirs( params );
         pathTracer->TraceDirectllumination( params );
         pathTracer->TraceIndirectllumination( params );
         pathTracer->TraceVolumetric( params );
 
+        framebuffers->BeginPhase( cmd, FB_PASS_PHASE_DENOISE );
         pathTracer->CalculateGradientsSamples( params );
         denoiser->Denoise( cmd, frameIndex, uniform );
+
+        framebuffers->BeginPhase( cmd, FB_PASS_PHASE_COMPOSE );
         volumetric->ProcessScattering(
             cmd, frameIndex, *uniform, *blueNoise, *framebuffers, volumetricMaxHistoryLen );
         tonemapping->CalculateExposure( cmd, frameIndex, uniform );
@@ -612,6 +694,8 @@ void RTGL1::VulkanDevice::Render( VkCommandBuffer cmd, const RgDrawFrameInfo& dr
                                 AccessParams< RgDrawFrameTonemappingParams >( drawInfo ) );
 
 
+    framebuffers->BeginPhase( cmd, FB_PASS_PHASE_POSTPROCESS );
+
     bool enableBloom = AccessParams< RgDrawFrameBloomParams >( drawInfo ).bloomIntensity > 0.0f;
     if( enableBloom )
     {
@@ -757,15 +841,55 @@ void RTGL1::VulkanDevice::Render( VkCommandBuffer cmd, const RgDrawFrameInfo& dr
     framebuffers->PresentToSwapchain(
         cmd, frameIndex, swapchain, accum, VK_FILTER_NEAREST, drawInfo.presentPrevFrame );
 
+    if( finalImageReadback )
+    {
+        finalImageReadback->Record( cmd,
+                                    frameIndex,
+                                    frameId,
+                                    swapchain->GetImage( swapchain->GetCurrentImageIndex() ),
+                                    swapchain->GetIdleLayout(),
+                                    swapchain->GetWidth(),
+                                    swapchain->GetHeight() );
+    }
+
     if( debugWindows )
     {
         debugWindows->SubmitForFrame( cmd, frameIndex );
     }
 }
 
+void RTGL1::VulkanDevice::ContinueFrame( VkCommandBuffer cmd )
+{
+    currentFrameState.OnCmdBufferChange( cmd );
+
+    if( profiler )
+    {
+        profiler->ContinueFrame( cmd );
+    }
+}
+
 void RTGL1::VulkanDevice::EndFrame( VkCommandBuffer cmd )
 {
     uint32_t frameIndex     = currentFrameState.GetFrameIndex();
+
+    if( swapchain->IsHeadless() )
+    {
+        if( profiler )
+        {
+            profiler->EndFrame( cmd );
+        }
+
+        // no present, the frame fence is enough to know when the final image is ready
+        cmdManager->Submit( cmd,
+                            currentFrameState.GetSemaphoreForWaitAndRemove(),
+                            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                            VK_NULL_HANDLE,
+                            frameFences[ frameIndex ] );
+
+        frameId++;
+        return;
+    }
+
     uint32_t swapchainCount = debugWindows && !debugWindows->IsMinimized() ? 2 : 1;
 
     VkSwapchainKHR swapchains[] = {
@@ -787,6 +911,11 @@ void RTGL1::VulkanDevice::EndFrame( VkCommandBuffer cmd )
     };
     VkResult results[ 2 ] = {};
 
+    if( profiler )
+    {
+        profiler->EndFrame( cmd );
+    }
+
     // submit command buffer, but wait until presentation engine has completed using image
     cmdManager->Submit( cmd,
                         semaphoresToWait,
@@ -868,14 +997,34 @@ void RTGL1::VulkanDevice::DrawFrame( const RgDrawFrameInfo* pOriginalInfo )
     previousFrameTime = currentFrameTime;
     currentFrameTime  = info.currentTime;
 
-    renderResolution.Setup( AccessParams< RgDrawFrameRenderResolutionParams >( info ),
-                            swapchain->GetWidth(),
-                            swapchain->GetHeight(),
-                            nvDlss );
-
-    if( observer )
     {
-        observer->RecheckFiles();
+        const auto& resolutionParams = AccessParams< RgDrawFrameRenderResolutionParams >( info );
+
+        uint32_t measuredFrameId = 0;
+        double   measuredGpuMs   = 0.0;
+        bool     hasMeasurement =
+            profiler && profiler->GetLatestGpuFrameTime( &measuredFrameId, &measuredGpuMs );
+
+        static bool warnedNoProfiler = false;
+        if( resolutionParams.dynamicResolutionTargetMs > 0.0f && !profiler && !warnedNoProfiler )
+        {
+            warnedNoProfiler = true;
+            debug::Warning( "Dynamic resolution requires \"frameProfiler\" in the library "
+                            "config to measure GPU frame time" );
+        }
+
+        float dynamicScale = dynamicResolution.Update( resolutionParams.dynamicResolutionTargetMs,
+                                                       resolutionParams.dynamicResolutionMinScale,
+                                                       frameId,
+                                                       hasMeasurement,
+                                                       measuredFrameId,
+                                                       measuredGpuMs );
+
+        renderResolution.Setup( resolutionParams,
+                                swapchain->GetWidth(),
+                                swapchain->GetHeight(),
+                                nvDlss,
+                                dynamicScale );
     }
 
     if( renderResolution.Width() > 0 && renderResolution.Height() > 0 )
@@ -885,7 +1034,8 @@ void RTGL1::VulkanDevice::DrawFrame( const RgDrawFrameInfo* pOriginalInfo )
         Render( cmd, info );
     }
 
-    EndFrame( cmd );
+    // Render might have continued the frame in another cmd
+    EndFrame( currentFrameState.GetCmdBuffer() );
     currentFrameState.OnEndFrame();
 
     // process in next frame
@@ -932,18 +1082,124 @@ void RTGL1::VulkanDevice::UploadMeshPrimitive( const RgMeshInfo*          pMesh,
         throw RgException( RG_RESULT_WRONG_FUNCTION_ARGUMENT, "Argument is null" );
     }
 
-    if( pPrimitive->vertexCount == 0 || pPrimitive->pVertices == nullptr )
+    UploadMeshPrimitive( *pMesh, *pPrimitive, nullptr );
+}
+
+void RTGL1::VulkanDevice::UploadMeshPrimitives( const RgMeshInfo*          pMesh,
+                                                const RgMeshPrimitiveInfo* pPrimitives,
+                                                uint32_t                   primitiveCount )
+{
+    RgMeshPrimitivesUploadInfo info = {
+        .pMesh          = pMesh,
+        .pPrimitives    = pPrimitives,
+        .primitiveCount = primitiveCount,
+    };
+    UploadMeshes( &info, 1 );
+}
+
+void RTGL1::VulkanDevice::UploadMeshes( const RgMeshPrimitivesUploadInfo* pMeshes,
+                                        uint32_t                          meshCount )
+{
+    if( pMeshes == nullptr && meshCount > 0 )
+    {
+        throw RgException( RG_RESULT_WRONG_FUNCTION_ARGUMENT, "Argument is null" );
+    }
+
+    // validate everything before uploading, to not leave the batch half-uploaded
+    for( const auto& m : std::span( pMeshes, meshCount ) )
+    {
+        if( m.pMesh == nullptr || ( m.pPrimitives == nullptr && m.primitiveCount > 0 ) )
+        {
+            throw RgException( RG_RESULT_WRONG_FUNCTION_ARGUMENT, "Argument is null" );
+        }
+
+        for( const auto& p : std::span( m.pPrimitives, m.primitiveCount ) )
+        {
+            if( p.materialHandle != RG_NO_MATERIAL_HANDLE &&
+                !materialHandles.Access( p.materialHandle ) )
+            {
+                throw RgException( RG_RESULT_WRONG_FUNCTION_ARGUMENT, "Invalid material handle" );
+            }
+        }
+    }
+
+    // primitives are uploaded in the submission order, as it's the draw order of the
+    // rasterized ones; lookups by texture name are done once per unique texture name
+    TextureLookupCache cache = {};
+    for( const auto& m : std::span( pMeshes, meshCount ) )
+    {
+        for( const auto& p : std::span( m.pPrimitives, m.primitiveCount ) )
+        {
+            UploadMeshPrimitive( *m.pMesh, p, &cache );
+        }
+    }
+}
+
+auto RTGL1::VulkanDevice::ResolveMaterial( const RgMeshPrimitiveInfo& primitive,
+                                           TextureLookupCache*        cache ) -> ResolvedMaterial
+{
+    if( primitive.materialHandle != RG_NO_MATERIAL_HANDLE )
+    {
+        const auto* entry = materialHandles.Access( primitive.materialHandle );
+        if( !entry )
+        {
+            throw RgException( RG_RESULT_WRONG_FUNCTION_ARGUMENT, "Invalid material handle" );
+        }
+
+        return ResolvedMaterial{
+            .textureName  = entry->textureName.c_str(),
+            .meta         = entry->meta,
+            .baseTextures = &entry->textures,
+        };
+    }
+
+    if( cache )
+    {
+        auto name            = std::string_view( Utils::SafeCstr( primitive.pTextureName ) );
+        auto [ iter, isNew ] = cache->entries.try_emplace( name );
+        if( isNew )
+        {
+            iter->second = TextureLookupCache::Entry{
+                .meta     = textureMetaManager->Find( primitive.pTextureName ),
+                .textures = textureManager->GetMaterialTextures( primitive.pTextureName ),
+            };
+        }
+
+        // valid until the next insertion to the cache
+        return ResolvedMaterial{
+            .textureName  = primitive.pTextureName,
+            .meta         = iter->second.meta,
+            .baseTextures = &iter->second.textures,
+        };
+    }
+
+    return ResolvedMaterial{
+        .textureName  = primitive.pTextureName,
+        .meta         = textureMetaManager->Find( primitive.pTextureName ),
+        .baseTextures = nullptr,
+    };
+}
+
+void RTGL1::VulkanDevice::UploadMeshPrimitive( const RgMeshInfo&          mesh,
+                                               const RgMeshPrimitiveInfo& primitive,
+                                               TextureLookupCache*        cache )
+{
+    if( primitive.vertexCount == 0 || primitive.pVertices == nullptr )
     {
         return;
     }
-    Dev_TryBreak( pPrimitive->pTextureName, false );
+
+
+    const auto [ textureName, meta, baseTextures ] = ResolveMaterial( primitive, cache );
+    Dev_TryBreak( textureName, false );
 
 
     // copy to modify
-    RgMeshPrimitiveInfo prim       = *pPrimitive;
+    RgMeshPrimitiveInfo prim       = primitive;
     RgEditorInfo        primEditor = prim.pEditorInfo ? *prim.pEditorInfo : RgEditorInfo{};
+    prim.pTextureName              = textureName;
     prim.pEditorInfo               = &primEditor;
-    if( !textureMetaManager->Modify( prim, primEditor, false ) )
+    if( !textureMetaManager->Modify( prim, primEditor, false, meta ) )
     {
         return;
     }
@@ -956,23 +1212,26 @@ void RTGL1::VulkanDevice::UploadMeshPrimitive( const RgMeshInfo*          pMesh,
     }
 
 
-    if( IsRasterized( *pMesh, prim ) )
+    if( IsRasterized( mesh, prim ) )
     {
+        auto lock = std::lock_guard( uploadMutex );
+
         rasterizer->Upload( currentFrameState.GetFrameIndex(),
                             prim.flags & RG_MESH_PRIMITIVE_SKY ? GeometryRasterType::SKY
                                                                : GeometryRasterType::WORLD,
-                            pMesh->transform,
+                            mesh.transform,
                             prim,
                             nullptr,
-                            nullptr );
+                            nullptr,
+                            baseTextures );
 
         if( devmode && devmode->primitivesTableMode == Devmode::DebugPrimMode::Rasterized )
         {
             devmode->primitivesTable.push_back( Devmode::DebugPrim{
                 .result         = UploadResult::Dynamic,
                 .callIndex      = uint32_t( devmode->primitivesTable.size() ),
-                .objectId       = pMesh->uniqueObjectID,
-                .meshName       = Utils::SafeCstr( pMesh->pMeshName ),
+                .objectId       = mesh.uniqueObjectID,
+                .meshName       = Utils::SafeCstr( mesh.pMeshName ),
                 .primitiveIndex = prim.primitiveIndexInMesh,
                 .primitiveName  = Utils::SafeCstr( prim.pPrimitiveNameInMesh ),
                 .textureName    = Utils::SafeCstr( prim.pTextureName ),
@@ -981,16 +1240,24 @@ void RTGL1::VulkanDevice::UploadMeshPrimitive( const RgMeshInfo*          pMesh,
     }
     else
     {
-        UploadResult r = scene->UploadPrimitive(
-            currentFrameState.GetFrameIndex(), *pMesh, prim, *textureManager, false );
+        // can be called in parallel: vertex data is copied to
+        // the ranges that are reserved in the staging buffers
+        UploadResult r = scene->UploadPrimitive( currentFrameState.GetFrameIndex(),
+                                                 mesh,
+                                                 prim,
+                                                 *textureManager,
+                                                 false,
+                                                 baseTextures );
+
+        auto lock = std::lock_guard( uploadMutex );
 
         if( devmode && devmode->primitivesTableMode == Devmode::DebugPrimMode::RayTraced )
         {
             devmode->primitivesTable.push_back( Devmode::DebugPrim{
                 .result         = r,
                 .callIndex      = uint32_t( devmode->primitivesTable.size() ),
-                .objectId       = pMesh->uniqueObjectID,
-                .meshName       = Utils::SafeCstr( pMesh->pMeshName ),
+                .objectId       = mesh.uniqueObjectID,
+                .meshName       = Utils::SafeCstr( mesh.pMeshName ),
                 .primitiveIndex = prim.primitiveIndexInMesh,
                 .primitiveName  = Utils::SafeCstr( prim.pPrimitiveNameInMesh ),
                 .textureName    = Utils::SafeCstr( prim.pTextureName ),
@@ -1001,11 +1268,11 @@ void RTGL1::VulkanDevice::UploadMeshPrimitive( const RgMeshInfo*          pMesh,
         {
             if( r == UploadResult::ExportableDynamic || r == UploadResult::ExportableStatic )
             {
-                e->AddPrimitive( *pMesh, prim );
+                e->AddPrimitive( mesh, prim );
             }
 
             // SHIPPING_HACK: add lights even for non-exportable geometry
-            e->AddPrimitiveLights( *pMesh, prim );
+            e->AddPrimitiveLights( mesh, prim );
         }
 
 
@@ -1013,7 +1280,7 @@ void RTGL1::VulkanDevice::UploadMeshPrimitive( const RgMeshInfo*          pMesh,
         {
             if( prim.pEditorInfo->attachedLightEvenOnDynamic )
             {
-                GltfExporter::MakeLightsForPrimitiveDynamic( *pMesh,
+                GltfExporter::MakeLightsForPrimitiveDynamic( mesh,
                                                              prim,
                                                              sceneImportExport->GetWorldScale(),
                                                              tempStorageInit,
@@ -1029,7 +1296,7 @@ void RTGL1::VulkanDevice::UploadMeshPrimitive( const RgMeshInfo*          pMesh,
                 hashBase = hashCombine( hashBase,
                                         std::string_view( Utils::SafeCstr( prim.pTextureName ) ) );
                 hashBase = hashCombine( hashBase,
-                                        std::string_view( Utils::SafeCstr( pMesh->pMeshName ) ) );
+                                        std::string_view( Utils::SafeCstr( mesh.pMeshName ) ) );
                 hashBase = hashCombine( hashBase, prim.primitiveIndexInMesh );
 
                 uint64_t counter = 0;
@@ -1054,6 +1321,81 @@ void RTGL1::VulkanDevice::UploadMeshPrimitive( const RgMeshInfo*          pMesh,
     }
 }
 
+void RTGL1::VulkanDevice::UploadStaticSector( const RgStaticSectorUploadInfo* pInfo )
+{
+    if( pInfo == nullptr || Utils::IsCstrEmpty( pInfo->pSectorName ) ||
+        ( pInfo->pMeshes == nullptr && pInfo->meshCount > 0 ) )
+    {
+        throw RgException( RG_RESULT_WRONG_FUNCTION_ARGUMENT, "Argument is null" );
+    }
+
+    const auto meshes = std::span( pInfo->pMeshes, pInfo->meshCount );
+
+    for( const auto& m : meshes )
+    {
+        if( m.pMesh == nullptr || ( m.pPrimitives == nullptr && m.primitiveCount > 0 ) )
+        {
+            throw RgException( RG_RESULT_WRONG_FUNCTION_ARGUMENT, "Argument is null" );
+        }
+    }
+
+    if( !scene->AreStaticSectorsEnabled() )
+    {
+        throw RgException( RG_RESULT_WRONG_FUNCTION_CALL,
+                           "Static sectors are disabled. Set \"staticSectorShare\" "
+                           "in the library config to a non-zero value" );
+    }
+
+    scene->BeginStaticSector( pInfo->pSectorName );
+
+    TextureLookupCache cache = {};
+    for( const auto& m : meshes )
+    {
+        for( const auto& primitive : std::span( m.pPrimitives, m.primitiveCount ) )
+        {
+            if( primitive.vertexCount == 0 || primitive.pVertices == nullptr )
+            {
+                continue;
+            }
+
+            const auto [ textureName, meta, baseTextures ] = ResolveMaterial( primitive, &cache );
+
+            // copy to modify
+            RgMeshPrimitiveInfo prim = primitive;
+            RgEditorInfo primEditor  = prim.pEditorInfo ? *prim.pEditorInfo : RgEditorInfo{};
+            prim.pTextureName        = textureName;
+            prim.pEditorInfo         = &primEditor;
+            if( !textureMetaManager->Modify( prim, primEditor, true, meta ) )
+            {
+                continue;
+            }
+
+            // rasterized geometry is uploaded each frame, so only ray traced is kept
+            if( IsRasterized( *m.pMesh, prim ) )
+            {
+                continue;
+            }
+
+            scene->UploadStaticSectorPrimitive( *m.pMesh, prim, *textureManager, baseTextures );
+        }
+    }
+
+    scene->SubmitStaticSector( currentFrameState.GetFrameIndex() );
+}
+
+void RTGL1::VulkanDevice::RemoveStaticSector( const char* pSectorName )
+{
+    if( Utils::IsCstrEmpty( pSectorName ) )
+    {
+        throw RgException( RG_RESULT_WRONG_FUNCTION_ARGUMENT, "Argument is null" );
+    }
+
+    if( !scene->RemoveStaticSector( currentFrameState.GetFrameIndex(), pSectorName ) )
+    {
+        debug::Warning( "Static sector \"{}\" was not found", pSectorName );
+    }
+}
+
 void RTGL1::VulkanDevice::UploadNonWorldPrimitive( const RgMeshPrimitiveInfo* pPrimitive,
                                                    const float*               pViewProjection,
                                                    const RgViewport*          pViewport )
@@ -1223,6 +1565,7 @@ void RTGL1::VulkanDevice::ProvideOriginalTexture( const RgOriginalTextureInfo* p
                                        currentFrameState.GetFrameIndex(),
                                        *pInfo,
                                        ovrdFolder );
+    materialHandles.Refresh( pInfo->pTextureName, *textureManager, *textureMetaManager );
 }
 
 void RTGL1::VulkanDevice::ProvideOriginalCubemapTexture( const RgOriginalCubemapInfo* pInfo )
@@ -1243,6 +1586,73 @@ void RTGL1::VulkanDevice::MarkOriginalTextureAsDeleted( const char* pTextureName
 {
     textureManager->TryDestroyMaterial( currentFrameState.GetFrameIndex(), pTextureName );
     cubemapManager->TryDestroyCubemap( currentFrameState.GetFrameIndex(), pTextureName );
+    materialHandles.Refresh( pTextureName, *textureManager, *textureMetaManager );
+}
+
+void RTGL1::VulkanDevice::GetMaterialHandle( const char* pTextureName, RgMaterialHandle* pResult )
+{
+    if( pResult == nullptr )
+    {
+        throw RgException( RG_RESULT_WRONG_FUNCTION_ARGUMENT, "Argument is null" );
+    }
+
+    *pResult = materialHandles.Intern( pTextureName, *textureManager, *textureMetaManager );
+}
+
+void RTGL1::VulkanDevice::GetFrameStatistics( RgFrameStatistics* pResult )
+{
+    if( pResult == nullptr )
+    {
+        throw RgException( RG_RESULT_WRONG_FUNCTION_ARGUMENT, "Argument is null" );
+    }
+
+    if( !profiler )
+    {
+        throw RgException(
+            RG_RESULT_WRONG_FUNCTION_CALL,
+            "Frame profiler is disabled. Set \"frameProfiler\" in the library config" );
+    }
+
+    profiler->GetFrameStatistics( pResult );
+}
+
+void RTGL1::VulkanDevice::ReadbackFinalImage( const RgReadbackFinalImageInfo* pInfo,
+                                              RgReadbackFinalImageResult*     pResult )
+{
+    if( pInfo == nullptr || pResult == nullptr )
+    {
+        throw RgException( RG_RESULT_WRONG_FUNCTION_ARGUMENT, "Argument is null" );
+    }
+
+    if( !finalImageReadback )
+    {
+        throw RgException( RG_RESULT_WRONG_FUNCTION_CALL,
+                           "Final image readback is available only if instance was created "
+                           "with pHeadlessCreateInfo" );
+    }
+
+    finalImageReadback->Read( *pInfo, frameFences, pResult );
+}
+
+void RTGL1::VulkanDevice::DumpFrameStatistics( const char* pFilePath )
+{
+    if( Utils::IsCstrEmpty( pFilePath ) )
+    {
+        throw RgException( RG_RESULT_WRONG_FUNCTION_ARGUMENT, "File path is empty" );
+    }
+
+    if( !profiler )
+    {
+        throw RgException(
+            RG_RESULT_WRONG_FUNCTION_CALL,
+            "Frame profiler is disabled. Set \"frameProfiler\" in the library config" );
+    }
+
+    if( !profiler->DumpChromeTrace( pFilePath ) )
+    {
+        throw RgException( RG_RESULT_WRONG_FUNCTION_ARGUMENT,
+                           std::format( "Can't write frame statistics to \"{}\"", pFilePath ) );
+    }
 }
 
 bool RTGL1::VulkanDevice::IsSuspended() const
@@ -1292,6 +1702,9 @@ void RTGL1::VulkanDevice::ScratchFree( const RgPrimitiveVertex* pPointer )
 
 void RTGL1::VulkanDevice::Print( std::string_view msg, RgMessageSeverityFlags severity ) const
 {
+    // can be called from the threads that upload primitives
+    auto lock = std::lock_guard( printMutex );
+
     if( devmode )
     {
         devmode->logs.emplace_back( severity, msg, std::hash< std::string_view >{}( msg ) );
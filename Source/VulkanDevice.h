@@ -23,6 +23,7 @@
 #include <RTGL1/RTGL1.h>
 
 #include <memory>
+#include <mutex>
 
 // clang-format off
 #include "Common.h"
@@ -31,6 +32,8 @@
 #include "PhysicalDevice.h"
 #include "Scene.h"
 #include "Swapchain.h"
+#include "FinalImageReadback.h"
+#include "AsyncCompute.h"
 #include "Queues.h"
 #include "GlobalUniform.h"
 #include "PathTracer.h"
@@ -48,6 +51,7 @@
 #include "Sharpening.h"
 #include "DLSS.h"
 #include "RenderResolutionHelper.h"
+#include "DynamicResolution.h"
 #include "DecalManager.h"
 #include "EffectWipe.h"
 #include "EffectSimple_Instances.h"
@@ -61,6 +65,9 @@
 #include "ScratchImmediate.h"
 #include "FolderObserver.h"
 #include "TextureMeta.h"
+#include "MaterialHandles.h"
+#include "Profiler.h"
+#include "PipelineCache.h"
 #include "SceneMeta.h"
 #include "DrawFrameInfo.h"
 #include "VulkanDevice_Dev.h"
@@ -84,6 +91,12 @@ public:
     VulkanDevice& operator=( VulkanDevice&& other ) noexcept = delete;
 
     void UploadMeshPrimitive( const RgMeshInfo* pMesh, const RgMeshPrimitiveInfo* pPrimitive );
+    void UploadMeshPrimitives( const RgMeshInfo*          pMesh,
+                               const RgMeshPrimitiveInfo* pPrimitives,
+                               uint32_t                   primitiveCount );
+    void UploadMeshes( const RgMeshPrimitivesUploadInfo* pMeshes, uint32_t meshCount );
+    void UploadStaticSector( const RgStaticSectorUploadInfo* pInfo );
+    void RemoveStaticSector( const char* pSectorName );
     void UploadNonWorldPrimitive( const RgMeshPrimitiveInfo* pPrimitive,
                                   const float*               pViewProjection,
                                   const RgViewport*          pViewport );
@@ -99,10 +112,15 @@ public:
     void ProvideOriginalTexture( const RgOriginalTextureInfo* pInfo );
     void ProvideOriginalCubemapTexture( const RgOriginalCubemapInfo* pInfo );
     void MarkOriginalTextureAsDeleted( const char* pTextureName );
+    void GetMaterialHandle( const char* pTextureName, RgMaterialHandle* pResult );
 
     void StartFrame( const RgStartFrameInfo* pInfo );
     void DrawFrame( const RgDrawFrameInfo* pInfo );
 
+    void GetFrameStatistics( RgFrameStatistics* pResult );
+    void DumpFrameStatistics( const char* pFilePath );
+    void ReadbackFinalImage( const RgReadbackFinalImageInfo* pInfo,
+                             RgReadbackFinalImageResult*     pResult );
 
     bool IsSuspended() const;
     bool IsUpscaleTechniqueAvailable( RgRenderUpscaleTechnique technique ) const;
@@ -145,6 +163,32 @@ private:
     VkCommandBuffer BeginFrame( const RgStartFrameInfo& info );
     void            Render( VkCommandBuffer cmd, const RgDrawFrameInfo& drawInfo );
     void            EndFrame( VkCommandBuffer cmd );
+    // Continue recording the frame in a new graphics cmd
+    void            ContinueFrame( VkCommandBuffer cmd );
+
+    // Results of the lookups by texture name, reused by all primitives
+    // of one upload call with the same texture name, in any order
+    struct TextureLookupCache
+    {
+        struct Entry
+        {
+            const TextureMeta* meta{ nullptr };
+            MaterialTextures   textures{};
+        };
+        rgl::unordered_map< std::string_view, Entry > entries;
+    };
+    struct ResolvedMaterial
+    {
+        const char*             textureName;
+        const TextureMeta*      meta;
+        const MaterialTextures* baseTextures;
+    };
+    // Resolve material handle or texture name of the primitive
+    ResolvedMaterial ResolveMaterial( const RgMeshPrimitiveInfo& primitive,
+                                      TextureLookupCache*        cache );
+    void             UploadMeshPrimitive( const RgMeshInfo&          mesh,
+                              const RgMeshPrimitiveInfo& primitive,
+                              TextureLookupCache*        cache );
 
 private:
     void Dev_Draw() const;
@@ -172,6 +216,8 @@ private:
     std::shared_ptr< PhysicalDevice > physDevice;
     std::shared_ptr< Queues >         queues;
     std::shared_ptr< Swapchain >      swapchain;
+    // only if headless
+    std::unique_ptr< FinalImageReadback > finalImageReadback;
 
     std::shared_ptr< MemoryAllocator > memAllocator;
 
@@ -185,6 +231,7 @@ private:
     std::shared_ptr< Scene >             scene;
     std::shared_ptr< SceneImportExport > sceneImportExport;
 
+    std::shared_ptr< PipelineCache >             pipelineCache;
     std::shared_ptr< ShaderManager >             shaderManager;
     std::shared_ptr< RayTracingPipeline >        rtPipeline;
     std::shared_ptr< PathTracer >                pathTracer;
@@ -219,6 +266,7 @@ private:
     std::shared_ptr< TextureMetaManager > textureMetaManager;
     std::shared_ptr< SceneMetaManager >   sceneMetaManager;
     std::shared_ptr< CubemapManager >     cubemapManager;
+    MaterialHandleTable                   materialHandles;
 
     std::filesystem::path ovrdFolder;
 
@@ -233,12 +281,24 @@ private:
     std::vector< PositionNormal >        tempStorageInit;
     std::vector< RgSpotLightUploadInfo > tempStorageLights;
 
+    // rgUploadMeshPrimitive can be called from multiple threads,
+    // guards the parts that are not thread-safe
+    std::mutex         uploadMutex;
+    mutable std::mutex printMutex;
+
     std::unique_ptr< Devmode > devmode;
 
+    // null, if disabled in the library config
+    std::unique_ptr< Profiler > profiler;
+
+    // null, if disabled in the library config
+    std::unique_ptr< AsyncCompute > asyncCompute;
+
     bool rayCullBackFacingTriangles;
     bool allowGeometryWithSkyFlag;
 
-    RenderResolutionHelper renderResolution;
+    RenderResolutionHelper      renderResolution;
+    DynamicResolutionController dynamicResolution;
 
     double previousFrameTime;
     double currentFrameTime;
@@ -212,6 +212,27 @@ void RTGL1::VulkanDevice::Dev_Draw() const
 
                 ImGui::EndDisabled();
             }
+            {
+                ImGui::SliderFloat( "Dynamic resolution target",
+                                    &modifiers.dynamicResolutionTargetMs,
+                                    0.0f,
+                                    50.0f,
+                                    "%.1f ms" );
+                ImGui::BeginDisabled( modifiers.dynamicResolutionTargetMs <= 0.0f );
+                ImGui::SliderFloat( "Dynamic resolution min scale",
+                                    &modifiers.dynamicResolutionMinScale,
+                                    0.1f,
+                                    1.0f );
+                ImGui::EndDisabled();
+                if( modifiers.dynamicResolutionTargetMs > 0.0f )
+                {
+                    ImGui::Text( "Render size: %u x %u of %u x %u",
+                                 renderResolution.Width(),
+                                 renderResolution.Height(),
+                                 renderResolution.MaxWidth(),
+                                 renderResolution.MaxHeight() );
+                }
+            }
 
             ImGui::TreePop();
         }
@@ -948,6 +969,8 @@ void RTGL1::VulkanDevice::Dev_Override( DrawFrameInfoCopy& copy ) const
             };
             dst_resol.pPixelizedRenderSize =
                 modifiers.pixelizedEnable ? &modifiers.pixelizedForPtr : nullptr;
+            dst_resol.dynamicResolutionTargetMs = modifiers.dynamicResolutionTargetMs;
+            dst_resol.dynamicResolutionMinScale = modifiers.dynamicResolutionMinScale;
         }
         {
             dst_illum.maxBounceShadows                 = modifiers.maxBounceShadows;
@@ -1006,6 +1029,10 @@ void RTGL1::VulkanDevice::Dev_Override( DrawFrameInfoCopy& copy ) const
                 src_resol.pPixelizedRenderSize
                     ? ClampPix< int >( src_resol.pPixelizedRenderSize->height )
                     : 0;
+            modifiers.dynamicResolutionTargetMs = src_resol.dynamicResolutionTargetMs;
+            modifiers.dynamicResolutionMinScale = src_resol.dynamicResolutionMinScale > 0.0f
+                                                      ? src_resol.dynamicResolutionMinScale
+                                                      : 0.5f;
         }
         {
             modifiers.maxBounceShadows                 = int( src_illum.maxBounceShadows );
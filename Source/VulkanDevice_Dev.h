@@ -72,6 +72,8 @@ struct Devmode
         RgRenderSharpenTechnique sharpenTechnique;
         RgRenderResolutionMode   resolutionMode;
         float                    customRenderSizeScale;
+        float                    dynamicResolutionTargetMs;
+        float                    dynamicResolutionMinScale;
         bool                     pixelizedEnable;
         int                      pixelized[ 2 ];
         RgExtent2D               pixelizedForPtr;
@@ -205,8 +205,10 @@ RTGL1::VulkanDevice::VulkanDevice( const RgInstanceCreateInfo* info )
     // clang-format off
 
 
-    // create VkSurfaceKHR using user's function
-    surface = GetSurfaceFromUser( instance, *info );
+    // create VkSurfaceKHR using user's function, if not headless
+    surface = info->pHeadlessCreateInfo == nullptr 
+        ? GetSurfaceFromUser( instance, *info ) 
+        : VK_NULL_HANDLE;
 
 
     // create selected physical device
@@ -227,30 +229,76 @@ RTGL1::VulkanDevice::VulkanDevice( const RgInstanceCreateInfo* info )
         device, 
         physDevice );
 
+    // async compute is pointless, if compute queue is the graphics one
+    const bool useAsyncCompute = 
+        libconfig.asyncCompute && queues->GetIndexCompute() != queues->GetIndexGraphics();
+
+    if( useAsyncCompute )
+    {
+        memAllocator->SetConcurrentQueueFamilies( 
+            queues->GetIndexGraphics(), 
+            queues->GetIndexCompute() );
+    }
+
     cmdManager = std::make_shared< CommandBufferManager >( 
         device, 
         queues );
 
+    if( useAsyncCompute )
+    {
+        asyncCompute = std::make_unique< AsyncCompute >( 
+            device, 
+            queues, 
+            cmdManager );
+    }
+
+    if( libconfig.frameProfiler )
+    {
+        profiler = std::make_unique< Profiler >( 
+            device, 
+            physDevice->Get(), 
+            queues->GetIndexGraphics() );
+    }
+
     uniform = std::make_shared< GlobalUniform >( 
         device, 
         memAllocator );
 
-    swapchain = std::make_shared< Swapchain >(
-        device, 
-        surface, 
-        physDevice->Get(), 
-        cmdManager );
+    if( info->pHeadlessCreateInfo == nullptr )
+    {
+        swapchain = std::make_shared< Swapchain >(
+            device, 
+            surface, 
+            physDevice->Get(), 
+            cmdManager );
+    }
+    else
+    {
+        swapchain = std::make_shared< Swapchain >(
+            device, 
+            memAllocator, 
+            cmdManager, 
+            *info->pHeadlessCreateInfo );
+
+        finalImageReadback = std::make_unique< FinalImageReadback >( 
+            device, 
+            memAllocator );
+    }
     
     if( libconfig.developerMode )
     {
-        debugWindows = std::make_shared< DebugWindows >( 
-            instance,
-            physDevice->Get(),
-            device,
-            queues->GetIndexGraphics(),
-            queues->GetGraphics(),
-            cmdManager );
-        debugWindows->Init( debugWindows );
+        // debug windows require window system integration
+        if( !swapchain->IsHeadless() )
+        {
+            debugWindows = std::make_shared< DebugWindows >( 
+                instance,
+                physDevice->Get(),
+                device,
+                queues->GetIndexGraphics(),
+                queues->GetGraphics(),
+                cmdManager );
+            debugWindows->Init( debugWindows );
+        }
 
         devmode = std::make_unique<Devmode>();
 
@@ -265,7 +313,8 @@ RTGL1::VulkanDevice::VulkanDevice( const RgInstanceCreateInfo* info )
         device, 
         memAllocator, 
         cmdManager,
-        *info );
+        *info,
+        libconfig.transientFramebufferAliasing );
 
     restirBuffers = std::make_shared< RestirBuffers >( 
         device, 
@@ -300,9 +349,15 @@ RTGL1::VulkanDevice::VulkanDevice( const RgInstanceCreateInfo* info )
         genericSamplerManager, 
         *cmdManager );
 
+    pipelineCache = std::make_shared< PipelineCache >(
+        device,
+        *physDevice,
+        ovrdFolder / PIPELINE_CACHE_FOLDER );
+
     shaderManager = std::make_shared< ShaderManager >( 
         device, 
-        ovrdFolder / SHADERS_FOLDER );
+        ovrdFolder / SHADERS_FOLDER,
+        pipelineCache );
 
     scene = std::make_shared< Scene >(
         device, 
@@ -310,10 +365,13 @@ RTGL1::VulkanDevice::VulkanDevice( const RgInstanceCreateInfo* info )
         memAllocator, 
         cmdManager, 
         *uniform, 
-        *shaderManager,
         info->allowTexCoordLayer1,
         info->allowTexCoordLayer2,
-        info->allowTexCoordLayer3 );
+        info->allowTexCoordLayer3,
+        libconfig.staticMeshInstancing,
+        libconfig.dynamicBlasMaxRefitCount,
+        libconfig.staticSectorShare,
+        libconfig.compactStaticVertices );
 
     sceneImportExport = std::make_shared< SceneImportExport >(
         ovrdFolder / SCENES_FOLDER, 
@@ -324,7 +382,6 @@ RTGL1::VulkanDevice::VulkanDevice( const RgInstanceCreateInfo* info )
     tonemapping = std::make_shared< Tonemapping >(
         device, 
         framebuffers, 
-        shaderManager, 
         uniform, 
         memAllocator );
 
@@ -332,7 +389,6 @@ RTGL1::VulkanDevice::VulkanDevice( const RgInstanceCreateInfo* info )
         device,
         *cmdManager,
         *memAllocator,
-        *shaderManager,
         *uniform,
         *blueNoise,
         *framebuffers );
@@ -349,13 +405,19 @@ RTGL1::VulkanDevice::VulkanDevice( const RgInstanceCreateInfo* info )
         memAllocator,
         framebuffers,
         cmdManager,
-        *info );
+        *info,
+        libconfig.rasterPipelineFallback,
+        libconfig.parallelCmdRecording
+            ? std::make_shared< SecondaryCmdRecorder >( 
+                device, 
+                queues->GetIndexGraphics(), 
+                Rasterizer::SecondaryCmdSlotCount )
+            : nullptr );
 
     decalManager = std::make_shared< DecalManager >(
         device, 
         memAllocator, 
         framebuffers,
-        *shaderManager, 
         *uniform, 
         *textureManager );
 
@@ -365,11 +427,11 @@ RTGL1::VulkanDevice::VulkanDevice( const RgInstanceCreateInfo* info )
 
     lightManager = std::make_shared< LightManager >( 
         device, 
-        memAllocator );
+        memAllocator,
+        libconfig.lightTree );
 
     lightGrid = std::make_shared< LightGrid >(
         device,
-        shaderManager, 
         uniform, 
         blueNoise, 
         lightManager );
@@ -378,7 +440,6 @@ RTGL1::VulkanDevice::VulkanDevice( const RgInstanceCreateInfo* info )
         device,
         physDevice,
         memAllocator,
-        *shaderManager,
         *scene,
         *uniform,
         *textureManager,
@@ -390,7 +451,8 @@ RTGL1::VulkanDevice::VulkanDevice( const RgInstanceCreateInfo* info )
         *rasterizer->GetRenderCubemap(),
         *portalList,
         *volumetric,
-        *info );
+        *info,
+        libconfig.lightTree );
 
     pathTracer = std::make_shared< PathTracer >( 
         device,
@@ -400,14 +462,12 @@ RTGL1::VulkanDevice::VulkanDevice( const RgInstanceCreateInfo* info )
         device, 
         memAllocator, 
         framebuffers, 
-        *shaderManager, 
         *uniform, 
         *tonemapping );
 
     bloom = std::make_shared< Bloom >( 
         device,
         framebuffers,
-        *shaderManager,
         *uniform,
         *textureManager,
         *tonemapping );
@@ -425,13 +485,11 @@ RTGL1::VulkanDevice::VulkanDevice( const RgInstanceCreateInfo* info )
 
     sharpening = std::make_shared< Sharpening >( 
         device, 
-        framebuffers, 
-        shaderManager );
+        framebuffers );
 
     denoiser = std::make_shared< Denoiser >(
         device, 
         framebuffers, 
-        *shaderManager,
         *uniform );
 
     effectWipe = std::make_shared< EffectWipe >(
@@ -439,15 +497,13 @@ RTGL1::VulkanDevice::VulkanDevice( const RgInstanceCreateInfo* info )
         framebuffers, 
         uniform, 
         blueNoise, 
-        shaderManager, 
         info->effectWipeIsUsed );
 
 
     // clang-format on
 
 
-#define CONSTRUCT_SIMPLE_EFFECT( T ) \
-    std::make_shared< T >( device, framebuffers, uniform, shaderManager )
+#define CONSTRUCT_SIMPLE_EFFECT( T ) std::make_shared< T >( device, framebuffers, uniform )
     effectRadialBlur          = CONSTRUCT_SIMPLE_EFFECT( EffectRadialBlur );
     effectChromaticAberration = CONSTRUCT_SIMPLE_EFFECT( EffectChromaticAberration );
     effectInverseBW           = CONSTRUCT_SIMPLE_EFFECT( EffectInverseBW );
@@ -484,6 +540,9 @@ RTGL1::VulkanDevice::VulkanDevice( const RgInstanceCreateInfo* info )
     shaderManager->Subscribe( effectCrtDemodulateEncode );
     shaderManager->Subscribe( effectCrtDecode );
 
+    // all pipelines are created at once on worker threads
+    shaderManager->CreateSubscriberPipelines();
+
     framebuffers->Subscribe( rasterizer );
     framebuffers->Subscribe( decalManager );
     framebuffers->Subscribe( amdFsr2 );
@@ -506,6 +565,8 @@ RTGL1::VulkanDevice::~VulkanDevice()
     physDevice.reset();
     queues.reset();
     swapchain.reset();
+    finalImageReadback.reset();
+    asyncCompute.reset();
     cmdManager.reset();
     framebuffers.reset();
     restirBuffers.reset();
@@ -532,6 +593,7 @@ RTGL1::VulkanDevice::~VulkanDevice()
     scene.reset();
     sceneImportExport.reset();
     shaderManager.reset();
+    pipelineCache.reset();
     rtPipeline.reset();
     pathTracer.reset();
     rasterizer.reset();
@@ -548,9 +610,13 @@ RTGL1::VulkanDevice::~VulkanDevice()
     cubemapManager.reset();
     debugWindows.reset();
     devmode.reset();
+    profiler.reset();
     memAllocator.reset();
 
-    vkDestroySurfaceKHR( instance, surface, nullptr );
+    if( surface != VK_NULL_HANDLE )
+    {
+        vkDestroySurfaceKHR( instance, surface, nullptr );
+    }
     DestroySyncPrimitives();
 
     DestroyDevice();
@@ -647,6 +713,9 @@ void RTGL1::VulkanDevice::CreateInstance( const RgInstanceCreateInfo& info )
 
     std::vector extensions = {
         VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME,
+    };
+
+    const auto surfaceExtensions = {
         VK_KHR_SURFACE_EXTENSION_NAME,
 
 #ifdef RG_USE_SURFACE_WIN32
@@ -670,6 +739,12 @@ void RTGL1::VulkanDevice::CreateInstance( const RgInstanceCreateInfo& info )
 #endif // RG_USE_SURFACE_XLIB
     };
 
+    // headless instance must work without window system integration
+    if( info.pHeadlessCreateInfo == nullptr )
+    {
+        extensions.insert( extensions.end(), surfaceExtensions.begin(), surfaceExtensions.end() );
+    }
+
     if( libconfig.vulkanValidation )
     {
         extensions.push_back( VK_EXT_DEBUG_UTILS_EXTENSION_NAME );
@@ -812,6 +887,7 @@ void RTGL1::VulkanDevice::CreateDevice()
         .shaderSampledImageArrayNonUniformIndexing  = 1,
         .shaderStorageBufferArrayNonUniformIndexing = 1,
         .runtimeDescriptorArray                     = 1,
+        .timelineSemaphore                          = 1,
         .bufferDeviceAddress                        = 1,
     };
 
@@ -865,7 +941,6 @@ void RTGL1::VulkanDevice::CreateDevice()
     }
 
     std::vector deviceExtensions = {
-        VK_KHR_SWAPCHAIN_EXTENSION_NAME,
         VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME,
         VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME,
         VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME,
@@ -874,6 +949,11 @@ void RTGL1::VulkanDevice::CreateDevice()
         VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME,
     };
 
+    if( surface != VK_NULL_HANDLE )
+    {
+        deviceExtensions.push_back( VK_KHR_SWAPCHAIN_EXTENSION_NAME );
+    }
+
     for( const char* n : DLSS::GetDlssVulkanDeviceExtensions() )
     {
         const bool isSupported = std::any_of( supportedDeviceExtensions.cbegin(),
@@ -1022,15 +1102,23 @@ void RTGL1::VulkanDevice::ValidateCreateInfo( const RgInstanceCreateInfo* pInfo
     {
         int count = !!pInfo->pWin32SurfaceInfo + !!pInfo->pMetalSurfaceCreateInfo +
                     !!pInfo->pWaylandSurfaceCreateInfo + !!pInfo->pXcbSurfaceCreateInfo +
-                    !!pInfo->pXlibSurfaceCreateInfo;
+                    !!pInfo->pXlibSurfaceCreateInfo + !!pInfo->pHeadlessCreateInfo;
 
         if( count != 1 )
         {
-            throw RgException( RG_RESULT_WRONG_FUNCTION_ARGUMENT,
-                               "Exactly one of the surface infos must be not null" );
+            throw RgException(
+                RG_RESULT_WRONG_FUNCTION_ARGUMENT,
+                "Exactly one of the surface infos or pHeadlessCreateInfo must be not null" );
         }
     }
 
+    if( pInfo->pHeadlessCreateInfo != nullptr &&
+        ( pInfo->pHeadlessCreateInfo->width == 0 || pInfo->pHeadlessCreateInfo->height == 0 ) )
+    {
+        throw RgException( RG_RESULT_WRONG_FUNCTION_ARGUMENT,
+                           "pHeadlessCreateInfo must have non-zero width and height" );
+    }
+
     if( pInfo->rasterizedSkyCubemapSize == 0 )
     {
         throw RgException( RG_RESULT_WRONG_FUNCTION_ARGUMENT,
@@ -0,0 +1,190 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Dynamic geometries can be uploaded from multiple threads, so the order of the uploads is
+// not deterministic. Check that the BLAS geometries and their topology hash don't depend on it,
+// otherwise the dynamic BLAS would be rebuilt each frame instead of refitting.
+
+#include "VertexCollectorFilter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using namespace RTGL1;
+using FT = VertexCollectorFilterTypeFlagBits;
+
+struct TestPrimitive
+{
+    uint64_t uniqueID;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+};
+
+// Data that determines if the BLAS can be refit
+struct BuildResult
+{
+    uint64_t                topologyHash;
+    std::vector< uint32_t > primitiveCounts;
+    std::vector< uint64_t > uniqueIDs;
+};
+
+void AddPending( VertexCollectorFilter& filter, const TestPrimitive& prim )
+{
+    const auto rangeInfo = VkAccelerationStructureBuildRangeInfoKHR{
+        .primitiveCount  = prim.indexCount / 3,
+        .primitiveOffset = 0,
+        .firstVertex     = 0,
+        .transformOffset = 0,
+    };
+
+    const auto fnMakeGeometry = []() -> std::optional< VkAccelerationStructureGeometryKHR > {
+        return VkAccelerationStructureGeometryKHR{
+            .sType        = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR,
+            .pNext        = nullptr,
+            .geometryType = VK_GEOMETRY_TYPE_TRIANGLES_KHR,
+            .geometry     = {},
+            .flags        = 0,
+        };
+    };
+
+    bool isAdded = filter.AddPendingGeometry( filter.GetFilter(),
+                                              fnMakeGeometry,
+                                              rangeInfo,
+                                              prim.uniqueID,
+                                              prim.vertexCount,
+                                              prim.indexCount,
+                                              ShGeometryInstance{} );
+    if( !isAdded )
+    {
+        printf( "Failed to add geometry %llu\n", ( unsigned long long )prim.uniqueID );
+    }
+}
+
+BuildResult Flush( VertexCollectorFilter& filter )
+{
+    auto result = BuildResult{};
+
+    filter.FlushPendingGeometries(
+        [ & ]( uint64_t uniqueID, uint32_t localIndex, ShGeometryInstance& ) {
+            // after Reset, local indices must be consecutive
+            if( localIndex == result.uniqueIDs.size() )
+            {
+                result.uniqueIDs.push_back( uniqueID );
+            }
+        } );
+
+    result.topologyHash    = filter.GetTopologyHash();
+    result.primitiveCounts = filter.GetPrimitiveCounts();
+    return result;
+}
+
+BuildResult BuildInOrder( VertexCollectorFilter& filter, const std::vector< TestPrimitive >& prims )
+{
+    filter.Reset();
+
+    for( const auto& p : prims )
+    {
+        AddPending( filter, p );
+    }
+
+    return Flush( filter );
+}
+
+BuildResult BuildConcurrently( VertexCollectorFilter&              filter,
+                               const std::vector< TestPrimitive >& prims,
+                               uint32_t                            threadCount )
+{
+    filter.Reset();
+
+    std::vector< std::thread > threads;
+    for( uint32_t t = 0; t < threadCount; t++ )
+    {
+        threads.emplace_back( [ &, t ]() {
+            for( size_t i = t; i < prims.size(); i += threadCount )
+            {
+                AddPending( filter, prims[ i ] );
+            }
+        } );
+    }
+
+    for( auto& th : threads )
+    {
+        th.join();
+    }
+
+    return Flush( filter );
+}
+
+// Same condition as in ASManager::SubmitDynamicGeometry,
+// and the geometries must have the same local indices
+bool CanRefit( const BuildResult& prev, const BuildResult& cur )
+{
+    return prev.topologyHash == cur.topologyHash && prev.primitiveCounts == cur.primitiveCounts &&
+           prev.uniqueIDs == cur.uniqueIDs;
+}
+
+bool Check( bool condition, const char* name )
+{
+    printf( "%s: %s\n", name, condition ? "OK" : "FAILED" );
+    return condition;
+}
+
+}
+
+int main()
+{
+    VertexCollectorFilterTypeFlags_Init();
+
+    auto filter = VertexCollectorFilter( FT::CF_DYNAMIC | FT::PT_OPAQUE | FT::PV_WORLD_0 );
+
+    std::vector< TestPrimitive > prims;
+    for( uint64_t i = 0; i < 64; i++ )
+    {
+        prims.push_back( TestPrimitive{
+            .uniqueID    = 1000 + i * 7,
+            .vertexCount = 3 + uint32_t( i % 5 ) * 3,
+            .indexCount  = 6 + uint32_t( i % 3 ) * 6,
+        } );
+    }
+
+    std::vector< TestPrimitive > reversed( prims.rbegin(), prims.rend() );
+
+    std::vector< TestPrimitive > changed = prims;
+    changed[ 10 ].vertexCount += 3;
+
+    const BuildResult first = BuildInOrder( filter, prims );
+
+    bool ok = true;
+    ok &= Check( first.uniqueIDs.size() == prims.size(), "All geometries are flushed" );
+    ok &= Check( std::ranges::is_sorted( first.uniqueIDs ), "Geometries are sorted by unique ID" );
+    ok &= Check( CanRefit( first, BuildInOrder( filter, reversed ) ), "Refit after reordering" );
+    ok &= Check( CanRefit( first, BuildConcurrently( filter, prims, 4 ) ),
+                 "Refit after concurrent upload" );
+    ok &= Check( !CanRefit( first, BuildInOrder( filter, changed ) ),
+                 "Rebuild after vertex count change" );
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+// Copyright (c) 2023 Sultim Tsyrendashiev
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Micro-benchmark of the vertex kernels: each available instruction set is checked
+// against the scalar variant, and timed on a big vertex array.
+
+#include "VertexKernels.h"
+#include "VertexKernels_Impl.h"
+
+#include "Generated/ShaderCommonC.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+using namespace RTGL1;
+using namespace RTGL1::VertexKernels::detail;
+
+constexpr uint32_t VertexCount = 1 << 20;
+constexpr int      Iterations  = 20;
+
+struct Input
+{
+    std::vector< RgPrimitiveVertex > vertices;
+    std::vector< float >             colors;
+    std::vector< RgFloat3D >         triangles;
+    RgTransform                      transform;
+};
+
+Input MakeInput()
+{
+    auto rnd   = std::mt19937( 7 );
+    auto range = []( float a, float b ) {
+        return std::uniform_real_distribution< float >( a, b );
+    };
+
+    Input in = {};
+    in.vertices.resize( VertexCount );
+    in.colors.resize( VertexCount * 4 );
+    in.triangles.resize( VertexCount / 3 * 3 );
+
+    for( auto& v : in.vertices )
+    {
+        auto pos = range( -1000.0f, 1000.0f );
+        auto dir = range( -1.0f, 1.0f );
+        auto uv  = range( -16.0f, 16.0f );
+
+        float n[ 3 ] = { dir( rnd ), dir( rnd ), dir( rnd ) };
+        float len    = std::sqrt( n[ 0 ] * n[ 0 ] + n[ 1 ] * n[ 1 ] + n[ 2 ] * n[ 2 ] );
+        len          = len > 0.0f ? len : 1.0f;
+
+        // value-initialized, so the padding fields are zero
+        v = RgPrimitiveVertex{};
+
+        v.position[ 0 ] = pos( rnd );
+        v.position[ 1 ] = pos( rnd );
+        v.position[ 2 ] = pos( rnd );
+
+        v.normal[ 0 ] = n[ 0 ] / len;
+        v.normal[ 1 ] = n[ 1 ] / len;
+        v.normal[ 2 ] = n[ 2 ] / len;
+
+        v.tangent[ 0 ] = 1;
+        v.tangent[ 1 ] = 0;
+        v.tangent[ 2 ] = 0;
+        v.tangent[ 3 ] = 1;
+
+        v.texCoord[ 0 ] = uv( rnd );
+        v.texCoord[ 1 ] = uv( rnd );
+
+        v.color = uint32_t( rnd() );
+    }
+
+    // out of range values must be clamped
+    for( auto& c : in.colors )
+    {
+        c = range( -0.5f, 1.5f )( rnd );
+    }
+
+    for( size_t i = 0; i < in.triangles.size(); i++ )
+    {
+        memcpy( in.triangles[ i ].data, in.vertices[ i ].position, sizeof( RgFloat3D ) );
+    }
+
+    in.transform = { {
+        { 0.8f, -0.6f, 0.0f, 10.0f },
+        { 0.6f, 0.8f, 0.0f, -5.0f },
+        { 0.0f, 0.0f, 2.0f, 1.0f },
+    } };
+
+    return in;
+}
+
+template< typename Func >
+double Measure( Func&& func )
+{
+    func();
+
+    auto begin = std::chrono::steady_clock::now();
+    for( int i = 0; i < Iterations; i++ )
+    {
+        func();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration< double, std::milli >( end - begin ).count() / Iterations;
+}
+
+bool AreClose( const RgFloat3D* a, const RgFloat3D* b, size_t count, float eps )
+{
+    for( size_t i = 0; i < count; i++ )
+    {
+        for( int k = 0; k < 3; k++ )
+        {
+            if( !( std::abs( a[ i ].data[ k ] - b[ i ].data[ k ] ) <= eps ) )
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool Run( const KernelTable& k, const KernelTable& reference, const Input& in )
+{
+    const uint32_t triCount = uint32_t( in.triangles.size() / 3 );
+
+    std::vector< uint8_t >           copied( VertexCount * sizeof( RgPrimitiveVertex ) );
+    std::vector< ShVertexCompact >   compact( VertexCount ), compactRef( VertexCount );
+    std::vector< RgFloat3D >         positions( VertexCount ), positionsRef( VertexCount );
+    std::vector< RgColor4DPacked32 > colors( VertexCount ), colorsRef( VertexCount );
+    std::vector< RgFloat3D >         normals( triCount ), normalsRef( triCount );
+    std::vector< float >             areas( triCount ), areasRef( triCount );
+
+    double tCopy = Measure( [ & ] {
+        k.streamCopy( copied.data(), in.vertices.data(), copied.size() );
+    } );
+    double tPack = Measure( [ & ] {
+        k.packCompact( compact.data(), in.vertices.data(), VertexCount );
+    } );
+    double tTransform = Measure( [ & ] {
+        k.transformPositions( positions.data(), in.vertices.data(), VertexCount, in.transform );
+    } );
+    double tColors = Measure( [ & ] {
+        k.packColors( colors.data(), in.colors.data(), VertexCount );
+    } );
+    double tNormals = Measure( [ & ] {
+        k.triangleNormals( normals.data(), areas.data(), in.triangles.data(), triCount );
+    } );
+
+    reference.packCompact( compactRef.data(), in.vertices.data(), VertexCount );
+    reference.transformPositions(
+        positionsRef.data(), in.vertices.data(), VertexCount, in.transform );
+    reference.packColors( colorsRef.data(), in.colors.data(), VertexCount );
+    reference.triangleNormals( normalsRef.data(), areasRef.data(), in.triangles.data(), triCount );
+
+    bool ok = true;
+    auto check = [ &ok, &k ]( bool result, const char* name ) {
+        if( !result )
+        {
+            printf( "  %s: %s result differs from the scalar one\n", k.isa, name );
+            ok = false;
+        }
+    };
+
+    check( memcmp( copied.data(), in.vertices.data(), copied.size() ) == 0, "StreamCopy" );
+    check( memcmp( compact.data(), compactRef.data(), compact.size() * sizeof( compact[ 0 ] ) ) ==
+               0,
+           "PackCompact" );
+    // FMA may differ in the last bits, positions are up to 1000 units
+    check( AreClose( positions.data(), positionsRef.data(), VertexCount, 1e-3f ),
+           "TransformPositions" );
+    check( colors == colorsRef, "PackColors" );
+    check( AreClose( normals.data(), normalsRef.data(), triCount, 1e-6f ), "TriangleNormals" );
+
+    printf( "%-8s copy %7.3f ms | pack %7.3f ms | transform %7.3f ms | colors %7.3f ms | "
+            "normals %7.3f ms\n",
+            k.isa,
+            tCopy,
+            tPack,
+            tTransform,
+            tColors,
+            tNormals );
+
+    return ok;
+}
+
+}
+
+int main()
+{
+    const Input input = MakeInput();
+
+    printf( "%u vertices, %d iterations, dispatched to: %s\n",
+            VertexCount,
+            Iterations,
+            VertexKernels::GetActiveISA() );
+
+    bool ok = Run( GetScalarKernels(), GetScalarKernels(), input );
+#if RG_VERTEX_KERNELS_X86
+    if( IsSSE4Supported() )
+    {
+        ok &= Run( GetSSE4Kernels(), GetScalarKernels(), input );
+    }
+    if( IsAVX2Supported() )
+    {
+        ok &= Run( GetAVX2Kernels(), GetScalarKernels(), input );
+    }
+#endif
+
+    return ok ? 0 : 1;
+}